@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <sstream>
 #include <iostream>
 #include "executor/executor.h"
 #include "storage/table_heap.h"
@@ -30,13 +31,32 @@ public:
 
             out << "TABLE " << name << std::endl;
             out << "ROOT " << root_page << std::endl;
+            if (pair.second->GetZoneMapPageId() != -1) {
+                out << "ZONEMAP " << pair.second->GetZoneMapPageId() << std::endl;
+            }
+            if (pair.second->GetStorage() != TableStorage::ROW) {
+                out << "STORAGE " << TableStorageName(pair.second->GetStorage()) << std::endl;
+            }
             out << "COLUMNS " << schema.GetColumnCount() << std::endl;
 
             for (const auto& col : schema.GetColumns()) {
                 // We use static_cast to int for TypeID
-                out << "COLUMN " << col.GetName() << " " << static_cast<int>(col.GetType()) << " " << col.GetOffset() << std::endl;
+                out << "COLUMN " << col.GetName() << " " << static_cast<int>(col.GetType()) << " " << col.GetOffset();
+                if (col.GetVectorEncoding() != VectorEncoding::FP32) out << " " << VectorEncodingName(col.GetVectorEncoding());
+                out << std::endl;
             }
         }
+
+        // Indexes follow the tables; older catalogs simply end here
+        out << "INDEX_COUNT " << executor_->indexes_.size() << std::endl;
+        for (const auto& pair : executor_->indexes_) {
+            const IndexInfo& index = pair.second;
+            out << "INDEX " << index.name << " " << index.table_name << " " << index.ColumnList() << " "
+                << index.tree->GetHeaderPageId() << " "
+                << IndexTypeName(index.tree->GetType());
+            if (!index.include_names.empty()) out << " INCLUDE " << index.IncludeList();
+            out << std::endl;
+        }
         out.close();
         std::cout << "\033[1;32mCatalog saved to " << catalog_file_ << " (Readable text format).\033[0m" << std::endl;
     }
@@ -59,11 +79,20 @@ public:
         for (uint32_t i = 0; i < table_count; ++i) {
             std::string table_name;
             page_id_t root_page;
+            page_id_t zone_map_page = -1;
+            TableStorage storage = TableStorage::ROW;
             uint32_t col_count;
 
             in >> key >> table_name; // TABLE name
             in >> key >> root_page;  // ROOT root_page
-            in >> key >> col_count; // COLUMNS col_count
+            in >> key;
+            if (key == "ZONEMAP") in >> zone_map_page >> key; // ZONEMAP page (absent in older catalogs)
+            if (key == "STORAGE") {                            // STORAGE COLUMNAR (row tables have none)
+                std::string storage_name;
+                in >> storage_name >> key;
+                ParseTableStorage(storage_name, storage);
+            }
+            in >> col_count; // COLUMNS col_count
 
             std::vector<Column> cols;
             for (uint32_t c = 0; c < col_count; ++c) {
@@ -71,14 +100,64 @@ public:
                 int type_int;
                 uint32_t offset;
                 in >> key >> col_name >> type_int >> offset; // COLUMN name type offset
-                cols.emplace_back(col_name, static_cast<TypeID>(type_int), offset);
+                // Then the encoding of a VECTOR column not stored as FP32
+                std::string rest, encoding_name;
+                std::getline(in, rest);
+                std::stringstream(rest) >> encoding_name;
+                VectorEncoding encoding = VectorEncoding::FP32;
+                ParseVectorEncoding(encoding_name, encoding);
+                cols.emplace_back(col_name, static_cast<TypeID>(type_int), offset, encoding);
             }
 
             Schema schema(cols);
-            auto heap = std::make_unique<TableHeap>(executor_->disk_manager_, root_page, schema);
+            std::unique_ptr<TableHeap> heap;
+            if (storage == TableStorage::COLUMNAR) {
+                heap = std::make_unique<ColumnarTable>(executor_->disk_manager_, root_page, schema);
+            } else {
+                heap = std::make_unique<TableHeap>(executor_->disk_manager_, root_page, schema, zone_map_page);
+            }
             executor_->tables_.emplace(table_name, std::move(heap));
             executor_->schemas_.emplace(table_name, schema);
         }
+
+        uint32_t index_count = 0;
+        if (in >> key && key == "INDEX_COUNT") {
+            in >> index_count;
+        }
+        for (uint32_t i = 0; i < index_count; ++i) {
+            IndexInfo index;
+            std::string columns;
+            page_id_t header_page;
+            in >> key >> index.name >> index.table_name >> columns >> header_page; // INDEX name table col[,col] header
+            // Then [BTREE|HASH|BLOOM|HNSW|IVFPQ] [INCLUDE col[,col...]], missing in older catalogs
+            std::string rest, method, include_key, includes;
+            std::getline(in, rest);
+            std::stringstream rest_stream(rest);
+            rest_stream >> method >> include_key >> includes;
+            IndexType type = IndexType::BPLUS_TREE;
+            ParseIndexType(method, type);
+            auto schema_it = executor_->schemas_.find(index.table_name);
+            if (schema_it == executor_->schemas_.end()) continue;
+            bool valid = true;
+            auto resolve = [&](const std::string& list, std::vector<std::string>& names,
+                               std::vector<uint32_t>& indexes) {
+                std::stringstream column_stream(list);
+                std::string column;
+                while (std::getline(column_stream, column, ',')) {
+                    int col_idx = schema_it->second.GetColumnIndex(column);
+                    if (col_idx == -1) valid = false;
+                    names.push_back(column);
+                    indexes.push_back(static_cast<uint32_t>(col_idx));
+                }
+            };
+            resolve(columns, index.column_names, index.column_indexes);
+            if (include_key == "INCLUDE") resolve(includes, index.include_names, index.include_indexes);
+            if (!valid) continue;
+            index.tree = TableIndex::Create(index.name, executor_->disk_manager_, schema_it->second,
+                                            index.column_indexes, header_page, type, index.include_indexes);
+            if (!index.tree) continue;
+            executor_->indexes_.emplace(index.name, std::move(index));
+        }
         in.close();
         std::cout << "Catalog loaded from " << catalog_file_ << " (" << table_count << " tables)." << std::endl;
     }
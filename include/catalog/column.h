@@ -1,18 +1,22 @@
 #pragma once
 
 #include <string>
+#include "common/vector_distance.h"
 #include "type/type_id.h"
 
 namespace mydb {
 
 class Column {
 public:
-    Column(std::string name, TypeID type_id, uint32_t offset)
-        : name_(std::move(name)), type_id_(type_id), offset_(offset) {}
+    Column(std::string name, TypeID type_id, uint32_t offset,
+           VectorEncoding vector_encoding = VectorEncoding::FP32)
+        : name_(std::move(name)), type_id_(type_id), offset_(offset), vector_encoding_(vector_encoding) {}
 
     std::string GetName() const { return name_; }
     TypeID GetType() const { return type_id_; }
     uint32_t GetOffset() const { return offset_; }
+    // How a VECTOR column stores its values (FP32 for every other type)
+    VectorEncoding GetVectorEncoding() const { return vector_encoding_; }
     
     // Fixed size for fixed-length types (INTEGER), 0 for variable (VARCHAR)
     uint32_t GetFixedLength() const {
@@ -24,6 +28,7 @@ private:
     std::string name_;
     TypeID type_id_;
     uint32_t offset_; // Byte offset in tuple (if fixed schema) - simpler approach for now: we might just serialize values in order
+    VectorEncoding vector_encoding_;
 };
 
 } // namespace mydb
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "index/table_index.h"
+
+namespace mydb {
+
+/**
+ * A secondary index over one or two columns (INT or VARCHAR) of a table.
+ * The tree (a B+ tree, or a hash table for USING HASH) maps the key columns -> RID and
+ * allows duplicate keys; lookups use the leading column. A B+ tree may also store the
+ * INCLUDE columns, so queries reading only key and INCLUDE columns skip the heap. The
+ * catalog records the index's header page, which never moves.
+ */
+struct IndexInfo {
+    std::string name;
+    std::string table_name;
+    std::vector<std::string> column_names;
+    std::vector<uint32_t> column_indexes;
+    std::vector<std::string> include_names;
+    std::vector<uint32_t> include_indexes;
+    std::unique_ptr<TableIndex> tree;
+
+    // "a" or "a,b", as written to the catalog
+    std::string ColumnList() const { return JoinNames(column_names); }
+    std::string IncludeList() const { return JoinNames(include_names); }
+
+    // Whether writing column `column` changes this index's entries
+    bool Stores(uint32_t column) const {
+        return std::find(column_indexes.begin(), column_indexes.end(), column) != column_indexes.end() ||
+               std::find(include_indexes.begin(), include_indexes.end(), column) != include_indexes.end();
+    }
+
+private:
+    static std::string JoinNames(const std::vector<std::string>& names) {
+        std::string list;
+        for (const auto& name : names) list += (list.empty() ? "" : ",") + name;
+        return list;
+    }
+};
+
+} // namespace mydb
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 #include "catalog/column.h"
 
@@ -15,6 +16,14 @@ public:
         return columns_[col_idx];
     }
 
+    // Returns the index of the named column, or -1 if it does not exist
+    int GetColumnIndex(const std::string& name) const {
+        for (uint32_t i = 0; i < columns_.size(); ++i) {
+            if (columns_[i].GetName() == name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
     uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
 private:
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mydb {
+
+/**
+ * TaskScheduler is a work-stealing thread pool shared by the executor (parallel scans,
+ * sorts, aggregates) and the HTTP server (one task per client connection).
+ *
+ * Every worker owns a deque. Tasks submitted from a worker go to the back of its own
+ * deque and are popped LIFO (cache-warm); tasks submitted from outside are spread
+ * round-robin. An idle worker steals from the front of the other deques.
+ * Placement is NUMA-agnostic.
+ */
+class TaskScheduler {
+public:
+    using Task = std::function<void()>;
+
+    struct Metrics {
+        std::vector<size_t> queue_depths; // tasks waiting per worker deque
+        uint64_t submitted = 0;
+        uint64_t executed = 0;
+        uint64_t steals = 0;             // tasks taken from another worker's deque
+    };
+
+    /**
+     * @param num_workers worker thread count, 0 = hardware concurrency
+     */
+    explicit TaskScheduler(size_t num_workers = 0);
+
+    /**
+     * Runs every task still queued, then joins the workers.
+     */
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+     * Queue a task for execution on some worker.
+     */
+    void Submit(Task task);
+
+    size_t GetWorkerCount() const { return workers_.size(); }
+
+    /**
+     * Snapshot of queue depths and counters.
+     */
+    Metrics GetMetrics() const;
+
+private:
+    struct WorkerQueue {
+        mutable std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void WorkerLoop(size_t worker_id);
+    bool PopLocal(size_t worker_id, Task& task);
+    bool Steal(size_t thief_id, Task& task);
+    void RunTask(Task& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_cv_;
+    bool stop_ = false;
+
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> steals_{0};
+};
+
+/**
+ * TaskGroup is a fork/join handle: Run() forks tasks onto the scheduler and Wait()
+ * joins them. A waiting thread runs any of the group's tasks that no worker has
+ * started yet, so waiting from inside a worker (e.g. a scan issued by a server
+ * request) can never deadlock the pool. The first exception thrown by a task is
+ * rethrown from Wait(). With a null scheduler every task runs inline.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskScheduler* scheduler) : scheduler_(scheduler), state_(std::make_shared<State>()) {}
+    ~TaskGroup() { WaitNoThrow(); }
+
+    void Run(TaskScheduler::Task task);
+    void Wait();
+
+private:
+    struct GroupTask {
+        std::atomic<bool> claimed{false};
+        TaskScheduler::Task fn;
+    };
+
+    struct State {
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        size_t outstanding = 0;
+        std::exception_ptr error;
+    };
+
+    static void Execute(const std::shared_ptr<State>& state, const std::shared_ptr<GroupTask>& task);
+    void WaitNoThrow();
+
+    TaskScheduler* scheduler_;
+    std::shared_ptr<State> state_;
+    std::vector<std::shared_ptr<GroupTask>> tasks_;
+};
+
+/**
+ * Sorts [first, last) by splitting it into `parallelism` runs that are sorted as
+ * scheduler tasks, then merged pairwise. Falls back to std::sort for small inputs.
+ */
+template <typename It, typename Compare>
+void ParallelSort(TaskScheduler* scheduler, It first, It last, Compare comp, size_t parallelism) {
+    const size_t n = static_cast<size_t>(std::distance(first, last));
+    constexpr size_t MIN_RUN = 4096;
+    if (scheduler == nullptr || parallelism <= 1 || n < 2 * MIN_RUN) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    size_t runs = std::min(parallelism, n / MIN_RUN);
+    std::vector<It> bounds;
+    for (size_t i = 0; i <= runs; ++i) {
+        bounds.push_back(first + static_cast<std::ptrdiff_t>(n * i / runs));
+    }
+
+    {
+        TaskGroup group(scheduler);
+        for (size_t i = 0; i < runs; ++i) {
+            It lo = bounds[i];
+            It hi = bounds[i + 1];
+            group.Run([lo, hi, &comp]() { std::sort(lo, hi, comp); });
+        }
+        group.Wait();
+    }
+
+    // Merge neighbouring runs until one remains; merges of one round are independent
+    while (bounds.size() > 2) {
+        std::vector<It> merged;
+        TaskGroup group(scheduler);
+        size_t i = 0;
+        for (; i + 2 < bounds.size(); i += 2) {
+            It lo = bounds[i];
+            It mid = bounds[i + 1];
+            It hi = bounds[i + 2];
+            group.Run([lo, mid, hi, &comp]() { std::inplace_merge(lo, mid, hi, comp); });
+            merged.push_back(lo);
+        }
+        group.Wait();
+        for (; i < bounds.size(); ++i) merged.push_back(bounds[i]);
+        bounds = std::move(merged);
+    }
+}
+
+} // namespace mydb
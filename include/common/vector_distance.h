@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mydb {
+
+/**
+ * Distance kernels for VECTOR columns. Every kernel set computes the same three
+ * primitives (squared L2 distance, dot product, and dot product plus both squared
+ * norms for cosine) with a different instruction set; the widest one the CPU supports
+ * is picked at run time, so one binary runs everywhere:
+ *  - avx512: 16 floats per step (x86 with AVX-512F)
+ *  - avx2:   8 floats per step with fused multiply-add (x86 with AVX2 and FMA)
+ *  - sse:    4 floats per step (every x86-64 CPU)
+ *  - scalar: portable fallback
+ * Kernels accumulate in a different order, so results may differ in the last bits.
+ *
+ * The quantized kernels compare a float query with a vector stored as FP16 or INT8
+ * codes (see VectorEncoding) without decoding it first: they widen the codes in
+ * registers and return the dot product and the squared norm of the codes, from which
+ * EncodedVectorDistance derives every metric. The sse set uses the scalar versions
+ * (widening bytes and halves needs SSE4.1 / F16C).
+ *
+ * dot4 scores one float vector against four others in a single pass, so every load of
+ * `a` feeds four multiply-adds; VectorDistanceBlock builds on it to score batches of
+ * queries against batches of rows.
+ */
+struct DistanceKernels {
+    const char* name;
+    float (*l2_squared)(const float* a, const float* b, size_t n);
+    float (*dot)(const float* a, const float* b, size_t n);
+    void (*dot_norms)(const float* a, const float* b, size_t n, float* dot, float* a_norm, float* b_norm);
+    void (*dot_norm_f16)(const float* a, const uint16_t* b, size_t n, float* dot, float* b_norm);
+    void (*dot_norm_i8)(const float* a, const int8_t* b, size_t n, float* dot, float* b_norm);
+    void (*dot4)(const float* a, const float* const* b, size_t n, float* dots); // dots[j] = <a, b[j]>, j < 4
+};
+
+enum class DistanceMetric { L2, INNER_PRODUCT, COSINE };
+
+// "L2", "IP" or "COSINE"
+const char* DistanceMetricName(DistanceMetric metric);
+// Accepts the names above (any case), plus EUCLIDEAN, INNER_PRODUCT and DOT
+bool ParseDistanceMetric(std::string name, DistanceMetric& metric);
+
+// How a VECTOR column stores its values. FP32 keeps the floats as given; FP16 keeps
+// IEEE half floats (2 bytes each, about 3 significant digits); INT8 keeps one byte per
+// dimension plus one float scale per vector (value = code * scale, the scale mapping
+// the largest magnitude to 127).
+enum class VectorEncoding : uint8_t { FP32 = 0, FP16 = 1, INT8 = 2 };
+
+// "FP32", "FP16" or "INT8"
+const char* VectorEncodingName(VectorEncoding encoding);
+// Accepts the names above in any case
+bool ParseVectorEncoding(std::string name, VectorEncoding& encoding);
+
+// Bytes of the codes of an n-dimensional vector (the INT8 scale not included)
+size_t EncodedVectorSize(VectorEncoding encoding, size_t n);
+// Writes the codes of `vec` to `codes`; returns the INT8 scale (1 for the others)
+float EncodeVector(VectorEncoding encoding, const float* vec, size_t n, void* codes);
+// The floats codes stand for
+void DecodeVector(VectorEncoding encoding, const void* codes, float scale, size_t n, float* out);
+
+// The kernels picked for this CPU
+const DistanceKernels& ActiveDistanceKernels();
+// Every kernel set this CPU can run, widest first
+std::vector<const DistanceKernels*> SupportedDistanceKernels();
+
+// Orders vectors by closeness to a query: smaller is closer. L2 gives the squared
+// distance (same order, no square root), INNER_PRODUCT the negated dot product and
+// COSINE 1 - cosine similarity (1 when either vector is all zeros).
+float VectorDistance(DistanceMetric metric, const float* a, const float* b, size_t n,
+                     const DistanceKernels& kernels = ActiveDistanceKernels());
+
+// VectorDistance between a query and an encoded vector, computed on the codes.
+// query_norm is the squared norm of the n query floats (computed once per query).
+// L2 is expanded as |q|^2 + |v|^2 - 2<q,v>, clamped at 0.
+float EncodedVectorDistance(DistanceMetric metric, const float* query, float query_norm, VectorEncoding encoding,
+                            const void* codes, float scale, size_t n,
+                            const DistanceKernels& kernels = ActiveDistanceKernels());
+
+// Distances from each of query_count queries to each of row_count rows, all n floats
+// and packed one after another: out[q * row_count + r] is
+// VectorDistance(metric, query q, row r). query_norms holds the squared norm of every
+// query (computed once per batch). Rows are taken in tiles that stay in cache while
+// every query passes over them, four rows per kernel call; L2 is expanded as
+// |q|^2 + |r|^2 - 2<q,r> (clamped at 0), so results may differ from VectorDistance in
+// the last bits.
+void VectorDistanceBlock(DistanceMetric metric, const float* queries, const float* query_norms, size_t query_count,
+                         const float* rows, size_t row_count, size_t n, float* out,
+                         const DistanceKernels& kernels = ActiveDistanceKernels());
+
+} // namespace mydb
@@ -2,9 +2,14 @@
 
 #include "parser/parser.h"
 #include "storage/table_heap.h"
+#include "storage/columnar_table.h"
+#include "catalog/index_info.h"
+#include "common/task_scheduler.h"
+#include "common/vector_distance.h"
 #include <map>
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
@@ -15,6 +20,8 @@
 #include <memory>
 #include <array>
 #include <cmath>
+#include <functional>
+#include <climits>
 
 namespace mydb {
 
@@ -23,6 +30,11 @@ class Executor {
 public:
     Executor(DiskManager* dm) : disk_manager_(dm) {}
 
+    // Pool used for parallel scans and sorts (null = run everything inline)
+    void SetScheduler(TaskScheduler* scheduler) {
+        scheduler_ = scheduler;
+    }
+
     void SetFiles(std::string db_file, std::string cat_file) {
         db_file_ = std::move(db_file);
         cat_file_ = std::move(cat_file);
@@ -75,6 +87,12 @@ public:
             HandleDrop(stmt);
         } else if (stmt.type == StatementType::AUTOUPDATE) {
             HandleAutoupdate(stmt);
+        } else if (stmt.type == StatementType::SET) {
+            HandleSet(stmt);
+        } else if (stmt.type == StatementType::CREATE_INDEX) {
+            HandleCreateIndex(stmt);
+        } else if (stmt.type == StatementType::DROP_INDEX) {
+            HandleDropIndex(stmt);
         } else {
              if (stmt.type != StatementType::INVALID) {
                 std::cout << "\033[1;31mCommand parsed but not implemented in Executor.\033[0m" << std::endl;
@@ -84,6 +102,57 @@ public:
         }
     }
 
+    // True (once) if a statement since the last call created or dropped a table or an
+    // index, or moved an index to new pages (CLEAR); callers then save the catalog
+    bool TakeCatalogChanged() {
+        bool changed = catalog_changed_;
+        catalog_changed_ = false;
+        return changed;
+    }
+
+    // Batch nearest-neighbour search for API callers (the HTTP server's /vector/search):
+    // the k rows of `table_name` nearest to each of `queries` by VECTOR column `column`,
+    // as (distance, row) closest first, from one shared scan (see BatchNearest).
+    // column_names receives the names of the rows' columns. False, with the reason in
+    // `error`, for an unknown table or column or an invalid batch.
+    bool SearchNearestBatch(const std::string& table_name, const std::string& column,
+                            const std::vector<std::vector<float>>& queries, DistanceMetric metric, size_t k,
+                            std::vector<std::string>& column_names,
+                            std::vector<std::vector<std::pair<float, Tuple>>>& results, std::string& error) {
+        auto schema_it = schemas_.find(table_name);
+        if (schema_it == schemas_.end()) {
+            error = "Table '" + table_name + "' not found.";
+            return false;
+        }
+        const Schema& schema = schema_it->second;
+        int col = schema.GetColumnIndex(column);
+        if (col == -1 || schema.GetColumn(col).GetType() != TypeID::VECTOR) {
+            error = "Column '" + column + "' is not a VECTOR column of '" + table_name + "'.";
+            return false;
+        }
+        if (!CheckQueryBatch(queries, error)) return false;
+        column_names.clear();
+        for (const auto& schema_col : schema.GetColumns()) column_names.push_back(schema_col.GetName());
+        Statement stmt;
+        stmt.type = StatementType::SELECT;
+        stmt.table_name = table_name;
+        results = BatchNearest(table_name, stmt, {}, nullptr, static_cast<uint32_t>(col), queries, metric, k);
+        return true;
+    }
+
+    // Parses a list of vector literals like [[1.0, 2.5], [0, 1]]
+    static std::vector<std::vector<float>> ParseVectorListLiteral(const std::string& val_str) {
+        std::vector<std::vector<float>> vecs;
+        size_t open = val_str.find('[', val_str.find('[') + 1);
+        while (open != std::string::npos) {
+            size_t close = val_str.find(']', open);
+            if (close == std::string::npos) throw std::invalid_argument("unterminated vector");
+            vecs.push_back(ParseVectorLiteral(val_str.substr(open, close - open + 1)));
+            open = val_str.find('[', close);
+        }
+        return vecs;
+    }
+
 private:
     void HandleCreate(const Statement& stmt) {
         if (tables_.find(stmt.table_name) != tables_.end()) {
@@ -94,18 +163,47 @@ private:
         std::vector<Column> cols;
         uint32_t offset = 0;
         for (const auto& pair : stmt.columns) {
-            TypeID type = (pair.second == "INT") ? TypeID::INTEGER : TypeID::VARCHAR;
-            cols.emplace_back(pair.first, type, offset);
+            TypeID type = TypeID::VARCHAR;
+            VectorEncoding encoding = VectorEncoding::FP32;
+            if (pair.second == "INT") type = TypeID::INTEGER;
+            else if (pair.second == "VECTOR") type = TypeID::VECTOR;
+            else if (pair.second.rfind("VECTOR_", 0) == 0 && ParseVectorEncoding(pair.second.substr(7), encoding)) {
+                type = TypeID::VECTOR;
+            }
+            cols.emplace_back(pair.first, type, offset, encoding);
             // offset update is dummy for now
         }
         
+        // WITH (storage = row | columnar)
+        TableStorage storage = TableStorage::ROW;
+        for (const auto& option : stmt.table_options) {
+            std::string name = option.first;
+            for (auto& c : name) c = std::tolower(c);
+            if (name != "storage" || !ParseTableStorage(option.second, storage)) {
+                std::cout << "\033[1;31mError: Unknown table option '" << option.first << " = " << option.second
+                          << "' (use storage = row or storage = columnar).\033[0m" << std::endl;
+                return;
+            }
+        }
+        if (storage == TableStorage::COLUMNAR && cols.size() > ColumnarTable::MAX_COLUMNS) {
+            std::cout << "\033[1;31mError: A columnar table has at most " << ColumnarTable::MAX_COLUMNS
+                      << " columns.\033[0m" << std::endl;
+            return;
+        }
+
         Schema schema(cols);
-        auto heap = TableHeap::Create(disk_manager_, schema);
+        std::unique_ptr<TableHeap> heap;
+        if (storage == TableStorage::COLUMNAR) {
+            heap = ColumnarTable::Create(disk_manager_, schema);
+        } else {
+            heap = TableHeap::Create(disk_manager_, schema);
+        }
         
         // We leak heap pointer here in this simple version (should be unique_ptr in map)
         // Converting unique_ptr to raw for map storage is messy, let's keep it simple.
         tables_.emplace(stmt.table_name, std::move(heap));
         schemas_.emplace(stmt.table_name, schema);
+        catalog_changed_ = true;
         
         std::cout << "\033[1;32mTable " << stmt.table_name << " created.\033[0m" << std::endl;
     }
@@ -143,25 +241,16 @@ private:
                      }
                      values.emplace_back(val);
                  } else if (col.GetType() == TypeID::VECTOR) {
-                     // Parse vector literal like [1.0, 2.5]
-                     std::string val_str = stmt.values[i];
-                     if (!val_str.empty() && val_str.front() == '[') val_str = val_str.substr(1);
-                     if (!val_str.empty() && val_str.back() == ']') val_str.pop_back();
-                     
-                     std::vector<float> vec;
-                     std::stringstream vss(val_str);
-                     std::string token;
-                     while (std::getline(vss, token, ',')) {
-                          vec.push_back(std::stof(token));
-                     }
-                     values.emplace_back(vec);
+                     values.emplace_back(ParseVectorLiteral(stmt.values[i]), col.GetVectorEncoding());
                  } else {
                      values.emplace_back(stmt.values[i]);
                  }
             }
         
             Tuple tuple(values);
-            if (table->InsertTuple(tuple)) {
+            RID rid;
+            if (table->InsertTuple(tuple, &rid)) {
+                InsertIntoIndexes(stmt.table_name, tuple, rid);
                 std::cout << "\033[1;32mInserted 1 row.\033[0m" << std::endl;
             } else {
                  std::cout << "\033[1;31mFailed to insert.\033[0m" << std::endl;
@@ -177,54 +266,79 @@ private:
             return;
         }
         
-        TableHeap* table = tables_[stmt.table_name].get();
-        std::vector<Tuple> tuples = table->Scan();
         Schema& schema = schemas_.at(stmt.table_name);
-        
-        // Filter tuples if WHERE clause exists
-        std::vector<Tuple> filtered_tuples;
-        if (!stmt.where_column.empty()) {
-            int col_idx = -1;
-            for (uint32_t i = 0; i < schema.GetColumnCount(); ++i) {
-                if (schema.GetColumn(i).GetName() == stmt.where_column) {
-                    col_idx = i;
-                    break;
+
+        // Resolve the output columns ('*' means every column in schema order)
+        std::vector<uint32_t> out_cols;
+        if (stmt.select_columns.empty()) {
+            for (uint32_t i = 0; i < schema.GetColumnCount(); ++i) out_cols.push_back(i);
+        } else {
+            for (const auto& name : stmt.select_columns) {
+                int idx = schema.GetColumnIndex(name);
+                if (idx == -1) {
+                    std::cout << "\033[1;31mError: Column '" << name << "' not found.\033[0m" << std::endl;
+                    return;
                 }
+                out_cols.push_back(idx);
             }
-            
-            if (col_idx == -1) {
-                 std::cout << "\033[1;31mError: Column '" << stmt.where_column << "' not found.\033[0m" << std::endl;
-                 return;
+        }
+
+        // Push the projection into the scan: only output, WHERE and ORDER BY
+        // columns are decoded, everything else is skipped in the page buffer.
+        std::vector<bool> projection;
+        if (!stmt.select_columns.empty()) {
+            projection.assign(schema.GetColumnCount(), false);
+            for (uint32_t c : out_cols) projection[c] = true;
+            int where_idx = schema.GetColumnIndex(stmt.where_column);
+            if (where_idx != -1) projection[where_idx] = true;
+            int order_idx = schema.GetColumnIndex(stmt.order_by_column);
+            if (order_idx != -1) projection[order_idx] = true;
+        }
+        // Filter tuples if WHERE clause exists
+        std::function<bool(const Tuple&)> predicate;
+        if (!BuildPredicate(schema, stmt, predicate)) return;
+
+        // ORDER BY VECTOR_DIST: target vector and metric
+        int vector_col_idx = schema.GetColumnIndex(stmt.order_by_column);
+        bool vector_order = stmt.order_by_vector_dist && vector_col_idx != -1 &&
+                            schema.GetColumn(vector_col_idx).GetType() == TypeID::VECTOR;
+        std::vector<std::vector<float>> targets;
+        DistanceMetric metric = DistanceMetric::L2;
+        if (vector_order && !ParseVectorOrder(stmt, targets, metric)) return;
+
+        // A list of query vectors: the nearest k of each, from one scan
+        if (vector_order && IsVectorListLiteral(stmt.order_by_vector_literal)) {
+            if (stmt.limit < 0) {
+                std::cout << "\033[1;31mError: A batch of query vectors needs LIMIT k.\033[0m" << std::endl;
+                return;
             }
-            
-            for (const auto& tuple : tuples) {
-                const Value& val = tuple.GetValue(col_idx);
-                bool match = false;
-                if (val.GetTypeId() == TypeID::INTEGER) {
-                    if (std::to_string(val.GetAsInteger()) == stmt.where_value) match = true;
-                } else {
-                    if (val.GetAsString() == stmt.where_value) match = true;
-                }
-                
-                if (stmt.where_op == "!=") {
-                    match = !match;
-                }
-                
-                if (match) {
-                    filtered_tuples.push_back(tuple);
-                }
+            auto results = BatchNearest(stmt.table_name, stmt, projection, predicate, vector_col_idx, targets, metric,
+                                        static_cast<size_t>(stmt.limit));
+            for (size_t q = 0; q < results.size(); ++q) {
+                std::vector<Tuple> tuples;
+                tuples.reserve(results[q].size());
+                for (auto& entry : results[q]) tuples.push_back(std::move(entry.second));
+                std::cout << "Query " << q << ":" << std::endl;
+                PrintRows(schema, out_cols, tuples);
             }
-        } else {
-            filtered_tuples = tuples;
-        }
-        
-        if (filtered_tuples.empty()) {
-            std::cout << "(0 rows)" << std::endl;
             return;
         }
+        std::vector<float> target_vec;
+        if (vector_order) target_vec = std::move(targets.front());
 
-        // Apply ORDER BY if specified
-        if (!stmt.order_by_column.empty()) {
+        bool ordered = false;
+        std::vector<Tuple> filtered_tuples;
+        if (vector_order && stmt.limit >= 0) {
+            // Nearest-k: only k rows are ever kept, never the whole table
+            filtered_tuples = NearestMatches(stmt.table_name, stmt, projection, predicate, vector_col_idx, target_vec,
+                                             metric, static_cast<size_t>(stmt.limit));
+            ordered = true;
+        } else {
+            filtered_tuples = FindMatches(stmt.table_name, stmt, projection, predicate, nullptr, &ordered);
+        }
+
+        // Apply ORDER BY if specified (rows read through an index on it are already sorted)
+        if (!stmt.order_by_column.empty() && !ordered) {
             int order_col_idx = -1;
             TypeID order_col_type = TypeID::INVALID;
             for (uint32_t i = 0; i < schema.GetColumnCount(); ++i) {
@@ -235,72 +349,55 @@ private:
                 }
             }
             if (order_col_idx != -1) {
-                if (stmt.order_by_vector_dist && order_col_type == TypeID::VECTOR) {
-                    // Parse literal target vector
-                    std::string val_str = stmt.order_by_vector_literal;
-                    if (!val_str.empty() && val_str.front() == '[') val_str = val_str.substr(1);
-                    if (!val_str.empty() && val_str.back() == ']') val_str.pop_back();
-                    std::vector<float> target_vec;
-                    std::stringstream vss(val_str);
-                    std::string token;
-                    while (std::getline(vss, token, ',')) {
-                        target_vec.push_back(std::stof(token));
-                    }
-                    
-                    // Sort by Euclidean distance
-                    std::sort(filtered_tuples.begin(), filtered_tuples.end(), 
-                              [order_col_idx, &target_vec](const Tuple& a, const Tuple& b) {
-                                  const auto& vecA = a.GetValue(order_col_idx).GetAsVector();
-                                  const auto& vecB = b.GetValue(order_col_idx).GetAsVector();
-                                  
-                                  float distA = 0.0f, distB = 0.0f;
-                                  size_t lenA = std::min(vecA.size(), target_vec.size());
-                                  for (size_t i = 0; i < lenA; ++i) {
-                                      float d = vecA[i] - target_vec[i];
-                                      distA += d * d;
-                                  }
-                                  size_t lenB = std::min(vecB.size(), target_vec.size());
-                                  for (size_t i = 0; i < lenB; ++i) {
-                                      float d = vecB[i] - target_vec[i];
-                                      distB += d * d;
-                                  }
-                                  
-                                  return distA < distB;
-                              });
+                if (vector_order) {
+                    SortByVectorDistance(filtered_tuples, order_col_idx, target_vec, metric);
                 } else {
-                    std::sort(filtered_tuples.begin(), filtered_tuples.end(), 
-                              [order_col_idx, order_col_type](const Tuple& a, const Tuple& b) {
-                                  const Value& valA = a.GetValue(order_col_idx);
-                                  const Value& valB = b.GetValue(order_col_idx);
+                    ParallelSort(scheduler_, filtered_tuples.begin(), filtered_tuples.end(), 
+                              [order_col_idx, order_col_type, desc = stmt.order_by_desc](const Tuple& a, const Tuple& b) {
+                                  const Value& valA = (desc ? b : a).GetValue(order_col_idx);
+                                  const Value& valB = (desc ? a : b).GetValue(order_col_idx);
                                   if (order_col_type == TypeID::INTEGER) {
                                       return valA.GetAsInteger() < valB.GetAsInteger();
                                   } else {
                                       return valA.GetAsString() < valB.GetAsString();
                                   }
-                              });
+                              }, scan_parallelism_);
                 }
             } else {
                  std::cout << "\033[1;31mWarning: ORDER BY column '" << stmt.order_by_column << "' not found.\033[0m" << std::endl;
             }
         }
+        if (stmt.limit >= 0 && filtered_tuples.size() > static_cast<size_t>(stmt.limit)) {
+            filtered_tuples.resize(static_cast<size_t>(stmt.limit));
+        }
+        PrintRows(schema, out_cols, filtered_tuples);
+    }
+
+    // Prints columns `out_cols` of the tuples as a table, followed by the row count
+    void PrintRows(const Schema& schema, const std::vector<uint32_t>& out_cols,
+                   const std::vector<Tuple>& filtered_tuples) {
+        if (filtered_tuples.empty()) {
+            std::cout << "(0 rows)" << std::endl;
+            return;
+        }
 
         // Calculate column widths
         std::vector<int> col_widths;
-        for (const auto& col : schema.GetColumns()) {
-            col_widths.push_back(std::max((int)col.GetName().length(), 10)); // Min 10
+        for (uint32_t c : out_cols) {
+            col_widths.push_back(std::max((int)schema.GetColumn(c).GetName().length(), 10)); // Min 10
         }
         
         // Check data width (simple scan)
         for (const auto& tuple : filtered_tuples) {
-             for (uint32_t c = 0; c < schema.GetColumnCount(); ++c) {
+             for (size_t i = 0; i < out_cols.size(); ++i) {
                  int len = 0;
-                 const Value& val = tuple.GetValue(c);
+                 const Value& val = tuple.GetValue(out_cols[i]);
                  if (val.GetTypeId() == TypeID::INTEGER) {
                      len = std::to_string(val.GetAsInteger()).length();
                  } else {
                      len = val.GetAsString().length();
                  }
-                 if (len > col_widths[c]) col_widths[c] = len;
+                 if (len > col_widths[i]) col_widths[i] = len;
              }
         }
 
@@ -315,8 +412,8 @@ private:
         
         PrintLine(col_widths);
         std::cout << "|";
-        for (uint32_t i = 0; i < schema.GetColumnCount(); ++i) {
-            std::cout << "\033[1;33m " << std::left << std::setw(col_widths[i]) << schema.GetColumn(i).GetName() << " \033[0m|";
+        for (size_t i = 0; i < out_cols.size(); ++i) {
+            std::cout << "\033[1;33m " << std::left << std::setw(col_widths[i]) << schema.GetColumn(out_cols[i]).GetName() << " \033[0m|";
         }
         std::cout << std::endl;
         PrintLine(col_widths);
@@ -324,13 +421,13 @@ private:
         // Print Rows
         for (const auto& tuple : filtered_tuples) {
              std::cout << "|";
-             for (uint32_t c = 0; c < schema.GetColumnCount(); ++c) {
-                 const Value& val = tuple.GetValue(c);
+             for (size_t i = 0; i < out_cols.size(); ++i) {
+                 const Value& val = tuple.GetValue(out_cols[i]);
                  std::cout << " ";
                  if (val.GetTypeId() == TypeID::INTEGER) {
-                     std::cout << std::left << std::setw(col_widths[c]) << val.GetAsInteger();
+                     std::cout << std::left << std::setw(col_widths[i]) << val.GetAsInteger();
                  } else {
-                     std::cout << std::left << std::setw(col_widths[c]) << val.GetAsString();
+                     std::cout << std::left << std::setw(col_widths[i]) << val.GetAsString();
                  }
                  std::cout << " |";
              }
@@ -372,14 +469,21 @@ private:
         }
         outfile << "\n";
         
-        // Write Rows
+        // Write Rows (vectors with enough digits to read back the same floats)
         for (const auto& tuple : tuples) {
             for (uint32_t i = 0; i < schema.GetColumnCount(); ++i) {
                 const Value& val = tuple.GetValue(i);
                 if (val.GetTypeId() == TypeID::INTEGER) {
                     outfile << val.GetAsInteger();
+                } else if (val.GetTypeId() == TypeID::VECTOR) {
+                    std::stringstream vss;
+                    vss << std::setprecision(std::numeric_limits<float>::max_digits10) << "[";
+                    const std::vector<float>& vec = val.GetAsVector();
+                    for (size_t d = 0; d < vec.size(); ++d) vss << (d > 0 ? ", " : "") << vec[d];
+                    vss << "]";
+                    outfile << CsvField(vss.str());
                 } else {
-                    outfile << val.GetAsString();
+                    outfile << CsvField(val.GetAsString());
                 }
                 if (i < schema.GetColumnCount() - 1) outfile << ",";
             }
@@ -417,23 +521,36 @@ private:
         std::string line;
         // Skip header
         std::getline(infile, line);
+
+        // Indexes that are still empty are bulk loaded once the rows are in; only
+        // their key and INCLUDE columns are kept meanwhile
+        std::vector<IndexInfo*> bulk_indexes;
+        std::vector<IndexInfo*> row_indexes;
+        std::vector<bool> key_columns(schema.GetColumnCount(), false);
+        for (IndexInfo* index : GetTableIndexes(stmt.table_name)) {
+            if (!index->tree->IsEmpty()) {
+                row_indexes.push_back(index);
+                continue;
+            }
+            bulk_indexes.push_back(index);
+            for (uint32_t c : index->column_indexes) key_columns[c] = true;
+            for (uint32_t c : index->include_indexes) key_columns[c] = true;
+        }
+        std::vector<Tuple> key_tuples;
+        std::vector<RID> key_rids;
         
         int imported_count = 0;
         int line_num = 1;
         while (std::getline(infile, line)) {
             line_num++;
-            std::stringstream ss(line);
-            std::string item;
+            // Clean line (remove \r if on windows/linux mix)
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            std::vector<std::string> fields = SplitCsvLine(line);
             std::vector<Value> values;
+            bool valid = true;
             
-            for (uint32_t i = 0; i < schema.GetColumnCount(); ++i) {
-                if (!std::getline(ss, item, ',')) {
-                    break;
-                }
-                
-                // Clean item (remove \r if on windows/linux mix)
-                if (!item.empty() && item.back() == '\r') item.pop_back();
-
+            for (uint32_t i = 0; i < schema.GetColumnCount() && i < fields.size(); ++i) {
+                const std::string& item = fields[i];
                 const Column& col = schema.GetColumn(i);
                 if (col.GetType() == TypeID::INTEGER) {
                      try {
@@ -442,10 +559,19 @@ private:
                          std::cout << "Warning: Invalid int at line " << line_num << ", col " << i + 1 << ". Using 0." << std::endl;
                          values.emplace_back(0);
                      }
+                } else if (col.GetType() == TypeID::VECTOR) {
+                     try {
+                         values.emplace_back(ParseVectorLiteral(item), col.GetVectorEncoding());
+                     } catch (...) {
+                         std::cout << "Warning: Invalid vector at line " << line_num << ", col " << i + 1 << ". Skipping." << std::endl;
+                         valid = false;
+                         break;
+                     }
                 } else {
                     values.emplace_back(item);
                 }
             }
+            if (!valid) continue;
             
             if (values.size() != schema.GetColumnCount()) {
                 std::cout << "Warning: Line " << line_num << " has " << values.size() << " columns, expected " << schema.GetColumnCount() << ". Skipping." << std::endl;
@@ -453,10 +579,22 @@ private:
             }
             
             Tuple tuple(values);
-            if (table->InsertTuple(tuple)) {
+            RID rid;
+            if (table->InsertTuple(tuple, &rid)) {
+                for (IndexInfo* index : row_indexes) index->tree->InsertEntry(tuple, rid);
+                if (!bulk_indexes.empty()) {
+                    for (uint32_t c = 0; c < schema.GetColumnCount(); ++c) {
+                        if (!key_columns[c]) values[c] = Value();
+                    }
+                    key_tuples.emplace_back(std::move(values));
+                    key_rids.push_back(rid);
+                }
                 imported_count++;
             }
         }
+        for (IndexInfo* index : bulk_indexes) {
+            index->tree->BulkLoad(key_tuples, key_rids, index_fill_percent_, scheduler_, scan_parallelism_);
+        }
         
         infile.close();
         std::cout << "\033[1;32mImported " << imported_count << " rows from " << stmt.file_path << ".\033[0m" << std::endl;
@@ -469,7 +607,54 @@ private:
         }
         
         TableHeap* table = tables_[stmt.table_name].get();
-        int count = table->Update(stmt.where_column, stmt.where_op, stmt.where_value, stmt.update_column, stmt.update_value);
+        Schema& schema = schemas_.at(stmt.table_name);
+        int set_idx = schema.GetColumnIndex(stmt.update_column);
+        if (set_idx == -1) {
+            std::cout << "\033[1;31mError: Column '" << stmt.update_column << "' not found.\033[0m" << std::endl;
+            return;
+        }
+        std::function<bool(const Tuple&)> predicate;
+        if (!BuildPredicate(schema, stmt, predicate)) return;
+
+        Value new_value;
+        try {
+            TypeID set_type = schema.GetColumn(set_idx).GetType();
+            if (set_type == TypeID::INTEGER) {
+                new_value = Value(static_cast<int32_t>(std::stoi(stmt.update_value)));
+            } else if (set_type == TypeID::VECTOR) {
+                new_value = Value(ParseVectorLiteral(stmt.update_value), schema.GetColumn(set_idx).GetVectorEncoding());
+            } else {
+                new_value = Value(stmt.update_value);
+            }
+        } catch (const std::exception& e) {
+            std::cout << "\033[1;31mError processing value: " << e.what() << "\033[0m" << std::endl;
+            return;
+        }
+
+        // Collect every match before writing: rows that grow are moved to the end of
+        // the heap and must not be visited (and updated) a second time.
+        std::vector<RID> rids;
+        std::vector<Tuple> matches = FindMatches(stmt.table_name, stmt, {}, predicate, &rids);
+        std::vector<IndexInfo*> indexes = GetTableIndexes(stmt.table_name);
+
+        int count = 0;
+        for (size_t i = 0; i < matches.size(); ++i) {
+            std::vector<Value> vals;
+            for (uint32_t c = 0; c < schema.GetColumnCount(); ++c) {
+                vals.push_back(c == static_cast<uint32_t>(set_idx) ? new_value : matches[i].GetValue(c));
+            }
+            Tuple updated(vals);
+            RID rid = rids[i];
+            if (!table->UpdateTuple(updated, rid)) continue;
+
+            for (IndexInfo* index : indexes) {
+                if (index->Stores(static_cast<uint32_t>(set_idx)) || !(rid == rids[i])) {
+                    index->tree->DeleteEntry(matches[i], rids[i]);
+                    index->tree->InsertEntry(updated, rid);
+                }
+            }
+            count++;
+        }
         std::cout << "\033[1;32mUpdated " << count << " rows.\033[0m" << std::endl;
     }
 
@@ -480,7 +665,22 @@ private:
         }
         
         TableHeap* table = tables_[stmt.table_name].get();
-        int count = table->Delete(stmt.where_column, stmt.where_op, stmt.where_value);
+        Schema& schema = schemas_.at(stmt.table_name);
+        std::function<bool(const Tuple&)> predicate;
+        if (!BuildPredicate(schema, stmt, predicate)) return;
+
+        std::vector<RID> rids;
+        std::vector<Tuple> matches = FindMatches(stmt.table_name, stmt, {}, predicate, &rids);
+        std::vector<IndexInfo*> indexes = GetTableIndexes(stmt.table_name);
+
+        int count = 0;
+        for (size_t i = 0; i < matches.size(); ++i) {
+            if (!table->MarkDelete(rids[i])) continue;
+            for (IndexInfo* index : indexes) {
+                index->tree->DeleteEntry(matches[i], rids[i]);
+            }
+            count++;
+        }
         std::cout << "\033[1;32mDeleted " << count << " rows.\033[0m" << std::endl;
     }
     
@@ -491,7 +691,14 @@ private:
         }
         
         TableHeap* table = tables_[stmt.table_name].get();
-        int count = table->Delete("", "=", "");
+        size_t count = table->Truncate();
+        // Start the table's indexes over empty (the old tree pages are not reclaimed)
+        for (IndexInfo* index : GetTableIndexes(stmt.table_name)) {
+            index->tree = TableIndex::Create(index->name, disk_manager_, schemas_.at(stmt.table_name),
+                                             index->column_indexes, -1, index->tree->GetType(),
+                                             index->include_indexes, index->tree->GetOptions());
+            catalog_changed_ = true;
+        }
         std::cout << "\033[1;32mCleared " << count << " rows from table " << stmt.table_name << ".\033[0m" << std::endl;
     }
     
@@ -531,15 +738,730 @@ private:
     void PrintSchema(const std::string& table_name, const Schema& schema) {
         std::cout << "Table: \033[1;33m" << table_name << "\033[0m" << std::endl;
         std::cout << "Columns: " << schema.GetColumnCount() << std::endl;
+        auto table_it = tables_.find(table_name);
+        if (table_it != tables_.end() && table_it->second->GetStorage() != TableStorage::ROW) {
+            std::cout << "Storage: " << TableStorageName(table_it->second->GetStorage()) << std::endl;
+        }
         for (const auto& col : schema.GetColumns()) {
             std::string type_str = "VARCHAR";
             if (col.GetType() == TypeID::INTEGER) type_str = "INT";
             else if (col.GetType() == TypeID::VECTOR) type_str = "VECTOR";
+            if (col.GetVectorEncoding() != VectorEncoding::FP32) {
+                type_str += "(" + std::string(VectorEncodingName(col.GetVectorEncoding())) + ")";
+            }
             
             std::cout << " - " << std::left << std::setw(15) << col.GetName() 
                       << " type: " << std::setw(10) << type_str 
                       << " offset: " << col.GetOffset() << std::endl;
         }
+        for (IndexInfo* index : GetTableIndexes(table_name)) {
+            std::cout << "Index: " << index->name << " (" << index->ColumnList() << ")";
+            if (!index->include_names.empty()) std::cout << " INCLUDE (" << index->IncludeList() << ")";
+            IndexType type = index->tree->GetType();
+            if (type != IndexType::BPLUS_TREE) std::cout << " USING " << IndexTypeName(type);
+            IndexOptions options = index->tree->GetOptions();
+            for (size_t i = 0; i < options.size(); ++i) {
+                std::cout << (i == 0 ? " WITH (" : ", ") << options[i].first << " = " << options[i].second;
+            }
+            if (!options.empty()) std::cout << ")";
+            std::cout << std::endl;
+        }
+    }
+
+    // Reads the target vector (or, for a list literal, the batch of query vectors) and
+    // the metric of ORDER BY VECTOR_DIST (errors are printed)
+    static bool ParseVectorOrder(const Statement& stmt, std::vector<std::vector<float>>& targets,
+                                 DistanceMetric& metric) {
+        metric = DistanceMetric::L2;
+        if (!stmt.order_by_vector_metric.empty() && !ParseDistanceMetric(stmt.order_by_vector_metric, metric)) {
+            std::cout << "\033[1;31mError: Unknown distance metric '" << stmt.order_by_vector_metric
+                      << "' (use L2, IP or COSINE).\033[0m" << std::endl;
+            return false;
+        }
+        try {
+            if (IsVectorListLiteral(stmt.order_by_vector_literal)) {
+                targets = ParseVectorListLiteral(stmt.order_by_vector_literal);
+            } else {
+                targets = {ParseVectorLiteral(stmt.order_by_vector_literal)};
+            }
+        } catch (...) {
+            std::cout << "\033[1;31mError: Invalid vector '" << stmt.order_by_vector_literal << "'.\033[0m"
+                      << std::endl;
+            return false;
+        }
+        std::string error;
+        if (IsVectorListLiteral(stmt.order_by_vector_literal) && !CheckQueryBatch(targets, error)) {
+            std::cout << "\033[1;31mError: " << error << "\033[0m" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // True for a list of vector literals such as [[1, 2], [3, 4]]
+    static bool IsVectorListLiteral(const std::string& text) {
+        size_t open = text.find('[');
+        if (open == std::string::npos) return false;
+        size_t next = text.find_first_not_of(" \t\r\n", open + 1);
+        return next != std::string::npos && text[next] == '[';
+    }
+
+    // A batch of query vectors must be non-empty and of one length
+    static bool CheckQueryBatch(const std::vector<std::vector<float>>& queries, std::string& error) {
+        if (queries.empty() || queries.front().empty()) {
+            error = "Empty query vector.";
+            return false;
+        }
+        for (const auto& query : queries) {
+            if (query.size() != queries.front().size()) {
+                error = "Query vectors of different lengths (" + std::to_string(queries.front().size()) + " and " +
+                        std::to_string(query.size()) + ").";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ORDER BY VECTOR_DIST ... LIMIT k: the k rows closest to `target`, closest first.
+    // Each scan worker streams its rows through a bounded max-heap of its k nearest
+    // (O(n log k), at most k rows per worker held), and the heaps are merged at the
+    // end. Ties go to the row stored first, as in the full sort. A WHERE clause that
+    // an index answers feeds the index's rows through the same heap instead. A vector
+    // index on the column built for the same metric may supply approximate candidates
+    // instead (see NearestThroughIndex), which are then ranked by their exact distances.
+    std::vector<Tuple> NearestMatches(const std::string& table_name, const Statement& stmt,
+                                      const std::vector<bool>& projection,
+                                      const std::function<bool(const Tuple&)>& predicate, uint32_t col,
+                                      const std::vector<float>& target, DistanceMetric metric, size_t k) {
+        struct Candidate {
+            float distance;
+            RID rid;
+            Tuple tuple;
+        };
+        auto closer = [](const Candidate& a, const Candidate& b) {
+            if (a.distance != b.distance) return a.distance < b.distance;
+            if (a.rid.GetPageId() != b.rid.GetPageId()) return a.rid.GetPageId() < b.rid.GetPageId();
+            return a.rid.GetSlotNum() < b.rid.GetSlotNum();
+        };
+        if (k == 0) return {};
+
+        // The heap's front is the farthest of the k kept so far
+        std::vector<std::vector<Candidate>> heaps(std::max<size_t>(scan_parallelism_, 1));
+        const float target_norm = ActiveDistanceKernels().dot(target.data(), target.data(), target.size());
+        auto offer = [&](size_t worker, const RID& rid, Tuple&& tuple) {
+            Candidate candidate{tuple.GetValue(col).VectorDistanceTo(metric, target, target_norm), rid, Tuple()};
+            std::vector<Candidate>& heap = heaps[worker];
+            if (heap.size() == k) {
+                if (!closer(candidate, heap.front())) return;
+                std::pop_heap(heap.begin(), heap.end(), closer);
+                heap.pop_back();
+            }
+            candidate.tuple = std::move(tuple);
+            heap.push_back(std::move(candidate));
+            std::push_heap(heap.begin(), heap.end(), closer);
+        };
+
+        Value low, high;
+        std::vector<RID> rids;
+        std::vector<Tuple> fetched;
+        IndexInfo* ann = FindVectorIndex(table_name, col);
+        IndexInfo* where_index = WhereIndex(table_name, stmt, low, high);
+        if (ann != nullptr && NearestThroughIndex(table_name, ann, where_index, low, high, projection, predicate, target,
+                                                  metric, k, rids, fetched)) {
+            for (size_t i = 0; i < fetched.size(); ++i) offer(0, rids[i], std::move(fetched[i]));
+        } else if (where_index != nullptr) {
+            std::vector<Tuple> tuples = FindMatches(table_name, stmt, projection, predicate, &rids);
+            for (size_t i = 0; i < tuples.size(); ++i) offer(0, rids[i], std::move(tuples[i]));
+        } else {
+            tables_[table_name]->ParallelForEach(projection, predicate, scheduler_, scan_parallelism_, offer,
+                                                 PageFilter(table_name, stmt));
+        }
+
+        std::vector<Candidate> nearest;
+        for (auto& heap : heaps) {
+            nearest.insert(nearest.end(), std::make_move_iterator(heap.begin()), std::make_move_iterator(heap.end()));
+        }
+        std::sort(nearest.begin(), nearest.end(), closer);
+        if (nearest.size() > k) nearest.resize(k);
+        std::vector<Tuple> tuples;
+        tuples.reserve(nearest.size());
+        for (auto& candidate : nearest) tuples.push_back(std::move(candidate.tuple));
+        return tuples;
+    }
+
+    // Rows from vector index `ann` among which the k nearest to `target` that pass the
+    // WHERE clause very likely are, with their RIDs; false to rank the matching rows
+    // exactly instead (pre-filtering: the caller reads them through `where_index` or a
+    // scan). HNSW returns k candidates (SET EF_SEARCH trades speed for recall), IVFPQ,
+    // whose own ranking is approximate, k * RERANK (SET NPROBE sets how many lists it
+    // scans). With a WHERE clause the strategy follows its estimated selectivity s:
+    // post-filtering searches for about k / s candidates and drops the ones that fail
+    // the clause, widening the search until k pass. With a WHERE index, s is the index's
+    // match count over the vector count, and pre-filtering is chosen when it fetches
+    // fewer rows. Otherwise s is measured as the pass rate of the candidates, and the
+    // scan takes over once a search would return more than a quarter of the index.
+    bool NearestThroughIndex(const std::string& table_name, IndexInfo* ann, IndexInfo* where_index,
+                             const Value& low, const Value& high, const std::vector<bool>& projection,
+                             const std::function<bool(const Tuple&)>& predicate, const std::vector<float>& target,
+                             DistanceMetric metric, size_t k, std::vector<RID>& rids, std::vector<Tuple>& tuples) {
+        constexpr double OVERSAMPLE = 2.0; // Margin on k / s for the estimate's error
+        const bool hnsw = ann->tree->GetType() == IndexType::HNSW;
+        const size_t per_row = hnsw ? 1 : rerank_;
+        TableHeap* table = tables_[table_name].get();
+        // `wanted` rows, so the search goes wanted / k times wider than an unfiltered one
+        auto search = [&](size_t wanted) {
+            size_t candidates = wanted * per_row;
+            size_t breadth = hnsw ? std::max(ef_search_, candidates) : nprobe_ * ((wanted + k - 1) / k);
+            return ann->tree->SearchNearest(target, metric, candidates, breadth, rids);
+        };
+        if (!predicate) {
+            if (!search(k)) return false;
+            tuples = table->GetTuples(rids, projection);
+            return true;
+        }
+
+        const size_t total = ann->tree->GetVectorCount();
+        if (total == 0) return false;
+        const size_t max_candidates = total / 4;
+        size_t wanted = static_cast<size_t>(std::ceil(k * OVERSAMPLE));
+        if (where_index != nullptr) {
+            size_t matches = where_index->tree->ScanRange(low, high, false).size();
+            if (matches == 0) return false;
+            double selectivity = std::min(1.0, static_cast<double>(matches) / total);
+            wanted = static_cast<size_t>(std::ceil(k * OVERSAMPLE / selectivity));
+            if (matches <= wanted * per_row) return false;
+        }
+        while (true) {
+            if (!search(wanted)) return false;
+            size_t found = rids.size();
+            // An HNSW search that comes back short has seen every reachable node
+            bool exhausted = hnsw && found < wanted;
+            tuples = table->GetTuples(rids, projection);
+            KeepMatching(predicate, tuples, rids);
+            if (tuples.size() >= k || exhausted) return true;
+            double pass_rate = found == 0 ? 0.0 : static_cast<double>(tuples.size()) / found;
+            size_t next = pass_rate > 0 ? static_cast<size_t>(std::ceil(k * OVERSAMPLE / pass_rate)) : wanted * 4;
+            wanted = std::max(next, wanted * 2);
+            if (wanted * per_row > max_candidates) return false;
+        }
+    }
+
+    // ORDER BY VECTOR_DIST(<col>, [[..], [..], ...]) LIMIT k: the k rows nearest to each
+    // of a batch of equal-length query vectors, as (distance, row) closest first, from
+    // one pass over the table shared by the whole batch. Each scan worker gathers rows
+    // in blocks of BATCH_ROWS, decodes their vectors once and scores the block against
+    // every query at once with VectorDistanceBlock, then offers each row to one bounded
+    // heap per query (as in NearestMatches). Rows of another length are scored one by
+    // one over the shared prefix. A WHERE clause that an index answers feeds the index's
+    // rows instead of the scan. Vector indexes are not used: the answers are exact.
+    std::vector<std::vector<std::pair<float, Tuple>>> BatchNearest(
+        const std::string& table_name, const Statement& stmt, const std::vector<bool>& projection,
+        const std::function<bool(const Tuple&)>& predicate, uint32_t col,
+        const std::vector<std::vector<float>>& queries, DistanceMetric metric, size_t k) {
+        constexpr size_t BATCH_ROWS = 64;
+        struct Candidate {
+            float distance;
+            RID rid;
+            Tuple tuple;
+        };
+        auto closer = [](const Candidate& a, const Candidate& b) {
+            if (a.distance != b.distance) return a.distance < b.distance;
+            if (a.rid.GetPageId() != b.rid.GetPageId()) return a.rid.GetPageId() < b.rid.GetPageId();
+            return a.rid.GetSlotNum() < b.rid.GetSlotNum();
+        };
+        std::vector<std::vector<std::pair<float, Tuple>>> results(queries.size());
+        if (k == 0 || queries.empty()) return results;
+
+        const size_t dims = queries.front().size();
+        std::vector<float> packed;
+        std::vector<float> norms;
+        packed.reserve(queries.size() * dims);
+        for (const auto& query : queries) {
+            packed.insert(packed.end(), query.begin(), query.end());
+            norms.push_back(ActiveDistanceKernels().dot(query.data(), query.data(), query.size()));
+        }
+
+        // Per scan worker: one heap per query (front: the farthest kept) and the pending block
+        struct Worker {
+            std::vector<std::vector<Candidate>> heaps;
+            std::vector<RID> rids;
+            std::vector<Tuple> rows;
+            std::vector<size_t> blocked;  // Rows of the block scored by VectorDistanceBlock
+            std::vector<float> vectors;   // Their decoded vectors, packed
+            std::vector<float> distances; // query x blocked row
+        };
+        std::vector<Worker> workers(std::max<size_t>(scan_parallelism_, 1));
+        for (Worker& worker : workers) worker.heaps.resize(queries.size());
+
+        auto offer = [&](std::vector<Candidate>& heap, float distance, const RID& rid, const Tuple& tuple) {
+            Candidate candidate{distance, rid, Tuple()};
+            if (heap.size() == k) {
+                if (!closer(candidate, heap.front())) return;
+                std::pop_heap(heap.begin(), heap.end(), closer);
+                heap.pop_back();
+            }
+            candidate.tuple = tuple; // Copied: a row may be among the nearest of several queries
+            heap.push_back(std::move(candidate));
+            std::push_heap(heap.begin(), heap.end(), closer);
+        };
+        auto flush = [&](Worker& worker) {
+            worker.blocked.clear();
+            worker.vectors.clear();
+            for (size_t i = 0; i < worker.rows.size(); ++i) {
+                const Value& value = worker.rows[i].GetValue(col);
+                if (value.GetVectorDims() == dims) {
+                    const std::vector<float>& vec = value.GetAsVector();
+                    worker.vectors.insert(worker.vectors.end(), vec.begin(), vec.end());
+                    worker.blocked.push_back(i);
+                } else {
+                    for (size_t q = 0; q < queries.size(); ++q) {
+                        offer(worker.heaps[q], value.VectorDistanceTo(metric, queries[q], norms[q]), worker.rids[i],
+                              worker.rows[i]);
+                    }
+                }
+            }
+            const size_t blocked = worker.blocked.size();
+            worker.distances.resize(queries.size() * blocked);
+            VectorDistanceBlock(metric, packed.data(), norms.data(), queries.size(), worker.vectors.data(), blocked,
+                                dims, worker.distances.data());
+            for (size_t q = 0; q < queries.size(); ++q) {
+                for (size_t b = 0; b < blocked; ++b) {
+                    size_t i = worker.blocked[b];
+                    offer(worker.heaps[q], worker.distances[q * blocked + b], worker.rids[i], worker.rows[i]);
+                }
+            }
+            worker.rids.clear();
+            worker.rows.clear();
+        };
+        auto gather = [&](size_t index, const RID& rid, Tuple&& tuple) {
+            Worker& worker = workers[index];
+            worker.rids.push_back(rid);
+            worker.rows.push_back(std::move(tuple));
+            if (worker.rows.size() == BATCH_ROWS) flush(worker);
+        };
+
+        Value low, high;
+        if (WhereIndex(table_name, stmt, low, high) != nullptr) {
+            std::vector<RID> rids;
+            std::vector<Tuple> tuples = FindMatches(table_name, stmt, projection, predicate, &rids);
+            for (size_t i = 0; i < tuples.size(); ++i) gather(0, rids[i], std::move(tuples[i]));
+        } else {
+            tables_[table_name]->ParallelForEach(projection, predicate, scheduler_, scan_parallelism_, gather,
+                                                 PageFilter(table_name, stmt));
+        }
+        for (Worker& worker : workers) flush(worker);
+
+        for (size_t q = 0; q < queries.size(); ++q) {
+            std::vector<Candidate> nearest;
+            for (Worker& worker : workers) {
+                std::vector<Candidate>& heap = worker.heaps[q];
+                nearest.insert(nearest.end(), std::make_move_iterator(heap.begin()),
+                               std::make_move_iterator(heap.end()));
+            }
+            std::sort(nearest.begin(), nearest.end(), closer);
+            if (nearest.size() > k) nearest.resize(k);
+            results[q].reserve(nearest.size());
+            for (auto& candidate : nearest) results[q].emplace_back(candidate.distance, std::move(candidate.tuple));
+        }
+        return results;
+    }
+
+    // Sorts tuples by the distance of column `col` to `target`, closest first. Each
+    // row's distance is computed once up front (in parallel chunks) instead of twice
+    // per comparison; vectors of another length are compared over the shared prefix.
+    void SortByVectorDistance(std::vector<Tuple>& tuples, uint32_t col, const std::vector<float>& target,
+                              DistanceMetric metric) {
+        std::vector<std::pair<float, uint32_t>> order(tuples.size());
+        const float target_norm = ActiveDistanceKernels().dot(target.data(), target.data(), target.size());
+        auto compute = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                order[i] = {tuples[i].GetValue(col).VectorDistanceTo(metric, target, target_norm),
+                            static_cast<uint32_t>(i)};
+            }
+        };
+        constexpr size_t CHUNK = 4096;
+        if (scheduler_ == nullptr || scan_parallelism_ <= 1 || tuples.size() < 2 * CHUNK) {
+            compute(0, tuples.size());
+        } else {
+            TaskGroup group(scheduler_);
+            for (size_t begin = 0; begin < tuples.size(); begin += CHUNK) {
+                size_t end = std::min(begin + CHUNK, tuples.size());
+                group.Run([&compute, begin, end]() { compute(begin, end); });
+            }
+            group.Wait();
+        }
+        // Ties keep scan order
+        ParallelSort(scheduler_, order.begin(), order.end(), std::less<std::pair<float, uint32_t>>(),
+                     scan_parallelism_);
+        std::vector<Tuple> sorted;
+        sorted.reserve(tuples.size());
+        for (const auto& entry : order) sorted.push_back(std::move(tuples[entry.second]));
+        tuples = std::move(sorted);
+    }
+
+    // CSV field as EXPORT writes it: quoted (inner quotes doubled) if it holds a comma,
+    // a quote or a line break, as vector values always do
+    static std::string CsvField(const std::string& text) {
+        if (text.find_first_of(",\"\r\n") == std::string::npos) return text;
+        std::string quoted = "\"";
+        for (char c : text) {
+            if (c == '"') quoted += '"';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    // Splits one CSV line into fields, undoing CsvField's quoting
+    static std::vector<std::string> SplitCsvLine(const std::string& line) {
+        std::vector<std::string> fields(1);
+        bool quoted = false;
+        for (size_t i = 0; i < line.size(); ++i) {
+            char c = line[i];
+            if (quoted) {
+                if (c != '"') {
+                    fields.back() += c;
+                } else if (i + 1 < line.size() && line[i + 1] == '"') {
+                    fields.back() += '"';
+                    ++i;
+                } else {
+                    quoted = false;
+                }
+            } else if (c == '"') {
+                quoted = true;
+            } else if (c == ',') {
+                fields.emplace_back();
+            } else {
+                fields.back() += c;
+            }
+        }
+        return fields;
+    }
+
+    // Parses a vector literal like [1.0, 2.5]
+    static std::vector<float> ParseVectorLiteral(std::string val_str) {
+        if (!val_str.empty() && val_str.front() == '[') val_str = val_str.substr(1);
+        if (!val_str.empty() && val_str.back() == ']') val_str.pop_back();
+        std::vector<float> vec;
+        std::stringstream vss(val_str);
+        std::string token;
+        while (std::getline(vss, token, ',')) {
+            vec.push_back(std::stof(token));
+        }
+        return vec;
+    }
+
+    // Evaluates `val <op> operand` (`val BETWEEN operand AND high_operand`). INTEGER
+    // columns compare numerically (an operand that is not a number only satisfies "!="),
+    // everything else compares as text.
+    static bool MatchesWhere(const Value& val, const std::string& op, const std::string& operand,
+                             const std::string& high_operand = "") {
+        if (op == "BETWEEN") {
+            return MatchesWhere(val, ">=", operand) && MatchesWhere(val, "<=", high_operand);
+        }
+        int cmp = 0;
+        if (val.GetTypeId() == TypeID::INTEGER) {
+            int target = 0;
+            if (!ParseInt(operand, target)) return op == "!=";
+            cmp = (val.GetAsInteger() < target) ? -1 : (val.GetAsInteger() > target ? 1 : 0);
+        } else {
+            cmp = val.GetAsString().compare(operand);
+        }
+        if (op == "!=") return cmp != 0;
+        if (op == "<") return cmp < 0;
+        if (op == "<=") return cmp <= 0;
+        if (op == ">") return cmp > 0;
+        if (op == ">=") return cmp >= 0;
+        return cmp == 0;
+    }
+
+    static bool ParseInt(const std::string& text, int& out) {
+        try {
+            size_t pos = 0;
+            out = std::stoi(text, &pos);
+            return pos == text.length();
+        } catch (...) {
+            return false;
+        }
+    }
+
+    // Builds the WHERE filter (left empty without a WHERE clause).
+    // Returns false, after reporting it, if the column does not exist.
+    bool BuildPredicate(const Schema& schema, const Statement& stmt, std::function<bool(const Tuple&)>& predicate) {
+        if (stmt.where_column.empty()) return true;
+        int col_idx = schema.GetColumnIndex(stmt.where_column);
+        if (col_idx == -1) {
+            std::cout << "\033[1;31mError: Column '" << stmt.where_column << "' not found.\033[0m" << std::endl;
+            return false;
+        }
+        std::string op = stmt.where_op;
+        std::string operand = stmt.where_value;
+        std::string high_operand = stmt.where_value_high;
+        predicate = [col_idx, op, operand, high_operand](const Tuple& tuple) {
+            return MatchesWhere(tuple.GetValue(col_idx), op, operand, high_operand);
+        };
+        return true;
+    }
+
+    // An index whose leading key column is column_name. Hash indexes only find equal
+    // keys: for an `equality` lookup one is preferred, otherwise only B+ trees qualify.
+    IndexInfo* FindIndex(const std::string& table_name, const std::string& column_name, bool equality = false) {
+        IndexInfo* found = nullptr;
+        for (auto& pair : indexes_) {
+            IndexInfo& index = pair.second;
+            if (index.table_name != table_name || index.column_names[0] != column_name) continue;
+            if (index.tree->GetType() == IndexType::BLOOM) continue; // Finds no rows itself
+            if (IsVectorIndex(index.tree->GetType())) continue;       // Only nearest-neighbour searches
+            bool hash = index.tree->GetType() == IndexType::HASH;
+            if (hash && !equality) continue;
+            if (found == nullptr || hash) found = &index;
+        }
+        return found;
+    }
+
+    // A vector index over VECTOR column `column`, or null. HNSW, whose distances are
+    // exact, is preferred over IVFPQ.
+    IndexInfo* FindVectorIndex(const std::string& table_name, uint32_t column) {
+        IndexInfo* found = nullptr;
+        for (IndexInfo* index : GetTableIndexes(table_name)) {
+            IndexType type = index->tree->GetType();
+            if (!IsVectorIndex(type) || index->column_indexes[0] != column) continue;
+            if (found == nullptr || type == IndexType::HNSW) found = index;
+        }
+        return found;
+    }
+
+    std::vector<IndexInfo*> GetTableIndexes(const std::string& table_name) {
+        std::vector<IndexInfo*> result;
+        for (auto& pair : indexes_) {
+            if (pair.second.table_name == table_name) result.push_back(&pair.second);
+        }
+        return result;
+    }
+
+    void InsertIntoIndexes(const std::string& table_name, const Tuple& tuple, const RID& rid) {
+        for (IndexInfo* index : GetTableIndexes(table_name)) {
+            // CREATE INDEX on an empty table could not check the vector length
+            IndexType type = index->tree->GetType();
+            if (IsVectorIndex(type)) {
+                size_t dims = tuple.GetValue(index->column_indexes[0]).GetAsVector().size();
+                uint32_t max_dims = TableIndex::MaxVectorDims(type, index->tree->GetOptions());
+                if (max_dims != 0 && dims > max_dims) {
+                    std::cout << "\033[1;33mWarning: index " << index->name << " holds vectors of at most "
+                              << max_dims << " dimensions; this row's " << dims
+                              << " are not indexed.\033[0m" << std::endl;
+                }
+            }
+            index->tree->InsertEntry(tuple, rid);
+        }
+    }
+
+    // Bounds [low, high] on an index's leading column selected by the WHERE clause; an
+    // INVALID bound is open and low > high selects nothing. False for "!=" or an INT
+    // column compared with something that is not a number.
+    static bool IndexKeyRange(const Statement& stmt, TypeID type, Value& low, Value& high) {
+        low = high = Value();
+        if (stmt.where_op == "!=") return false;
+        if (type == TypeID::VARCHAR) {
+            // Strict bounds are kept inclusive; the predicate drops the boundary rows
+            Value key(stmt.where_value);
+            if (stmt.where_op == "=") low = high = key;
+            else if (stmt.where_op == "<" || stmt.where_op == "<=") high = key;
+            else if (stmt.where_op == ">" || stmt.where_op == ">=") low = key;
+            else if (stmt.where_op == "BETWEEN") low = key, high = Value(stmt.where_value_high);
+            else return false;
+            return true;
+        }
+
+        int key = 0;
+        if (!ParseInt(stmt.where_value, key)) return false;
+        if (stmt.where_op == "=") {
+            low = high = Value(key);
+        } else if (stmt.where_op == "<") {
+            if (key == INT_MIN) low = Value(1), high = Value(0);
+            else high = Value(key - 1);
+        } else if (stmt.where_op == "<=") {
+            high = Value(key);
+        } else if (stmt.where_op == ">") {
+            if (key == INT_MAX) low = Value(1), high = Value(0);
+            else low = Value(key + 1);
+        } else if (stmt.where_op == ">=") {
+            low = Value(key);
+        } else if (stmt.where_op == "BETWEEN") {
+            int key_high = 0;
+            if (!ParseInt(stmt.where_value_high, key_high)) return false;
+            low = Value(key);
+            high = Value(key_high);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // Drops the tuples (and their RIDs) that fail the predicate, keeping the order
+    static void KeepMatching(const std::function<bool(const Tuple&)>& predicate, std::vector<Tuple>& tuples,
+                             std::vector<RID>& rids) {
+        size_t kept = 0;
+        for (size_t i = 0; i < tuples.size(); ++i) {
+            if (!predicate(tuples[i])) continue;
+            if (kept != i) { // a self-move would empty the tuple
+                tuples[kept] = std::move(tuples[i]);
+                rids[kept] = rids[i];
+            }
+            kept++;
+        }
+        tuples.resize(kept);
+        rids.resize(kept);
+    }
+
+    // The rows of index entries in [low, high] (see TableIndex::ScanRange), in index order
+    // or in `heap_order`, with their RIDs in `matched`. If the index stores every column
+    // in `projection` (empty = all), this is an index-only scan: rows are rebuilt from the
+    // entries and the heap is only read for entries that cannot restore theirs.
+    std::vector<Tuple> ReadThroughIndex(TableHeap* table, IndexInfo* index, const Value& low, const Value& high,
+                                        bool descending, bool heap_order, const std::vector<bool>& projection,
+                                        std::vector<RID>& matched) {
+        auto rid_less = [](const RID& a, const RID& b) {
+            if (a.GetPageId() != b.GetPageId()) return a.GetPageId() < b.GetPageId();
+            return a.GetSlotNum() < b.GetSlotNum();
+        };
+        std::vector<bool> needed = projection;
+        if (needed.empty()) needed.assign(schemas_.at(index->table_name).GetColumnCount(), true);
+        if (!index->tree->Covers(needed)) {
+            matched = index->tree->ScanRange(low, high, descending);
+            if (heap_order) std::sort(matched.begin(), matched.end(), rid_less);
+            return table->GetTuples(matched, projection);
+        }
+
+        std::vector<Tuple> rows;
+        index->tree->ScanCovered(low, high, descending, needed, matched, rows);
+        if (heap_order) {
+            std::vector<size_t> order(matched.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return rid_less(matched[a], matched[b]); });
+            std::vector<RID> sorted_rids;
+            std::vector<Tuple> sorted_rows;
+            for (size_t i : order) {
+                sorted_rids.push_back(matched[i]);
+                sorted_rows.push_back(std::move(rows[i]));
+            }
+            matched = std::move(sorted_rids);
+            rows = std::move(sorted_rows);
+        }
+
+        std::vector<RID> missing;
+        for (size_t i = 0; i < rows.size(); ++i) {
+            if (rows[i].GetValueCount() == 0) missing.push_back(matched[i]);
+        }
+        if (missing.empty()) return rows;
+        // GetTuples keeps the order of the RIDs it finds
+        std::vector<Tuple> fetched = table->GetTuples(missing, projection);
+        size_t next = 0, kept = 0;
+        for (size_t i = 0; i < rows.size(); ++i) {
+            if (rows[i].GetValueCount() == 0) {
+                if (next == missing.size() || !(missing[next] == matched[i])) continue; // Not in the heap
+                rows[i] = std::move(fetched[next++]);
+            }
+            if (kept != i) {
+                rows[kept] = std::move(rows[i]);
+                matched[kept] = matched[i];
+            }
+            kept++;
+        }
+        rows.resize(kept);
+        matched.resize(kept);
+        return rows;
+    }
+
+    // The index that answers the WHERE clause, with its key range (null: none does)
+    IndexInfo* WhereIndex(const std::string& table_name, const Statement& stmt, Value& low, Value& high) {
+        if (stmt.where_column.empty()) return nullptr;
+        IndexInfo* index = FindIndex(table_name, stmt.where_column, stmt.where_op == "=");
+        if (index == nullptr) return nullptr;
+        const Schema& schema = schemas_.at(table_name);
+        if (!IndexKeyRange(stmt, schema.GetColumn(index->column_indexes[0]).GetType(), low, high)) return nullptr;
+        return index;
+    }
+
+    // Rows matching the WHERE clause. An equality, range or BETWEEN test on the leading
+    // column of an index is answered from the index (the predicate is re-checked on the
+    // fetched rows, since VARCHAR keys are prefixes), without touching the heap when the
+    // index covers the projection; anything else runs the filter inside a (parallel) scan. `rids`, when given, receives the RID of each returned tuple.
+    // With `ordered`, an index on the ORDER BY column may be walked instead so the rows
+    // come back already sorted; *ordered then tells the caller to skip its sort.
+    std::vector<Tuple> FindMatches(const std::string& table_name, const Statement& stmt,
+                                   const std::vector<bool>& projection,
+                                   const std::function<bool(const Tuple&)>& predicate,
+                                   std::vector<RID>* rids, bool* ordered = nullptr) {
+        TableHeap* table = tables_[table_name].get();
+        const Schema& schema = schemas_.at(table_name);
+        Value low, high;
+        IndexInfo* where_index = WhereIndex(table_name, stmt, low, high);
+        bool index_range = where_index != nullptr;
+
+        // VARCHAR keys only order rows by their prefix, so only INT keys can stand in for the sort
+        IndexInfo* order_index = nullptr;
+        if (ordered != nullptr && !stmt.order_by_column.empty() && !stmt.order_by_vector_dist) {
+            order_index = FindIndex(table_name, stmt.order_by_column);
+            if (order_index != nullptr &&
+                schema.GetColumn(order_index->column_indexes[0]).GetType() != TypeID::INTEGER) {
+                order_index = nullptr;
+            }
+        }
+        // A selective index on another WHERE column beats walking the ORDER BY index
+        if (order_index != nullptr && (!index_range || where_index == order_index)) {
+            // Same index: the walk applies the WHERE range
+            std::vector<RID> matched;
+            std::vector<Tuple> tuples = index_range
+                ? ReadThroughIndex(table, order_index, low, high, stmt.order_by_desc, false, projection, matched)
+                : ReadThroughIndex(table, order_index, Value(), Value(), stmt.order_by_desc, false, projection,
+                                   matched);
+            if (predicate) KeepMatching(predicate, tuples, matched);
+            if (rids != nullptr) *rids = std::move(matched);
+            *ordered = true;
+            return tuples;
+        }
+
+        if (index_range) {
+            // In heap order, the same order a scan would produce
+            std::vector<RID> matched;
+            std::vector<Tuple> tuples = ReadThroughIndex(table, where_index, low, high, false, true, projection,
+                                                         matched);
+            KeepMatching(predicate, tuples, matched);
+            if (rids != nullptr) *rids = std::move(matched);
+            return tuples;
+        }
+
+        // The filter runs inside the scan workers (inline when parallelism is 1)
+        return table->ParallelScan(projection, predicate, scheduler_, scan_parallelism_, rids,
+                                   PageFilter(table_name, stmt));
+    }
+
+    // The heap pages a scan for the WHERE clause needs to decode, going by the table's
+    // zone map and the page summaries of its BLOOM indexes on the WHERE column (null:
+    // every page)
+    std::function<bool(page_id_t)> PageFilter(const std::string& table_name, const Statement& stmt) {
+        if (stmt.where_column.empty()) return nullptr;
+        const Schema& schema = schemas_.at(table_name);
+        int column = schema.GetColumnIndex(stmt.where_column);
+        if (column < 0) return nullptr;
+        Value low, high;
+        if (!IndexKeyRange(stmt, schema.GetColumn(column).GetType(), low, high)) return nullptr;
+
+        const TableHeap* table = tables_.at(table_name).get();
+        bool zoned = ZoneMap::Tracks(schema.GetColumn(column).GetType()) && table->GetZoneMapPageId() != -1;
+        std::vector<const TableIndex*> summaries;
+        for (IndexInfo* index : GetTableIndexes(table_name)) {
+            if (index->tree->GetType() == IndexType::BLOOM && index->column_names[0] == stmt.where_column) {
+                summaries.push_back(index->tree.get());
+            }
+        }
+        if (!zoned && summaries.empty()) return nullptr;
+        return [table, zoned, column, summaries, low, high](page_id_t page_id) {
+            if (zoned && !table->PageMayMatch(page_id, column, low, high)) return false;
+            for (const TableIndex* summary : summaries) {
+                if (!summary->PageMayMatch(page_id, low, high)) return false;
+            }
+            return true;
+        };
     }
 
     void HandleShowTables(const Statement& stmt) {
@@ -553,9 +1475,8 @@ private:
             TableHeap* table = pair.second.get();
             const Schema& schema = schemas_.at(name);
             
-            // Get row count by scanning (inefficient but works for now)
-            std::vector<Tuple> tuples = table->Scan();
-            int rows = tuples.size();
+            // Row count comes from the page headers, no tuple decoding needed
+            size_t rows = table->CountTuples(scheduler_, scan_parallelism_);
             
             std::cout << " - \033[1;36m" << std::left << std::setw(15) << name << "\033[0m"
                       << " | Cols: " << std::setw(3) << schema.GetColumnCount() 
@@ -568,10 +1489,25 @@ private:
         std::cout << "-----------------------------------" << std::endl;
         std::cout << "\033[1;33mCore SQL:\033[0m" << std::endl;
         std::cout << "  CREATE TABLE <name> <cols>   - Create a new table" << std::endl;
+        std::cout << "  ... WITH (storage = columnar) - Store each column on its own pages" << std::endl;
         std::cout << "  INSERT INTO <name> VALUES <v>- Insert data" << std::endl;
         std::cout << "  SELECT * FROM <name> [WHERE] - Queries data" << std::endl;
+        std::cout << "  SELECT <c1>, <c2> FROM <name> - Query selected columns" << std::endl;
+        std::cout << "  ... WHERE <c> BETWEEN <a> AND <b> ORDER BY <c> [DESC]" << std::endl;
+        std::cout << "  ... ORDER BY VECTOR_DIST(<c>, [..] [, L2|IP|COSINE]) - Nearest vectors first" << std::endl;
+        std::cout << "  ... ORDER BY VECTOR_DIST(<c>, [[..], [..], ...]) LIMIT k - k nearest per query, one scan" << std::endl;
+        std::cout << "  ... LIMIT <n>                - Return the first n rows only" << std::endl;
         std::cout << "  UPDATE <name> SET <c>=<v>... - Update rows" << std::endl;
         std::cout << "  DELETE FROM <name> [WHERE]   - Delete rows" << std::endl;
+        std::cout << "  CREATE INDEX ON <t>(<c>[,<c>]) - Index INT/VARCHAR columns (WHERE =, <, >)" << std::endl;
+        std::cout << "  CREATE INDEX ON <t>(<c>) USING HASH - Hash index (WHERE = only)" << std::endl;
+        std::cout << "  CREATE INDEX ON <t>(<c>) USING BLOOM - Skip pages in WHERE = scans" << std::endl;
+        std::cout << "  CREATE INDEX ON <t>(<c>) USING HNSW [WITH (m = 16, ef_construction = 200)]" << std::endl;
+        std::cout << "                               - Approximate ORDER BY VECTOR_DIST ... LIMIT k" << std::endl;
+        std::cout << "  CREATE INDEX ON <t>(<c>) USING IVFPQ [WITH (lists = .., subvectors = ..)]" << std::endl;
+        std::cout << "                               - Same, from 16-32x smaller quantized vectors" << std::endl;
+        std::cout << "  CREATE INDEX ON <t>(<c>) INCLUDE (<c>,...) - Store more columns for index-only reads" << std::endl;
+        std::cout << "  DROP INDEX <index_name>      - Remove an index" << std::endl;
         std::cout << "\033[1;33mFeatures:\033[0m" << std::endl;
         std::cout << "  SHOW TABLES                  - List all tables" << std::endl;
         std::cout << "  DESCRIBE <table_name>        - Show table schema" << std::endl;
@@ -585,15 +1521,75 @@ private:
         std::cout << "  CONNECT <basename>           - Switch database" << std::endl;
         std::cout << "  VERSION                      - Show version info" << std::endl;
         std::cout << "  AUTOUPDATE                   - Pull latest engine updates" << std::endl;
+        std::cout << "  SET PARALLELISM <n>          - Scan tables with n worker threads" << std::endl;
+        std::cout << "  SET FILLFACTOR <pct>         - Page fill of bulk-built indexes (default 90)" << std::endl;
+        std::cout << "  SET EF_SEARCH <n>            - HNSW search candidates (default 64)" << std::endl;
+        std::cout << "  SET NPROBE <n>               - IVFPQ lists scanned per search (default 8)" << std::endl;
+        std::cout << "  SET RERANK <n>               - IVFPQ candidates re-ranked per row (default 4)" << std::endl;
         std::cout << "  EXIT / QUIT                  - Exit shell" << std::endl;
         std::cout << "-----------------------------------" << std::endl;
     }
 
+    void HandleSet(const Statement& stmt) {
+        if (stmt.update_column == "parallelism" || stmt.update_column == "threads") {
+            int threads = 0;
+            try {
+                threads = std::stoi(stmt.update_value);
+            } catch (...) {
+                threads = 0;
+            }
+            if (threads < 1) {
+                std::cout << "\033[1;31mError: parallelism must be a positive integer.\033[0m" << std::endl;
+                return;
+            }
+            scan_parallelism_ = static_cast<size_t>(threads);
+            std::cout << "\033[1;32mScan parallelism set to " << scan_parallelism_ << ".\033[0m" << std::endl;
+        } else if (stmt.update_column == "fillfactor") {
+            int percent = 0;
+            if (!ParseInt(stmt.update_value, percent) || percent < 10 || percent > 100) {
+                std::cout << "\033[1;31mError: fillfactor must be a percentage from 10 to 100.\033[0m" << std::endl;
+                return;
+            }
+            index_fill_percent_ = percent;
+            std::cout << "\033[1;32mIndex fill factor set to " << index_fill_percent_ << "%.\033[0m" << std::endl;
+        } else if (stmt.update_column == "ef_search") {
+            int ef = 0;
+            if (!ParseInt(stmt.update_value, ef) || ef < 1 || ef > 10000) {
+                std::cout << "\033[1;31mError: ef_search must be an integer from 1 to 10000.\033[0m" << std::endl;
+                return;
+            }
+            ef_search_ = static_cast<size_t>(ef);
+            std::cout << "\033[1;32mHNSW ef_search set to " << ef_search_ << ".\033[0m" << std::endl;
+        } else if (stmt.update_column == "nprobe") {
+            int lists = 0;
+            if (!ParseInt(stmt.update_value, lists) || lists < 1 || lists > 4096) {
+                std::cout << "\033[1;31mError: nprobe must be an integer from 1 to 4096.\033[0m" << std::endl;
+                return;
+            }
+            nprobe_ = static_cast<size_t>(lists);
+            std::cout << "\033[1;32mIVFPQ nprobe set to " << nprobe_ << ".\033[0m" << std::endl;
+        } else if (stmt.update_column == "rerank") {
+            int factor = 0;
+            if (!ParseInt(stmt.update_value, factor) || factor < 1 || factor > 100) {
+                std::cout << "\033[1;31mError: rerank must be an integer from 1 to 100.\033[0m" << std::endl;
+                return;
+            }
+            rerank_ = static_cast<size_t>(factor);
+            std::cout << "\033[1;32mIVFPQ rerank set to " << rerank_ << ".\033[0m" << std::endl;
+        } else {
+            std::cout << "\033[1;31mError: Unknown setting '" << stmt.update_column << "'.\033[0m" << std::endl;
+        }
+    }
+
     void HandleSystem(const Statement& stmt) {
         std::cout << "\033[1;37mSystem Information:\033[0m" << std::endl;
         std::cout << " Database File: " << db_file_ << std::endl;
         std::cout << " Catalog  File: " << cat_file_ << std::endl;
         std::cout << " State:         Active" << std::endl;
+        std::cout << " Scan Threads:  " << scan_parallelism_ << std::endl;
+        std::cout << " Fill Factor:   " << index_fill_percent_ << "%" << std::endl;
+        std::cout << " EF Search:     " << ef_search_ << std::endl;
+        std::cout << " NProbe:        " << nprobe_ << " (rerank " << rerank_ << "x)" << std::endl;
     }
 
     void HandleDbInfo(const Statement& stmt) {
@@ -602,6 +1598,14 @@ private:
         uint32_t total_cols = 0;
         for (const auto& p : schemas_) total_cols += p.second.GetColumnCount();
         std::cout << " Total Columns: " << total_cols << std::endl;
+        if (scheduler_ != nullptr) {
+            TaskScheduler::Metrics metrics = scheduler_->GetMetrics();
+            size_t queued = 0;
+            for (size_t depth : metrics.queue_depths) queued += depth;
+            std::cout << " Workers:       " << scheduler_->GetWorkerCount() << std::endl;
+            std::cout << " Tasks:         " << metrics.executed << " run, " << queued << " queued, "
+                      << metrics.steals << " stolen" << std::endl;
+        }
         
         // Very basic disk stat
         std::ifstream ifs(db_file_, std::ios::binary | std::ios::ate);
@@ -649,6 +1653,7 @@ private:
         std::cout << "\033[1;33mReloading catalog...\033[0m" << std::endl;
         tables_.clear();
         schemas_.clear();
+        indexes_.clear();
         // The shell/main should call catalog_manager.LoadCatalog()
         // For now, let's just say it's cleared and needs manual reload? 
         // No, let's make it work if possible.
@@ -672,9 +1677,150 @@ private:
         }
         tables_.erase(stmt.table_name);
         schemas_.erase(stmt.table_name);
+        for (auto it = indexes_.begin(); it != indexes_.end();) {
+            if (it->second.table_name == stmt.table_name) it = indexes_.erase(it);
+            else ++it;
+        }
+        catalog_changed_ = true;
         std::cout << "\033[1;32mTable " << stmt.table_name << " dropped.\033[0m" << std::endl;
     }
 
+    void HandleCreateIndex(const Statement& stmt) {
+        if (tables_.find(stmt.table_name) == tables_.end()) {
+            std::cout << "\033[1;31mError: Table '" << stmt.table_name << "' not found.\033[0m" << std::endl;
+            return;
+        }
+        if (indexes_.find(stmt.index_name) != indexes_.end()) {
+            std::cout << "\033[1;31mError: Index '" << stmt.index_name << "' already exists.\033[0m" << std::endl;
+            return;
+        }
+        const Schema& schema = schemas_.at(stmt.table_name);
+        if (stmt.index_columns.empty() || stmt.index_columns.size() > 2) {
+            std::cout << "\033[1;31mError: An index key has one or two columns.\033[0m" << std::endl;
+            return;
+        }
+        IndexType type = IndexType::BPLUS_TREE;
+        if (!stmt.index_method.empty() && !ParseIndexType(stmt.index_method, type)) {
+            std::cout << "\033[1;31mError: Unknown index method '" << stmt.index_method
+                      << "' (use BTREE, HASH, BLOOM, HNSW or IVFPQ).\033[0m" << std::endl;
+            return;
+        }
+        std::string options_error;
+        if (!TableIndex::ValidateOptions(type, stmt.index_options, options_error)) {
+            std::cout << "\033[1;31mError: " << options_error << ".\033[0m" << std::endl;
+            return;
+        }
+        if (type != IndexType::BPLUS_TREE && stmt.index_columns.size() != 1) {
+            std::cout << "\033[1;31mError: A " << IndexTypeName(type) << " index has one key column.\033[0m"
+                      << std::endl;
+            return;
+        }
+        if (type != IndexType::BPLUS_TREE && !stmt.index_include.empty()) {
+            std::cout << "\033[1;31mError: Only B+ tree indexes take INCLUDE columns.\033[0m" << std::endl;
+            return;
+        }
+        std::vector<uint32_t> col_idxs;
+        for (const auto& column : stmt.index_columns) {
+            int col_idx = schema.GetColumnIndex(column);
+            if (col_idx == -1) {
+                std::cout << "\033[1;31mError: Column '" << column << "' not found.\033[0m" << std::endl;
+                return;
+            }
+            TypeID column_type = schema.GetColumn(col_idx).GetType();
+            if (IsVectorIndex(type) && column_type != TypeID::VECTOR) {
+                std::cout << "\033[1;31mError: " << IndexTypeName(type) << " indexes take a VECTOR column.\033[0m"
+                          << std::endl;
+                return;
+            }
+            if (!IsVectorIndex(type) && column_type != TypeID::INTEGER && column_type != TypeID::VARCHAR) {
+                std::cout << "\033[1;31mError: Only INT and VARCHAR columns can be indexed.\033[0m" << std::endl;
+                return;
+            }
+            col_idxs.push_back(static_cast<uint32_t>(col_idx));
+        }
+        std::vector<uint32_t> include_idxs;
+        for (const auto& column : stmt.index_include) {
+            int col_idx = schema.GetColumnIndex(column);
+            if (col_idx == -1) {
+                std::cout << "\033[1;31mError: Column '" << column << "' not found.\033[0m" << std::endl;
+                return;
+            }
+            TypeID type = schema.GetColumn(col_idx).GetType();
+            if (type != TypeID::INTEGER && type != TypeID::VARCHAR) {
+                std::cout << "\033[1;31mError: Only INT and VARCHAR columns can be included.\033[0m" << std::endl;
+                return;
+            }
+            include_idxs.push_back(static_cast<uint32_t>(col_idx));
+        }
+        for (IndexInfo* existing : GetTableIndexes(stmt.table_name)) {
+            if (existing->column_names == stmt.index_columns && existing->include_names == stmt.index_include &&
+                existing->tree->GetType() == type) {
+                std::cout << "\033[1;31mError: Columns are already indexed by '" << existing->name << "'.\033[0m" << std::endl;
+                return;
+            }
+        }
+
+        // Read the existing rows, decoding only the stored columns
+        std::vector<bool> projection(schema.GetColumnCount(), false);
+        for (uint32_t col_idx : col_idxs) projection[col_idx] = true;
+        for (uint32_t col_idx : include_idxs) projection[col_idx] = true;
+        std::vector<RID> rids;
+        std::vector<Tuple> tuples = tables_[stmt.table_name]->ParallelScan(projection, nullptr, scheduler_,
+                                                                            scan_parallelism_, &rids);
+
+        // A vector index takes the length of the first vector; refuse one it cannot hold
+        uint32_t max_dims = TableIndex::MaxVectorDims(type, stmt.index_options);
+        if (max_dims != 0) {
+            for (const Tuple& tuple : tuples) {
+                size_t dims = tuple.GetValue(col_idxs[0]).GetAsVector().size();
+                if (dims == 0) continue;
+                if (dims > max_dims) {
+                    std::cout << "\033[1;31mError: " << IndexTypeName(type) << " indexes hold vectors of at most "
+                              << max_dims << " dimensions here; '" << stmt.index_columns[0]
+                              << "' has " << dims << ".\033[0m" << std::endl;
+                    return;
+                }
+                break;
+            }
+        }
+
+        IndexInfo index;
+        index.name = stmt.index_name;
+        index.table_name = stmt.table_name;
+        index.column_names = stmt.index_columns;
+        index.column_indexes = col_idxs;
+        index.include_names = stmt.index_include;
+        index.include_indexes = include_idxs;
+        index.tree = TableIndex::Create(stmt.index_name, disk_manager_, schema, col_idxs, -1, type, include_idxs,
+                                        stmt.index_options);
+        // Fill it in one bulk load
+        index.tree->BulkLoad(tuples, rids, index_fill_percent_, scheduler_, scan_parallelism_);
+        // Vector indexes leave out rows whose vector length differs from the first
+        size_t entries = IsVectorIndex(type) ? index.tree->GetVectorCount() : tuples.size();
+
+        std::string columns = index.ColumnList();
+        std::string includes = stmt.index_include.empty() ? "" : " including (" + index.IncludeList() + ")";
+        indexes_.emplace(stmt.index_name, std::move(index));
+        catalog_changed_ = true;
+        std::cout << "\033[1;32mIndex " << stmt.index_name << " created on " << stmt.table_name << "("
+                  << columns << ")" << includes
+                  << (type != IndexType::BPLUS_TREE ? std::string(" using ") + IndexTypeName(type) : "") << ", "
+                  << entries << " entries.\033[0m" << std::endl;
+        if (entries < tuples.size()) {
+            std::cout << "\033[1;33mWarning: " << tuples.size() - entries
+                      << " rows left out (their vector is empty or of another length).\033[0m" << std::endl;
+        }
+    }
+
+    void HandleDropIndex(const Statement& stmt) {
+        if (indexes_.erase(stmt.index_name) == 0) {
+            std::cout << "\033[1;31mError: Index '" << stmt.index_name << "' not found.\033[0m" << std::endl;
+            return;
+        }
+        catalog_changed_ = true;
+        std::cout << "\033[1;32mIndex " << stmt.index_name << " dropped.\033[0m" << std::endl;
+    }
+
     // Helper to run OS command and get standard output
     std::string ExecCommand(const char* cmd) {
         std::array<char, 128> buffer;
@@ -752,10 +1898,18 @@ private:
     }
 
     DiskManager* disk_manager_;
+    TaskScheduler* scheduler_ = nullptr;
     std::map<std::string, std::unique_ptr<TableHeap>> tables_;
     std::map<std::string, Schema> schemas_;
+    std::map<std::string, IndexInfo> indexes_; // by index name
+    size_t scan_parallelism_ = 1; // Degree of parallelism for table scans (SET PARALLELISM)
+    int index_fill_percent_ = 90; // Leaf/internal occupancy of bulk-loaded indexes (SET FILLFACTOR)
+    size_t ef_search_ = 64;       // Candidate list size of HNSW searches (SET EF_SEARCH)
+    size_t nprobe_ = 8;           // Lists scanned by IVFPQ searches (SET NPROBE)
+    size_t rerank_ = 4;           // IVFPQ candidates fetched per requested row (SET RERANK)
     std::string db_file_ = "v2v-1.db";
     std::string cat_file_ = "v2v-1.cat";
+    bool catalog_changed_ = false; // Set by statements that change what the catalog records
 };
 
 } // namespace mydb
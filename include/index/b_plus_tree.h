@@ -2,39 +2,140 @@
 
 #include "storage/page/b_plus_tree_leaf_page.h"
 #include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_header_page.h"
 #include "storage/disk_manager.h"
+#include "index/index_iterator.h"
+#include "index/index_key.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <shared_mutex>
 #include <string>
+#include <vector>
 
 namespace mydb {
 
+#define BPLUSTREE_TYPE BPlusTree<KeyType, KeyComparator>
+
+/**
+ * Disk-resident B+ tree mapping KeyType -> RID. Every page is a fixed-size KeyType
+ * array, so the fan-out of each instantiation is fixed at compile time; the
+ * instantiations built into the engine are listed in index/index_key.h.
+ *
+ * Pages of keys with a string column are stored prefix compressed and hold up to
+ * twice as many entries; nodes are read into NODE_SIZE buffers (ReadNode) and split
+ * when they no longer encode into a page (IsOverfull). Leaf splits push up the
+ * shortest key that separates the two halves (KeyTraits::Separator).
+ *
+ * Concurrency: readers and writers may share a tree. A tree latch orders them with
+ * page latches below it (a thread never holds more than one page latch):
+ *  - lookups, scans and writes that stay inside one leaf hold the tree latch shared,
+ *    so internal pages cannot change under them; they read pages under a shared page
+ *    latch, and a writer re-reads its leaf under an exclusive one before updating it.
+ *  - an insert that would split a leaf, or a removal that would underflow one, drops
+ *    everything and redoes the operation with the tree latch held exclusively, so
+ *    splits, merges and root changes see no concurrent readers.
+ * Most writes never leave the shared path, so lookups proceed alongside them.
+ */
+INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
+    using LeafPage = BPlusTreeLeafPage<KeyType, KeyComparator>;
+    using InternalPage = BPlusTreeInternalPage<KeyType, KeyComparator>;
+    friend class IndexIterator<KeyType, KeyComparator>;
+
 public:
-    explicit BPlusTree(std::string name, DiskManager* buffer_pool_manager);
+    using Iterator = IndexIterator<KeyType, KeyComparator>;
+    using MappingType = std::pair<KeyType, RID>;
+
+    // header_page_id == -1 creates a new (empty) index, otherwise reopens an existing one
+    // (whose uniqueness is read back from its header page)
+    explicit BPlusTree(std::string name, DiskManager* buffer_pool_manager, page_id_t header_page_id = -1,
+                       bool unique = true, const KeyComparator &comparator = KeyComparator());
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
 
     // Returns true if the key exists
-    bool GetValue(const int &key, RID &result);
+    bool GetValue(const KeyType &key, RID &result);
+
+    // Appends the RIDs of all entries with low <= key <= high, in key order
+    void GetRange(const KeyType &low, const KeyType &high, std::vector<RID> &result);
+
+    // Insert a key-value pair (false if the tree is unique and the key exists)
+    bool Insert(const KeyType &key, const RID &value);
 
-    // Insert a key-value pair
-    bool Insert(const int &key, const RID &value);
+    // Remove key; underfull nodes borrow from or merge with a sibling
+    void Remove(const KeyType &key);
+    // Remove one (key, value) entry, for non-unique trees. Returns false if absent
+    bool Remove(const KeyType &key, const RID &value);
 
-    // Remove key (optional for Phase 3)
-    void Remove(const int &key);
+    bool IsUnique() const { return unique_; }
+
+    // Builds an empty tree bottom-up from entries sorted by key: leaves are packed to
+    // fill_percent of their capacity and written left to right, then each internal
+    // level is built over the one below, so every page is written exactly once.
+    // Returns false (and leaves the tree alone) if the tree is not empty, or if it is
+    // unique and the input repeats a key.
+    bool BulkLoad(const std::vector<MappingType> &entries, int fill_percent = 100);
+
+    // Leaf-chain iteration in key order. Begin(key) is the first entry >= key.
+    Iterator Begin();
+    Iterator Begin(const KeyType &key);
+    Iterator End();
+
+    bool IsEmpty() const { return root_page_id_ == -1; }
+    page_id_t GetRootPageId() const { return root_page_id_; }
+    // Page to record in the catalog; stays fixed for the lifetime of the index
+    page_id_t GetHeaderPageId() const { return header_page_id_; }
     
     // Debug
     void Print(page_id_t page_id = -1);
 
 private:
-    void StartNewTree(const int &key, const RID &value);
-    bool InsertIntoLeaf(const int &key, const RID &value);
-    void InsertIntoParent(BPlusTreePage *old_node, const int &key, BPlusTreePage *new_node);
+    void StartNewTree(const KeyType &key, const RID &value);
+    bool InsertIntoLeaf(const KeyType &key, const RID &value);
+    void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node);
+    void SplitInternal(char *node_buf);
+    page_id_t FindLeafPage(const KeyType &key, char *buf, bool leftmost = false);
+    // Node I/O: pages of compressed key types are decoded on read and encoded on write
+    void ReadNode(page_id_t page_id, char *buf);
+    void WriteNode(page_id_t page_id, const char *buf);
+    // Reads a node under its page latch in shared mode
+    void ReadPageShared(page_id_t page_id, char *buf);
+    // Takes the tree latch exclusively. The structure version tells iterators that
+    // leaves may have been split or merged since they last looked.
+    std::unique_lock<std::shared_mutex> LockExclusive() {
+        std::unique_lock<std::shared_mutex> lock(tree_latch_);
+        ++structure_version_;
+        return lock;
+    }
+    std::shared_mutex &PageLatch(page_id_t page_id) {
+        return page_latches_[static_cast<size_t>(page_id) % PAGE_LATCH_STRIPES];
+    }
+    void RebalanceAfterRemove(char *leaf_buf);
+    void CoalesceOrRedistribute(char *node_buf);
+    void AdjustRoot(char *root_buf);
+    void UpdateRootPageId(page_id_t root_page_id);
     
     template <typename N>
     N *FetchPage(page_id_t page_id);
 
     std::string index_name_;
-    page_id_t root_page_id_;
+    page_id_t header_page_id_;
+    std::atomic<page_id_t> root_page_id_;
+    bool unique_;
+    KeyComparator comparator_;
     DiskManager* disk_manager_; // We really need a BufferPoolManager here, but sticking to DiskManager for now means manual memory management mess.
     // HACK: We will just read/write pages directly. 
+
+    // Page latches are striped by page id: with one latch held at a time, two pages
+    // sharing a stripe only cost some contention.
+    static constexpr size_t PAGE_LATCH_STRIPES = 128;
+    static constexpr bool COMPRESSED = KeyTraits<KeyType>::COMPRESSED;
+    // Size of a node buffer, which holds a decoded leaf or internal page
+    static constexpr int NODE_SIZE = std::max(LeafPage::NODE_SIZE, InternalPage::NODE_SIZE);
+    std::shared_mutex tree_latch_;
+    uint64_t structure_version_ = 0; // Changed under the exclusive tree latch only
+    std::array<std::shared_mutex, PAGE_LATCH_STRIPES> page_latches_;
 };
 
 } // namespace mydb
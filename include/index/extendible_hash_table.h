@@ -0,0 +1,77 @@
+#pragma once
+
+#include "storage/page/hash_table_header_page.h"
+#include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_bucket_page.h"
+#include "storage/disk_manager.h"
+#include "index/index_key.h"
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace mydb {
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, KeyComparator>
+
+/**
+ * Disk-resident extendible hash index mapping KeyType -> RID, for equality lookups
+ * only. Pages form three levels: the header page (recorded in the catalog) sends the
+ * top bits of a key's hash to a directory page, whose low GlobalDepth bits pick a
+ * bucket page. The header stays in memory, so a lookup reads one directory page and
+ * one bucket page whatever the size of the index.
+ *
+ * A full bucket splits in two on the next hash bit, doubling its directory when it
+ * has to (up to HashTableDirectoryPage::MAX_DEPTH); a bucket that cannot split grows an
+ * overflow chain instead. A bucket emptied by removals merges into its split image,
+ * and the directory halves once no bucket needs its top bit. Keys may repeat, one
+ * entry per (key, RID), like the secondary-index B+ trees.
+ *
+ * Concurrency: one latch, shared by lookups and held exclusively by writers.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class ExtendibleHashTable {
+    using BucketPage = HashTableBucketPage<KeyType, KeyComparator>;
+
+public:
+    using MappingType = std::pair<KeyType, RID>;
+
+    // header_page_id == -1 creates a new (empty) index, otherwise reopens an existing one
+    explicit ExtendibleHashTable(std::string name, DiskManager *disk_manager, page_id_t header_page_id = -1,
+                                 const KeyComparator &comparator = KeyComparator());
+    ExtendibleHashTable(const ExtendibleHashTable&) = delete;
+    ExtendibleHashTable& operator=(const ExtendibleHashTable&) = delete;
+
+    // Appends the RIDs of every entry with this key; false if there is none
+    bool GetValue(const KeyType &key, std::vector<RID> &result);
+    void Insert(const KeyType &key, const RID &value);
+    // Remove one (key, value) entry. Returns false if absent
+    bool Remove(const KeyType &key, const RID &value);
+
+    bool IsEmpty() const;
+    // Page to record in the catalog; stays fixed for the lifetime of the index
+    page_id_t GetHeaderPageId() const { return header_page_id_; }
+
+    // Keys compare equal exactly when their bytes do (see index/index_key.h), so the
+    // hash runs over the raw key bytes
+    static uint32_t Hash(const KeyType &key);
+
+private:
+    HashTableHeaderPage *Header() { return reinterpret_cast<HashTableHeaderPage *>(header_); }
+    const HashTableHeaderPage *Header() const { return reinterpret_cast<const HashTableHeaderPage *>(header_); }
+    // Reads a bucket page and its overflow pages
+    void ReadChain(page_id_t bucket_page_id, std::vector<page_id_t> &page_ids, std::vector<MappingType> &entries);
+    // Writes entries over the pages of a chain, allocating pages when they run out
+    void WriteChain(std::vector<page_id_t> page_ids, const std::vector<MappingType> &entries);
+    bool IsEmptyBucket(page_id_t bucket_page_id);
+    void SplitBucket(HashTableDirectoryPage *directory, uint32_t bucket_index);
+    void MergeBuckets(HashTableDirectoryPage *directory, uint32_t bucket_index);
+
+    std::string index_name_;
+    page_id_t header_page_id_;
+    KeyComparator comparator_;
+    DiskManager *disk_manager_;
+    alignas(8) char header_[PAGE_SIZE]; // Changed under the exclusive latch only
+    mutable std::shared_mutex latch_;
+};
+
+} // namespace mydb
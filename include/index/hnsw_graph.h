@@ -0,0 +1,135 @@
+#pragma once
+
+#include "common/vector_distance.h"
+#include "common/rid.h"
+#include "storage/disk_manager.h"
+#include "storage/page_summary_map.h"
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mydb {
+
+// Build parameters of an HNSW graph, from CREATE INDEX ... WITH (...)
+struct HnswParams {
+    uint32_t m = 16;                // Links per node on the upper levels, twice that on level 0
+    uint32_t ef_construction = 200; // Candidates kept while linking a new node
+    DistanceMetric metric = DistanceMetric::L2;
+
+    // Reads m, ef_construction and metric from (name, value) pairs; false (with a
+    // message in `error`) for an unknown name or a value out of range
+    static bool Parse(const std::vector<std::pair<std::string, std::string>> &options, HnswParams &params,
+                      std::string &error);
+};
+
+/**
+ * Disk-resident HNSW graph (hierarchical navigable small world) over float vectors,
+ * for approximate nearest-neighbour search. Every node is on level 0; a node reaches
+ * each higher level with probability 1/M, so the upper levels are sparse express
+ * lanes. A search descends greedily from the entry point on the top level, then
+ * keeps the ef closest candidates while walking level 0.
+ *
+ * Storage: each node is a fixed-size record in a PageSummaryMap keyed by node id,
+ *   | RID (8) | Level (4) | Deleted (4) | Vector (Dims x 4) | Count (4) | Links (2M x 4) |
+ * and each of its upper levels one more record in a second map, keyed by
+ * node id * MAX_LEVELS + level: | Count (4) | Links (M x 4) |. The maps keep their pages
+ * in memory, so the graph is walked in place, and every record a change touches is
+ * written through. A node must fit one page, which caps the dimension count
+ * (MaxDims).
+ *
+ * Removed rows are only marked deleted: they still route searches but are never
+ * returned. Vectors are checked against the dimension count of the first node and
+ * rejected if they differ.
+ *
+ * Not latched beyond one mutex: the executor runs statements one at a time.
+ */
+class HnswGraph {
+public:
+    static constexpr uint32_t MAX_LEVELS = 16;
+
+    // header_page_id == -1 creates a new (empty) graph with `params`, otherwise
+    // reopens an existing one (its parameters are read back from the header page)
+    HnswGraph(DiskManager *disk_manager, page_id_t header_page_id = -1, const HnswParams &params = HnswParams());
+    HnswGraph(const HnswGraph&) = delete;
+    HnswGraph& operator=(const HnswGraph&) = delete;
+
+    // Adds a node; false if `dims` differs from the graph's or is above MaxDims
+    bool Insert(const float *vec, uint32_t dims, const RID &rid);
+    // Marks the node of `rid` deleted; false if there is none
+    bool Remove(const RID &rid);
+
+    // Up to k live nodes nearest to `query` as (distance, RID), closest first. ef
+    // (raised to k) is the candidate list size on level 0: larger is slower but
+    // finds more of the true nearest neighbours.
+    std::vector<std::pair<float, RID>> Search(const float *query, uint32_t dims, size_t k, size_t ef);
+
+    // Bulk builds skip the write-through; EndBulk writes every page once
+    void BeginBulk() { bulk_ = true; }
+    void EndBulk();
+
+    bool IsEmpty() const { return live_count_ == 0; }
+    size_t GetLiveCount() const { return live_count_; }
+    page_id_t GetHeaderPageId() const { return header_page_id_; }
+    const HnswParams &GetParams() const { return params_; }
+    uint32_t GetDims() const { return dims_; }
+
+    // Largest dimension count whose node record fits one page
+    static uint32_t MaxDims(uint32_t m);
+
+private:
+    using Candidate = std::pair<float, uint32_t>; // (distance, node)
+
+    uint32_t MaxLinks(uint32_t level) const { return level == 0 ? 2 * params_.m : params_.m; }
+    uint32_t NodeSize() const { return 16 + dims_ * 4 + 4 + 2 * params_.m * 4; }
+    uint32_t LinksSize() const { return 4 + params_.m * 4; }
+
+    const float *Vector(uint32_t node) const { return reinterpret_cast<const float *>(nodes_[node] + 16); }
+    uint32_t Level(uint32_t node) const;
+    bool IsDeleted(uint32_t node) const;
+    // The link list of a node on a level: a count followed by MaxLinks(level) ids
+    uint32_t *Links(uint32_t node, uint32_t level);
+    float Distance(const float *query, uint32_t node) const {
+        return VectorDistance(params_.metric, query, Vector(node), dims_);
+    }
+
+    void CreateMaps();
+    uint32_t RandomLevel();
+    // Nearest `ef` nodes to `query` on a level, closest first, starting from `entry`
+    std::vector<Candidate> SearchLevel(const float *query, const std::vector<Candidate> &entry, size_t ef,
+                                       uint32_t level);
+    // Greedy descent from the entry point down to (but not into) `level`
+    Candidate Descend(const float *query, uint32_t level);
+    // Picks up to `max` neighbours from candidates sorted by distance, preferring ones
+    // that are not closer to an already picked neighbour than to the base node
+    std::vector<uint32_t> SelectNeighbors(const std::vector<Candidate> &candidates, size_t max) const;
+    // Adds `node` to the links of `neighbor`, pruning them if they overflow
+    void Connect(uint32_t neighbor, uint32_t node, uint32_t level);
+    void MarkDirty(page_id_t key, bool links) { (links ? dirty_links_ : dirty_nodes_).push_back(key); }
+    void Flush();
+    void WriteHeader();
+
+    DiskManager *disk_manager_;
+    page_id_t header_page_id_;
+    HnswParams params_;
+    uint32_t dims_ = 0;
+    uint32_t entry_point_ = 0;
+    uint32_t max_level_ = 0;
+    size_t live_count_ = 0;
+    std::unique_ptr<PageSummaryMap> node_map_;
+    std::unique_ptr<PageSummaryMap> link_map_;
+    std::vector<char *> nodes_;                  // Node id -> record
+    std::vector<std::vector<char *>> upper_;     // Node id -> link records of levels 1..Level
+    std::unordered_map<uint64_t, uint32_t> rids_; // RID -> node id
+    std::mt19937 rng_;
+    bool bulk_ = false;
+    std::vector<page_id_t> dirty_nodes_, dirty_links_;
+    std::vector<uint32_t> visited_;              // Per node: the search that last saw it
+    uint32_t visit_mark_ = 0;
+    std::mutex latch_;
+};
+
+} // namespace mydb
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/disk_manager.h"
+#include <vector>
+
+namespace mydb {
+
+#define INDEXITERATOR_TYPE IndexIterator<KeyType, KeyComparator>
+
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
+/**
+ * Position in a B+ tree: (leaf page, entry index), walking the leaf chain in key order.
+ * The current leaf is kept in a private copy, so reading entries costs no I/O; only
+ * crossing to another leaf reads a page.
+ *
+ * Leaves only link forward. Stepping back over a leaf boundary climbs to the nearest
+ * ancestor with a left neighbour and descends its rightmost path (O(height) reads).
+ * Decrementing End() yields the last entry; decrementing the first entry yields End().
+ *
+ * Iterators run alongside writers (see BPlusTree): each step that reads a page holds
+ * the tree latch shared for just that step. If leaves were split or merged since the
+ * current one was copied, the next step finds its place again from the tree root by
+ * the last key visited, skipping the duplicates of that key it has already returned.
+ * So a scan returns every entry present for its whole duration exactly once; entries
+ * inserted or removed meanwhile may or may not be seen.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class IndexIterator {
+    using LeafPage = BPlusTreeLeafPage<KeyType, KeyComparator>;
+    using InternalPage = BPlusTreeInternalPage<KeyType, KeyComparator>;
+
+public:
+    // End iterator
+    explicit IndexIterator(BPlusTree<KeyType, KeyComparator>* tree);
+    // Positioned at entry `index` of the leaf copied in `leaf`, as of tree structure `version`
+    IndexIterator(BPlusTree<KeyType, KeyComparator>* tree, std::vector<char> leaf, int index, uint64_t version);
+
+    bool IsEnd() const { return page_id_ == -1; }
+
+    KeyType Key() const;
+    RID Value() const;
+
+    IndexIterator& operator++();
+    IndexIterator& operator--();
+
+    bool operator==(const IndexIterator& other) const {
+        return page_id_ == other.page_id_ && index_ == other.index_;
+    }
+    bool operator!=(const IndexIterator& other) const { return !(*this == other); }
+
+private:
+    const LeafPage* Leaf() const { return reinterpret_cast<const LeafPage*>(page_.data()); }
+    // The helpers below run with the tree latch held in shared mode.
+    // Reads page_id into the buffer
+    void Load(page_id_t page_id);
+    void SetEnd();
+    // Reads the rightmost leaf below page_id into the buffer
+    void DescendRightmost(page_id_t page_id);
+    void StepForward();
+    void StepBackward();
+    // Moves to the last entry of the previous leaf (End() if none)
+    void PreviousLeaf();
+    // On leaving a leaf in `direction` (1 forward, -1 back) at entry `from`: adds the
+    // entries visited with that key in this leaf to run_
+    void RememberRun(int from, int direction);
+    bool InRun(const RID& rid) const;
+    // Whether the current entry was already returned; ends the skipping once past the run
+    bool Visited();
+    // After a structure change: the first unvisited entry from the start of the run, or
+    // the last one before its end. Later inserts may sit between visited duplicates, so
+    // the steps that follow keep skipping visited entries until the key changes.
+    void SeekAfterRun();
+    void SeekBeforeRun();
+
+    BPlusTree<KeyType, KeyComparator>* tree_;
+    page_id_t page_id_ = -1;
+    int index_ = 0;
+    std::vector<char> page_;
+    uint64_t version_ = 0;
+    // Entries visited with the key at the leaf boundary last crossed
+    KeyType run_key_{};
+    int run_direction_ = 0;
+    std::vector<RID> run_;
+    bool skipping_ = false;
+};
+
+} // namespace mydb
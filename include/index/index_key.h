@@ -0,0 +1,243 @@
+#pragma once
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "type/value.h"
+
+namespace mydb {
+
+/**
+ * Key types and comparators for BPlusTree.
+ *
+ * A comparator is a stateless functor returning <0, 0 or >0 like memcmp. Keys are
+ * fixed width so a page's capacity is known at compile time for every instantiation.
+ *
+ * KeyTraits<K> builds keys from column values (Make), and gives the smallest and
+ * largest key (Min/Max) plus Low/High, the key range covering one leading-column value
+ * (for a composite key, every value of the trailing column). Restore turns a key back
+ * into its column values, and is false if a string may have been cut to the key width.
+ *
+ * Separator(left, right) is a key s with left < s <= right that is as short as possible
+ * (mostly zero bytes), used as the separator pushed up when a leaf splits. COMPRESSED
+ * marks keys with a string column, whose pages are stored prefix/suffix compressed
+ * (see KeyBytesRange in storage/page/b_plus_tree_page.h).
+ */
+
+template <typename IntType>
+struct IntegerComparator {
+    int operator()(const IntType &a, const IntType &b) const {
+        return (a > b) - (a < b);
+    }
+};
+
+// First N bytes of a string, zero padded. Compares bytewise, so longer strings
+// sort after their prefixes; strings sharing N leading bytes compare equal.
+template <size_t N>
+struct StringKey {
+    char data[N];
+
+    static StringKey FromString(const std::string &s) {
+        StringKey key;
+        std::memset(key.data, 0, N);
+        std::memcpy(key.data, s.data(), std::min(N, s.size()));
+        return key;
+    }
+
+    std::string ToString() const {
+        return std::string(data, strnlen(data, N));
+    }
+};
+
+template <size_t N>
+struct StringKeyComparator {
+    int operator()(const StringKey<N> &a, const StringKey<N> &b) const {
+        return std::memcmp(a.data, b.data, N);
+    }
+};
+
+// Two keys compared lexicographically, e.g. (last_name, id)
+template <typename K1, typename K2>
+struct CompositeKey {
+    K1 first;
+    K2 second;
+};
+
+template <typename K1, typename C1, typename K2, typename C2>
+struct CompositeComparator {
+    int operator()(const CompositeKey<K1, K2> &a, const CompositeKey<K1, K2> &b) const {
+        int cmp = C1()(a.first, b.first);
+        return cmp != 0 ? cmp : C2()(a.second, b.second);
+    }
+};
+
+template <size_t N>
+std::ostream &operator<<(std::ostream &os, const StringKey<N> &key) {
+    return os << key.ToString();
+}
+
+template <typename K1, typename K2>
+std::ostream &operator<<(std::ostream &os, const CompositeKey<K1, K2> &key) {
+    return os << "(" << key.first << ", " << key.second << ")";
+}
+
+template <typename KeyType>
+struct KeyTraits;
+
+template <>
+struct KeyTraits<int32_t> {
+    static constexpr uint32_t COLUMNS = 1;
+    static int32_t Make(const Value *values) { return values[0].GetAsInteger(); }
+    static int32_t Min() { return INT32_MIN; }
+    static int32_t Max() { return INT32_MAX; }
+    static int32_t Low(const Value &value) { return Make(&value); }
+    static int32_t High(const Value &value) { return Make(&value); }
+    static bool Restore(const int32_t &key, Value *values) {
+        values[0] = Value(key);
+        return true;
+    }
+    static constexpr bool COMPRESSED = false;
+    static int32_t Separator(const int32_t &, const int32_t &right) { return right; }
+};
+
+template <>
+struct KeyTraits<int64_t> {
+    static constexpr uint32_t COLUMNS = 1;
+    static int64_t Make(const Value *values) { return values[0].GetAsInteger(); }
+    static int64_t Min() { return INT64_MIN; }
+    static int64_t Max() { return INT64_MAX; }
+    static int64_t Low(const Value &value) { return Make(&value); }
+    static int64_t High(const Value &value) { return Make(&value); }
+    static bool Restore(const int64_t &key, Value *values) {
+        values[0] = Value(static_cast<int32_t>(key)); // Made from an INT column
+        return true;
+    }
+    static constexpr bool COMPRESSED = false;
+    static int64_t Separator(const int64_t &, const int64_t &right) { return right; }
+};
+
+template <size_t N>
+struct KeyTraits<StringKey<N>> {
+    static constexpr uint32_t COLUMNS = 1;
+    static StringKey<N> Make(const Value *values) { return StringKey<N>::FromString(values[0].GetAsString()); }
+    static StringKey<N> Min() {
+        StringKey<N> key;
+        std::memset(key.data, 0, N);
+        return key;
+    }
+    static StringKey<N> Max() {
+        StringKey<N> key;
+        std::memset(key.data, 0xFF, N);
+        return key;
+    }
+    static StringKey<N> Low(const Value &value) { return Make(&value); }
+    static StringKey<N> High(const Value &value) { return Make(&value); }
+    static bool Restore(const StringKey<N> &key, Value *values) {
+        values[0] = Value(key.ToString());
+        return strnlen(key.data, N) < N;
+    }
+    static constexpr bool COMPRESSED = true;
+    // right cut just past its first byte that differs from left
+    static StringKey<N> Separator(const StringKey<N> &left, const StringKey<N> &right) {
+        size_t differ = 0;
+        while (differ < N && left.data[differ] == right.data[differ]) ++differ;
+        if (differ == N) return right;
+        StringKey<N> key;
+        std::memset(key.data, 0, N);
+        std::memcpy(key.data, right.data, differ + 1);
+        return key;
+    }
+};
+
+template <typename K1, typename K2>
+struct KeyTraits<CompositeKey<K1, K2>> {
+    static constexpr uint32_t COLUMNS = KeyTraits<K1>::COLUMNS + KeyTraits<K2>::COLUMNS;
+    static CompositeKey<K1, K2> Make(const Value *values) {
+        return {KeyTraits<K1>::Make(values), KeyTraits<K2>::Make(values + KeyTraits<K1>::COLUMNS)};
+    }
+    static CompositeKey<K1, K2> Min() { return {KeyTraits<K1>::Min(), KeyTraits<K2>::Min()}; }
+    static CompositeKey<K1, K2> Max() { return {KeyTraits<K1>::Max(), KeyTraits<K2>::Max()}; }
+    static CompositeKey<K1, K2> Low(const Value &value) { return {KeyTraits<K1>::Low(value), KeyTraits<K2>::Min()}; }
+    static CompositeKey<K1, K2> High(const Value &value) { return {KeyTraits<K1>::High(value), KeyTraits<K2>::Max()}; }
+    static bool Restore(const CompositeKey<K1, K2> &key, Value *values) {
+        bool exact = KeyTraits<K1>::Restore(key.first, values);
+        return KeyTraits<K2>::Restore(key.second, values + KeyTraits<K1>::COLUMNS) && exact;
+    }
+    static constexpr bool COMPRESSED = KeyTraits<K1>::COMPRESSED || KeyTraits<K2>::COMPRESSED;
+    static CompositeKey<K1, K2> Separator(const CompositeKey<K1, K2> &left, const CompositeKey<K1, K2> &right) {
+        if (std::memcmp(&left.first, &right.first, sizeof(K1)) == 0) {
+            return {right.first, KeyTraits<K2>::Separator(left.second, right.second)};
+        }
+        // Below right's first column any second column will do; zeros compress best
+        K1 first = KeyTraits<K1>::Separator(left.first, right.first);
+        bool below = std::memcmp(&first, &right.first, sizeof(K1)) != 0;
+        return {first, below ? K2{} : KeyTraits<K2>::Min()};
+    }
+};
+
+// The instantiations compiled into the engine (see the end of the B+ tree sources)
+constexpr size_t STRING_KEY_SIZE = 32;
+
+using IntKey = int32_t;
+using IntKeyComparator = IntegerComparator<int32_t>;
+using BigIntKey = int64_t;
+using BigIntKeyComparator = IntegerComparator<int64_t>;
+using StrKey = StringKey<STRING_KEY_SIZE>;
+using StrKeyComparator = StringKeyComparator<STRING_KEY_SIZE>;
+using IntIntKey = CompositeKey<IntKey, IntKey>;
+using IntIntKeyComparator = CompositeComparator<IntKey, IntKeyComparator, IntKey, IntKeyComparator>;
+using IntStrKey = CompositeKey<IntKey, StrKey>;
+using IntStrKeyComparator = CompositeComparator<IntKey, IntKeyComparator, StrKey, StrKeyComparator>;
+using StrIntKey = CompositeKey<StrKey, IntKey>;
+using StrIntKeyComparator = CompositeComparator<StrKey, StrKeyComparator, IntKey, IntKeyComparator>;
+using StrStrKey = CompositeKey<StrKey, StrKey>;
+using StrStrKeyComparator = CompositeComparator<StrKey, StrKeyComparator, StrKey, StrKeyComparator>;
+
+#define MYDB_FOR_EACH_INDEX_KEY(M)           \
+    M(IntKey, IntKeyComparator)              \
+    M(BigIntKey, BigIntKeyComparator)        \
+    M(StrKey, StrKeyComparator)              \
+    M(IntIntKey, IntIntKeyComparator)        \
+    M(IntStrKey, IntStrKeyComparator)        \
+    M(StrIntKey, StrIntKeyComparator)        \
+    M(StrStrKey, StrStrKeyComparator)
+
+// Keys of covering indexes: the key columns followed by the encoded values of the
+// INCLUDE columns (see index/table_index.h), so every leaf entry carries them. The
+// payload compares bytewise and only orders entries whose key columns are equal;
+// Low/High still span all of it, and its zero tail is left out of compressed pages.
+constexpr size_t INCLUDE_PAYLOAD_SIZE = 64;
+
+using IncludePayload = StringKey<INCLUDE_PAYLOAD_SIZE>;
+using IncludePayloadComparator = StringKeyComparator<INCLUDE_PAYLOAD_SIZE>;
+template <typename K>
+using CoveringKey = CompositeKey<K, IncludePayload>;
+template <typename K, typename C>
+using CoveringComparator = CompositeComparator<K, C, IncludePayload, IncludePayloadComparator>;
+
+using IntCoveringKey = CoveringKey<IntKey>;
+using IntCoveringKeyComparator = CoveringComparator<IntKey, IntKeyComparator>;
+using StrCoveringKey = CoveringKey<StrKey>;
+using StrCoveringKeyComparator = CoveringComparator<StrKey, StrKeyComparator>;
+using IntIntCoveringKey = CoveringKey<IntIntKey>;
+using IntIntCoveringKeyComparator = CoveringComparator<IntIntKey, IntIntKeyComparator>;
+using IntStrCoveringKey = CoveringKey<IntStrKey>;
+using IntStrCoveringKeyComparator = CoveringComparator<IntStrKey, IntStrKeyComparator>;
+using StrIntCoveringKey = CoveringKey<StrIntKey>;
+using StrIntCoveringKeyComparator = CoveringComparator<StrIntKey, StrIntKeyComparator>;
+using StrStrCoveringKey = CoveringKey<StrStrKey>;
+using StrStrCoveringKeyComparator = CoveringComparator<StrStrKey, StrStrKeyComparator>;
+
+// B+ tree instantiations: every index key, plus the covering keys
+#define MYDB_FOR_EACH_BPLUS_TREE_KEY(M)                  \
+    MYDB_FOR_EACH_INDEX_KEY(M)                           \
+    M(IntCoveringKey, IntCoveringKeyComparator)          \
+    M(StrCoveringKey, StrCoveringKeyComparator)          \
+    M(IntIntCoveringKey, IntIntCoveringKeyComparator)    \
+    M(IntStrCoveringKey, IntStrCoveringKeyComparator)    \
+    M(StrIntCoveringKey, StrIntCoveringKeyComparator)    \
+    M(StrStrCoveringKey, StrStrCoveringKeyComparator)
+
+} // namespace mydb
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "common/rid.h"
+#include "common/task_scheduler.h"
+#include "common/vector_distance.h"
+#include "storage/disk_manager.h"
+#include "storage/page_summary_map.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mydb {
+
+// Build parameters of an IVF-PQ index, from CREATE INDEX ... WITH (...)
+struct IvfPqParams {
+    uint32_t lists = 0;       // Coarse clusters; 0 = about the square root of the rows trained on
+    uint32_t sub_vectors = 0; // Bytes per encoded vector; 0 = a quarter of the dimensions (16x smaller)
+    DistanceMetric metric = DistanceMetric::L2;
+
+    // Reads lists, subvectors and metric from (name, value) pairs; false (with a
+    // message in `error`) for an unknown name or a value out of range
+    static bool Parse(const std::vector<std::pair<std::string, std::string>> &options, IvfPqParams &params,
+                      std::string &error);
+};
+
+/**
+ * Disk-resident IVF-PQ index (inverted file with product quantization) over float
+ * vectors, for approximate nearest-neighbour search in bounded memory.
+ *
+ * A coarse k-means quantizer splits the vectors into `lists` clusters. Each vector is
+ * stored in the inverted list of its nearest centroid as its RID plus a PQ code: the
+ * residual (vector - centroid) is cut into `sub_vectors` slices and each slice is
+ * replaced by the index (one byte) of its nearest of 256 trained sub-centroids. A
+ * search ranks the centroids, scans the `nprobe` nearest lists and scores every code
+ * with asymmetric distance tables (query slice to each sub-centroid, computed once per
+ * list), so a scored row costs `sub_vectors` table lookups and no float decoding. The
+ * scores are approximate; callers re-rank the best candidates with exact distances.
+ * COSINE vectors are normalized and compared by L2.
+ *
+ * Storage: the inverted lists are chains of PageSummaryPages whose entries are
+ *   | RID page (key) | RID slot (4) | Code (SubVectors) |
+ * read from disk by searches; only the centroids, the codebooks and a directory of
+ * (first page, last page, entry count) per list stay in memory. Until TRAIN_ROWS
+ * vectors (or 16 per requested list) have arrived the index is untrained: vectors are
+ * kept raw in a pending list (directory key -1) and searches are refused, then the
+ * quantizers are trained on them and the pending vectors encoded. Centroids do not
+ * move after training, so a table that grows far past its training size should have
+ * the index rebuilt.
+ *
+ * Removed rows are tombstoned in place (slot UINT32_MAX), their space not reused.
+ * Not latched beyond one mutex: the executor runs statements one at a time.
+ */
+class IvfPq {
+public:
+    static constexpr uint32_t CODEBOOK_SIZE = 256;
+    static constexpr uint32_t TRAIN_ROWS = 2048;
+    static constexpr uint32_t MAX_TRAIN_ROWS = 65536;
+    static constexpr uint32_t MAX_LISTS = 4096;
+
+    // header_page_id == -1 creates a new (empty) index with `params`, otherwise reopens
+    // an existing one (its parameters are read back from the header page)
+    IvfPq(DiskManager *disk_manager, page_id_t header_page_id = -1, const IvfPqParams &params = IvfPqParams());
+    IvfPq(const IvfPq&) = delete;
+    IvfPq& operator=(const IvfPq&) = delete;
+
+    // Adds a vector; false if `dims` differs from the index's or is above MaxDims
+    bool Insert(const float *vec, uint32_t dims, const RID &rid);
+    // Adds many vectors at once: an untrained index with enough rows trains on them
+    // first, and lists are appended to page by page. Scheduler tasks train and encode.
+    void BulkInsert(const std::vector<const float *> &vecs, uint32_t dims, const std::vector<RID> &rids,
+                    TaskScheduler *scheduler, size_t parallelism);
+    // Tombstones the entry of `rid` (found through the list `vec` falls in); false if none
+    bool Remove(const float *vec, uint32_t dims, const RID &rid);
+
+    // Up to k entries with the smallest approximate distance to `query` as (distance,
+    // RID), closest first, from the nprobe lists whose centroids are nearest. Empty
+    // while untrained.
+    std::vector<std::pair<float, RID>> Search(const float *query, uint32_t dims, size_t k, size_t nprobe);
+
+    bool IsTrained() const { return trained_; }
+    bool IsEmpty() const { return live_count_ == 0; }
+    size_t GetLiveCount() const { return live_count_; }
+    page_id_t GetHeaderPageId() const { return header_page_id_; }
+    const IvfPqParams &GetParams() const { return params_; }
+    uint32_t GetDims() const { return dims_; }
+
+    // Largest dimension count whose raw vector fits one pending entry
+    static uint32_t MaxDims();
+
+private:
+    // Directory record of a list: | FirstPageId (4) | LastPageId (4) | Count (4) |
+    static constexpr uint32_t DIRECTORY_RECORD_SIZE = 12;
+    static constexpr page_id_t PENDING_LIST = -1;
+
+    size_t SubBegin(uint32_t s) const { return s * static_cast<size_t>(dims_) / params_.sub_vectors; }
+    size_t SubDims() const { return (dims_ + params_.sub_vectors - 1) / params_.sub_vectors; }
+    // Codebook of slice s, transposed: float t of codeword j at [t * CODEBOOK_SIZE + j]
+    const float *SubCodebook(uint32_t s) const { return codebooks_.data() + s * SubDims() * CODEBOOK_SIZE; }
+    // out[j] = distance of slice s of `vec` to codeword j: squared L2, or the negated dot
+    // product for `inner_product`. Runs across the codewords, so the loop vectorizes.
+    void SubTable(uint32_t s, const float *vec, bool inner_product, float *out) const;
+    uint32_t TrainRows() const;
+    // Copy of `vec`, normalized for COSINE
+    std::vector<float> Prepare(const float *vec) const;
+    uint32_t NearestList(const float *vec) const;
+    // List and PQ code (sub_vectors bytes) of a prepared vector
+    uint32_t Encode(const float *vec, uint8_t *code) const;
+
+    void Train(const std::vector<const float *> &vecs, size_t total_rows, TaskScheduler *scheduler,
+               size_t parallelism);
+    void TrainPending(TaskScheduler *scheduler, size_t parallelism);
+    // Encodes prepared vectors into their lists, in parallel chunks
+    void EncodeAll(const std::vector<const float *> &vecs, const std::vector<RID> &rids, TaskScheduler *scheduler,
+                   size_t parallelism);
+    // Appends entries (RID + payload of summary_size - 4 bytes each) to a list's chain
+    void Append(page_id_t list, uint32_t summary_size, const std::vector<RID> &rids, const char *payloads);
+    bool Tombstone(page_id_t list, const RID &rid);
+    void WriteHeader();
+
+    DiskManager *disk_manager_;
+    page_id_t header_page_id_;
+    IvfPqParams params_;
+    uint32_t dims_ = 0;
+    bool trained_ = false;
+    size_t live_count_ = 0;
+    size_t pending_count_ = 0;
+    std::unique_ptr<PageSummaryMap> directory_;
+    page_id_t centroids_page_id_ = -1;
+    page_id_t codebooks_page_id_ = -1;
+    std::vector<float> centroids_; // lists x dims
+    std::vector<float> codebooks_; // sub_vectors x SubDims x CODEBOOK_SIZE (see SubCodebook)
+    std::mutex latch_;
+};
+
+} // namespace mydb
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "common/task_scheduler.h"
+#include "common/vector_distance.h"
+#include "storage/disk_manager.h"
+#include "storage/tuple.h"
+
+namespace mydb {
+
+// BPLUS_TREE answers ranges and ordered walks; HASH (an extendible hash table) only
+// finds the rows of one key, in O(1) page reads. BLOOM keeps a bloom filter of the key
+// per heap page and finds no rows itself: it tells scans which pages to skip. HNSW (a
+// graph) and IVFPQ (quantized inverted lists, for less memory) index one VECTOR column
+// and only answer approximate nearest-neighbour searches.
+enum class IndexType { BPLUS_TREE, HASH, BLOOM, HNSW, IVF_PQ };
+
+// (name, value) build options from CREATE INDEX ... WITH (...), as written to the catalog
+using IndexOptions = std::vector<std::pair<std::string, std::string>>;
+
+// The USING name of an index type, as written to the catalog
+inline const char *IndexTypeName(IndexType type) {
+    switch (type) {
+        case IndexType::HASH: return "HASH";
+        case IndexType::BLOOM: return "BLOOM";
+        case IndexType::HNSW: return "HNSW";
+        case IndexType::IVF_PQ: return "IVFPQ";
+        default: return "BTREE";
+    }
+}
+
+// Parses a USING name (upper case); false if it names no index type
+inline bool ParseIndexType(const std::string &name, IndexType &type) {
+    for (IndexType candidate : {IndexType::BPLUS_TREE, IndexType::HASH, IndexType::BLOOM, IndexType::HNSW,
+                                IndexType::IVF_PQ}) {
+        if (name == IndexTypeName(candidate)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// True for the index types over a VECTOR column (see TableIndex::SearchNearest)
+inline bool IsVectorIndex(IndexType type) { return type == IndexType::HNSW || type == IndexType::IVF_PQ; }
+
+/**
+ * A table's view of one secondary index: entries are built from the key columns of
+ * a tuple, whatever their types, so the executor does not need to know which
+ * BPlusTree instantiation sits underneath.
+ *
+ * Supported keys: one or two columns, each INT or VARCHAR (HASH and BLOOM take one);
+ * HNSW and IVFPQ indexes take exactly one VECTOR column.
+ * VARCHAR keys hold the first STRING_KEY_SIZE bytes of the string, so lookups may
+ * return extra candidates and the caller re-checks its predicate on the fetched rows.
+ *
+ * A B+ tree index may also be covering: it stores the values of INCLUDE columns (INT or
+ * VARCHAR) in its entries, after the key (see CoveringKey in index/index_key.h), and
+ * ScanCovered rebuilds rows from the index alone. Values are packed into
+ * INCLUDE_PAYLOAD_SIZE bytes; when a row needs values that did not fit, or a VARCHAR
+ * key that may be cut short, the caller reads that row from the heap instead.
+ */
+class TableIndex {
+public:
+    virtual ~TableIndex() = default;
+
+    virtual void InsertEntry(const Tuple &tuple, const RID &rid) = 0;
+    // Removes the entry `tuple` produced at `rid`; false if it was not found
+    virtual bool DeleteEntry(const Tuple &tuple, const RID &rid) = 0;
+
+    // RIDs whose leading key column lies in [low, high], in ascending or descending
+    // key order. An INVALID Value leaves that side of the range open. A HASH index
+    // only takes low == high (anything else finds nothing); a BLOOM index finds nothing.
+    virtual std::vector<RID> ScanRange(const Value &low, const Value &high, bool descending) = 0;
+
+    // False if no row on heap page `page_id` can have its leading key column in [low,
+    // high], so a scan may skip the page. Only BLOOM indexes rule pages out (for
+    // low == high); other indexes always return true.
+    virtual bool PageMayMatch(page_id_t, const Value &, const Value &) const { return true; }
+
+    // True if ScanCovered can rebuild every flagged column (each is a key or INCLUDE
+    // column). Always false for an index without INCLUDE columns.
+    virtual bool Covers(const std::vector<bool> &) const { return false; }
+    // ScanRange that also rebuilds the flagged columns from the index entries: rows[i]
+    // belongs to rids[i] and holds those columns (the rest INVALID), or no values at all
+    // if that entry cannot restore them exactly.
+    virtual void ScanCovered(const Value &low, const Value &high, bool descending, const std::vector<bool> &,
+                             std::vector<RID> &rids, std::vector<Tuple> &rows) {
+        rids = ScanRange(low, high, descending);
+        rows.assign(rids.size(), Tuple());
+    }
+
+    // Builds an empty index from the rows in one pass (see BPlusTree::BulkLoad) instead
+    // of inserting them one by one. The (key, RID) pairs are sorted in memory with
+    // ParallelSort; leaves are packed to fill_percent. HASH and BLOOM indexes just
+    // insert the rows. False if the index is not empty.
+    virtual bool BulkLoad(const std::vector<Tuple> &tuples, const std::vector<RID> &rids, int fill_percent,
+                          TaskScheduler *scheduler = nullptr, size_t parallelism = 1) = 0;
+
+    // RIDs of up to k rows whose key vector is (approximately) nearest to `query` under
+    // `metric`, closest first. `breadth` is how hard to look: the candidates an HNSW search
+    // keeps, the lists an IVFPQ search probes. False if the index cannot answer the search
+    // (not a vector index, not trained yet, or built for another metric or dimension count).
+    virtual bool SearchNearest(const std::vector<float> &, DistanceMetric, size_t, size_t, std::vector<RID> &) {
+        return false;
+    }
+    // Rows a vector index can return (deleted ones excluded); 0 for other indexes
+    virtual size_t GetVectorCount() const { return 0; }
+
+    virtual bool IsEmpty() const = 0;
+    virtual page_id_t GetHeaderPageId() const = 0;
+    virtual IndexType GetType() const = 0;
+    // The build options to pass to Create when the index is rebuilt; none for most types
+    virtual IndexOptions GetOptions() const { return {}; }
+
+    // False (with a message in `error`) if CREATE INDEX ... WITH options do not suit `type`
+    static bool ValidateOptions(IndexType type, const IndexOptions &options, std::string &error);
+    // Longest vector an index of `type` built with `options` can hold (an HNSW node, and
+    // an IVFPQ vector waiting for training, must fit one page); 0 if there is no limit or
+    // the options do not parse
+    static uint32_t MaxVectorDims(IndexType type, const IndexOptions &options);
+
+    // Creates a new index (header_page_id == -1) or reopens one over the given key
+    // columns, storing include_columns too. Returns null if the column types cannot be
+    // indexed, for a HASH or BLOOM index with INCLUDE columns or two key columns, or for
+    // vector index options that do not parse (a reopened one reads its own from disk).
+    static std::unique_ptr<TableIndex> Create(const std::string &name, DiskManager *disk_manager,
+                                              const Schema &schema, const std::vector<uint32_t> &key_columns,
+                                              page_id_t header_page_id = -1,
+                                              IndexType type = IndexType::BPLUS_TREE,
+                                              const std::vector<uint32_t> &include_columns = {},
+                                              const IndexOptions &options = {});
+};
+
+} // namespace mydb
@@ -5,6 +5,7 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <cctype>
 
 namespace mydb {
 
@@ -31,12 +32,17 @@ enum class StatementType {
     VERSION,
     CONNECT,
     DROP,
-    AUTOUPDATE
+    AUTOUPDATE,
+    SET,
+    CREATE_INDEX,
+    DROP_INDEX
 };
 
 struct Statement {
     StatementType type;
     std::string table_name;
+    // For SELECT column list (empty means all columns, i.e. '*')
+    std::vector<std::string> select_columns;
     // For CREATE
     std::vector<std::pair<std::string, std::string>> columns; // name, type
     // For INSERT
@@ -45,21 +51,36 @@ struct Statement {
     // For EXPORT/IMPORT/BACKUP/RESTORE
     std::string file_path;
     
+    // For CREATE INDEX / DROP INDEX (the key columns, in order, go in index_columns)
+    std::vector<std::string> index_columns;
+    std::string index_name;
+    std::string index_method; // USING <method>, upper case; empty for the default B+ tree
+    std::vector<std::string> index_include; // INCLUDE (<column>, ...)
+    std::vector<std::pair<std::string, std::string>> index_options; // WITH (<name> = <value>, ...)
+    // For CREATE TABLE ... WITH (<name> = <value>, ...)
+    std::vector<std::pair<std::string, std::string>> table_options;
+    
     // For WHERE clause
     std::string where_column;
-    std::string where_op = "="; // Default, can be "!="
+    std::string where_op = "="; // Default, can be "!=", "<", "<=", ">", ">=", "BETWEEN"
     std::string where_value;
+    std::string where_value_high; // Upper bound of BETWEEN <where_value> AND <where_value_high>
     
     // For ORDER BY clause
     std::string order_by_column;
+    bool order_by_desc = false;
     
-    // For UPDATE (SET col = val)
+    // For UPDATE (SET col = val), also SET <setting> = <val>
     std::string update_column;
     std::string update_value;
     
     // For VECTOR_DIST
     bool order_by_vector_dist = false;
     std::string order_by_vector_literal;
+    std::string order_by_vector_metric; // Optional third argument (L2 / IP / COSINE)
+
+    // For SELECT ... LIMIT n (-1 = no limit)
+    long long limit = -1;
 };
 
 class Parser {
@@ -85,8 +106,11 @@ public:
                 stmt.type = StatementType::CREATE_TABLE;
                 ss >> stmt.table_name;
                 SanitizeIdentifier(stmt.table_name);
-                
-                while (ss >> word) {
+                std::string rest;
+                std::getline(ss, rest);
+                std::stringstream cs(ParseTableOptions(rest, stmt));
+
+                while (cs >> word) {
                     if (word == "with" || word == "fields" || word == "properties" || word == "(" || word == ")" || word == ",") {
                         continue; 
                     }
@@ -95,7 +119,7 @@ public:
                     if (col_name.back() == ',') col_name.pop_back();
                     SanitizeIdentifier(col_name);
                     
-                    if (ss >> word) {
+                    if (cs >> word) {
                         std::string type = word;
                         if (type.back() == ',') type.pop_back();
                         // Case-insensitive type check
@@ -105,11 +129,20 @@ public:
                         if (type_up == "STRING" || type_up == "TEXT" || type_up == "VARCHAR") type = "VARCHAR";
                         else if (type_up == "INT" || type_up == "INTEGER" || type_up == "NUMBER") type = "INT";
                         else if (type_up == "VECTOR") type = "VECTOR";
+                        // VECTOR_FP16 / VECTOR(FP16) etc. pick the vector storage encoding
+                        else if (type_up == "VECTOR_FP32" || type_up == "VECTOR(FP32)") type = "VECTOR";
+                        else if (type_up == "VECTOR_FP16" || type_up == "VECTOR(FP16)") type = "VECTOR_FP16";
+                        else if (type_up == "VECTOR_INT8" || type_up == "VECTOR(INT8)") type = "VECTOR_INT8";
                         else if (type == ",") continue; 
                         
                         stmt.columns.emplace_back(col_name, type);
                     }
                 }
+            } else if (sub == "INDEX") {
+                // CREATE INDEX [name] ON <table>(<column>)
+                std::string rest;
+                std::getline(ss, rest);
+                ParseIndexTarget(rest, stmt);
             }
         } 
         // 2. INSERT / ADD TO
@@ -147,17 +180,25 @@ public:
         } 
         // 3. SELECT / SHOW ME
         else if (cmd == "SELECT" || cmd == "GET" || cmd == "LIST") {
+            std::string remainder;
             if (cmd == "SELECT") {
-                ss >> word; // *
-                ss >> word; // FROM
-                std::string sub = word;
-                for (auto &c : sub) c = std::toupper(c);
+                // Column list runs up to FROM ("*" selects everything)
+                std::string list;
+                std::string sub;
+                while (ss >> word) {
+                    sub = word;
+                    for (auto &c : sub) c = std::toupper(c);
+                    if (sub == "FROM") break;
+                    list += word + " ";
+                }
                 if (sub == "FROM") {
                     stmt.type = StatementType::SELECT;
+                    ParseColumnList(list, stmt);
                     ss >> stmt.table_name;
                     if (stmt.table_name.back() == ';') stmt.table_name.pop_back();
                     SanitizeIdentifier(stmt.table_name);
                 }
+                std::getline(ss, remainder);
             } else if (cmd == "LIST" || cmd == "GET") {
                 ss >> word; 
                 std::string next = word;
@@ -165,40 +206,37 @@ public:
                 if (next == "TABLES") {
                     stmt.type = StatementType::SHOW_TABLES;
                 } else {
-                    if (next == "ME" || next == "ALL" || next == "FROM") {
-                        ss >> stmt.table_name;
-                    } else {
-                        stmt.table_name = word;
+                    std::getline(ss, remainder);
+                    if (next != "ME" && next != "ALL" && next != "FROM") {
+                        remainder = word + remainder;
                     }
                     stmt.type = StatementType::SELECT;
-                    SanitizeIdentifier(stmt.table_name);
+                    remainder = ParseTarget(remainder, stmt);
                 }
             }
             // Eat remaining part of SQL for robust Where/Order parsing
-            std::string remainder;
-            std::getline(ss, remainder);
-            ParseWhereClause(remainder, stmt);
+            ParseWhereClause(StripLimit(remainder, stmt), stmt);
         }
         // 4. SHOW (Legacy/New)
         else if (cmd == "SHOW") {
             ss >> word;
             std::string sub = word;
             for (auto &c : sub) c = std::toupper(c);
+            std::string remainder;
+            std::getline(ss, remainder);
             if (sub == "TABLES") {
                 stmt.type = StatementType::SHOW_TABLES;
             } else if (sub == "ME") {
+                // show me <table> | show me <col>, <col> of <table>
                 stmt.type = StatementType::SELECT;
-                ss >> stmt.table_name;
-                SanitizeIdentifier(stmt.table_name);
+                remainder = ParseTarget(remainder, stmt);
             } else {
                 // assume show <table_name> is select
                 stmt.type = StatementType::SELECT;
                 stmt.table_name = word;
                 SanitizeIdentifier(stmt.table_name);
             }
-            std::string remainder;
-            std::getline(ss, remainder);
-            ParseWhereClause(remainder, stmt);
+            ParseWhereClause(StripLimit(remainder, stmt), stmt);
         }
         // 5. EXPORT
         else if (cmd == "EXPORT") {
@@ -326,12 +364,50 @@ public:
                 stmt.type = StatementType::DROP;
                 ss >> stmt.table_name;
                 SanitizeIdentifier(stmt.table_name);
+            } else if (sub == "INDEX") {
+                stmt.type = StatementType::DROP_INDEX;
+                ss >> stmt.index_name;
+                SanitizeIdentifier(stmt.index_name);
             }
         }
+        // 18b. INDEX <table> BY <column>[, <column>] (V2V form of CREATE INDEX)
+        else if (cmd == "INDEX") {
+            std::string table, by, columns;
+            ss >> table >> by;
+            std::getline(ss, columns);
+            for (auto &c : by) c = std::toupper(c);
+            if (by == "BY" || by == "ON") ParseIndexTarget("ON " + table + "(" + columns + ")", stmt);
+        }
         // 19. AUTOUPDATE
         else if (cmd == "AUTOUPDATE") {
             stmt.type = StatementType::AUTOUPDATE;
         }
+        // 20. SET <setting> [=|TO] <value>
+        else if (cmd == "SET") {
+            stmt.type = StatementType::SET;
+            std::string rest;
+            std::getline(ss, rest);
+            std::replace(rest.begin(), rest.end(), '=', ' ');
+            std::stringstream rs(rest);
+            rs >> stmt.update_column >> stmt.update_value;
+            std::string sub = stmt.update_value;
+            for (auto &c : sub) c = std::toupper(c);
+            if (sub == "TO") rs >> stmt.update_value;
+            for (auto &c : stmt.update_column) c = std::tolower(c);
+            CleanValue(stmt.update_value);
+        }
+        // 21. USE <n> THREADS (V2V form of SET PARALLELISM)
+        else if (cmd == "USE") {
+            std::string count;
+            ss >> count >> word;
+            std::string sub = word;
+            for (auto &c : sub) c = std::toupper(c);
+            if (sub == "THREADS" || sub == "THREAD" || sub == "WORKERS") {
+                stmt.type = StatementType::SET;
+                stmt.update_column = "parallelism";
+                stmt.update_value = count;
+            }
+        }
         
         return stmt;
     }
@@ -359,6 +435,200 @@ private:
         if (!val.empty() && val.back() == ';') val.pop_back();
     }
 
+    // Splits a SELECT column list ("id, name" or "name and age") into stmt.select_columns.
+    // "*" (or an empty list) leaves it empty, meaning all columns.
+    static void ParseColumnList(const std::string& list, Statement& stmt) {
+        std::string normalized = list;
+        std::replace(normalized.begin(), normalized.end(), ',', ' ');
+        std::stringstream ls(normalized);
+        std::string col;
+        while (ls >> col) {
+            std::string up = col;
+            for (auto &c : up) c = std::toupper(c);
+            if (col == "*" || up == "AND") continue;
+            SanitizeIdentifier(col);
+            if (!col.empty()) stmt.select_columns.push_back(col);
+        }
+    }
+
+    // Parses the V2V target "<table> ..." or "<cols> of <table> ...", sets the table
+    // (and projection) on stmt, and returns the text following the table name.
+    static std::string ParseTarget(const std::string& text, Statement& stmt) {
+        std::stringstream ts(text);
+        std::string word;
+        std::string list;
+        while (ts >> word) {
+            std::string up = word;
+            for (auto &c : up) c = std::toupper(c);
+            if (up == "WHERE" || up == "ORDER") break;
+            if (up == "OF") {
+                ParseColumnList(list, stmt);
+                ts >> stmt.table_name;
+                SanitizeIdentifier(stmt.table_name);
+                std::string rest;
+                std::getline(ts, rest);
+                return rest;
+            }
+            list += word + " ";
+        }
+
+        // No projection: the first word is the table
+        std::stringstream ts2(text);
+        ts2 >> stmt.table_name;
+        SanitizeIdentifier(stmt.table_name);
+        std::string rest;
+        std::getline(ts2, rest);
+        return rest;
+    }
+
+    // Parses "<name> = <value>, ..." into `options`; false if an entry is malformed
+    static bool ParseOptionList(const std::string& list, std::vector<std::pair<std::string, std::string>>& options) {
+        std::stringstream os(list);
+        std::string option;
+        while (std::getline(os, option, ',')) {
+            size_t eq = option.find('=');
+            if (eq == std::string::npos) return false;
+            std::string name = option.substr(0, eq), value = option.substr(eq + 1);
+            for (std::string* part : {&name, &value}) {
+                size_t first = part->find_first_not_of(" \t'");
+                size_t last = part->find_last_not_of(" \t';");
+                *part = first == std::string::npos ? "" : part->substr(first, last - first + 1);
+            }
+            if (name.empty() || value.empty()) return false;
+            options.emplace_back(name, value);
+        }
+        return true;
+    }
+
+    // Takes a trailing "WITH (<name> = <value>, ...)" off the column list of CREATE TABLE
+    // into stmt.table_options. A WITH not followed by such a list stays (as in
+    // "CREATE TABLE t WITH FIELDS ...") and is skipped with the column words.
+    static std::string ParseTableOptions(const std::string& text, Statement& stmt) {
+        std::string upper_text = text;
+        std::transform(upper_text.begin(), upper_text.end(), upper_text.begin(), ::toupper);
+        size_t with = upper_text.rfind("WITH");
+        while (with != std::string::npos) {
+            size_t open = text.find_first_not_of(" \t", with + 4);
+            size_t close = text.find(')', with);
+            bool word_start = with == 0 || std::isspace(upper_text[with - 1]) || upper_text[with - 1] == ')' ||
+                              upper_text[with - 1] == ',';
+            if (word_start && open != std::string::npos && text[open] == '(' && close != std::string::npos &&
+                text.find('=', open) < close) {
+                if (!ParseOptionList(text.substr(open + 1, close - open - 1), stmt.table_options)) return text;
+                return text.substr(0, with) + " " + text.substr(close + 1);
+            }
+            if (with == 0) break;
+            with = upper_text.rfind("WITH", with - 1);
+        }
+        return text;
+    }
+
+    // Parses "[name] ON <table>(<column>[, <column>]) [INCLUDE (<column>, ...)] [USING <method>]
+    // [WITH (<name> = <value>, ...)]" (USING may come anywhere after the name); an unnamed index
+    // is called <table>_<column>[_<column>]_idx, or <table>_<column>_<method>_idx for USING
+    // other than BTREE
+    static void ParseIndexTarget(const std::string& text, Statement& stmt) {
+        std::string normalized = text;
+        std::string upper_text = text;
+        std::transform(upper_text.begin(), upper_text.end(), upper_text.begin(), ::toupper);
+        size_t with = upper_text.find("WITH");
+        while (with != std::string::npos &&
+               ((with > 0 && !std::isspace(upper_text[with - 1]) && upper_text[with - 1] != ')') ||
+                (with + 4 < upper_text.size() && (std::isalnum(upper_text[with + 4]) || upper_text[with + 4] == '_')))) {
+            with = upper_text.find("WITH", with + 4);
+        }
+        if (with != std::string::npos) {
+            size_t open = text.find('(', with);
+            size_t close = text.find(')', with);
+            if (open == std::string::npos || close == std::string::npos || close < open ||
+                text.find_first_not_of(" \t", with + 4) != open) {
+                return;
+            }
+            if (!ParseOptionList(text.substr(open + 1, close - open - 1), stmt.index_options)) return;
+            normalized = text.substr(0, with) + " " + text.substr(close + 1);
+        }
+        for (auto &c : normalized) {
+            if (c == '(' || c == ')' || c == ',' || c == ';') c = ' ';
+        }
+        std::stringstream ts(normalized);
+        std::vector<std::string> words;
+        std::string word;
+        while (ts >> word) {
+            std::string up = word;
+            for (auto &c : up) c = std::toupper(c);
+            if (up == "USING" && ts >> stmt.index_method) {
+                for (auto &c : stmt.index_method) c = std::toupper(c);
+                continue;
+            }
+            words.push_back(word);
+        }
+
+        for (size_t i = 0; i < words.size(); ++i) {
+            std::string up = words[i];
+            for (auto &c : up) c = std::toupper(c);
+            if (up != "INCLUDE") continue;
+            for (size_t j = i + 1; j < words.size(); ++j) {
+                std::string column = words[j];
+                SanitizeIdentifier(column);
+                if (column.empty()) return;
+                stmt.index_include.push_back(column);
+            }
+            if (stmt.index_include.empty()) return;
+            words.resize(i);
+            break;
+        }
+
+        size_t on = 0;
+        while (on < words.size()) {
+            std::string up = words[on];
+            for (auto &c : up) c = std::toupper(c);
+            if (up == "ON") break;
+            on++;
+        }
+        if (on > 1 || on + 2 >= words.size()) return;
+
+        if (on == 1) stmt.index_name = words[0];
+        stmt.table_name = words[on + 1];
+        SanitizeIdentifier(stmt.index_name);
+        SanitizeIdentifier(stmt.table_name);
+        if (stmt.table_name.empty()) return;
+        std::string default_name = stmt.table_name;
+        for (size_t i = on + 2; i < words.size(); ++i) {
+            std::string column = words[i];
+            SanitizeIdentifier(column);
+            if (column.empty()) return;
+            stmt.index_columns.push_back(column);
+            default_name += "_" + column;
+        }
+        if (!stmt.index_method.empty() && stmt.index_method != "BTREE") {
+            std::string method = stmt.index_method;
+            for (auto &c : method) c = std::tolower(c);
+            default_name += "_" + method;
+        }
+        if (stmt.index_name.empty()) stmt.index_name = default_name + "_idx";
+        stmt.type = StatementType::CREATE_INDEX;
+    }
+
+    // Removes a trailing "LIMIT <n>" from a SELECT clause into stmt.limit
+    static std::string StripLimit(const std::string& clause, Statement& stmt) {
+        std::string upper_clause = clause;
+        std::transform(upper_clause.begin(), upper_clause.end(), upper_clause.begin(), ::toupper);
+        size_t limit_pos = upper_clause.rfind("LIMIT");
+        if (limit_pos == std::string::npos || (limit_pos > 0 && !std::isspace(upper_clause[limit_pos - 1]))) {
+            return clause;
+        }
+        std::stringstream ls(clause.substr(limit_pos + 5));
+        std::string count, extra;
+        ls >> count >> extra;
+        if (!count.empty() && count.back() == ';') count.pop_back();
+        if (count.empty() || !extra.empty() || count.size() > 18 ||
+            !std::all_of(count.begin(), count.end(), ::isdigit)) {
+            return clause;
+        }
+        stmt.limit = std::stoll(count);
+        return clause.substr(0, limit_pos);
+    }
+
     static void ParseWhereClause(const std::string& clause, Statement& stmt) {
         if (clause.empty()) return;
         
@@ -378,9 +648,20 @@ private:
             wss >> stmt.where_column;
             SanitizeIdentifier(stmt.where_column);
             wss >> stmt.where_op;
-            if (stmt.where_op == "=" || stmt.where_op == "!=") {
+            if (stmt.where_op == "==") stmt.where_op = "=";
+            std::string op_up = stmt.where_op;
+            for (auto &c : op_up) c = std::toupper(c);
+            if (stmt.where_op == "=" || stmt.where_op == "!=" || stmt.where_op == "<" || stmt.where_op == "<=" ||
+                stmt.where_op == ">" || stmt.where_op == ">=") {
                 wss >> stmt.where_value;
                 CleanValue(stmt.where_value);
+            } else if (op_up == "BETWEEN") {
+                // BETWEEN <low> AND <high>, both bounds inclusive
+                std::string and_word;
+                stmt.where_op = "BETWEEN";
+                wss >> stmt.where_value >> and_word >> stmt.where_value_high;
+                CleanValue(stmt.where_value);
+                CleanValue(stmt.where_value_high);
             }
         }
         
@@ -406,6 +687,15 @@ private:
                         SanitizeIdentifier(stmt.order_by_column);
                         
                         stmt.order_by_vector_literal = args.substr(comma + 1);
+                        // VECTOR_DIST(col, [..], <metric>), or a list [[..], [..], ...] of query vectors
+                        size_t bracket = stmt.order_by_vector_literal.rfind(']');
+                        if (bracket != std::string::npos) {
+                            std::string metric = stmt.order_by_vector_literal.substr(bracket + 1);
+                            stmt.order_by_vector_literal.erase(bracket + 1);
+                            metric.erase(0, metric.find_first_not_of(", \t\r\n"));
+                            metric.erase(metric.find_last_not_of(" \t\r\n") + 1);
+                            stmt.order_by_vector_metric = metric;
+                        }
                         // trim spaces
                         stmt.order_by_vector_literal.erase(0, stmt.order_by_vector_literal.find_first_not_of(" \t\r\n"));
                         stmt.order_by_vector_literal.erase(stmt.order_by_vector_literal.find_last_not_of(" \t\r\n") + 1);
@@ -413,8 +703,11 @@ private:
                 }
             } else {
                 std::stringstream oss(order_part);
-                oss >> stmt.order_by_column;
+                std::string direction;
+                oss >> stmt.order_by_column >> direction;
                 SanitizeIdentifier(stmt.order_by_column);
+                for (auto &c : direction) c = std::toupper(c);
+                stmt.order_by_desc = (direction == "DESC" || direction == "DESC;");
             }
         }
     }
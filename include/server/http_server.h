@@ -2,6 +2,8 @@
 
 #include "executor/executor.h"
 #include "catalog/catalog_manager.h"
+#include "common/task_scheduler.h"
+#include <mutex>
 #include <string>
 
 #ifdef _WIN32
@@ -15,7 +17,9 @@ namespace mydb {
 
 class HttpServer {
 public:
-    HttpServer(Executor* executor, CatalogManager* catalog, int port, const std::string& api_key);
+    // Client connections are handled as tasks on `scheduler` (inline when null)
+    HttpServer(Executor* executor, CatalogManager* catalog, int port, const std::string& api_key,
+               TaskScheduler* scheduler = nullptr);
     ~HttpServer();
 
     void Start();
@@ -29,15 +33,24 @@ private:
     void HandleHealth(int client_sock);
     void HandleTables(int client_sock);
     void HandleQuery(int client_sock, const std::string& body);
+    void HandleMetrics(int client_sock);
+    void HandleVectorSearch(int client_sock, const std::string& body);
     
     // Helpers
     std::string ExecuteToString(const std::string& sql);
     std::string EscapeJsonString(const std::string& input);
+    // Raw text of a top-level field of a flat JSON object: a string's contents, an
+    // array with its brackets, or a number / literal (empty when missing)
+    std::string JsonField(const std::string& body, const std::string& name);
 
     Executor* executor_;
     CatalogManager* catalog_;
     int port_;
     std::string api_key_;
+    TaskScheduler* scheduler_;
+    // The executor is single-threaded and ExecuteToString swaps std::cout's buffer,
+    // so statements from concurrent requests run one at a time.
+    std::mutex execute_mutex_;
     
 #ifdef _WIN32
     SOCKET server_sock_;
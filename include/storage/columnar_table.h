@@ -0,0 +1,465 @@
+#pragma once
+
+#include "storage/table_heap.h"
+#include "storage/page/column_page.h"
+#include "storage/page/columnar_header_page.h"
+#include "storage/page/row_map_page.h"
+#include <limits>
+#include <unordered_map>
+
+namespace mydb {
+
+/**
+ * A table stored column by column, for analytic scans that read a few columns of
+ * many rows: CREATE TABLE ... WITH (storage = columnar). Rows are numbered in insert
+ * order and every column keeps its values in its own chain of ColumnPages, so a scan
+ * reads the pages of the projected columns only; the others are never touched.
+ *
+ * A row map (RowMapPages, all kept in memory) holds a deleted flag per row and gives
+ * each row its RID: (row map page, row - its first row), so indexes work unchanged.
+ * Inserts append to the last page of every chain, kept in memory and written
+ * through; values above OVERFLOW_THRESHOLD bytes go to overflow chains as in the row
+ * heap. Deletes only flag the row, and updates delete and append, so the table suits
+ * append-mostly data. Point lookups (index reads) find a row's page through a
+ * per-column directory of (first row, page), built by walking the chain the first
+ * time the column is looked up.
+ *
+ * Scans hand out morsels of MORSEL_ROWS rows. Claiming one copies, under a short
+ * lock, the pages of each projected column that hold its rows (a page straddling two
+ * morsels is read once and copied to both); decoding runs outside the lock. Page
+ * filters are asked about the row map page of a morsel, which is what RIDs, and so
+ * BLOOM summaries, refer to. There is no zone map.
+ */
+class ColumnarTable : public TableHeap {
+public:
+    static constexpr uint32_t OVERFLOW_THRESHOLD = PAGE_SIZE / 4;
+    static constexpr uint32_t MORSEL_ROWS = RowMapPage::ROWS / 16;
+    static constexpr uint32_t MAX_COLUMNS = ColumnarHeaderPage::MAX_COLUMNS;
+
+    // Opens the columnar table whose header is `header_page_id`
+    ColumnarTable(DiskManager* disk_manager, page_id_t header_page_id, const Schema& schema)
+        : TableHeap(disk_manager, header_page_id, schema, NoRowPages()) {
+        char buf[PAGE_SIZE];
+        disk_manager_->ReadPage(first_page_id_, buf);
+        const auto* header = reinterpret_cast<const ColumnarHeaderPage*>(buf);
+        row_count_ = header->GetRowCount();
+        for (uint32_t c = 0; c < schema_.GetColumnCount(); ++c) {
+            first_pages_.push_back(header->GetFirstPageId(c));
+            last_pages_.push_back(header->GetLastPageId(c));
+        }
+        page_id_t row_map_page_id = header->GetRowMapPageId();
+        while (row_map_page_id != -1) {
+            LoadRowMapPage(row_map_page_id);
+            row_map_page_id = RowMap(row_maps_.size() - 1)->GetNextPageId();
+        }
+        for (uint32_t c = 0; c < schema_.GetColumnCount(); ++c) {
+            tails_.emplace_back(new char[PAGE_SIZE]);
+            disk_manager_->ReadPage(last_pages_[c], tails_[c].get());
+        }
+        directories_.resize(schema_.GetColumnCount());
+        directory_built_.assign(schema_.GetColumnCount(), false);
+    }
+
+    // Create a new, empty columnar table (the caller checks the column count against
+    // MAX_COLUMNS)
+    static std::unique_ptr<ColumnarTable> Create(DiskManager* disk_manager, const Schema& schema) {
+        char buf[PAGE_SIZE];
+        page_id_t header_page_id = disk_manager->AllocatePage();
+        page_id_t row_map_page_id = disk_manager->AllocatePage();
+        std::memset(buf, 0, PAGE_SIZE);
+        reinterpret_cast<RowMapPage*>(buf)->Init(-1, 0);
+        disk_manager->WritePage(row_map_page_id, buf);
+
+        std::memset(buf, 0, PAGE_SIZE);
+        auto* header = reinterpret_cast<ColumnarHeaderPage*>(buf);
+        header->Init(schema.GetColumnCount(), row_map_page_id);
+        for (uint32_t c = 0; c < schema.GetColumnCount(); ++c) {
+            page_id_t page_id = disk_manager->AllocatePage();
+            char column_buf[PAGE_SIZE];
+            std::memset(column_buf, 0, PAGE_SIZE);
+            reinterpret_cast<ColumnPage*>(column_buf)->Init(-1, 0);
+            disk_manager->WritePage(page_id, column_buf);
+            header->SetChain(c, page_id, page_id);
+        }
+        disk_manager->WritePage(header_page_id, buf);
+        return std::make_unique<ColumnarTable>(disk_manager, header_page_id, schema);
+    }
+
+    TableStorage GetStorage() const override { return TableStorage::COLUMNAR; }
+
+    // Appends the row's values to the end of every column chain
+    bool InsertTuple(const Tuple& tuple, RID* rid = nullptr) override {
+        if (tuple.GetValueCount() != schema_.GetColumnCount()) return false;
+        const uint32_t row = row_count_;
+        for (uint32_t c = 0; c < schema_.GetColumnCount(); ++c) {
+            const Value& value = tuple.GetValue(c);
+            TypeID type = value.GetTypeId();
+            uint32_t size = value.GetSerializedSize();
+            if ((type == TypeID::VARCHAR || type == TypeID::VECTOR) && !value.IsExternal() &&
+                size > OVERFLOW_THRESHOLD) {
+                AppendValue(c, row, Value::External(type, WriteOverflow(value), size));
+            } else {
+                AppendValue(c, row, value);
+            }
+        }
+        size_t map = row / RowMapPage::ROWS;
+        if (map == row_maps_.size()) AddRowMapPage(row);
+        row_count_ = row + 1;
+        WriteHeader();
+        if (rid != nullptr) rid->Set(row_map_ids_[map], row % RowMapPage::ROWS);
+        return true;
+    }
+
+    std::vector<Tuple> Scan(const std::vector<bool>& projection = {}) override {
+        return ParallelScan(projection, nullptr, nullptr, 1);
+    }
+
+    bool GetTuple(const RID& rid, Tuple& tuple, const std::vector<bool>& projection = {}) override {
+        std::vector<RID> rids = {rid};
+        std::vector<Tuple> tuples = GetTuples(rids, projection);
+        if (tuples.empty()) return false;
+        tuple = std::move(tuples.front());
+        return true;
+    }
+
+    // Reads column by column, each in row order, so every page is read once
+    std::vector<Tuple> GetTuples(std::vector<RID>& rids, const std::vector<bool>& projection = {}) override {
+        std::vector<RID> found_rids;
+        std::vector<uint32_t> rows;
+        for (const RID& rid : rids) {
+            uint32_t row = 0;
+            if (!ResolveRow(rid, row)) continue;
+            found_rids.push_back(rid);
+            rows.push_back(row);
+        }
+        std::vector<size_t> order(rows.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&rows](size_t a, size_t b) { return rows[a] < rows[b]; });
+
+        std::vector<std::vector<Value>> values(rows.size(), std::vector<Value>(schema_.GetColumnCount()));
+        char buf[PAGE_SIZE];
+        for (uint32_t c = 0; c < schema_.GetColumnCount(); ++c) {
+            if (!projection.empty() && !projection[c]) continue;
+            const auto& directory = Directory(c);
+            page_id_t loaded_page_id = -1;
+            for (size_t i : order) {
+                // The last page whose first row is at most rows[i]
+                auto it = std::upper_bound(directory.begin(), directory.end(),
+                                           std::make_pair(rows[i], std::numeric_limits<page_id_t>::max()));
+                page_id_t page_id = std::prev(it)->second;
+                if (page_id != loaded_page_id) {
+                    disk_manager_->ReadPage(page_id, buf);
+                    loaded_page_id = page_id;
+                }
+                const auto* page = reinterpret_cast<const ColumnPage*>(buf);
+                values[i][c] = page->GetValue(rows[i] - page->GetFirstRow(), schema_.GetColumn(c).GetType());
+            }
+        }
+
+        std::vector<Tuple> results;
+        results.reserve(rows.size());
+        for (auto& row_values : values) {
+            results.emplace_back(std::move(row_values));
+            FetchOverflow(results.back());
+        }
+        rids = std::move(found_rids);
+        return results;
+    }
+
+    std::vector<Tuple> ParallelScan(const std::vector<bool>& projection,
+                                    const std::function<bool(const Tuple&)>& predicate,
+                                    TaskScheduler* scheduler, size_t parallelism,
+                                    std::vector<RID>* rids = nullptr,
+                                    const std::function<bool(page_id_t)>& page_filter = nullptr) override {
+        struct MorselResult {
+            std::vector<Tuple> tuples;
+            std::vector<RID> rids;
+        };
+        std::vector<MorselResult> morsel_results;
+        std::mutex results_mutex;
+
+        ForEachMorsel(projection, page_filter, scheduler, parallelism, [&](size_t /*worker*/, size_t morsel,
+                                                                           std::vector<Tuple>& tuples,
+                                                                           const std::vector<RID>& morsel_rids) {
+            MorselResult local;
+            for (size_t i = 0; i < tuples.size(); ++i) {
+                if (predicate && !predicate(tuples[i])) continue;
+                local.tuples.push_back(std::move(tuples[i]));
+                if (rids) local.rids.push_back(morsel_rids[i]);
+            }
+            std::lock_guard<std::mutex> guard(results_mutex);
+            if (morsel_results.size() <= morsel) morsel_results.resize(morsel + 1);
+            morsel_results[morsel] = std::move(local);
+        });
+
+        std::vector<Tuple> results;
+        for (auto& part : morsel_results) {
+            results.insert(results.end(), std::make_move_iterator(part.tuples.begin()),
+                           std::make_move_iterator(part.tuples.end()));
+            if (rids) rids->insert(rids->end(), part.rids.begin(), part.rids.end());
+        }
+        return results;
+    }
+
+    void ParallelForEach(const std::vector<bool>& projection,
+                         const std::function<bool(const Tuple&)>& predicate,
+                         TaskScheduler* scheduler, size_t parallelism,
+                         const std::function<void(size_t, const RID&, Tuple&&)>& consume,
+                         const std::function<bool(page_id_t)>& page_filter = nullptr) override {
+        ForEachMorsel(projection, page_filter, scheduler, parallelism, [&](size_t worker, size_t /*morsel*/,
+                                                                           std::vector<Tuple>& tuples,
+                                                                           const std::vector<RID>& morsel_rids) {
+            for (size_t i = 0; i < tuples.size(); ++i) {
+                if (predicate && !predicate(tuples[i])) continue;
+                consume(worker, morsel_rids[i], std::move(tuples[i]));
+            }
+        });
+    }
+
+    // From the row map alone; no column is read
+    size_t CountTuples(TaskScheduler* /*scheduler*/ = nullptr, size_t /*parallelism*/ = 1) override {
+        size_t live = 0;
+        for (uint32_t row = 0; row < row_count_; ++row) {
+            if (!IsDeleted(row)) live++;
+        }
+        return live;
+    }
+
+    bool MarkDelete(const RID& rid) override {
+        uint32_t row = 0;
+        if (!ResolveRow(rid, row)) return false;
+        size_t map = row / RowMapPage::ROWS;
+        RowMap(map)->SetDeleted(row % RowMapPage::ROWS);
+        disk_manager_->WritePage(row_map_ids_[map], row_maps_[map].get());
+        return true;
+    }
+
+    // Deletes the row and appends the new version, moving `rid` to it
+    bool UpdateTuple(const Tuple& tuple, RID& rid) override {
+        if (tuple.GetValueCount() != schema_.GetColumnCount()) return false;
+        if (!MarkDelete(rid)) return false;
+        return InsertTuple(tuple, &rid);
+    }
+
+    // Empties the table; the chains are kept and refilled from their first pages
+    size_t Truncate() override {
+        size_t removed = CountTuples();
+        for (uint32_t c = 0; c < schema_.GetColumnCount(); ++c) {
+            disk_manager_->ReadPage(first_pages_[c], tails_[c].get());
+            page_id_t next_page_id = Tail(c)->GetNextPageId();
+            std::memset(tails_[c].get(), 0, PAGE_SIZE);
+            Tail(c)->Init(next_page_id, 0);
+            disk_manager_->WritePage(first_pages_[c], tails_[c].get());
+            last_pages_[c] = first_pages_[c];
+            directories_[c].clear();
+            directory_built_[c] = false;
+        }
+        for (size_t map = 0; map < row_maps_.size(); ++map) {
+            RowMapPage* page = RowMap(map);
+            page->Init(page->GetNextPageId(), static_cast<uint32_t>(map * RowMapPage::ROWS));
+            disk_manager_->WritePage(row_map_ids_[map], row_maps_[map].get());
+        }
+        row_count_ = 0;
+        WriteHeader();
+        return removed;
+    }
+
+private:
+    ColumnPage* Tail(uint32_t column) { return reinterpret_cast<ColumnPage*>(tails_[column].get()); }
+    RowMapPage* RowMap(size_t map) { return reinterpret_cast<RowMapPage*>(row_maps_[map].get()); }
+    const RowMapPage* RowMap(size_t map) const { return reinterpret_cast<const RowMapPage*>(row_maps_[map].get()); }
+
+    bool IsDeleted(uint32_t row) const {
+        return RowMap(row / RowMapPage::ROWS)->IsDeleted(row % RowMapPage::ROWS);
+    }
+
+    // The row a RID names; false if it names none or a deleted one
+    bool ResolveRow(const RID& rid, uint32_t& row) const {
+        auto it = row_map_index_.find(rid.GetPageId());
+        if (it == row_map_index_.end() || rid.GetSlotNum() >= RowMapPage::ROWS) return false;
+        row = static_cast<uint32_t>(it->second * RowMapPage::ROWS + rid.GetSlotNum());
+        return row < row_count_ && !IsDeleted(row);
+    }
+
+    void LoadRowMapPage(page_id_t page_id) {
+        row_maps_.emplace_back(new char[PAGE_SIZE]);
+        disk_manager_->ReadPage(page_id, row_maps_.back().get());
+        row_map_index_[page_id] = row_maps_.size() - 1;
+        row_map_ids_.push_back(page_id);
+    }
+
+    // Links a new row map page for rows from `first_row` to the end of the row map
+    void AddRowMapPage(uint32_t first_row) {
+        page_id_t page_id = disk_manager_->AllocatePage();
+        RowMap(row_maps_.size() - 1)->SetNextPageId(page_id);
+        disk_manager_->WritePage(row_map_ids_.back(), row_maps_.back().get());
+        char buf[PAGE_SIZE];
+        std::memset(buf, 0, PAGE_SIZE);
+        reinterpret_cast<RowMapPage*>(buf)->Init(-1, first_row);
+        disk_manager_->WritePage(page_id, buf);
+        LoadRowMapPage(page_id);
+    }
+
+    // Appends the value of `row` to column `column`, moving on to the next page of the
+    // chain (reused after a Truncate, otherwise a new one) when the last one is full
+    void AppendValue(uint32_t column, uint32_t row, const Value& value) {
+        ColumnPage* tail = Tail(column);
+        if (!tail->Append(value)) {
+            page_id_t next_page_id = tail->GetNextPageId();
+            page_id_t after_next = -1;
+            if (next_page_id == -1) {
+                next_page_id = disk_manager_->AllocatePage();
+                tail->SetNextPageId(next_page_id);
+            } else {
+                char buf[PAGE_SIZE];
+                disk_manager_->ReadPage(next_page_id, buf);
+                after_next = reinterpret_cast<const ColumnPage*>(buf)->GetNextPageId();
+            }
+            disk_manager_->WritePage(last_pages_[column], tails_[column].get());
+            std::memset(tails_[column].get(), 0, PAGE_SIZE);
+            tail->Init(after_next, row);
+            tail->Append(value);
+            last_pages_[column] = next_page_id;
+            if (directory_built_[column]) directories_[column].emplace_back(row, next_page_id);
+        }
+        disk_manager_->WritePage(last_pages_[column], tails_[column].get());
+    }
+
+    void WriteHeader() {
+        char buf[PAGE_SIZE];
+        std::memset(buf, 0, PAGE_SIZE);
+        auto* header = reinterpret_cast<ColumnarHeaderPage*>(buf);
+        header->Init(schema_.GetColumnCount(), row_map_ids_.front());
+        header->SetRowCount(row_count_);
+        for (uint32_t c = 0; c < schema_.GetColumnCount(); ++c) header->SetChain(c, first_pages_[c], last_pages_[c]);
+        disk_manager_->WritePage(first_page_id_, buf);
+    }
+
+    // (first row, page) of every page of a column chain, in chain order
+    const std::vector<std::pair<uint32_t, page_id_t>>& Directory(uint32_t column) {
+        std::lock_guard<std::mutex> guard(directory_mutex_);
+        if (!directory_built_[column]) {
+            auto& directory = directories_[column];
+            directory.clear();
+            char buf[PAGE_SIZE];
+            page_id_t page_id = first_pages_[column];
+            while (true) {
+                disk_manager_->ReadPage(page_id, buf);
+                const auto* page = reinterpret_cast<const ColumnPage*>(buf);
+                directory.emplace_back(page->GetFirstRow(), page_id);
+                if (page_id == last_pages_[column]) break;
+                page_id = page->GetNextPageId();
+            }
+            directory_built_[column] = true;
+        }
+        return directories_[column];
+    }
+
+    // Hands out the rows in morsels of MORSEL_ROWS. fn(worker, morsel, tuples, rids)
+    // receives the live rows of a morsel, in row order, with the projected columns
+    // decoded (and fetched from overflow chains) and the others INVALID.
+    void ForEachMorsel(const std::vector<bool>& projection, const std::function<bool(page_id_t)>& page_filter,
+                       TaskScheduler* scheduler, size_t parallelism,
+                       const std::function<void(size_t, size_t, std::vector<Tuple>&, const std::vector<RID>&)>& fn) {
+        std::vector<uint32_t> columns;
+        for (uint32_t c = 0; c < schema_.GetColumnCount(); ++c) {
+            if (projection.empty() || projection[c]) columns.push_back(c);
+        }
+        // Per projected column, the page holding the next unclaimed rows
+        std::vector<std::vector<char>> cursors(columns.size(), std::vector<char>(PAGE_SIZE));
+        std::vector<page_id_t> cursor_ids(columns.size(), -1);
+        std::mutex cursor_mutex;
+        uint32_t next_row = 0;
+        size_t next_morsel = 0;
+        const uint32_t row_count = row_count_;
+
+        auto worker = [&](size_t worker_id) {
+            // Per projected column, copies of the pages holding the morsel's rows
+            std::vector<std::vector<char>> pages(columns.size());
+            std::vector<Value> values;
+            while (true) {
+                uint32_t begin = 0, end = 0;
+                size_t morsel = 0;
+                bool skip = false;
+                {
+                    std::lock_guard<std::mutex> guard(cursor_mutex);
+                    if (next_row >= row_count) return;
+                    begin = next_row;
+                    end = std::min(begin + MORSEL_ROWS, row_count);
+                    next_row = end;
+                    morsel = next_morsel++;
+                    skip = page_filter && !page_filter(row_map_ids_[begin / RowMapPage::ROWS]);
+                    for (size_t k = 0; k < columns.size() && !skip; ++k) {
+                        char* cursor = cursors[k].data();
+                        const auto* page = reinterpret_cast<const ColumnPage*>(cursor);
+                        if (cursor_ids[k] == -1) {
+                            cursor_ids[k] = first_pages_[columns[k]];
+                            disk_manager_->ReadPage(cursor_ids[k], cursor);
+                        }
+                        while (page->GetEndRow() <= begin && page->GetNextPageId() != -1) {
+                            cursor_ids[k] = page->GetNextPageId();
+                            disk_manager_->ReadPage(cursor_ids[k], cursor);
+                        }
+                        pages[k].clear();
+                        while (true) {
+                            pages[k].insert(pages[k].end(), cursor, cursor + PAGE_SIZE);
+                            if (page->GetEndRow() >= end || page->GetNextPageId() == -1) break;
+                            cursor_ids[k] = page->GetNextPageId();
+                            disk_manager_->ReadPage(cursor_ids[k], cursor);
+                        }
+                    }
+                }
+                std::vector<Tuple> tuples;
+                std::vector<RID> rids;
+                if (!skip) {
+                    // Column at a time: values[(row - begin) * column count + column]
+                    values.assign(static_cast<size_t>(end - begin) * schema_.GetColumnCount(), Value());
+                    for (size_t k = 0; k < columns.size(); ++k) {
+                        TypeID type = schema_.GetColumn(columns[k]).GetType();
+                        for (size_t offset = 0; offset < pages[k].size(); offset += PAGE_SIZE) {
+                            const auto* page = reinterpret_cast<const ColumnPage*>(pages[k].data() + offset);
+                            uint32_t first = std::max(begin, page->GetFirstRow());
+                            uint32_t last = std::min(end, page->GetEndRow());
+                            for (uint32_t row = first; row < last; ++row) {
+                                values[static_cast<size_t>(row - begin) * schema_.GetColumnCount() + columns[k]] =
+                                    page->GetValue(row - page->GetFirstRow(), type);
+                            }
+                        }
+                    }
+                    for (uint32_t row = begin; row < end; ++row) {
+                        if (IsDeleted(row)) continue;
+                        auto first = values.begin() + static_cast<size_t>(row - begin) * schema_.GetColumnCount();
+                        tuples.emplace_back(std::vector<Value>(std::make_move_iterator(first),
+                                                               std::make_move_iterator(first + schema_.GetColumnCount())));
+                        FetchOverflow(tuples.back());
+                        rids.emplace_back(row_map_ids_[row / RowMapPage::ROWS], row % RowMapPage::ROWS);
+                    }
+                }
+                fn(worker_id, morsel, tuples, rids);
+            }
+        };
+
+        if (scheduler == nullptr || parallelism <= 1) {
+            worker(0);
+            return;
+        }
+        TaskGroup group(scheduler);
+        for (size_t i = 0; i < parallelism; ++i) {
+            group.Run([&worker, i]() { worker(i); });
+        }
+        group.Wait();
+    }
+
+    uint32_t row_count_ = 0;
+    std::vector<page_id_t> first_pages_;
+    std::vector<page_id_t> last_pages_;
+    std::vector<std::unique_ptr<char[]>> tails_; // Last page of every column, as on disk
+    std::vector<page_id_t> row_map_ids_;
+    std::vector<std::unique_ptr<char[]>> row_maps_;
+    std::unordered_map<page_id_t, size_t> row_map_index_;
+    std::vector<std::vector<std::pair<uint32_t, page_id_t>>> directories_;
+    std::vector<bool> directory_built_;
+    std::mutex directory_mutex_;
+};
+
+} // namespace mydb
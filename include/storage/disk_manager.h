@@ -31,6 +31,14 @@ public:
      */
     void ReadPage(page_id_t page_id, char* page_data);
 
+    /**
+     * Allocate a fresh page at the end of the database file.
+     * Ids are handed out from an in-memory counter (seeded from the file size) so two
+     * allocations made before either page is written never collide.
+     * @return id of the new page
+     */
+    page_id_t AllocatePage();
+
     /**
      * Shutdown the disk manager and close all files.
      */
@@ -41,10 +49,17 @@ public:
      */
     int GetFileSize(const std::string& file_name);
 
+    /**
+     * Number of ReadPage calls since the disk manager was opened.
+     */
+    uint64_t GetNumReads();
+
 private:
     std::string file_name_;
     std::fstream db_io_;
     std::mutex db_io_mutex_; 
+    page_id_t next_page_id_ = -1;
+    uint64_t num_reads_ = 0;
 };
 
 } // namespace mydb
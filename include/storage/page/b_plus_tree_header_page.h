@@ -0,0 +1,31 @@
+#pragma once
+
+#include "common/config.h"
+
+namespace mydb {
+
+/**
+ * First page of every index. The root moves whenever the tree grows or shrinks,
+ * so the catalog records this page instead and the current root id lives here.
+ *
+ * Format: | RootPageId (4) | Unique (4) |
+ */
+class BPlusTreeHeaderPage {
+public:
+    void Init(bool unique = true) {
+        root_page_id_ = -1;
+        unique_ = unique ? 1 : 0;
+    }
+
+    page_id_t GetRootPageId() const { return root_page_id_; }
+    void SetRootPageId(page_id_t root_page_id) { root_page_id_ = root_page_id; }
+
+    // Non-unique trees (secondary indexes) keep one entry per (key, RID)
+    bool IsUnique() const { return unique_ != 0; }
+
+private:
+    page_id_t root_page_id_;
+    int32_t unique_;
+};
+
+} // namespace mydb
@@ -1,43 +1,95 @@
 #pragma once
 
 #include "storage/page/b_plus_tree_page.h"
+#include "storage/disk_manager.h"
 #include "type/type_id.h"
+#include "index/index_key.h"
 
 namespace mydb {
 
-#define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage
+#define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, KeyComparator>
 #define INTERNAL_PAGE_HEADER_SIZE 24
-#define INTERNAL_PAGE_SIZE ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(std::pair<int, int>)))
 
 /**
  * Store n keys and n+1 child pointers (page_id).
- * Key type: int (Phase 2 requirement simplified)
+ * Key type: KeyType, ordered by KeyComparator (509 int keys per page)
  * Value type: page_id_t
  * 
  * note: The first key is invalid (or ignored), it acts as a router.
+ *
+ * With string keys the page is stored compressed like a leaf page (the unused first
+ * key is not stored); separators pushed up from leaves are already cut short by
+ * KeyTraits::Separator, which is what makes them compress well here.
  */
+INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
 public:
+    using MappingType = std::pair<KeyType, page_id_t>;
+    static constexpr bool COMPRESSED = KeyTraits<KeyType>::COMPRESSED;
+    static constexpr int INTERNAL_PAGE_SIZE =
+        COMPRESSED ? 2 * ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE - COMPRESSED_HEADER_SIZE) /
+                          (sizeof(KeyType) + sizeof(page_id_t)))
+                   : (PAGE_SIZE - EntryArrayOffset(INTERNAL_PAGE_HEADER_SIZE, alignof(MappingType))) / sizeof(MappingType);
+    // Bytes of the page in memory
+    static constexpr int NODE_SIZE =
+        COMPRESSED ? EntryArrayOffset(INTERNAL_PAGE_HEADER_SIZE, alignof(MappingType)) +
+                         INTERNAL_PAGE_SIZE * sizeof(MappingType)
+                   : PAGE_SIZE;
+    static constexpr int MinSize(int max_size) { return COMPRESSED ? max_size / 4 : max_size / 2; }
+
     void Init(page_id_t page_id, page_id_t parent_id = -1, int max_size = INTERNAL_PAGE_SIZE);
 
-    int KeyAt(int index) const;
-    void SetKeyAt(int index, int key);
+    // As in BPlusTreeLeafPage
+    int GetMinSize() const { return MinSize(GetMaxSize()); }
+    bool IsOverfull() const;
+    // Whether merging `right` in (middle_key taking the place of its unused first key)
+    // would leave this page writable
+    bool CanAbsorb(const BPlusTreeInternalPage *right, const KeyType &middle_key) const;
+    // Size of the page image holding entries[0, count)
+    static int EncodedSize(const MappingType *entries, int count);
+    void Encode(char *page) const;
+    static void Decode(const char *page, char *node);
+
+    KeyType KeyAt(int index) const;
+    void SetKeyAt(int index, const KeyType &key);
     
     page_id_t ValueAt(int index) const;
     void SetValueAt(int index, page_id_t value);
 
     int ValueIndex(page_id_t value) const;
-    page_id_t Lookup(const int &key, const int &comparator) const;
+    page_id_t Lookup(const KeyType &key, const KeyComparator &comparator) const;
+    // Leftmost child that can hold key; with duplicate keys equal entries may
+    // sit on both sides of a separator
+    page_id_t LookupFirst(const KeyType &key, const KeyComparator &comparator) const;
+
+    // Root growth: [old_value, (new_key, new_value)]
+    void PopulateNewRoot(const page_id_t &old_value, const KeyType &new_key, const page_id_t &new_value);
+    // Insert (new_key, new_value) right after the entry pointing to old_value; returns new size
+    int InsertNodeAfter(const page_id_t &old_value, const KeyType &new_key, const page_id_t &new_value);
 
     // Split & Merge utils
-    void MoveHalfTo(BPlusTreeInternalPage *recipient, char *buffer);
-    void MoveAllTo(BPlusTreeInternalPage *recipient, int index_in_parent, char *buffer);
+    // Moves the upper half of the entries to recipient and re-parents the moved children on disk.
+    // recipient->KeyAt(0) is left holding the separator to push up into the parent.
+    void MoveHalfTo(BPlusTreeInternalPage *recipient, DiskManager *disk_manager);
+    // Merge: appends every entry to recipient (the left sibling); middle_key is the parent's
+    // separator for this page and becomes the key of our first entry over there
+    void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, DiskManager *disk_manager);
+    // Redistribute: lend one entry to a sibling, rotating middle_key through the parent
+    void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key, DiskManager *disk_manager);
+    void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key, DiskManager *disk_manager);
+
+    // Delete
+    void Remove(int index);
+    // Root shrink: the single remaining child of an otherwise empty root
+    page_id_t RemoveAndReturnOnlyChild();
 
 private:
+    void Reparent(page_id_t child_page_id, DiskManager *disk_manager) const;
+
     // Flexible array member
     // In a real implementation we might use a char array and cast it
     // Mapping: array[0].second is the pointer to the left of array[1].first
-    std::pair<int, page_id_t> array_[1]; 
+    MappingType array_[1]; 
 };
 
 } // namespace mydb
@@ -2,42 +2,91 @@
 
 #include "storage/page/b_plus_tree_page.h"
 #include "common/rid.h"
+#include "index/index_key.h"
 
 namespace mydb {
 
-#define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage
+#define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE ((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (sizeof(std::pair<int, RID>)))
 
 /**
  * Store n keys and n values (RID).
  * Linked list pointers (next/prev) leaf pages.
+ *
+ * Keys are fixed-width KeyType values ordered by KeyComparator (see index/index_key.h);
+ * LEAF_PAGE_SIZE entries fit after the header (339 for int keys).
+ *
+ * Pages with string keys are stored compressed (see KeyBytesRange) and hold up to twice
+ * what fits uncompressed, as long as the encoded page fits: they are read into a
+ * NODE_SIZE buffer with Decode and written back with Encode. Either half of a split
+ * fits even uncompressed, and such pages only underflow below a quarter of max_size.
  */
+INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
 public:
+    using MappingType = std::pair<KeyType, RID>;
+    static constexpr bool COMPRESSED = KeyTraits<KeyType>::COMPRESSED;
+    static constexpr int LEAF_PAGE_SIZE =
+        COMPRESSED ? 2 * ((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - COMPRESSED_HEADER_SIZE) / (sizeof(KeyType) + sizeof(RID)))
+                   : (PAGE_SIZE - EntryArrayOffset(LEAF_PAGE_HEADER_SIZE, alignof(MappingType))) / sizeof(MappingType);
+    // Bytes of the page in memory
+    static constexpr int NODE_SIZE =
+        COMPRESSED ? EntryArrayOffset(LEAF_PAGE_HEADER_SIZE, alignof(MappingType)) + LEAF_PAGE_SIZE * sizeof(MappingType)
+                   : PAGE_SIZE;
+    static constexpr int MinSize(int max_size) { return COMPRESSED ? max_size / 4 : max_size / 2; }
+
     void Init(page_id_t page_id, page_id_t parent_id = -1, int max_size = LEAF_PAGE_SIZE);
 
+    // Hides BPlusTreePage::GetMinSize, which does not know about compression
+    int GetMinSize() const { return MinSize(GetMaxSize()); }
+    // Whether the page has to split before it can be written
+    bool IsOverfull() const;
+    // Whether appending every entry of `right` would leave this page writable
+    bool CanAbsorb(const BPlusTreeLeafPage *right) const;
+    // Size of the page image holding entries[0, count)
+    static int EncodedSize(const MappingType *entries, int count);
+
+    // Page image (PAGE_SIZE) <-> page in memory (NODE_SIZE)
+    void Encode(char *page) const;
+    static void Decode(const char *page, char *node);
+
     // Helpers
     page_id_t GetNextPageId() const;
     void SetNextPageId(page_id_t next_page_id);
 
-    int KeyAt(int index) const;
+    KeyType KeyAt(int index) const;
     RID ValueAt(int index) const;
-    const std::pair<int, RID> &GetItem(int index);
+    const MappingType &GetItem(int index);
 
-    // Insert
-    int Insert(const int &key, const RID &value, const int &comparator);
+    // Insert; a non-unique insert goes after any entries with the same key.
+    // Returns the new size, or 0 if unique and the key already exists
+    int Insert(const KeyType &key, const RID &value, const KeyComparator &comparator, bool unique = true);
     
-    // Split
+    // Delete: returns the size after removal (unchanged if the key is absent)
+    int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
+    // Delete the exact (key, value) entry of a non-unique page
+    int RemoveAndDeleteRecord(const KeyType &key, const RID &value, const KeyComparator &comparator);
+
+    // Bulk load: fills an empty page with `count` sorted entries
+    void CopyNFrom(const MappingType *items, int count);
+
+    // Split: moves the upper half of the entries to recipient
     void MoveHalfTo(BPlusTreeLeafPage *recipient);
+    // Merge: appends every entry to recipient (the left sibling) and unlinks this page
+    void MoveAllTo(BPlusTreeLeafPage *recipient);
+    // Redistribute: lend one entry to a sibling
+    void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+    void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
     // Look up
-    int KeyIndex(const int &key, const int &comparator) const;
-    RID Lookup(const int &key, const int &comparator) const;
+    int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+    // Index of the first entry with a key >= key (GetSize() if none)
+    int LowerBound(const KeyType &key, const KeyComparator &comparator) const;
+    RID Lookup(const KeyType &key, const KeyComparator &comparator) const;
 
 private:
     page_id_t next_page_id_;
-    std::pair<int, RID> array_[1];
+    MappingType array_[1];
 };
 
 } // namespace mydb
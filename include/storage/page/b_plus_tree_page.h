@@ -1,8 +1,12 @@
 #pragma once
 
 #include "common/config.h"
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <type_traits>
+#include <utility>
 
 namespace mydb {
 
@@ -48,4 +52,128 @@ private:
     page_id_t page_id_;
 };
 
+#define INDEX_TEMPLATE_ARGUMENTS template <typename KeyType, typename KeyComparator>
+
+// Entries of a page with a typed array start at the first offset >= header_size
+// suitably aligned for the entry type
+constexpr int EntryArrayOffset(int header_size, int alignment) {
+    return (header_size + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * Binary search over the sorted keys of entries[0, n) (entries are (key, value) pairs).
+ * Returns the index of the first entry whose key is >= key, or > key with `upper`.
+ *
+ * Branch-free: the loop runs ceil(log2 n) times for any key, and the comparison only
+ * selects the next base pointer (a conditional move), so a lookup pays no branch
+ * mispredictions on the ~500 keys of an integer page.
+ */
+template <typename Entry, typename KeyType, typename KeyComparator>
+inline int KeySearch(const Entry *entries, int n, const KeyType &key, const KeyComparator &comparator,
+                     bool upper = false) {
+    if (n <= 0) return 0;
+    const int bound = upper ? 1 : 0; // entry < key  <=>  compare(entry, key) < bound
+    const Entry *base = entries;
+    while (n > 1) {
+        int half = n / 2;
+        bool right = comparator(base[half - 1].first, key) < bound;
+        base = right ? base + half : base;
+        n -= half;
+    }
+    bool past = comparator(base->first, key) < bound;
+    return static_cast<int>(base - entries) + (past ? 1 : 0);
+}
+
+/**
+ * Prefix/suffix compression for pages whose keys have a string column
+ * (KeyTraits<K>::COMPRESSED). On disk such a page is its header followed by
+ *
+ *   | PrefixLen (2) | KeyLen (2) | Prefix bytes | Entry 0 | Entry 1 | ... |
+ *
+ * Every key shares its first PrefixLen bytes and is zero past KeyLen (strings are zero
+ * padded), so an entry keeps only key bytes [PrefixLen, KeyLen) and then its value.
+ * In memory the page is decoded back into its plain entry array, so searches are as
+ * before. Keys are compared as raw bytes here, which only decides what can be left out.
+ *
+ * KeyBytesRange accumulates the keys of a page to size its compressed form.
+ */
+constexpr int COMPRESSED_HEADER_SIZE = 4;
+
+template <typename KeyType>
+class KeyBytesRange {
+    static_assert(std::is_trivially_copyable<KeyType>::value, "keys are stored as raw bytes");
+    static constexpr int WIDTH = sizeof(KeyType);
+
+public:
+    void Add(const KeyType &key) {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&key);
+        if (count_++ == 0) {
+            std::memcpy(first_, bytes, WIDTH);
+            prefix_ = WIDTH;
+        }
+        int same = 0;
+        while (same < prefix_ && first_[same] == bytes[same]) ++same;
+        prefix_ = same;
+        int length = WIDTH;
+        while (length > length_ && bytes[length - 1] == 0) --length;
+        length_ = length;
+    }
+
+    int Prefix() const { return std::min(prefix_, length_); }
+    int Length() const { return length_; }
+    // Bytes taken by the codec header, the prefix and the keys
+    int Bytes() const { return COMPRESSED_HEADER_SIZE + Prefix() + count_ * (length_ - Prefix()); }
+
+private:
+    unsigned char first_[WIDTH];
+    int count_ = 0;
+    int prefix_ = 0;
+    int length_ = 0;
+};
+
+// Writes entries[0, n) to out as laid out above; the keys of entries before first_key
+// are not stored (the unused key 0 of an internal page). Returns the bytes written.
+template <typename KeyType, typename ValueType>
+int CompressEntries(const std::pair<KeyType, ValueType> *entries, int n, int first_key, char *out) {
+    KeyBytesRange<KeyType> range;
+    for (int i = first_key; i < n; ++i) range.Add(entries[i].first);
+    uint16_t prefix = static_cast<uint16_t>(range.Prefix());
+    uint16_t length = static_cast<uint16_t>(range.Length());
+    char *pos = out;
+    std::memcpy(pos, &prefix, 2);
+    std::memcpy(pos + 2, &length, 2);
+    pos += COMPRESSED_HEADER_SIZE;
+    if (first_key < n) std::memcpy(pos, &entries[first_key].first, prefix);
+    pos += prefix;
+    for (int i = 0; i < n; ++i) {
+        if (i >= first_key) {
+            std::memcpy(pos, reinterpret_cast<const char *>(&entries[i].first) + prefix, length - prefix);
+            pos += length - prefix;
+        }
+        std::memcpy(pos, &entries[i].second, sizeof(ValueType));
+        pos += sizeof(ValueType);
+    }
+    return static_cast<int>(pos - out);
+}
+
+template <typename KeyType, typename ValueType>
+void DecompressEntries(const char *in, std::pair<KeyType, ValueType> *entries, int n, int first_key) {
+    uint16_t prefix, length;
+    std::memcpy(&prefix, in, 2);
+    std::memcpy(&length, in + 2, 2);
+    const char *prefix_bytes = in + COMPRESSED_HEADER_SIZE;
+    const char *pos = prefix_bytes + prefix;
+    for (int i = 0; i < n; ++i) {
+        char *key = reinterpret_cast<char *>(&entries[i].first);
+        std::memset(key, 0, sizeof(KeyType));
+        if (i >= first_key) {
+            std::memcpy(key, prefix_bytes, prefix);
+            std::memcpy(key + prefix, pos, length - prefix);
+            pos += length - prefix;
+        }
+        std::memcpy(&entries[i].second, pos, sizeof(ValueType));
+        pos += sizeof(ValueType);
+    }
+}
+
 } // namespace mydb
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstring>
+#include "common/config.h"
+#include "type/value.h"
+
+namespace mydb {
+
+/**
+ * One page of a column chain of a columnar table (see ColumnarTable): the values of
+ * one column for the consecutive rows FirstRow .. FirstRow + ValueCount - 1. Values
+ * keep their usual serialized form, packed from the front of the data area in row
+ * order; their offsets grow down from the end of the page, so a page of INTEGERs
+ * holds about 680 rows.
+ *
+ * Format: | NextPageId (4) | FirstRow (4) | ValueCount (4) | DataEnd (4) |
+ *         | Values ... free space ... | Offset (2) x ValueCount, last value first |
+ */
+class ColumnPage {
+public:
+    static constexpr uint32_t HEADER_SIZE = 16;
+    static constexpr uint32_t DATA_SIZE = PAGE_SIZE - HEADER_SIZE;
+
+    void Init(page_id_t next_page_id, uint32_t first_row) {
+        next_page_id_ = next_page_id;
+        first_row_ = first_row;
+        value_count_ = 0;
+        data_end_ = 0;
+    }
+
+    page_id_t GetNextPageId() const { return next_page_id_; }
+    void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+    uint32_t GetFirstRow() const { return first_row_; }
+    uint32_t GetValueCount() const { return value_count_; }
+    // One past the last row on the page
+    uint32_t GetEndRow() const { return first_row_ + value_count_; }
+
+    // Adds the value of row GetEndRow(); false if the page has no room for it
+    bool Append(const Value &value) {
+        uint32_t size = value.GetSerializedSize();
+        if (data_end_ + size + (value_count_ + 1) * sizeof(uint16_t) > DATA_SIZE) return false;
+        value.Serialize(data_ + data_end_);
+        uint16_t offset = static_cast<uint16_t>(data_end_);
+        std::memcpy(OffsetSlot(value_count_), &offset, sizeof(uint16_t));
+        data_end_ += size;
+        value_count_++;
+        return true;
+    }
+
+    // The value of row GetFirstRow() + index
+    Value GetValue(uint32_t index, TypeID type) const {
+        uint16_t offset;
+        std::memcpy(&offset, OffsetSlot(index), sizeof(uint16_t));
+        return Value::Deserialize(data_ + offset, type);
+    }
+
+private:
+    char *OffsetSlot(uint32_t index) { return data_ + DATA_SIZE - (index + 1) * sizeof(uint16_t); }
+    const char *OffsetSlot(uint32_t index) const { return data_ + DATA_SIZE - (index + 1) * sizeof(uint16_t); }
+
+    page_id_t next_page_id_;
+    uint32_t first_row_;
+    uint32_t value_count_;
+    uint32_t data_end_;
+    char data_[DATA_SIZE];
+};
+
+} // namespace mydb
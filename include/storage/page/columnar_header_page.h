@@ -0,0 +1,45 @@
+#pragma once
+
+#include "common/config.h"
+
+namespace mydb {
+
+/**
+ * First page of a columnar table, the page the catalog records as its root: the row
+ * count, the first page of the row map and the first and last page of every column
+ * chain (see ColumnarTable).
+ *
+ * Format: | RowCount (4) | ColumnCount (4) | RowMapPageId (4) |
+ *         | (FirstPageId (4), LastPageId (4)) x ColumnCount |
+ */
+class ColumnarHeaderPage {
+public:
+    static constexpr uint32_t HEADER_SIZE = 12;
+    static constexpr uint32_t MAX_COLUMNS = (PAGE_SIZE - HEADER_SIZE) / (2 * sizeof(page_id_t));
+
+    void Init(uint32_t column_count, page_id_t row_map_page_id) {
+        row_count_ = 0;
+        column_count_ = column_count;
+        row_map_page_id_ = row_map_page_id;
+    }
+
+    uint32_t GetRowCount() const { return row_count_; }
+    void SetRowCount(uint32_t row_count) { row_count_ = row_count; }
+    uint32_t GetColumnCount() const { return column_count_; }
+    page_id_t GetRowMapPageId() const { return row_map_page_id_; }
+
+    page_id_t GetFirstPageId(uint32_t column) const { return chains_[2 * column]; }
+    page_id_t GetLastPageId(uint32_t column) const { return chains_[2 * column + 1]; }
+    void SetChain(uint32_t column, page_id_t first_page_id, page_id_t last_page_id) {
+        chains_[2 * column] = first_page_id;
+        chains_[2 * column + 1] = last_page_id;
+    }
+
+private:
+    uint32_t row_count_;
+    uint32_t column_count_;
+    page_id_t row_map_page_id_;
+    page_id_t chains_[2 * MAX_COLUMNS];
+};
+
+} // namespace mydb
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include "storage/page/b_plus_tree_page.h"
+#include "common/rid.h"
+
+namespace mydb {
+
+#define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, KeyComparator>
+#define HASH_BUCKET_PAGE_HEADER_SIZE 8
+
+/**
+ * Bucket of an extendible hash index: (key, RID) entries in no particular order.
+ * A bucket that cannot split any further (its keys all share one hash, e.g. many rows
+ * with the same key) continues in overflow pages linked through NextPageId.
+ *
+ * Format: | Size (4) | NextPageId (4) | (KeyType, RID) x BUCKET_SIZE |
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class HashTableBucketPage {
+public:
+    using MappingType = std::pair<KeyType, RID>;
+    static constexpr int BUCKET_SIZE =
+        (PAGE_SIZE - EntryArrayOffset(HASH_BUCKET_PAGE_HEADER_SIZE, alignof(MappingType))) / sizeof(MappingType);
+
+    void Init();
+
+    int GetSize() const { return size_; }
+    bool IsFull() const { return size_ == BUCKET_SIZE; }
+    page_id_t GetNextPageId() const { return next_page_id_; }
+    void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+    KeyType KeyAt(int index) const;
+    RID ValueAt(int index) const;
+    const MappingType &GetItem(int index) const;
+
+    // Appends the RIDs of every entry with this key
+    void GetValues(const KeyType &key, const KeyComparator &comparator, std::vector<RID> &result) const;
+    // Index of the exact (key, value) entry, or -1
+    int EntryIndex(const KeyType &key, const RID &value, const KeyComparator &comparator) const;
+
+    // Appends an entry; false if the bucket is full
+    bool Insert(const KeyType &key, const RID &value);
+    // Removes the entry at index, filling the hole with the last entry
+    void RemoveAt(int index);
+
+private:
+    int32_t size_;
+    page_id_t next_page_id_;
+    MappingType array_[1];
+};
+
+} // namespace mydb
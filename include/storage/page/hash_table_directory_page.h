@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include "common/config.h"
+
+namespace mydb {
+
+/**
+ * Directory of an extendible hash index. Slot i, the low GlobalDepth bits of a hash,
+ * points at a bucket page. A bucket of local depth d <= GlobalDepth is shared by the
+ * 2^(GlobalDepth - d) slots that agree on their low d bits; splitting it raises d and
+ * hands half of those slots to a new bucket, doubling the directory first if d was
+ * already GlobalDepth.
+ *
+ * Format: | MaxDepth (4) | GlobalDepth (4) | LocalDepths (1 x 2^MAX_DEPTH) | BucketPageIds (4 x 2^MAX_DEPTH) |
+ */
+class HashTableDirectoryPage {
+public:
+    static constexpr uint32_t MAX_DEPTH = 9;
+
+    // A directory of one slot pointing at bucket_page_id
+    void Init(page_id_t bucket_page_id, uint32_t max_depth = MAX_DEPTH);
+
+    uint32_t HashToBucketIndex(uint32_t hash) const { return hash & GetGlobalDepthMask(); }
+
+    page_id_t GetBucketPageId(uint32_t bucket_index) const;
+    void SetBucketPageId(uint32_t bucket_index, page_id_t bucket_page_id);
+
+    uint32_t GetMaxDepth() const { return max_depth_; }
+    uint32_t GetGlobalDepth() const { return global_depth_; }
+    uint32_t GetGlobalDepthMask() const { return (1u << global_depth_) - 1; }
+    uint32_t Size() const { return 1u << global_depth_; }
+
+    uint32_t GetLocalDepth(uint32_t bucket_index) const;
+    void SetLocalDepth(uint32_t bucket_index, uint32_t local_depth);
+
+    // Slot that the bucket at bucket_index was split from (or would merge with): the
+    // same low bits up to its local depth, with the highest of them flipped
+    uint32_t GetSplitImageIndex(uint32_t bucket_index) const;
+
+    // Doubles the directory; the new upper half mirrors the lower half
+    void IncrGlobalDepth();
+    void DecrGlobalDepth();
+    // True if no bucket uses every bit of the global depth, so the directory can halve
+    bool CanShrink() const;
+
+private:
+    uint32_t max_depth_;
+    uint32_t global_depth_;
+    uint8_t local_depths_[1u << MAX_DEPTH];
+    page_id_t bucket_page_ids_[1u << MAX_DEPTH];
+};
+
+static_assert(sizeof(HashTableDirectoryPage) <= PAGE_SIZE, "hash directory must fit a page");
+
+} // namespace mydb
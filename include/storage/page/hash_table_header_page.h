@@ -0,0 +1,41 @@
+#pragma once
+
+#include "common/config.h"
+
+namespace mydb {
+
+/**
+ * First page of a hash index, and the page the catalog records. The top MaxDepth bits
+ * of a key's hash pick one of up to 2^MaxDepth directory pages, each created the first
+ * time a key lands on it (-1 until then).
+ *
+ * Format: | MaxDepth (4) | DirectoryPageIds (4 x 2^MaxDepth) |
+ */
+class HashTableHeaderPage {
+public:
+    static constexpr uint32_t MAX_DEPTH = 9;
+
+    void Init(uint32_t max_depth = MAX_DEPTH) {
+        max_depth_ = max_depth;
+        for (uint32_t i = 0; i < MaxSize(); ++i) directory_page_ids_[i] = -1;
+    }
+
+    uint32_t HashToDirectoryIndex(uint32_t hash) const {
+        return max_depth_ == 0 ? 0 : hash >> (32 - max_depth_);
+    }
+
+    page_id_t GetDirectoryPageId(uint32_t directory_index) const { return directory_page_ids_[directory_index]; }
+    void SetDirectoryPageId(uint32_t directory_index, page_id_t page_id) {
+        directory_page_ids_[directory_index] = page_id;
+    }
+
+    uint32_t MaxSize() const { return 1u << max_depth_; }
+
+private:
+    uint32_t max_depth_;
+    page_id_t directory_page_ids_[1u << MAX_DEPTH];
+};
+
+static_assert(sizeof(HashTableHeaderPage) <= PAGE_SIZE, "hash header must fit a page");
+
+} // namespace mydb
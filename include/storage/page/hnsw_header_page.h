@@ -0,0 +1,65 @@
+#pragma once
+
+#include "common/config.h"
+
+namespace mydb {
+
+/**
+ * First page of an HNSW index, the page the catalog records. It holds the build
+ * parameters and where the graph starts; the nodes and their links live in two
+ * PageSummaryMaps, created with the first node (the dimension count fixes the node
+ * size).
+ *
+ * Format: | Dims (4) | M (4) | EfConstruction (4) | Metric (4) | EntryPoint (4) |
+ *         | MaxLevel (4) | NodeCount (4) | NodesPageId (4) | LinksPageId (4) |
+ */
+class HnswHeaderPage {
+public:
+    void Init(uint32_t m, uint32_t ef_construction, uint32_t metric) {
+        dims_ = 0;
+        m_ = m;
+        ef_construction_ = ef_construction;
+        metric_ = metric;
+        entry_point_ = 0;
+        max_level_ = 0;
+        node_count_ = 0;
+        nodes_page_id_ = -1;
+        links_page_id_ = -1;
+    }
+
+    // 0 until the first node is inserted
+    uint32_t GetDims() const { return dims_; }
+    void SetDims(uint32_t dims) { dims_ = dims; }
+    uint32_t GetM() const { return m_; }
+    uint32_t GetEfConstruction() const { return ef_construction_; }
+    uint32_t GetMetric() const { return metric_; }
+
+    uint32_t GetEntryPoint() const { return entry_point_; }
+    uint32_t GetMaxLevel() const { return max_level_; }
+    void SetEntryPoint(uint32_t node, uint32_t level) {
+        entry_point_ = node;
+        max_level_ = level;
+    }
+    uint32_t GetNodeCount() const { return node_count_; }
+    void SetNodeCount(uint32_t node_count) { node_count_ = node_count; }
+
+    page_id_t GetNodesPageId() const { return nodes_page_id_; }
+    page_id_t GetLinksPageId() const { return links_page_id_; }
+    void SetMapPageIds(page_id_t nodes_page_id, page_id_t links_page_id) {
+        nodes_page_id_ = nodes_page_id;
+        links_page_id_ = links_page_id;
+    }
+
+private:
+    uint32_t dims_;
+    uint32_t m_;
+    uint32_t ef_construction_;
+    uint32_t metric_;
+    uint32_t entry_point_;
+    uint32_t max_level_;
+    uint32_t node_count_;
+    page_id_t nodes_page_id_;
+    page_id_t links_page_id_;
+};
+
+} // namespace mydb
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "common/config.h"
+
+namespace mydb {
+
+/**
+ * First page of an IVF-PQ index, the page the catalog records. It holds the build
+ * parameters, whether the quantizers are trained yet, and the first pages of the
+ * PageSummaryMaps holding the list directory, the coarse centroids and the PQ
+ * codebooks. Lists and SubVectors are 0 ("pick from the data") until training.
+ *
+ * Format: | Dims (4) | Lists (4) | SubVectors (4) | Metric (4) | Trained (4) |
+ *         | LiveCount (4) | PendingCount (4) | DirectoryPageId (4) | CentroidsPageId (4) |
+ *         | CodebooksPageId (4) |
+ */
+class IvfPqHeaderPage {
+public:
+    void Init(uint32_t lists, uint32_t sub_vectors, uint32_t metric) {
+        dims_ = 0;
+        lists_ = lists;
+        sub_vectors_ = sub_vectors;
+        metric_ = metric;
+        trained_ = 0;
+        live_count_ = 0;
+        pending_count_ = 0;
+        directory_page_id_ = -1;
+        centroids_page_id_ = -1;
+        codebooks_page_id_ = -1;
+    }
+
+    // 0 until the first vector is inserted
+    uint32_t GetDims() const { return dims_; }
+    void SetDims(uint32_t dims) { dims_ = dims; }
+    uint32_t GetLists() const { return lists_; }
+    uint32_t GetSubVectors() const { return sub_vectors_; }
+    uint32_t GetMetric() const { return metric_; }
+    bool IsTrained() const { return trained_ != 0; }
+    void SetTrained(uint32_t lists, uint32_t sub_vectors) {
+        lists_ = lists;
+        sub_vectors_ = sub_vectors;
+        trained_ = 1;
+    }
+
+    uint32_t GetLiveCount() const { return live_count_; }
+    uint32_t GetPendingCount() const { return pending_count_; }
+    void SetCounts(uint32_t live_count, uint32_t pending_count) {
+        live_count_ = live_count;
+        pending_count_ = pending_count;
+    }
+
+    page_id_t GetDirectoryPageId() const { return directory_page_id_; }
+    void SetDirectoryPageId(page_id_t page_id) { directory_page_id_ = page_id; }
+    page_id_t GetCentroidsPageId() const { return centroids_page_id_; }
+    page_id_t GetCodebooksPageId() const { return codebooks_page_id_; }
+    void SetQuantizerPageIds(page_id_t centroids_page_id, page_id_t codebooks_page_id) {
+        centroids_page_id_ = centroids_page_id;
+        codebooks_page_id_ = codebooks_page_id;
+    }
+
+private:
+    uint32_t dims_;
+    uint32_t lists_;
+    uint32_t sub_vectors_;
+    uint32_t metric_;
+    uint32_t trained_;
+    uint32_t live_count_;
+    uint32_t pending_count_;
+    page_id_t directory_page_id_;
+    page_id_t centroids_page_id_;
+    page_id_t codebooks_page_id_;
+};
+
+} // namespace mydb
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "common/config.h"
+
+namespace mydb {
+
+/**
+ * One page of an overflow chain, holding part of a VARCHAR or VECTOR value too large
+ * to stay in its heap tuple (see TableHeap). The tuple keeps the chain's first page
+ * and the value's size; the value's usual serialized bytes are split across the
+ * chain in order. A page belongs to a single value.
+ *
+ * Format: | NextPageId (4) | DataSize (4) | Data (up to CAPACITY) |
+ */
+class OverflowPage {
+public:
+    static constexpr uint32_t HEADER_SIZE = 8;
+    static constexpr uint32_t CAPACITY = PAGE_SIZE - HEADER_SIZE;
+
+    void Init(page_id_t next_page_id, uint32_t data_size) {
+        next_page_id_ = next_page_id;
+        data_size_ = data_size;
+    }
+
+    page_id_t GetNextPageId() const { return next_page_id_; }
+    uint32_t GetDataSize() const { return data_size_; }
+    char *GetData() { return data_; }
+    const char *GetData() const { return data_; }
+
+private:
+    page_id_t next_page_id_;
+    uint32_t data_size_;
+    char data_[CAPACITY];
+};
+
+} // namespace mydb
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstring>
+#include "common/config.h"
+
+namespace mydb {
+
+/**
+ * One page of a PageSummaryMap: fixed-size summaries of heap pages (a bloom filter,
+ * say), each tagged with the heap page it describes. The pages form a chain from the
+ * first one, which is the page the catalog records.
+ *
+ * Format: | NextPageId (4) | Count (4) | SummarySize (4) | (HeapPageId (4), Summary) x Count |
+ */
+class PageSummaryPage {
+public:
+    static constexpr uint32_t HEADER_SIZE = 12;
+
+    void Init(uint32_t summary_size) {
+        next_page_id_ = -1;
+        count_ = 0;
+        summary_size_ = summary_size;
+    }
+
+    page_id_t GetNextPageId() const { return next_page_id_; }
+    void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+    uint32_t GetCount() const { return count_; }
+    uint32_t GetSummarySize() const { return summary_size_; }
+    uint32_t MaxCount() const { return (PAGE_SIZE - HEADER_SIZE) / EntrySize(); }
+    bool IsFull() const { return count_ >= MaxCount(); }
+
+    page_id_t HeapPageIdAt(uint32_t index) const {
+        page_id_t heap_page_id;
+        std::memcpy(&heap_page_id, entries_ + index * EntrySize(), sizeof(page_id_t));
+        return heap_page_id;
+    }
+    char *SummaryAt(uint32_t index) { return entries_ + index * EntrySize() + sizeof(page_id_t); }
+    const char *SummaryAt(uint32_t index) const { return entries_ + index * EntrySize() + sizeof(page_id_t); }
+
+    // Appends a zeroed summary for heap_page_id and returns its index; the page must not be full
+    uint32_t Add(page_id_t heap_page_id) {
+        char *entry = entries_ + count_ * EntrySize();
+        std::memcpy(entry, &heap_page_id, sizeof(page_id_t));
+        std::memset(entry + sizeof(page_id_t), 0, summary_size_);
+        return count_++;
+    }
+
+private:
+    uint32_t EntrySize() const { return sizeof(page_id_t) + summary_size_; }
+
+    page_id_t next_page_id_;
+    uint32_t count_;
+    uint32_t summary_size_;
+    char entries_[PAGE_SIZE - HEADER_SIZE];
+};
+
+static_assert(sizeof(PageSummaryPage) == PAGE_SIZE, "summary page must fill a page");
+
+} // namespace mydb
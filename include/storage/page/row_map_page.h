@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstring>
+#include "common/config.h"
+
+namespace mydb {
+
+/**
+ * One page of the row map of a columnar table (see ColumnarTable): a deleted flag for
+ * each of ROWS consecutive rows starting at FirstRow. A row's RID is (this page, row -
+ * FirstRow), so RIDs stay valid however the column chains are laid out.
+ *
+ * Format: | NextPageId (4) | FirstRow (4) | Deleted flags (1 bit per row) |
+ */
+class RowMapPage {
+public:
+    static constexpr uint32_t HEADER_SIZE = 8;
+    static constexpr uint32_t ROWS = (PAGE_SIZE - HEADER_SIZE) * 8;
+
+    void Init(page_id_t next_page_id, uint32_t first_row) {
+        next_page_id_ = next_page_id;
+        first_row_ = first_row;
+        std::memset(flags_, 0, sizeof(flags_));
+    }
+
+    page_id_t GetNextPageId() const { return next_page_id_; }
+    void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+    uint32_t GetFirstRow() const { return first_row_; }
+
+    bool IsDeleted(uint32_t slot) const { return (flags_[slot / 8] >> (slot % 8)) & 1; }
+    void SetDeleted(uint32_t slot) { flags_[slot / 8] |= static_cast<uint8_t>(1u << (slot % 8)); }
+
+private:
+    page_id_t next_page_id_;
+    uint32_t first_row_;
+    uint8_t flags_[PAGE_SIZE - HEADER_SIZE];
+};
+
+} // namespace mydb
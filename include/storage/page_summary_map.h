@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "storage/disk_manager.h"
+#include "storage/page/page_summary_page.h"
+
+namespace mydb {
+
+/**
+ * A fixed-size summary per heap page (see PageSummaryPage), used by scans to skip
+ * pages whose summary rules out the predicate without decoding them. All summary
+ * pages are kept in memory, about one per PAGE_SIZE / summary_size heap pages, and
+ * every change is written through to disk.
+ *
+ * Not latched: changes come from statements, which the executor runs one at a time,
+ * while any number of scan workers may read.
+ */
+class PageSummaryMap {
+public:
+    // first_page_id == -1 creates a new (empty) map, otherwise loads an existing one
+    PageSummaryMap(DiskManager *disk_manager, uint32_t summary_size, page_id_t first_page_id = -1);
+    PageSummaryMap(const PageSummaryMap&) = delete;
+    PageSummaryMap& operator=(const PageSummaryMap&) = delete;
+
+    // The summary of heap_page_id, or null if it has none yet
+    const char *Find(page_id_t heap_page_id) const;
+    // The summary of heap_page_id, added (zeroed, and *added set) if missing. Changes
+    // reach disk with WriteBack(heap_page_id), or WriteAll after many changes.
+    char *FindOrAdd(page_id_t heap_page_id, bool *added = nullptr);
+    void WriteBack(page_id_t heap_page_id);
+    void WriteAll();
+
+    bool IsEmpty() const { return locations_.empty(); }
+    uint32_t GetSummarySize() const { return summary_size_; }
+    // Page to record in the catalog; the chain only grows after it
+    page_id_t GetFirstPageId() const { return page_ids_.front(); }
+
+private:
+    struct Location {
+        uint32_t page;  // Index into page_ids_ / pages_
+        uint32_t index; // Entry on that page
+    };
+
+    PageSummaryPage *Page(uint32_t page) { return reinterpret_cast<PageSummaryPage *>(pages_[page].get()); }
+    const PageSummaryPage *Page(uint32_t page) const {
+        return reinterpret_cast<const PageSummaryPage *>(pages_[page].get());
+    }
+    void AppendPage();
+
+    DiskManager *disk_manager_;
+    uint32_t summary_size_;
+    std::vector<page_id_t> page_ids_;
+    std::vector<std::unique_ptr<char[]>> pages_;
+    std::unordered_map<page_id_t, Location> locations_;
+};
+
+} // namespace mydb
@@ -2,28 +2,78 @@
 
 #include "storage/disk_manager.h"
 #include "storage/table_page.h"
+#include "storage/zone_map.h"
+#include "storage/page/overflow_page.h"
 #include "catalog/schema.h"
+#include "common/task_scheduler.h"
+#include "common/rid.h"
 #include <memory>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <cctype>
 
 namespace mydb {
 
+// How a table lays out its rows: TableHeap's row pages, or ColumnarTable's column chains
+enum class TableStorage { ROW, COLUMNAR };
+
+inline const char* TableStorageName(TableStorage storage) {
+    return storage == TableStorage::COLUMNAR ? "COLUMNAR" : "ROW";
+}
+
+// Accepts ROW and COLUMNAR in any case
+inline bool ParseTableStorage(std::string name, TableStorage& storage) {
+    for (auto& c : name) c = std::toupper(c);
+    if (name == "ROW") storage = TableStorage::ROW;
+    else if (name == "COLUMNAR") storage = TableStorage::COLUMNAR;
+    else return false;
+    return true;
+}
+
+/**
+ * A table's rows, in a chain of TablePages. A row serializing to more than
+ * OVERFLOW_THRESHOLD bytes has its largest VARCHAR / VECTOR values moved to overflow
+ * chains (OverflowPage), largest first, until it fits; the row keeps a 12-byte
+ * reference to each. Reads fetch a moved value only when its column is projected, so
+ * scans that do not touch the large column never read its overflow pages. Chains of
+ * deleted or rewritten rows are not reused, like the rows' own bytes.
+ *
+ * The row operations are virtual so other layouts of a table (ColumnarTable) can
+ * stand in for it behind the executor.
+ */
 class TableHeap {
 public:
-    TableHeap(DiskManager* diff_manager, page_id_t first_page_id, const Schema& schema)
+    static constexpr uint32_t OVERFLOW_THRESHOLD = PAGE_SIZE / 2;
+
+    // zone_map_page_id == -1 builds the zone map from the pages (tables of older
+    // catalogs); tables without INTEGER columns have none
+    TableHeap(DiskManager* diff_manager, page_id_t first_page_id, const Schema& schema,
+              page_id_t zone_map_page_id = -1)
         : disk_manager_(diff_manager), first_page_id_(first_page_id), schema_(schema) {
-        }
-    
+        if (!ZoneMap::Applies(schema_)) return;
+        zone_map_ = std::make_unique<ZoneMap>(disk_manager_, schema_, zone_map_page_id);
+        if (zone_map_page_id == -1) RebuildZoneMap();
+    }
+    virtual ~TableHeap() = default;
+
+    virtual TableStorage GetStorage() const { return TableStorage::ROW; }
+
     page_id_t GetFirstPageId() const { return first_page_id_; }
+    // First page of the zone map, -1 if the table has none
+    page_id_t GetZoneMapPageId() const { return zone_map_ ? zone_map_->GetFirstPageId() : -1; }
+
+    // False if the zone map rules out any live tuple of page `page_id` having `column`
+    // in [low, high] (an INVALID bound is open)
+    bool PageMayMatch(page_id_t page_id, uint32_t column, const Value& low, const Value& high) const {
+        return !zone_map_ || zone_map_->PageMayMatch(page_id, column, low, high);
+    }
 
     // Create a new table heap (allocates first page)
     static std::unique_ptr<TableHeap> Create(DiskManager* disk_manager, const Schema& schema) {
-         page_id_t first_page = 0; 
-         // Find a free page (HACK: just use file size / page size for new pages, 
-         // but for the very first page of the very first table, we might overwrite 0 if not careful.
-         // Let's assume we append to end.)
-         int file_size = disk_manager->GetFileSize("mydb.db");
-         if (file_size < 0) file_size = 0;
-         first_page = file_size / PAGE_SIZE;
+         page_id_t first_page = disk_manager->AllocatePage();
 
          char buf[PAGE_SIZE];
          std::memset(buf, 0, PAGE_SIZE);
@@ -36,7 +86,296 @@ public:
          return std::make_unique<TableHeap>(disk_manager, first_page, schema);
     }
 
-    bool InsertTuple(const Tuple& tuple) {
+    // Appends the tuple to the first page with room; `rid` receives its location.
+    // False if it cannot fit a page even with its large values moved out.
+    virtual bool InsertTuple(const Tuple& tuple, RID* rid = nullptr) {
+        Tuple moved;
+        const Tuple& stored = ToStoredForm(tuple, moved);
+        if (!FitsPage(stored)) return false;
+        return InsertStored(stored, rid);
+    }
+    
+    // Full scan. `projection` flags the columns to decode (empty = all);
+    // the others come back as INVALID values and are never materialized.
+    virtual std::vector<Tuple> Scan(const std::vector<bool>& projection = {}) {
+        std::vector<Tuple> results;
+        page_id_t current_page_id = first_page_id_;
+        char buf[PAGE_SIZE];
+
+        while (current_page_id != -1) {
+             disk_manager_->ReadPage(current_page_id, buf);
+             TablePage page;
+             page.Init(current_page_id, -1, buf);
+
+             std::vector<Tuple> tuples = page.GetAllTuples(schema_, projection);
+             for (Tuple& tuple : tuples) FetchOverflow(tuple);
+             results.insert(results.end(), tuples.begin(), tuples.end());
+             
+             current_page_id = page.GetNextPageId();
+        }
+        return results;
+    }
+
+    // Point lookup of a single tuple; false if the RID is deleted or invalid
+    virtual bool GetTuple(const RID& rid, Tuple& tuple, const std::vector<bool>& projection = {}) {
+        if (rid.GetPageId() < 0) return false;
+        char buf[PAGE_SIZE];
+        disk_manager_->ReadPage(rid.GetPageId(), buf);
+        TablePage page;
+        page.Init(rid.GetPageId(), -1, buf);
+        if (!page.GetTuple(rid.GetSlotNum(), schema_, tuple, projection)) return false;
+        FetchOverflow(tuple);
+        return true;
+    }
+
+    // Batch lookup for index scans; results keep the order of `rids`. The lookups are
+    // done in page order so every page is read once. RIDs that no longer resolve are
+    // dropped from `rids`, leaving rids[i] <-> result[i].
+    virtual std::vector<Tuple> GetTuples(std::vector<RID>& rids, const std::vector<bool>& projection = {}) {
+        std::vector<size_t> order(rids.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&rids](size_t a, size_t b) {
+            if (rids[a].GetPageId() != rids[b].GetPageId()) return rids[a].GetPageId() < rids[b].GetPageId();
+            return rids[a].GetSlotNum() < rids[b].GetSlotNum();
+        });
+
+        std::vector<Tuple> fetched(rids.size());
+        std::vector<bool> found(rids.size(), false);
+        char buf[PAGE_SIZE];
+        page_id_t loaded_page_id = -1;
+        for (size_t i : order) {
+            const RID& rid = rids[i];
+            if (rid.GetPageId() < 0) continue;
+            if (rid.GetPageId() != loaded_page_id) {
+                disk_manager_->ReadPage(rid.GetPageId(), buf);
+                loaded_page_id = rid.GetPageId();
+            }
+            TablePage page;
+            page.Init(loaded_page_id, -1, buf);
+            found[i] = page.GetTuple(rid.GetSlotNum(), schema_, fetched[i], projection);
+        }
+        // After the heap pages, so their reads stay in page order
+        for (size_t i = 0; i < rids.size(); ++i) {
+            if (found[i]) FetchOverflow(fetched[i]);
+        }
+
+        std::vector<Tuple> results;
+        std::vector<RID> found_rids;
+        for (size_t i = 0; i < rids.size(); ++i) {
+            if (!found[i]) continue;
+            results.push_back(std::move(fetched[i]));
+            found_rids.push_back(rids[i]);
+        }
+        rids = std::move(found_rids);
+        return results;
+    }
+
+    // Morsel-driven parallel scan. Up to `parallelism` scheduler tasks pull batches of
+    // SCAN_MORSEL_PAGES pages off the chain, decode them with `projection` and keep
+    // the tuples accepted by `predicate` (null = all). Per-morsel results are merged
+    // in page order, so the output matches Scan() followed by a filter.
+    // When `rids` is given it receives the RID of every returned tuple, in the same order.
+    // Pages rejected by `page_filter` (null = none) are passed over without being decoded.
+    virtual std::vector<Tuple> ParallelScan(const std::vector<bool>& projection,
+                                            const std::function<bool(const Tuple&)>& predicate,
+                                            TaskScheduler* scheduler, size_t parallelism,
+                                            std::vector<RID>* rids = nullptr,
+                                            const std::function<bool(page_id_t)>& page_filter = nullptr) {
+        struct MorselResult {
+            std::vector<Tuple> tuples;
+            std::vector<RID> rids;
+        };
+        std::vector<MorselResult> morsel_results;
+        std::mutex results_mutex;
+
+        ForEachMorsel(scheduler, parallelism, [&](size_t /*worker*/, size_t morsel, char* pages,
+                                                  const page_id_t* page_ids, size_t page_count) {
+            MorselResult local;
+            std::vector<uint32_t> slots;
+            for (size_t p = 0; p < page_count; ++p) {
+                if (page_filter && !page_filter(page_ids[p])) continue;
+                TablePage page;
+                page.Init(page_ids[p], -1, pages + p * PAGE_SIZE);
+                slots.clear();
+                std::vector<Tuple> tuples = page.GetAllTuples(schema_, projection, rids ? &slots : nullptr);
+                for (size_t i = 0; i < tuples.size(); ++i) {
+                    FetchOverflow(tuples[i]);
+                    if (predicate && !predicate(tuples[i])) continue;
+                    local.tuples.push_back(std::move(tuples[i]));
+                    if (rids) local.rids.emplace_back(page_ids[p], slots[i]);
+                }
+            }
+            std::lock_guard<std::mutex> guard(results_mutex);
+            if (morsel_results.size() <= morsel) morsel_results.resize(morsel + 1);
+            morsel_results[morsel] = std::move(local);
+        });
+
+        std::vector<Tuple> results;
+        for (auto& part : morsel_results) {
+            results.insert(results.end(), std::make_move_iterator(part.tuples.begin()),
+                           std::make_move_iterator(part.tuples.end()));
+            if (rids) rids->insert(rids->end(), part.rids.begin(), part.rids.end());
+        }
+        return results;
+    }
+
+    // Streaming form of ParallelScan: every tuple accepted by `predicate` is handed to
+    // consume(worker, rid, tuple) as its page is decoded, and nothing is collected.
+    // `worker` is the scan task's index in [0, parallelism), so callers can keep
+    // per-worker state without locking; tuples arrive in no particular order.
+    virtual void ParallelForEach(const std::vector<bool>& projection,
+                                 const std::function<bool(const Tuple&)>& predicate,
+                                 TaskScheduler* scheduler, size_t parallelism,
+                                 const std::function<void(size_t, const RID&, Tuple&&)>& consume,
+                                 const std::function<bool(page_id_t)>& page_filter = nullptr) {
+        ForEachMorsel(scheduler, parallelism, [&](size_t worker, size_t /*morsel*/, char* pages,
+                                                  const page_id_t* page_ids, size_t page_count) {
+            std::vector<uint32_t> slots;
+            for (size_t p = 0; p < page_count; ++p) {
+                if (page_filter && !page_filter(page_ids[p])) continue;
+                TablePage page;
+                page.Init(page_ids[p], -1, pages + p * PAGE_SIZE);
+                slots.clear();
+                std::vector<Tuple> tuples = page.GetAllTuples(schema_, projection, &slots);
+                for (size_t i = 0; i < tuples.size(); ++i) {
+                    FetchOverflow(tuples[i]);
+                    if (predicate && !predicate(tuples[i])) continue;
+                    consume(worker, RID(page_ids[p], slots[i]), std::move(tuples[i]));
+                }
+            }
+        });
+    }
+
+    // Row count from the page headers; each worker keeps its own counter and the
+    // counters are summed once all workers are done.
+    virtual size_t CountTuples(TaskScheduler* scheduler = nullptr, size_t parallelism = 1) {
+        std::vector<size_t> counts(std::max<size_t>(parallelism, 1), 0);
+        ForEachMorsel(scheduler, parallelism, [&](size_t worker, size_t /*morsel*/, char* pages,
+                                                  const page_id_t* /*page_ids*/, size_t page_count) {
+            for (size_t p = 0; p < page_count; ++p) {
+                TablePage page;
+                page.Init(-1, -1, pages + p * PAGE_SIZE);
+                counts[worker] += page.GetLiveTupleCount();
+            }
+        });
+        size_t total = 0;
+        for (size_t c : counts) total += c;
+        return total;
+    }
+
+    // Flag a tuple as deleted. Its bytes stay on the page, so other RIDs remain valid.
+    virtual bool MarkDelete(const RID& rid) {
+        if (rid.GetPageId() < 0) return false;
+        char buf[PAGE_SIZE];
+        disk_manager_->ReadPage(rid.GetPageId(), buf);
+        TablePage page;
+        page.Init(rid.GetPageId(), -1, buf);
+        if (!page.MarkDelete(rid.GetSlotNum(), schema_)) return false;
+        disk_manager_->WritePage(rid.GetPageId(), buf);
+        if (zone_map_) zone_map_->Reset(rid.GetPageId(), page, schema_);
+        return true;
+    }
+
+    // Replace the tuple at `rid`. A same-size tuple is overwritten in place; otherwise the
+    // old version is deleted and the new one appended, and `rid` is moved to it.
+    virtual bool UpdateTuple(const Tuple& tuple, RID& rid) {
+        if (rid.GetPageId() < 0) return false;
+        Tuple moved;
+        const Tuple& stored = ToStoredForm(tuple, moved);
+        if (!FitsPage(stored)) return false;
+        char buf[PAGE_SIZE];
+        disk_manager_->ReadPage(rid.GetPageId(), buf);
+        TablePage page;
+        page.Init(rid.GetPageId(), -1, buf);
+        if (page.UpdateTupleInPlace(rid.GetSlotNum(), stored, schema_)) {
+            disk_manager_->WritePage(rid.GetPageId(), buf);
+            if (zone_map_) zone_map_->Reset(rid.GetPageId(), page, schema_);
+            return true;
+        }
+        if (!page.MarkDelete(rid.GetSlotNum(), schema_)) return false;
+        disk_manager_->WritePage(rid.GetPageId(), buf);
+        if (zone_map_) zone_map_->Reset(rid.GetPageId(), page, schema_);
+        return InsertStored(stored, &rid);
+    }
+
+    // Empty every page (the chain is kept for reuse). Returns the number of rows removed.
+    virtual size_t Truncate() {
+        size_t removed = 0;
+        page_id_t current_page_id = first_page_id_;
+        char buf[PAGE_SIZE];
+        while (current_page_id != -1) {
+            disk_manager_->ReadPage(current_page_id, buf);
+            TablePage page;
+            page.Init(current_page_id, -1, buf);
+            removed += page.GetLiveTupleCount();
+            page_id_t next_page_id = page.GetNextPageId();
+            std::memset(buf, 0, PAGE_SIZE);
+            page.InitNewPage(next_page_id);
+            disk_manager_->WritePage(current_page_id, buf);
+            if (zone_map_) zone_map_->Reset(current_page_id, page, schema_, false);
+            current_page_id = next_page_id;
+        }
+        if (zone_map_) zone_map_->WriteAll();
+        return removed;
+    }
+
+protected:
+    // For other layouts of the table, which keep no row pages and no zone map
+    struct NoRowPages {};
+    TableHeap(DiskManager* disk_manager, page_id_t first_page_id, const Schema& schema, NoRowPages)
+        : disk_manager_(disk_manager), first_page_id_(first_page_id), schema_(schema) {}
+
+    // Writes the serialization of `value` to a new overflow chain; returns its first page
+    page_id_t WriteOverflow(const Value& value) {
+        std::vector<char> data(value.GetSerializedSize());
+        value.Serialize(data.data());
+        size_t page_count = (data.size() + OverflowPage::CAPACITY - 1) / OverflowPage::CAPACITY;
+        std::vector<page_id_t> page_ids(page_count);
+        for (auto& page_id : page_ids) page_id = disk_manager_->AllocatePage();
+        char buf[PAGE_SIZE];
+        for (size_t i = 0; i < page_count; ++i) {
+            size_t offset = i * OverflowPage::CAPACITY;
+            uint32_t chunk = static_cast<uint32_t>(std::min<size_t>(OverflowPage::CAPACITY, data.size() - offset));
+            std::memset(buf, 0, PAGE_SIZE);
+            auto* page = reinterpret_cast<OverflowPage*>(buf);
+            page->Init(i + 1 < page_count ? page_ids[i + 1] : -1, chunk);
+            std::memcpy(page->GetData(), data.data() + offset, chunk);
+            disk_manager_->WritePage(page_ids[i], buf);
+        }
+        return page_ids.front();
+    }
+
+    // Replaces the overflow references among the decoded values of `tuple` (the
+    // projected columns) with the values read from their chains
+    void FetchOverflow(Tuple& tuple) {
+        for (uint32_t i = 0; i < tuple.GetValueCount(); ++i) {
+            const Value& reference = tuple.GetValue(i);
+            if (!reference.IsExternal()) continue;
+            std::vector<char> data(reference.GetExternalSize());
+            char buf[PAGE_SIZE];
+            page_id_t page_id = reference.GetExternalPageId();
+            size_t offset = 0;
+            while (page_id != -1 && offset < data.size()) {
+                disk_manager_->ReadPage(page_id, buf);
+                const auto* page = reinterpret_cast<const OverflowPage*>(buf);
+                size_t chunk = std::min<size_t>(page->GetDataSize(), data.size() - offset);
+                std::memcpy(data.data() + offset, page->GetData(), chunk);
+                offset += chunk;
+                page_id = page->GetNextPageId();
+            }
+            tuple.SetValue(i, Value::Deserialize(data.data(), reference.GetTypeId()));
+        }
+    }
+
+    DiskManager* disk_manager_;
+    page_id_t first_page_id_;
+    Schema schema_;
+
+private:
+    static constexpr size_t SCAN_MORSEL_PAGES = 8;
+
+    // Appends a tuple already in its stored form (see ToStoredForm)
+    bool InsertStored(const Tuple& tuple, RID* rid) {
         page_id_t current_page_id = first_page_id_;
         char buf[PAGE_SIZE];
         
@@ -46,16 +385,18 @@ public:
             TablePage page;
             page.Init(current_page_id, -1, buf);
             
-            if (page.InsertTuple(tuple)) {
+            uint32_t slot = 0;
+            if (page.InsertTuple(tuple, &slot)) {
                 disk_manager_->WritePage(current_page_id, buf);
+                if (zone_map_) zone_map_->Widen(current_page_id, tuple);
+                if (rid != nullptr) rid->Set(current_page_id, slot);
                 return true;
             }
             
             page_id_t next = page.GetNextPageId();
             if (next == -1) {
                 // Determine new page ID
-                int file_size = disk_manager_->GetFileSize("mydb.db");
-                page_id_t new_page_id = file_size / PAGE_SIZE;
+                page_id_t new_page_id = disk_manager_->AllocatePage();
                 
                 // Link current to new
                 page.SetNextPageId(new_page_id);
@@ -69,211 +410,108 @@ public:
                 new_page.InitNewPage();
                 
                 // Retry insert on new page
-                new_page.InsertTuple(tuple);
+                new_page.InsertTuple(tuple, &slot);
                 disk_manager_->WritePage(new_page_id, new_buf);
+                if (zone_map_) zone_map_->Widen(new_page_id, tuple);
+                if (rid != nullptr) rid->Set(new_page_id, slot);
                 return true;
             }
             current_page_id = next;
         }
     }
-    
-    // Full scan
-    std::vector<Tuple> Scan() {
-        std::vector<Tuple> results;
-        page_id_t current_page_id = first_page_id_;
-        char buf[PAGE_SIZE];
-        
-        while (current_page_id != -1) {
-             disk_manager_->ReadPage(current_page_id, buf);
-             TablePage page;
-             page.Init(current_page_id, -1, buf);
-             
-             std::vector<Tuple> tuples = page.GetAllTuples(schema_);
-             results.insert(results.end(), tuples.begin(), tuples.end());
-             
-             current_page_id = page.GetNextPageId();
-        }
-        return results;
+
+    static bool FitsPage(const Tuple& tuple) {
+        return tuple.GetSerializedSize() <= PAGE_SIZE - TablePage::HEADER_SIZE;
     }
 
-    // Delete tuples matching where col = val
-    // Returns number of deleted tuples
-    int Delete(const std::string& col_name, const std::string& op_str, const std::string& val_str) {
-        int deleted_count = 0;
-        
-        // Resolve column index
-        int col_idx = -1;
-        TypeID col_type = TypeID::INVALID;
-        
-        for (uint32_t i = 0; i < schema_.GetColumnCount(); ++i) {
-            if (schema_.GetColumn(i).GetName() == col_name) {
-                col_idx = i;
-                col_type = schema_.GetColumn(i).GetType();
-                break;
-            }
+    // The tuple as it is written to a page: itself, or (built in `moved`) a copy whose
+    // largest VARCHAR / VECTOR values went to new overflow chains until it is no larger
+    // than OVERFLOW_THRESHOLD
+    const Tuple& ToStoredForm(const Tuple& tuple, Tuple& moved) {
+        uint32_t size = tuple.GetSerializedSize();
+        if (size <= OVERFLOW_THRESHOLD) return tuple;
+        std::vector<std::pair<uint32_t, uint32_t>> candidates; // (serialized size, column)
+        std::vector<Value> values;
+        values.reserve(tuple.GetValueCount());
+        for (uint32_t i = 0; i < tuple.GetValueCount(); ++i) {
+            const Value& value = tuple.GetValue(i);
+            values.push_back(value);
+            TypeID type = value.GetTypeId();
+            if ((type != TypeID::VARCHAR && type != TypeID::VECTOR) || value.IsExternal()) continue;
+            uint32_t value_size = value.GetSerializedSize();
+            if (value_size > Value::EXTERNAL_SIZE) candidates.emplace_back(value_size, i);
         }
-        
-        if (col_idx == -1 && !col_name.empty()) {
-            return 0; // Column not found
+        std::sort(candidates.begin(), candidates.end(), std::greater<std::pair<uint32_t, uint32_t>>());
+        for (const auto& candidate : candidates) {
+            if (size <= OVERFLOW_THRESHOLD) break;
+            Value& value = values[candidate.second];
+            value = Value::External(value.GetTypeId(), WriteOverflow(value), candidate.first);
+            size -= candidate.first - Value::EXTERNAL_SIZE;
         }
+        moved = Tuple(std::move(values));
+        return moved;
+    }
 
+    void RebuildZoneMap() {
         page_id_t current_page_id = first_page_id_;
         char buf[PAGE_SIZE];
-        
         while (current_page_id != -1) {
-             disk_manager_->ReadPage(current_page_id, buf);
-             TablePage page;
-             page.Init(current_page_id, -1, buf);
-             
-             std::vector<Tuple> tuples = page.GetAllTuples(schema_);
-             std::vector<Tuple> remaining_tuples;
-             bool changed = false;
-             
-             for (const auto& tuple : tuples) {
-                 bool match = false;
-                 if (col_name.empty()) {
-                     match = true; 
-                 } else {
-                     const Value& v = tuple.GetValue(col_idx);
-                     if (v.GetTypeId() == TypeID::INTEGER) {
-                         if (std::to_string(v.GetAsInteger()) == val_str) match = true;
-                     } else {
-                         if (v.GetAsString() == val_str) match = true;
-                     }
-                     if (op_str == "!=") match = !match;
-                 }
-                 
-                 if (match) {
-                     deleted_count++;
-                     changed = true;
-                 } else {
-                     remaining_tuples.push_back(std::move(tuple));
-                 }
-             }
-             
-             if (changed) {
-                 // Rewrite page
-                 // Preserve next page id
-                 page_id_t next_page_id = page.GetNextPageId();
-                 
-                 // Clear/Init Page
-                 std::memset(buf, 0, PAGE_SIZE);
-                 page.Init(current_page_id, -1, buf); // re-init wrapper
-                 page.InitNewPage(next_page_id);
-                 
-                 // Insert remaining
-                 for (const auto& t : remaining_tuples) {
-                     page.InsertTuple(t);
-                 }
-                 
-                 disk_manager_->WritePage(current_page_id, buf);
-             }
-             
-             current_page_id = page.GetNextPageId();
-         }
-         
-         return deleted_count;
+            disk_manager_->ReadPage(current_page_id, buf);
+            TablePage page;
+            page.Init(current_page_id, -1, buf);
+            zone_map_->Reset(current_page_id, page, schema_, false);
+            current_page_id = page.GetNextPageId();
+        }
+        zone_map_->WriteAll();
     }
-    
-    // Update tuples matching where col = val
-    // Returns number of updated tuples
-    int Update(const std::string& where_col, const std::string& where_op, const std::string& where_val,
-               const std::string& set_col, const std::string& set_val) {
-        int updated_count = 0;
-        
-        // Resolve columns
-        int where_idx = -1;
-        TypeID where_type = TypeID::INVALID;
-        
-        int set_idx = -1;
-        TypeID set_type = TypeID::INVALID;
-
-        for (uint32_t i = 0; i < schema_.GetColumnCount(); ++i) {
-            std::string col = schema_.GetColumn(i).GetName();
-            if (col == where_col) {
-                where_idx = i;
-                where_type = schema_.GetColumn(i).GetType();
-            }
-            if (col == set_col) {
-                set_idx = i;
-                set_type = schema_.GetColumn(i).GetType();
+
+    // Hands out the page chain in morsels of SCAN_MORSEL_PAGES pages. The chain can only
+    // be followed by reading each page, so claiming a morsel (reading its pages into the
+    // worker's buffer) happens under a short lock; decoding and filtering run outside it.
+    // fn(worker, morsel, pages, page_ids, page_count) is called once per morsel, `worker`
+    // being the index of the scan task in [0, parallelism).
+    void ForEachMorsel(TaskScheduler* scheduler, size_t parallelism,
+                       const std::function<void(size_t, size_t, char*, const page_id_t*, size_t)>& fn) {
+        std::mutex cursor_mutex;
+        page_id_t cursor = first_page_id_;
+        size_t next_morsel = 0;
+
+        auto worker = [&](size_t worker_id) {
+            std::vector<char> pages(SCAN_MORSEL_PAGES * PAGE_SIZE);
+            page_id_t page_ids[SCAN_MORSEL_PAGES];
+            while (true) {
+                size_t morsel = 0;
+                size_t page_count = 0;
+                {
+                    std::lock_guard<std::mutex> guard(cursor_mutex);
+                    if (cursor == -1) return;
+                    morsel = next_morsel++;
+                    while (page_count < SCAN_MORSEL_PAGES && cursor != -1) {
+                        char* page_buf = pages.data() + page_count * PAGE_SIZE;
+                        disk_manager_->ReadPage(cursor, page_buf);
+                        page_ids[page_count] = cursor;
+                        TablePage page;
+                        page.Init(cursor, -1, page_buf);
+                        cursor = page.GetNextPageId();
+                        page_count++;
+                    }
+                }
+                fn(worker_id, morsel, pages.data(), page_ids, page_count);
             }
-        }
-        
-        if (set_idx == -1) return 0; // Target col not found
-        // If where_col is empty but val provided, we might have issue. 
-        // But if where_col is not empty and not found, return 0.
-        if (!where_col.empty() && where_idx == -1) return 0;
+        };
 
-        page_id_t current_page_id = first_page_id_;
-        char buf[PAGE_SIZE];
-         
-         while (current_page_id != -1) {
-             disk_manager_->ReadPage(current_page_id, buf);
-             TablePage page;
-             page.Init(current_page_id, -1, buf);
-             
-             std::vector<Tuple> tuples = page.GetAllTuples(schema_);
-             std::vector<Tuple> new_tuples;
-             bool changed = false;
-             
-             for (const auto& tuple : tuples) {
-                 bool match = false;
-                 if (where_col.empty()) {
-                     match = true;
-                 } else {
-                     const Value& v = tuple.GetValue(where_idx);
-                     if (v.GetTypeId() == TypeID::INTEGER) {
-                         if (std::to_string(v.GetAsInteger()) == where_val) match = true;
-                     } else {
-                         if (v.GetAsString() == where_val) match = true;
-                     }
-                     if (where_op == "!=") match = !match;
-                 }
-                 
-                 if (match) {
-                     // Create new tuple with updated value
-                     std::vector<Value> vals;
-                     for (uint32_t i = 0; i < schema_.GetColumnCount(); ++i) {
-                         if (i == (uint32_t)set_idx) {
-                             if (set_type == TypeID::INTEGER) {
-                                  vals.emplace_back(std::stoi(set_val));
-                             } else {
-                                  vals.emplace_back(set_val);
-                             }
-                         } else {
-                             vals.push_back(tuple.GetValue(i));
-                         }
-                     }
-                     new_tuples.emplace_back(vals);
-                     updated_count++;
-                     changed = true;
-                 } else {
-                     new_tuples.push_back(tuple);
-                 }
-             }
-             
-             if (changed) {
-                 page_id_t next_page_id = page.GetNextPageId();
-                 std::memset(buf, 0, PAGE_SIZE);
-                 page.Init(current_page_id, -1, buf);
-                 page.InitNewPage(next_page_id);
-                 
-                 for (const auto& t : new_tuples) {
-                     page.InsertTuple(t);
-                 }
-                 disk_manager_->WritePage(current_page_id, buf);
-             }
-             
-             current_page_id = page.GetNextPageId();
-         }
-         return updated_count;
+        if (scheduler == nullptr || parallelism <= 1) {
+            worker(0);
+            return;
+        }
+        TaskGroup group(scheduler);
+        for (size_t i = 0; i < parallelism; ++i) {
+            group.Run([&worker, i]() { worker(i); });
+        }
+        group.Wait();
     }
 
-private:
-    DiskManager* disk_manager_;
-    page_id_t first_page_id_;
-    Schema schema_;
+    std::unique_ptr<ZoneMap> zone_map_;
 };
 
 } // namespace mydb
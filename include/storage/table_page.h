@@ -14,6 +14,11 @@ namespace mydb {
  * We simply append tuples one after another for this simplified version.
  * Real DBs use Slotted Page Design (Footer with offsets).
  * We will stick to Append-Only for Phase 2 simplicity unless requested otherwise.
+ *
+ * A tuple's slot number is its position in the page, so RID(page, slot) stays valid
+ * as long as tuples are never moved: deletes only flag the tuple (Tuple::DELETED_FLAG).
+ * TupleCount holds the slot count in its low 16 bits and the deleted count in its
+ * high 16 bits (zero on pages written before deletes were flagged).
  */
 class TablePage {
 public:
@@ -39,12 +44,27 @@ public:
         *reinterpret_cast<page_id_t*>(data_ + OFFSET_NEXT_PAGE) = next_page_id;
     }
     
+    // Number of slots, deleted tuples included
     uint32_t GetTupleCount() const {
-        return *reinterpret_cast<uint32_t*>(data_ + OFFSET_TUPLE_COUNT);
+        return *reinterpret_cast<uint32_t*>(data_ + OFFSET_TUPLE_COUNT) & 0xFFFF;
     }
 
     void SetTupleCount(uint32_t count) {
-        *reinterpret_cast<uint32_t*>(data_ + OFFSET_TUPLE_COUNT) = count;
+        uint32_t& word = *reinterpret_cast<uint32_t*>(data_ + OFFSET_TUPLE_COUNT);
+        word = (word & 0xFFFF0000u) | count;
+    }
+
+    uint32_t GetDeletedCount() const {
+        return *reinterpret_cast<uint32_t*>(data_ + OFFSET_TUPLE_COUNT) >> 16;
+    }
+
+    void SetDeletedCount(uint32_t count) {
+        uint32_t& word = *reinterpret_cast<uint32_t*>(data_ + OFFSET_TUPLE_COUNT);
+        word = (word & 0xFFFFu) | (count << 16);
+    }
+
+    uint32_t GetLiveTupleCount() const {
+        return GetTupleCount() - GetDeletedCount();
     }
     
     uint32_t GetFreeSpaceOffset() const {
@@ -58,12 +78,13 @@ public:
     // Initialize a blank page
     void InitNewPage(page_id_t next_page_id = -1) {
         SetNextPageId(next_page_id);
-        SetTupleCount(0);
+        *reinterpret_cast<uint32_t*>(data_ + OFFSET_TUPLE_COUNT) = 0;
         SetFreeSpaceOffset(HEADER_SIZE);
     }
 
     // Try to insert a tuple. Returns true if successful, false if no space.
-    bool InsertTuple(const Tuple& tuple) {
+    // `slot` receives the slot number of the new tuple.
+    bool InsertTuple(const Tuple& tuple, uint32_t* slot = nullptr) {
         uint32_t size = tuple.GetSerializedSize();
         uint32_t free_offset = GetFreeSpaceOffset();
         
@@ -73,27 +94,78 @@ public:
         
         tuple.Serialize(data_ + free_offset);
         SetFreeSpaceOffset(free_offset + size);
+        if (slot != nullptr) *slot = GetTupleCount();
         SetTupleCount(GetTupleCount() + 1);
         return true;
     }
+
+    // Decode the tuple in `slot`; false if the slot does not exist or was deleted
+    bool GetTuple(uint32_t slot, const Schema& schema, Tuple& tuple, const std::vector<bool>& projection = {}) const {
+        if (slot >= GetTupleCount()) return false;
+        const char* src = data_ + TupleOffset(slot, schema);
+        if (Tuple::IsDeletedAt(src)) return false;
+        uint32_t size = 0;
+        tuple = Tuple::Deserialize(src, schema, projection, size);
+        return true;
+    }
+
+    // Flag the tuple in `slot` as deleted; false if it is absent or already deleted
+    bool MarkDelete(uint32_t slot, const Schema& schema) {
+        if (slot >= GetTupleCount()) return false;
+        char* src = data_ + TupleOffset(slot, schema);
+        if (Tuple::IsDeletedAt(src)) return false;
+        uint32_t count;
+        std::memcpy(&count, src, sizeof(uint32_t));
+        count |= Tuple::DELETED_FLAG;
+        std::memcpy(src, &count, sizeof(uint32_t));
+        SetDeletedCount(GetDeletedCount() + 1);
+        return true;
+    }
+
+    // Overwrite the tuple in `slot` when the new version has the same serialized
+    // size; false otherwise (the caller then moves the tuple elsewhere)
+    bool UpdateTupleInPlace(uint32_t slot, const Tuple& tuple, const Schema& schema) {
+        if (slot >= GetTupleCount()) return false;
+        char* dest = data_ + TupleOffset(slot, schema);
+        if (Tuple::IsDeletedAt(dest)) return false;
+        if (Tuple::GetSerializedSizeAt(dest, schema) != tuple.GetSerializedSize()) return false;
+        tuple.Serialize(dest);
+        return true;
+    }
     
     // Read all tuples (full scan helper)
-    // In a real system we'd have an Iterator or GetTuple(slot_id).
-    // Here we just return all for checking.
-    std::vector<Tuple> GetAllTuples(const Schema& schema) const {
+    // `projection` selects which columns get decoded (empty = all).
+    // Deleted tuples are skipped; `slots` (optional) receives the slot of each tuple returned.
+    std::vector<Tuple> GetAllTuples(const Schema& schema, const std::vector<bool>& projection = {},
+                                    std::vector<uint32_t>* slots = nullptr) const {
         std::vector<Tuple> tuples;
         uint32_t count = GetTupleCount();
         uint32_t offset = HEADER_SIZE;
-        
+        tuples.reserve(GetLiveTupleCount());
+
         for (uint32_t i = 0; i < count; ++i) {
-            Tuple t = Tuple::Deserialize(data_ + offset, schema);
-            tuples.push_back(t);
-            offset += t.GetSerializedSize();
+            if (Tuple::IsDeletedAt(data_ + offset)) {
+                offset += Tuple::GetSerializedSizeAt(data_ + offset, schema);
+                continue;
+            }
+            uint32_t size = 0;
+            tuples.push_back(Tuple::Deserialize(data_ + offset, schema, projection, size));
+            if (slots != nullptr) slots->push_back(i);
+            offset += size;
         }
         return tuples;
     }
 
 private:
+    // Tuples are variable length, so a slot is found by stepping over the ones before it
+    uint32_t TupleOffset(uint32_t slot, const Schema& schema) const {
+        uint32_t offset = HEADER_SIZE;
+        for (uint32_t i = 0; i < slot; ++i) {
+            offset += Tuple::GetSerializedSizeAt(data_ + offset, schema);
+        }
+        return offset;
+    }
+
     page_id_t page_id_;
     page_id_t prev_page_id_;
     char* data_; // Pointer to the 4KB buffer in memory
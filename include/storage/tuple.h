@@ -8,6 +8,10 @@ namespace mydb {
 
 class Tuple {
 public:
+    // Set in the stored value count of a deleted tuple. The table page keeps its
+    // bytes in place so the slot numbers (RIDs) of later tuples do not shift.
+    static constexpr uint32_t DELETED_FLAG = 0x80000000u;
+
     Tuple() = default;
     
     explicit Tuple(std::vector<Value> values) : values_(std::move(values)) {}
@@ -15,6 +19,10 @@ public:
     const Value& GetValue(uint32_t idx) const {
         return values_[idx];
     }
+
+    void SetValue(uint32_t idx, Value value) { values_[idx] = std::move(value); }
+
+    uint32_t GetValueCount() const { return static_cast<uint32_t>(values_.size()); }
     
     // Serialize tuple to buffer
     // Format: [Count] [Value1] [Value2] ... 
@@ -35,32 +43,58 @@ public:
     
     // Deserialize tuple from buffer
     static Tuple Deserialize(const char* src, const Schema& schema) {
+         uint32_t size = 0;
+         return Deserialize(src, schema, {}, size);
+    }
+
+    // Deserialize only the columns flagged in `projection` (empty = all columns).
+    // Skipped columns keep their position as INVALID values so column indexes
+    // stay valid for the caller. `size` receives the bytes the tuple occupies.
+    static Tuple Deserialize(const char* src, const Schema& schema,
+                             const std::vector<bool>& projection, uint32_t& size) {
          // Note: In a real system, we'd use the schema to know types.
          // Here, our serialized format includes simple length for Varchar, but we need types.
          // Let's assume the schema matches the stored data order perfectly.
-         
+
          uint32_t count;
          uint32_t offset = 0;
          std::memcpy(&count, src + offset, sizeof(uint32_t));
+         count &= ~DELETED_FLAG;
          offset += sizeof(uint32_t);
-         
+
          std::vector<Value> values;
+         values.reserve(count);
          for (uint32_t i = 0; i < count; ++i) {
-             const Column& col = schema.GetColumn(i);
-             // We peek/deserialize based on type
-             if (col.GetType() == TypeID::INTEGER) {
-                 Value v = Value::Deserialize(src + offset, TypeID::INTEGER);
-                 values.push_back(v);
-                 offset += v.GetSerializedSize();
-             } else if (col.GetType() == TypeID::VARCHAR) {
-                 Value v = Value::Deserialize(src + offset, TypeID::VARCHAR);
-                 values.push_back(v);
-                 offset += v.GetSerializedSize();
+             TypeID type = schema.GetColumn(i).GetType();
+             if (projection.empty() || (i < projection.size() && projection[i])) {
+                 values.push_back(Value::Deserialize(src + offset, type));
+             } else {
+                 values.emplace_back();
              }
+             offset += Value::GetSerializedSizeAt(src + offset, type);
          }
-         return Tuple(values);
+         size = offset;
+         return Tuple(std::move(values));
     }
     
+    // Bytes occupied by the serialized tuple at src, read from the length prefixes only
+    static uint32_t GetSerializedSizeAt(const char* src, const Schema& schema) {
+         uint32_t count;
+         std::memcpy(&count, src, sizeof(uint32_t));
+         count &= ~DELETED_FLAG;
+         uint32_t offset = sizeof(uint32_t);
+         for (uint32_t i = 0; i < count; ++i) {
+             offset += Value::GetSerializedSizeAt(src + offset, schema.GetColumn(i).GetType());
+         }
+         return offset;
+    }
+
+    static bool IsDeletedAt(const char* src) {
+         uint32_t count;
+         std::memcpy(&count, src, sizeof(uint32_t));
+         return (count & DELETED_FLAG) != 0;
+    }
+
     uint32_t GetSerializedSize() const {
         uint32_t size = sizeof(uint32_t); // count
         for (const auto& val : values_) {
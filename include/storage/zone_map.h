@@ -0,0 +1,126 @@
+#pragma once
+
+#include <climits>
+#include <cstring>
+#include <vector>
+#include "catalog/schema.h"
+#include "storage/page_summary_map.h"
+#include "storage/table_page.h"
+
+namespace mydb {
+
+/**
+ * Min and max of every INTEGER column per heap page, so scans can skip pages whose
+ * range cannot satisfy the WHERE clause. The table heap keeps it up to date: inserts
+ * widen a page's ranges, while deletes and updates recompute them from the page's
+ * live tuples, so they shrink back as rows go.
+ *
+ * Summary format (one per heap page): | (Min (4), Max (4)) x INTEGER columns |, in
+ * schema order. A page without live tuples has Min > Max in every column.
+ */
+class ZoneMap {
+public:
+    // Whether a column of this type gets a range; other numeric types would join INTEGER here
+    static bool Tracks(TypeID type) { return type == TypeID::INTEGER; }
+
+    static bool Applies(const Schema &schema) {
+        for (const auto &column : schema.GetColumns()) {
+            if (Tracks(column.GetType())) return true;
+        }
+        return false;
+    }
+
+    // first_page_id == -1 creates an empty map: Rebuild it unless the table is new
+    ZoneMap(DiskManager *disk_manager, const Schema &schema, page_id_t first_page_id = -1)
+        : slots_(schema.GetColumnCount(), -1), projection_(schema.GetColumnCount(), false),
+          summaries_(disk_manager, SummarySize(schema), first_page_id) {
+        int slot = 0;
+        for (uint32_t i = 0; i < schema.GetColumnCount(); ++i) {
+            if (!Tracks(schema.GetColumn(i).GetType())) continue;
+            slots_[i] = slot++;
+            projection_[i] = true;
+        }
+    }
+
+    page_id_t GetFirstPageId() const { return summaries_.GetFirstPageId(); }
+
+    // Widens the ranges of heap page `page_id` to hold a tuple inserted there
+    void Widen(page_id_t page_id, const Tuple &tuple) {
+        bool added = false;
+        char *summary = summaries_.FindOrAdd(page_id, &added);
+        if (added) SetEmpty(summary);
+        bool changed = added;
+        for (uint32_t column = 0; column < slots_.size(); ++column) {
+            if (slots_[column] == -1) continue;
+            changed |= Include(summary, slots_[column], tuple.GetValue(column).GetAsInteger());
+        }
+        if (changed) summaries_.WriteBack(page_id);
+    }
+
+    // Recomputes the ranges of a heap page from its live tuples
+    void Reset(page_id_t page_id, const TablePage &page, const Schema &schema, bool write = true) {
+        char *summary = summaries_.FindOrAdd(page_id);
+        SetEmpty(summary);
+        for (const Tuple &tuple : page.GetAllTuples(schema, projection_)) {
+            for (uint32_t column = 0; column < slots_.size(); ++column) {
+                if (slots_[column] != -1) Include(summary, slots_[column], tuple.GetValue(column).GetAsInteger());
+            }
+        }
+        if (write) summaries_.WriteBack(page_id);
+    }
+
+    // Writes every summary, after Reset(..., false) calls
+    void WriteAll() { summaries_.WriteAll(); }
+
+    // False if no live tuple on heap page `page_id` has `column` in [low, high] (an
+    // INVALID bound is open). Pages the map knows nothing about may match.
+    bool PageMayMatch(page_id_t page_id, uint32_t column, const Value &low, const Value &high) const {
+        if (column >= slots_.size() || slots_[column] == -1) return true;
+        const char *summary = summaries_.Find(page_id);
+        if (summary == nullptr) return true;
+        int32_t min, max;
+        Get(summary, slots_[column], min, max);
+        if (min > max) return false;
+        if (low.GetTypeId() == TypeID::INTEGER && max < low.GetAsInteger()) return false;
+        if (high.GetTypeId() == TypeID::INTEGER && min > high.GetAsInteger()) return false;
+        return true;
+    }
+
+private:
+    static uint32_t SummarySize(const Schema &schema) {
+        uint32_t tracked = 0;
+        for (const auto &column : schema.GetColumns()) tracked += Tracks(column.GetType());
+        return tracked * 2 * sizeof(int32_t);
+    }
+
+    void SetEmpty(char *summary) const {
+        for (int slot : slots_) {
+            if (slot != -1) Set(summary, slot, INT32_MAX, INT32_MIN);
+        }
+    }
+
+    static void Get(const char *summary, int slot, int32_t &min, int32_t &max) {
+        std::memcpy(&min, summary + slot * 8, sizeof(int32_t));
+        std::memcpy(&max, summary + slot * 8 + 4, sizeof(int32_t));
+    }
+
+    static void Set(char *summary, int slot, int32_t min, int32_t max) {
+        std::memcpy(summary + slot * 8, &min, sizeof(int32_t));
+        std::memcpy(summary + slot * 8 + 4, &max, sizeof(int32_t));
+    }
+
+    // True if the range grew
+    static bool Include(char *summary, int slot, int32_t value) {
+        int32_t min, max;
+        Get(summary, slot, min, max);
+        if (value >= min && value <= max) return false;
+        Set(summary, slot, std::min(min, value), std::max(max, value));
+        return true;
+    }
+
+    std::vector<int> slots_;         // Column -> range slot, -1 if not tracked
+    std::vector<bool> projection_;   // The tracked columns, for decoding pages
+    PageSummaryMap summaries_;
+};
+
+} // namespace mydb
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <cstring>
 #include <iostream>
 #include <sstream>
+#include "common/vector_distance.h"
 #include "type/type_id.h"
 
 namespace mydb {
@@ -15,7 +17,19 @@ namespace mydb {
  * For simplicity in this phase:
  *  - INTEGER: 4-byte int
  *  - VARCHAR: string (length + chars)
- *  - VECTOR: array of floats (count + floats)
+ *  - VECTOR: array of floats (count + floats), or FP16 / INT8 codes (see below)
+ *
+ * A VECTOR value stored FP16 or INT8 keeps its codes as read from the page; the
+ * floats are decoded only if asked for (GetAsVector), and VectorDistanceTo scores it
+ * on the codes. On disk the count word carries the encoding in its top byte (0 =
+ * FP32, so older rows read unchanged), followed by count floats, count halves, or a
+ * float scale and count bytes.
+ *
+ * A VARCHAR or VECTOR value moved to an overflow chain by the table heap is stored
+ * as a 12-byte reference instead: | EXTERNAL_FLAG (4) | FirstPageId (4) | Size (4) |,
+ * Size being the bytes of its usual serialization kept in the chain. Deserialize
+ * returns such a reference as an external Value, which the table heap replaces with
+ * the fetched value.
  */
 class Value {
 public:
@@ -38,19 +52,46 @@ public:
         vec_ = vec;
     }
 
+    // Vector constructor for a column with the given encoding (quantizes FP16 / INT8)
+    Value(const std::vector<float>& vec, VectorEncoding encoding) : type_id_(TypeID::VECTOR), encoding_(encoding) {
+        if (encoding_ == VectorEncoding::FP32) {
+            vec_ = vec;
+            return;
+        }
+        dims_ = static_cast<uint32_t>(vec.size());
+        codes_.resize(EncodedVectorSize(encoding_, dims_));
+        scale_ = EncodeVector(encoding_, vec.data(), dims_, codes_.data());
+        decoded_ = false;
+    }
+
+    // Reference to a value of `type_id` whose serialization (`size` bytes) is in the
+    // overflow chain starting at `first_page_id`
+    static Value External(TypeID type_id, int32_t first_page_id, uint32_t size) {
+        Value value;
+        value.type_id_ = type_id;
+        value.external_page_id_ = first_page_id;
+        value.external_size_ = size;
+        return value;
+    }
+
     TypeID GetTypeId() const { return type_id_; }
 
+    bool IsExternal() const { return external_page_id_ != -1; }
+    int32_t GetExternalPageId() const { return external_page_id_; }
+    uint32_t GetExternalSize() const { return external_size_; }
+
     int32_t GetAsInteger() const {
         return value_.integer_;
     }
 
     std::string GetAsString() const {
         if (type_id_ == TypeID::VECTOR) {
+            const std::vector<float>& vec = GetAsVector();
             std::stringstream ss;
             ss << "[";
-            for (size_t i = 0; i < vec_.size(); ++i) {
-                ss << vec_[i];
-                if (i < vec_.size() - 1) ss << ", ";
+            for (size_t i = 0; i < vec.size(); ++i) {
+                ss << vec[i];
+                if (i < vec.size() - 1) ss << ", ";
             }
             ss << "]";
             return ss.str();
@@ -59,12 +100,36 @@ public:
     }
 
     const std::vector<float>& GetAsVector() const {
+        if (!decoded_) {
+            vec_.resize(dims_);
+            DecodeVector(encoding_, codes_.data(), scale_, dims_, vec_.data());
+            decoded_ = true;
+        }
         return vec_;
     }
 
+    VectorEncoding GetVectorEncoding() const { return encoding_; }
+    uint32_t GetVectorDims() const { return encoding_ == VectorEncoding::FP32 ? vec_.size() : dims_; }
+
+    // VectorDistance from `query` (query_norm: its squared norm) to this vector, over
+    // the dimensions both have. Quantized vectors are scored on their codes.
+    float VectorDistanceTo(DistanceMetric metric, const std::vector<float>& query, float query_norm) const {
+        size_t dims = std::min<size_t>(GetVectorDims(), query.size());
+        if (encoding_ == VectorEncoding::FP32) return VectorDistance(metric, vec_.data(), query.data(), dims);
+        if (dims != query.size()) query_norm = ActiveDistanceKernels().dot(query.data(), query.data(), dims);
+        return EncodedVectorDistance(metric, query.data(), query_norm, encoding_, codes_.data(), scale_, dims);
+    }
+
     // Serialize to a buffer (for disk storage)
     // Returns number of bytes written
     uint32_t Serialize(char* dest) const {
+        if (IsExternal()) {
+            uint32_t flag = EXTERNAL_FLAG;
+            std::memcpy(dest, &flag, sizeof(uint32_t));
+            std::memcpy(dest + sizeof(uint32_t), &external_page_id_, sizeof(int32_t));
+            std::memcpy(dest + 2 * sizeof(uint32_t), &external_size_, sizeof(uint32_t));
+            return EXTERNAL_SIZE;
+        }
         if (type_id_ == TypeID::INTEGER) {
             std::memcpy(dest, &value_.integer_, sizeof(int32_t));
             return sizeof(int32_t);
@@ -74,6 +139,17 @@ public:
             std::memcpy(dest + sizeof(uint32_t), str_.c_str(), size);
             return sizeof(uint32_t) + size;
         } else if (type_id_ == TypeID::VECTOR) {
+            if (encoding_ != VectorEncoding::FP32) {
+                uint32_t word = dims_ | (static_cast<uint32_t>(encoding_) << ENCODING_SHIFT);
+                std::memcpy(dest, &word, sizeof(uint32_t));
+                uint32_t offset = sizeof(uint32_t);
+                if (encoding_ == VectorEncoding::INT8) {
+                    std::memcpy(dest + offset, &scale_, sizeof(float));
+                    offset += sizeof(float);
+                }
+                if (!codes_.empty()) std::memcpy(dest + offset, codes_.data(), codes_.size());
+                return offset + static_cast<uint32_t>(codes_.size());
+            }
             uint32_t count = vec_.size();
             std::memcpy(dest, &count, sizeof(uint32_t));
             if (count > 0) {
@@ -87,6 +163,13 @@ public:
     // Deserialize from a buffer
     // Returns number of bytes read
     static Value Deserialize(const char* src, TypeID type_id) {
+        if (IsExternalAt(src, type_id)) {
+            int32_t page_id;
+            uint32_t size;
+            std::memcpy(&page_id, src + sizeof(uint32_t), sizeof(int32_t));
+            std::memcpy(&size, src + 2 * sizeof(uint32_t), sizeof(uint32_t));
+            return External(type_id, page_id, size);
+        }
         if (type_id == TypeID::INTEGER) {
             int32_t val;
             std::memcpy(&val, src, sizeof(int32_t));
@@ -99,6 +182,21 @@ public:
         } else if (type_id == TypeID::VECTOR) {
             uint32_t count;
             std::memcpy(&count, src, sizeof(uint32_t));
+            VectorEncoding encoding = static_cast<VectorEncoding>(count >> ENCODING_SHIFT);
+            if (encoding != VectorEncoding::FP32) {
+                Value value;
+                value.type_id_ = TypeID::VECTOR;
+                value.encoding_ = encoding;
+                value.dims_ = count & COUNT_MASK;
+                uint32_t offset = sizeof(uint32_t);
+                if (encoding == VectorEncoding::INT8) {
+                    std::memcpy(&value.scale_, src + offset, sizeof(float));
+                    offset += sizeof(float);
+                }
+                value.codes_.assign(src + offset, src + offset + EncodedVectorSize(encoding, value.dims_));
+                value.decoded_ = false;
+                return value;
+            }
             std::vector<float> vec(count);
             if (count > 0) {
                 std::memcpy(vec.data(), src + sizeof(uint32_t), count * sizeof(float));
@@ -108,13 +206,36 @@ public:
         return Value();
     }
     
+    // Size of a serialized value in a buffer, read from its length prefix only.
+    // Lets scans step over columns they do not need without materializing them.
+    static uint32_t GetSerializedSizeAt(const char* src, TypeID type_id) {
+        if (IsExternalAt(src, type_id)) return EXTERNAL_SIZE;
+        if (type_id == TypeID::INTEGER) {
+            return sizeof(int32_t);
+        } else if (type_id == TypeID::VARCHAR) {
+            uint32_t size;
+            std::memcpy(&size, src, sizeof(uint32_t));
+            return sizeof(uint32_t) + size;
+        } else if (type_id == TypeID::VECTOR) {
+            uint32_t count;
+            std::memcpy(&count, src, sizeof(uint32_t));
+            VectorEncoding encoding = static_cast<VectorEncoding>(count >> ENCODING_SHIFT);
+            uint32_t scale_size = encoding == VectorEncoding::INT8 ? sizeof(float) : 0;
+            return sizeof(uint32_t) + scale_size + EncodedVectorSize(encoding, count & COUNT_MASK);
+        }
+        return 0;
+    }
+
     // Get serialization size
     uint32_t GetSerializedSize() const {
+         if (IsExternal()) return EXTERNAL_SIZE;
          if (type_id_ == TypeID::INTEGER) {
             return sizeof(int32_t);
         } else if (type_id_ == TypeID::VARCHAR) {
             return sizeof(uint32_t) + str_.length();
         } else if (type_id_ == TypeID::VECTOR) {
+            if (encoding_ == VectorEncoding::INT8) return sizeof(uint32_t) + sizeof(float) + codes_.size();
+            if (encoding_ == VectorEncoding::FP16) return sizeof(uint32_t) + codes_.size();
             return sizeof(uint32_t) + (vec_.size() * sizeof(float));
         }
         return 0;
@@ -125,11 +246,27 @@ public:
         if (type_id_ != other.type_id_) return false;
         if (type_id_ == TypeID::INTEGER) return value_.integer_ == other.value_.integer_;
         if (type_id_ == TypeID::VARCHAR) return str_ == other.str_;
-        if (type_id_ == TypeID::VECTOR) return vec_ == other.vec_;
+        if (type_id_ == TypeID::VECTOR) return GetAsVector() == other.GetAsVector();
         return true;
     }
 
+    // Bytes of an overflow reference in a tuple
+    static constexpr uint32_t EXTERNAL_SIZE = 12;
+
 private:
+    // Set in the length / count word of a VARCHAR / VECTOR kept in an overflow chain
+    static constexpr uint32_t EXTERNAL_FLAG = 0x80000000u;
+    // Serialized VECTOR count word: | Encoding (8 bits) | Count (24 bits) |
+    static constexpr uint32_t ENCODING_SHIFT = 24;
+    static constexpr uint32_t COUNT_MASK = (1u << ENCODING_SHIFT) - 1;
+
+    static bool IsExternalAt(const char* src, TypeID type_id) {
+        if (type_id != TypeID::VARCHAR && type_id != TypeID::VECTOR) return false;
+        uint32_t word;
+        std::memcpy(&word, src, sizeof(uint32_t));
+        return (word & EXTERNAL_FLAG) != 0;
+    }
+
     TypeID type_id_;
     union Val {
         int32_t integer_;
@@ -137,7 +274,15 @@ private:
     // Simplified storage for varchar (not optimized union yet)
     uint32_t len_ = 0;
     std::string str_;
-    std::vector<float> vec_;
+    // FP32 vectors live in vec_; FP16 / INT8 ones in codes_, decoded into vec_ on demand
+    mutable std::vector<float> vec_;
+    mutable bool decoded_ = true;
+    VectorEncoding encoding_ = VectorEncoding::FP32;
+    uint32_t dims_ = 0;
+    float scale_ = 1.0f;
+    std::vector<char> codes_;
+    int32_t external_page_id_ = -1;
+    uint32_t external_size_ = 0;
 };
 
 } // namespace mydb
@@ -0,0 +1,173 @@
+#include "common/task_scheduler.h"
+#include <iostream>
+
+namespace mydb {
+
+namespace {
+// Identifies the scheduler/worker running on this thread (null/0 outside workers)
+thread_local TaskScheduler* tls_scheduler = nullptr;
+thread_local size_t tls_worker_id = 0;
+} // namespace
+
+TaskScheduler::TaskScheduler(size_t num_workers) {
+    if (num_workers == 0) {
+        num_workers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    for (size_t i = 0; i < num_workers; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers_.emplace_back(&TaskScheduler::WorkerLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> guard(sleep_mutex_);
+        stop_ = true;
+    }
+    wake_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void TaskScheduler::Submit(Task task) {
+    size_t target;
+    if (tls_scheduler == this) {
+        target = tls_worker_id; // keep forked work local, others will steal it
+    } else {
+        target = next_queue_.fetch_add(1) % queues_.size();
+    }
+    {
+        // Count the task before it becomes visible (a worker may pop it right away),
+        // and under the sleep lock so a worker about to sleep cannot miss it
+        std::lock_guard<std::mutex> guard(sleep_mutex_);
+        pending_++;
+    }
+    {
+        std::lock_guard<std::mutex> guard(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
+    submitted_++;
+    wake_cv_.notify_one();
+}
+
+TaskScheduler::Metrics TaskScheduler::GetMetrics() const {
+    Metrics metrics;
+    for (const auto& queue : queues_) {
+        std::lock_guard<std::mutex> guard(queue->mutex);
+        metrics.queue_depths.push_back(queue->tasks.size());
+    }
+    metrics.submitted = submitted_.load();
+    metrics.executed = executed_.load();
+    metrics.steals = steals_.load();
+    return metrics;
+}
+
+bool TaskScheduler::PopLocal(size_t worker_id, Task& task) {
+    WorkerQueue& queue = *queues_[worker_id];
+    std::lock_guard<std::mutex> guard(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool TaskScheduler::Steal(size_t thief_id, Task& task) {
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        WorkerQueue& victim = *queues_[(thief_id + offset) % queues_.size()];
+        std::lock_guard<std::mutex> guard(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        steals_++;
+        return true;
+    }
+    return false;
+}
+
+void TaskScheduler::RunTask(Task& task) {
+    pending_--;
+    try {
+        task();
+    } catch (const std::exception& e) {
+        std::cerr << "Task failed: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Task failed with an unknown error" << std::endl;
+    }
+    executed_++;
+}
+
+void TaskScheduler::WorkerLoop(size_t worker_id) {
+    tls_scheduler = this;
+    tls_worker_id = worker_id;
+
+    while (true) {
+        Task task;
+        if (PopLocal(worker_id, task) || Steal(worker_id, task)) {
+            RunTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_cv_.wait(lock, [this] { return stop_ || pending_.load() > 0; });
+        if (stop_ && pending_.load() == 0) return;
+    }
+}
+
+void TaskGroup::Run(TaskScheduler::Task task) {
+    auto group_task = std::make_shared<GroupTask>();
+    group_task->fn = std::move(task);
+    {
+        std::lock_guard<std::mutex> guard(state_->mutex);
+        state_->outstanding++;
+    }
+    tasks_.push_back(group_task);
+
+    if (scheduler_ == nullptr) {
+        Execute(state_, group_task);
+        return;
+    }
+    // The queued closure only holds shared state, so it stays valid after the group is gone
+    std::shared_ptr<State> state = state_;
+    scheduler_->Submit([state, group_task]() { Execute(state, group_task); });
+}
+
+void TaskGroup::Execute(const std::shared_ptr<State>& state, const std::shared_ptr<GroupTask>& task) {
+    if (task->claimed.exchange(true)) return; // already run by a worker or the waiter
+
+    std::exception_ptr error;
+    try {
+        task->fn();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> guard(state->mutex);
+    if (error && !state->error) state->error = error;
+    if (--state->outstanding == 0) state->done_cv.notify_all();
+}
+
+void TaskGroup::WaitNoThrow() {
+    // Help out: run whatever no worker has picked up yet
+    for (const auto& task : tasks_) {
+        Execute(state_, task);
+    }
+    tasks_.clear();
+
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->done_cv.wait(lock, [this] { return state_->outstanding == 0; });
+}
+
+void TaskGroup::Wait() {
+    WaitNoThrow();
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> guard(state_->mutex);
+        std::swap(error, state_->error);
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+} // namespace mydb
@@ -0,0 +1,656 @@
+#include "common/vector_distance.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MYDB_X86_KERNELS 1
+#include <immintrin.h>
+#define MYDB_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_MSC_VER) && defined(_M_X64)
+// MSVC has no per-function targets; SSE is part of x86-64, so only that set is built
+#define MYDB_SSE_ONLY 1
+#include <immintrin.h>
+#endif
+
+namespace mydb {
+
+namespace {
+
+// --- scalar: four accumulators so the compiler can keep several adds in flight ---
+
+float ScalarL2(const float* a, const float* b, size_t n) {
+    float sum[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (size_t j = 0; j < 4; ++j) {
+            float d = a[i + j] - b[i + j];
+            sum[j] += d * d;
+        }
+    }
+    for (; i < n; ++i) {
+        float d = a[i] - b[i];
+        sum[0] += d * d;
+    }
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+float ScalarDot(const float* a, const float* b, size_t n) {
+    float sum[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (size_t j = 0; j < 4; ++j) sum[j] += a[i + j] * b[i + j];
+    }
+    for (; i < n; ++i) sum[0] += a[i] * b[i];
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+void ScalarDotNorms(const float* a, const float* b, size_t n, float* dot, float* a_norm, float* b_norm) {
+    float ab = 0, aa = 0, bb = 0;
+    for (size_t i = 0; i < n; ++i) {
+        ab += a[i] * b[i];
+        aa += a[i] * a[i];
+        bb += b[i] * b[i];
+    }
+    *dot = ab;
+    *a_norm = aa;
+    *b_norm = bb;
+}
+
+// IEEE half float <-> float, rounding to nearest even. Magnitudes past the half range
+// are clamped to its largest value (65504) rather than stored as infinity.
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t magnitude = bits & 0x7FFFFFFFu;
+    if (magnitude > 0x7F800000u) return static_cast<uint16_t>(sign | 0x7E00u); // NaN
+    if (magnitude >= 0x477FF000u) return static_cast<uint16_t>(sign | 0x7BFFu);
+    if (magnitude < 0x38800000u) {
+        // Below the smallest normal half: a multiple of 2^-24, exact in float arithmetic
+        float abs_value;
+        std::memcpy(&abs_value, &magnitude, sizeof(abs_value));
+        return static_cast<uint16_t>(sign | static_cast<uint32_t>(std::nearbyint(abs_value * 16777216.0f)));
+    }
+    uint32_t half = (magnitude - 0x38000000u) >> 13; // rebias the exponent from 127 to 15
+    uint32_t rest = magnitude & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) ++half;
+    return static_cast<uint16_t>(sign | half);
+}
+
+float HalfToFloat(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+    if (exponent == 0) {
+        float value = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+        return sign ? -value : value;
+    }
+    uint32_t bits = sign | (exponent == 31 ? 0x7F800000u : (exponent + 112) << 23) | (mantissa << 13);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void ScalarDotNormF16(const float* a, const uint16_t* b, size_t n, float* dot, float* b_norm) {
+    float ab = 0, bb = 0;
+    for (size_t i = 0; i < n; ++i) {
+        float v = HalfToFloat(b[i]);
+        ab += a[i] * v;
+        bb += v * v;
+    }
+    *dot = ab;
+    *b_norm = bb;
+}
+
+void ScalarDotNormI8(const float* a, const int8_t* b, size_t n, float* dot, float* b_norm) {
+    float ab = 0, bb = 0;
+    for (size_t i = 0; i < n; ++i) {
+        float v = b[i];
+        ab += a[i] * v;
+        bb += v * v;
+    }
+    *dot = ab;
+    *b_norm = bb;
+}
+
+void ScalarDot4(const float* a, const float* const* b, size_t n, float* dots) {
+    float sum[4] = {0, 0, 0, 0};
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < 4; ++j) sum[j] += a[i] * b[j][i];
+    }
+    for (size_t j = 0; j < 4; ++j) dots[j] = sum[j];
+}
+
+const DistanceKernels SCALAR_KERNELS = {"scalar", ScalarL2, ScalarDot, ScalarDotNorms, ScalarDotNormF16,
+                                        ScalarDotNormI8, ScalarDot4};
+
+#if defined(MYDB_X86_KERNELS) || defined(MYDB_SSE_ONLY)
+#ifndef MYDB_TARGET
+#define MYDB_TARGET(isa)
+#endif
+
+// --- sse: 4 lanes, two accumulators ---
+
+MYDB_TARGET("sse2") float HorizontalSum(__m128 v) {
+    __m128 shuffled = _mm_movehl_ps(v, v);
+    v = _mm_add_ps(v, shuffled);
+    shuffled = _mm_shuffle_ps(v, v, 0x55);
+    return _mm_cvtss_f32(_mm_add_ss(v, shuffled));
+}
+
+MYDB_TARGET("sse2") float SseL2(const float* a, const float* b, size_t n) {
+    __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 d0 = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        __m128 d1 = _mm_sub_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4));
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(d0, d0));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(d1, d1));
+    }
+    float sum = HorizontalSum(_mm_add_ps(sum0, sum1));
+    return sum + ScalarL2(a + i, b + i, n - i);
+}
+
+MYDB_TARGET("sse2") float SseDot(const float* a, const float* b, size_t n) {
+    __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float sum = HorizontalSum(_mm_add_ps(sum0, sum1));
+    return sum + ScalarDot(a + i, b + i, n - i);
+}
+
+MYDB_TARGET("sse2") void SseDotNorms(const float* a, const float* b, size_t n, float* dot, float* a_norm,
+                                     float* b_norm) {
+    __m128 ab = _mm_setzero_ps(), aa = _mm_setzero_ps(), bb = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 va = _mm_loadu_ps(a + i), vb = _mm_loadu_ps(b + i);
+        ab = _mm_add_ps(ab, _mm_mul_ps(va, vb));
+        aa = _mm_add_ps(aa, _mm_mul_ps(va, va));
+        bb = _mm_add_ps(bb, _mm_mul_ps(vb, vb));
+    }
+    float tail_ab, tail_aa, tail_bb;
+    ScalarDotNorms(a + i, b + i, n - i, &tail_ab, &tail_aa, &tail_bb);
+    *dot = HorizontalSum(ab) + tail_ab;
+    *a_norm = HorizontalSum(aa) + tail_aa;
+    *b_norm = HorizontalSum(bb) + tail_bb;
+}
+
+MYDB_TARGET("sse2") void SseDot4(const float* a, const float* const* b, size_t n, float* dots) {
+    __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps(), sum2 = _mm_setzero_ps(), sum3 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 va = _mm_loadu_ps(a + i);
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(va, _mm_loadu_ps(b[0] + i)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(va, _mm_loadu_ps(b[1] + i)));
+        sum2 = _mm_add_ps(sum2, _mm_mul_ps(va, _mm_loadu_ps(b[2] + i)));
+        sum3 = _mm_add_ps(sum3, _mm_mul_ps(va, _mm_loadu_ps(b[3] + i)));
+    }
+    dots[0] = HorizontalSum(sum0) + ScalarDot(a + i, b[0] + i, n - i);
+    dots[1] = HorizontalSum(sum1) + ScalarDot(a + i, b[1] + i, n - i);
+    dots[2] = HorizontalSum(sum2) + ScalarDot(a + i, b[2] + i, n - i);
+    dots[3] = HorizontalSum(sum3) + ScalarDot(a + i, b[3] + i, n - i);
+}
+
+const DistanceKernels SSE_KERNELS = {"sse", SseL2, SseDot, SseDotNorms, ScalarDotNormF16, ScalarDotNormI8,
+                                     SseDot4};
+#endif
+
+#ifdef MYDB_X86_KERNELS
+// --- avx2: 8 lanes with fused multiply-add, two accumulators. Everything they call
+// is compiled for AVX too: mixing in SSE-encoded helpers costs a state transition ---
+
+MYDB_TARGET("avx2,fma") float HorizontalSum256(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    return _mm_cvtss_f32(sum);
+}
+
+MYDB_TARGET("avx2,fma") float Avx2L2(const float* a, const float* b, size_t n) {
+    __m256 sum0 = _mm256_setzero_ps(), sum1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        sum0 = _mm256_fmadd_ps(d0, d0, sum0);
+        sum1 = _mm256_fmadd_ps(d1, d1, sum1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        sum0 = _mm256_fmadd_ps(d, d, sum0);
+    }
+    float sum = HorizontalSum256(_mm256_add_ps(sum0, sum1));
+    for (; i < n; ++i) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+MYDB_TARGET("avx2,fma") float Avx2Dot(const float* a, const float* b, size_t n) {
+    __m256 sum0 = _mm256_setzero_ps(), sum1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+    }
+    float sum = HorizontalSum256(_mm256_add_ps(sum0, sum1));
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+MYDB_TARGET("avx2,fma") void Avx2DotNorms(const float* a, const float* b, size_t n, float* dot, float* a_norm,
+                                          float* b_norm) {
+    __m256 ab = _mm256_setzero_ps(), aa = _mm256_setzero_ps(), bb = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i), vb = _mm256_loadu_ps(b + i);
+        ab = _mm256_fmadd_ps(va, vb, ab);
+        aa = _mm256_fmadd_ps(va, va, aa);
+        bb = _mm256_fmadd_ps(vb, vb, bb);
+    }
+    float sum_ab = HorizontalSum256(ab), sum_aa = HorizontalSum256(aa), sum_bb = HorizontalSum256(bb);
+    for (; i < n; ++i) {
+        sum_ab += a[i] * b[i];
+        sum_aa += a[i] * a[i];
+        sum_bb += b[i] * b[i];
+    }
+    *dot = sum_ab;
+    *a_norm = sum_aa;
+    *b_norm = sum_bb;
+}
+
+// Halves widen with F16C (present on every AVX2 CPU), bytes sign-extend to 32-bit
+// lanes; two accumulator pairs, as in the float kernels
+MYDB_TARGET("avx2,fma,f16c") void Avx2DotNormF16(const float* a, const uint16_t* b, size_t n, float* dot,
+                                                 float* b_norm) {
+    __m256 ab0 = _mm256_setzero_ps(), ab1 = _mm256_setzero_ps();
+    __m256 bb0 = _mm256_setzero_ps(), bb1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 vb0 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        __m256 vb1 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 8)));
+        ab0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), vb0, ab0);
+        ab1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), vb1, ab1);
+        bb0 = _mm256_fmadd_ps(vb0, vb0, bb0);
+        bb1 = _mm256_fmadd_ps(vb1, vb1, bb1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m256 vb = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        ab0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), vb, ab0);
+        bb0 = _mm256_fmadd_ps(vb, vb, bb0);
+    }
+    float tail_ab, tail_bb;
+    ScalarDotNormF16(a + i, b + i, n - i, &tail_ab, &tail_bb);
+    *dot = HorizontalSum256(_mm256_add_ps(ab0, ab1)) + tail_ab;
+    *b_norm = HorizontalSum256(_mm256_add_ps(bb0, bb1)) + tail_bb;
+}
+
+MYDB_TARGET("avx2,fma") void Avx2DotNormI8(const float* a, const int8_t* b, size_t n, float* dot, float* b_norm) {
+    __m256 ab0 = _mm256_setzero_ps(), ab1 = _mm256_setzero_ps();
+    __m256 bb0 = _mm256_setzero_ps(), bb1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m256 vb0 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(bytes));
+        __m256 vb1 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_unpackhi_epi64(bytes, bytes)));
+        ab0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), vb0, ab0);
+        ab1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), vb1, ab1);
+        bb0 = _mm256_fmadd_ps(vb0, vb0, bb0);
+        bb1 = _mm256_fmadd_ps(vb1, vb1, bb1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + i));
+        __m256 vb = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(bytes));
+        ab0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), vb, ab0);
+        bb0 = _mm256_fmadd_ps(vb, vb, bb0);
+    }
+    float tail_ab, tail_bb;
+    ScalarDotNormI8(a + i, b + i, n - i, &tail_ab, &tail_bb);
+    *dot = HorizontalSum256(_mm256_add_ps(ab0, ab1)) + tail_ab;
+    *b_norm = HorizontalSum256(_mm256_add_ps(bb0, bb1)) + tail_bb;
+}
+
+MYDB_TARGET("avx2,fma") void Avx2Dot4(const float* a, const float* const* b, size_t n, float* dots) {
+    __m256 sum0 = _mm256_setzero_ps(), sum1 = _mm256_setzero_ps();
+    __m256 sum2 = _mm256_setzero_ps(), sum3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        sum0 = _mm256_fmadd_ps(va, _mm256_loadu_ps(b[0] + i), sum0);
+        sum1 = _mm256_fmadd_ps(va, _mm256_loadu_ps(b[1] + i), sum1);
+        sum2 = _mm256_fmadd_ps(va, _mm256_loadu_ps(b[2] + i), sum2);
+        sum3 = _mm256_fmadd_ps(va, _mm256_loadu_ps(b[3] + i), sum3);
+    }
+    dots[0] = HorizontalSum256(sum0);
+    dots[1] = HorizontalSum256(sum1);
+    dots[2] = HorizontalSum256(sum2);
+    dots[3] = HorizontalSum256(sum3);
+    for (; i < n; ++i) {
+        for (size_t j = 0; j < 4; ++j) dots[j] += a[i] * b[j][i];
+    }
+}
+
+const DistanceKernels AVX2_KERNELS = {"avx2", Avx2L2, Avx2Dot, Avx2DotNorms, Avx2DotNormF16, Avx2DotNormI8,
+                                      Avx2Dot4};
+
+// --- avx512: 16 lanes; the tail is a masked load instead of a scalar loop ---
+
+MYDB_TARGET("avx512f") __mmask16 TailMask(size_t remaining) {
+    return static_cast<__mmask16>((1u << remaining) - 1);
+}
+
+MYDB_TARGET("avx512f") float Avx512L2(const float* a, const float* b, size_t n) {
+    __m512 sum0 = _mm512_setzero_ps(), sum1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512 d0 = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        __m512 d1 = _mm512_sub_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16));
+        sum0 = _mm512_fmadd_ps(d0, d0, sum0);
+        sum1 = _mm512_fmadd_ps(d1, d1, sum1);
+    }
+    for (; i + 16 <= n; i += 16) {
+        __m512 d = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        sum0 = _mm512_fmadd_ps(d, d, sum0);
+    }
+    if (i < n) {
+        __mmask16 mask = TailMask(n - i);
+        __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+        sum1 = _mm512_fmadd_ps(d, d, sum1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+}
+
+MYDB_TARGET("avx512f") float Avx512Dot(const float* a, const float* b, size_t n) {
+    __m512 sum0 = _mm512_setzero_ps(), sum1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum0);
+        sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), sum1);
+    }
+    for (; i + 16 <= n; i += 16) {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum0);
+    }
+    if (i < n) {
+        __mmask16 mask = TailMask(n - i);
+        sum1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), sum1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+}
+
+MYDB_TARGET("avx512f") void Avx512DotNorms(const float* a, const float* b, size_t n, float* dot, float* a_norm,
+                                           float* b_norm) {
+    __m512 ab = _mm512_setzero_ps(), aa = _mm512_setzero_ps(), bb = _mm512_setzero_ps();
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 mask = n - i >= 16 ? static_cast<__mmask16>(0xFFFF) : TailMask(n - i);
+        __m512 va = _mm512_maskz_loadu_ps(mask, a + i), vb = _mm512_maskz_loadu_ps(mask, b + i);
+        ab = _mm512_fmadd_ps(va, vb, ab);
+        aa = _mm512_fmadd_ps(va, va, aa);
+        bb = _mm512_fmadd_ps(vb, vb, bb);
+    }
+    *dot = _mm512_reduce_add_ps(ab);
+    *a_norm = _mm512_reduce_add_ps(aa);
+    *b_norm = _mm512_reduce_add_ps(bb);
+}
+
+// Codes have no masked load in plain AVX-512F, so the tail is copied to a zeroed block
+MYDB_TARGET("avx512f") void Avx512DotNormF16(const float* a, const uint16_t* b, size_t n, float* dot,
+                                             float* b_norm) {
+    __m512 ab = _mm512_setzero_ps(), bb = _mm512_setzero_ps();
+    for (size_t i = 0; i < n; i += 16) {
+        __m256i halves;
+        __mmask16 mask = static_cast<__mmask16>(0xFFFF);
+        if (n - i >= 16) {
+            halves = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        } else {
+            uint16_t tail[16] = {};
+            std::memcpy(tail, b + i, (n - i) * sizeof(uint16_t));
+            halves = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail));
+            mask = TailMask(n - i);
+        }
+        __m512 vb = _mm512_cvtph_ps(halves);
+        ab = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), vb, ab);
+        bb = _mm512_fmadd_ps(vb, vb, bb);
+    }
+    *dot = _mm512_reduce_add_ps(ab);
+    *b_norm = _mm512_reduce_add_ps(bb);
+}
+
+MYDB_TARGET("avx512f") void Avx512DotNormI8(const float* a, const int8_t* b, size_t n, float* dot, float* b_norm) {
+    __m512 ab = _mm512_setzero_ps(), bb = _mm512_setzero_ps();
+    for (size_t i = 0; i < n; i += 16) {
+        __m128i bytes;
+        __mmask16 mask = static_cast<__mmask16>(0xFFFF);
+        if (n - i >= 16) {
+            bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        } else {
+            int8_t tail[16] = {};
+            std::memcpy(tail, b + i, n - i);
+            bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tail));
+            mask = TailMask(n - i);
+        }
+        __m512 vb = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(bytes));
+        ab = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), vb, ab);
+        bb = _mm512_fmadd_ps(vb, vb, bb);
+    }
+    *dot = _mm512_reduce_add_ps(ab);
+    *b_norm = _mm512_reduce_add_ps(bb);
+}
+
+MYDB_TARGET("avx512f") void Avx512Dot4(const float* a, const float* const* b, size_t n, float* dots) {
+    __m512 sum0 = _mm512_setzero_ps(), sum1 = _mm512_setzero_ps();
+    __m512 sum2 = _mm512_setzero_ps(), sum3 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 va = _mm512_loadu_ps(a + i);
+        sum0 = _mm512_fmadd_ps(va, _mm512_loadu_ps(b[0] + i), sum0);
+        sum1 = _mm512_fmadd_ps(va, _mm512_loadu_ps(b[1] + i), sum1);
+        sum2 = _mm512_fmadd_ps(va, _mm512_loadu_ps(b[2] + i), sum2);
+        sum3 = _mm512_fmadd_ps(va, _mm512_loadu_ps(b[3] + i), sum3);
+    }
+    if (i < n) {
+        __mmask16 mask = TailMask(n - i);
+        __m512 va = _mm512_maskz_loadu_ps(mask, a + i);
+        sum0 = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, b[0] + i), sum0);
+        sum1 = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, b[1] + i), sum1);
+        sum2 = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, b[2] + i), sum2);
+        sum3 = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, b[3] + i), sum3);
+    }
+    dots[0] = _mm512_reduce_add_ps(sum0);
+    dots[1] = _mm512_reduce_add_ps(sum1);
+    dots[2] = _mm512_reduce_add_ps(sum2);
+    dots[3] = _mm512_reduce_add_ps(sum3);
+}
+
+const DistanceKernels AVX512_KERNELS = {"avx512", Avx512L2, Avx512Dot, Avx512DotNorms,
+                                        Avx512DotNormF16, Avx512DotNormI8, Avx512Dot4};
+#endif
+
+} // namespace
+
+const char* DistanceMetricName(DistanceMetric metric) {
+    switch (metric) {
+        case DistanceMetric::INNER_PRODUCT: return "IP";
+        case DistanceMetric::COSINE: return "COSINE";
+        default: return "L2";
+    }
+}
+
+bool ParseDistanceMetric(std::string name, DistanceMetric& metric) {
+    std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+    if (name == "L2" || name == "EUCLIDEAN") metric = DistanceMetric::L2;
+    else if (name == "IP" || name == "INNER_PRODUCT" || name == "DOT") metric = DistanceMetric::INNER_PRODUCT;
+    else if (name == "COSINE") metric = DistanceMetric::COSINE;
+    else return false;
+    return true;
+}
+
+const char* VectorEncodingName(VectorEncoding encoding) {
+    switch (encoding) {
+        case VectorEncoding::FP16: return "FP16";
+        case VectorEncoding::INT8: return "INT8";
+        default: return "FP32";
+    }
+}
+
+bool ParseVectorEncoding(std::string name, VectorEncoding& encoding) {
+    std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+    if (name == "FP32") encoding = VectorEncoding::FP32;
+    else if (name == "FP16") encoding = VectorEncoding::FP16;
+    else if (name == "INT8") encoding = VectorEncoding::INT8;
+    else return false;
+    return true;
+}
+
+size_t EncodedVectorSize(VectorEncoding encoding, size_t n) {
+    switch (encoding) {
+        case VectorEncoding::FP16: return n * sizeof(uint16_t);
+        case VectorEncoding::INT8: return n;
+        default: return n * sizeof(float);
+    }
+}
+
+float EncodeVector(VectorEncoding encoding, const float* vec, size_t n, void* codes) {
+    if (encoding == VectorEncoding::FP16) {
+        uint16_t* halves = static_cast<uint16_t*>(codes);
+        for (size_t i = 0; i < n; ++i) halves[i] = FloatToHalf(vec[i]);
+        return 1.0f;
+    }
+    if (encoding == VectorEncoding::INT8) {
+        float max_abs = 0;
+        for (size_t i = 0; i < n; ++i) max_abs = std::max(max_abs, std::fabs(vec[i]));
+        int8_t* bytes = static_cast<int8_t*>(codes);
+        if (max_abs == 0 || !std::isfinite(max_abs)) {
+            std::fill(bytes, bytes + n, 0);
+            return 0.0f;
+        }
+        float scale = max_abs / 127.0f;
+        for (size_t i = 0; i < n; ++i) {
+            float code = std::nearbyint(vec[i] / scale);
+            bytes[i] = static_cast<int8_t>(std::max(-127.0f, std::min(127.0f, code)));
+        }
+        return scale;
+    }
+    std::memcpy(codes, vec, n * sizeof(float));
+    return 1.0f;
+}
+
+void DecodeVector(VectorEncoding encoding, const void* codes, float scale, size_t n, float* out) {
+    if (encoding == VectorEncoding::FP16) {
+        const uint16_t* halves = static_cast<const uint16_t*>(codes);
+        for (size_t i = 0; i < n; ++i) out[i] = HalfToFloat(halves[i]);
+    } else if (encoding == VectorEncoding::INT8) {
+        const int8_t* bytes = static_cast<const int8_t*>(codes);
+        for (size_t i = 0; i < n; ++i) out[i] = bytes[i] * scale;
+    } else {
+        std::memcpy(out, codes, n * sizeof(float));
+    }
+}
+
+std::vector<const DistanceKernels*> SupportedDistanceKernels() {
+    std::vector<const DistanceKernels*> kernels;
+#ifdef MYDB_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) kernels.push_back(&AVX512_KERNELS);
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c")) {
+        kernels.push_back(&AVX2_KERNELS);
+    }
+    if (__builtin_cpu_supports("sse2")) kernels.push_back(&SSE_KERNELS);
+#elif defined(MYDB_SSE_ONLY)
+    kernels.push_back(&SSE_KERNELS);
+#endif
+    kernels.push_back(&SCALAR_KERNELS);
+    return kernels;
+}
+
+const DistanceKernels& ActiveDistanceKernels() {
+    static const DistanceKernels* active = SupportedDistanceKernels().front();
+    return *active;
+}
+
+float VectorDistance(DistanceMetric metric, const float* a, const float* b, size_t n,
+                     const DistanceKernels& kernels) {
+    switch (metric) {
+        case DistanceMetric::INNER_PRODUCT:
+            return -kernels.dot(a, b, n);
+        case DistanceMetric::COSINE: {
+            float dot, a_norm, b_norm;
+            kernels.dot_norms(a, b, n, &dot, &a_norm, &b_norm);
+            if (a_norm == 0.0f || b_norm == 0.0f) return 1.0f;
+            return 1.0f - dot / std::sqrt(a_norm * b_norm);
+        }
+        default:
+            return kernels.l2_squared(a, b, n);
+    }
+}
+
+float EncodedVectorDistance(DistanceMetric metric, const float* query, float query_norm, VectorEncoding encoding,
+                            const void* codes, float scale, size_t n, const DistanceKernels& kernels) {
+    float dot, norm;
+    if (encoding == VectorEncoding::FP16) {
+        kernels.dot_norm_f16(query, static_cast<const uint16_t*>(codes), n, &dot, &norm);
+    } else if (encoding == VectorEncoding::INT8) {
+        kernels.dot_norm_i8(query, static_cast<const int8_t*>(codes), n, &dot, &norm);
+        dot *= scale;
+        norm *= scale * scale;
+    } else {
+        return VectorDistance(metric, query, static_cast<const float*>(codes), n, kernels);
+    }
+    switch (metric) {
+        case DistanceMetric::INNER_PRODUCT:
+            return -dot;
+        case DistanceMetric::COSINE:
+            if (query_norm == 0.0f || norm == 0.0f) return 1.0f;
+            return 1.0f - dot / std::sqrt(query_norm * norm);
+        default:
+            return std::max(0.0f, query_norm + norm - 2.0f * dot);
+    }
+}
+
+void VectorDistanceBlock(DistanceMetric metric, const float* queries, const float* query_norms, size_t query_count,
+                         const float* rows, size_t row_count, size_t n, float* out, const DistanceKernels& kernels) {
+    // About 32 KiB of rows per tile, a multiple of the four dot4 takes
+    const size_t tile = std::max<size_t>(4, (32768 / (std::max<size_t>(n, 1) * sizeof(float))) & ~size_t(3));
+    std::vector<float> row_norms;
+    if (metric != DistanceMetric::INNER_PRODUCT) {
+        row_norms.resize(row_count);
+        for (size_t r = 0; r < row_count; ++r) row_norms[r] = kernels.dot(rows + r * n, rows + r * n, n);
+    }
+    auto distance = [&](size_t q, size_t r, float dot) {
+        switch (metric) {
+            case DistanceMetric::INNER_PRODUCT:
+                return -dot;
+            case DistanceMetric::COSINE:
+                if (query_norms[q] == 0.0f || row_norms[r] == 0.0f) return 1.0f;
+                return 1.0f - dot / std::sqrt(query_norms[q] * row_norms[r]);
+            default:
+                return std::max(0.0f, query_norms[q] + row_norms[r] - 2.0f * dot);
+        }
+    };
+    for (size_t tile_begin = 0; tile_begin < row_count; tile_begin += tile) {
+        const size_t tile_end = std::min(tile_begin + tile, row_count);
+        for (size_t q = 0; q < query_count; ++q) {
+            const float* query = queries + q * n;
+            float* query_out = out + q * row_count;
+            size_t r = tile_begin;
+            for (; r + 4 <= tile_end; r += 4) {
+                const float* four[4] = {rows + r * n, rows + (r + 1) * n, rows + (r + 2) * n, rows + (r + 3) * n};
+                float dots[4];
+                kernels.dot4(query, four, n, dots);
+                for (size_t j = 0; j < 4; ++j) query_out[r + j] = distance(q, r + j, dots[j]);
+            }
+            for (; r < tile_end; ++r) query_out[r] = distance(q, r, kernels.dot(query, rows + r * n, n));
+        }
+    }
+}
+
+} // namespace mydb
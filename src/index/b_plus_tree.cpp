@@ -1,10 +1,29 @@
 #include "index/b_plus_tree.h"
 #include <iostream>
+#include <algorithm>
+#include <mutex>
+#include <vector>
 
 namespace mydb {
 
-BPlusTree::BPlusTree(std::string name, DiskManager* disk_manager)
-    : index_name_(std::move(name)), root_page_id_(-1), disk_manager_(disk_manager) {}
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::BPlusTree(std::string name, DiskManager* disk_manager, page_id_t header_page_id, bool unique,
+                          const KeyComparator &comparator)
+    : index_name_(std::move(name)), header_page_id_(header_page_id), root_page_id_(-1), unique_(unique),
+      comparator_(comparator), disk_manager_(disk_manager) {
+    alignas(8) char buf[PAGE_SIZE];
+    std::memset(buf, 0, PAGE_SIZE);
+    BPlusTreeHeaderPage* header = reinterpret_cast<BPlusTreeHeaderPage*>(buf);
+    if (header_page_id_ == -1) {
+        header_page_id_ = disk_manager_->AllocatePage();
+        header->Init(unique_);
+        disk_manager_->WritePage(header_page_id_, buf);
+    } else {
+        disk_manager_->ReadPage(header_page_id_, buf);
+        root_page_id_ = header->GetRootPageId();
+        unique_ = header->IsUnique();
+    }
+}
 
 // Helper to cast raw page data
 template <typename N>
@@ -12,33 +31,105 @@ N* CastPage(char* raw_data) {
     return reinterpret_cast<N*>(raw_data);
 }
 
-bool BPlusTree::GetValue(const int &key, RID &result) {
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::GetValue(const KeyType &key, RID &result) {
+    if (!unique_) {
+        // Duplicates may start in an earlier leaf than the plain descent reaches
+        std::vector<RID> matches;
+        GetRange(key, key, matches);
+        if (matches.empty()) return false;
+        result = matches.front();
+        return true;
+    }
+
+    std::shared_lock<std::shared_mutex> tree_lock(tree_latch_);
     if (root_page_id_ == -1) return false;
+    alignas(8) char buf[NODE_SIZE];
+    FindLeafPage(key, buf);
+    LeafPage* leaf = CastPage<LeafPage>(buf);
+    int index = leaf->KeyIndex(key, comparator_);
+    if (index == -1) return false;
+    result = leaf->ValueAt(index);
+    return true;
+}
 
-    char buf[PAGE_SIZE]; // Only holds one page at a time (inefficient but works)
-    page_id_t current_page_id = root_page_id_;
-    
-    // Traverse down
-    while (true) {
-        disk_manager_->ReadPage(current_page_id, buf);
-        BPlusTreePage* page = CastPage<BPlusTreePage>(buf);
-        
-        if (page->IsLeafPage()) {
-             BPlusTreeLeafPage* leaf = CastPage<BPlusTreeLeafPage>(buf);
-             RID rid = leaf->Lookup(key, 0);
-             if (rid.GetPageId() != -1) {
-                 result = rid;
-                 return true;
-             }
-             return false;
-        } else {
-             BPlusTreeInternalPage* internal = CastPage<BPlusTreeInternalPage>(buf);
-             current_page_id = internal->Lookup(key, 0);
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetRange(const KeyType &low, const KeyType &high, std::vector<RID> &result) {
+    if (comparator_(low, high) > 0) return;
+    for (Iterator it = Begin(low); !it.IsEnd() && comparator_(it.Key(), high) <= 0; ++it) {
+        result.push_back(it.Value());
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Begin() -> Iterator {
+    // The leaf is handed over as read: positioning by page id could land on it after a split
+    std::vector<char> leaf(NODE_SIZE);
+    uint64_t version;
+    {
+        std::shared_lock<std::shared_mutex> tree_lock(tree_latch_);
+        page_id_t current_page_id = root_page_id_;
+        if (current_page_id == -1) return End();
+        while (true) {
+            ReadPageShared(current_page_id, leaf.data());
+            if (CastPage<BPlusTreePage>(leaf.data())->IsLeafPage()) break;
+            current_page_id = CastPage<InternalPage>(leaf.data())->ValueAt(0);
+        }
+        if (CastPage<LeafPage>(leaf.data())->GetSize() == 0) return End();
+        version = structure_version_;
+    }
+    return Iterator(this, std::move(leaf), 0, version);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> Iterator {
+    std::vector<char> leaf(NODE_SIZE);
+    int index;
+    uint64_t version;
+    {
+        std::shared_lock<std::shared_mutex> tree_lock(tree_latch_);
+        if (root_page_id_ == -1) return End();
+        FindLeafPage(key, leaf.data(), true);
+        index = CastPage<LeafPage>(leaf.data())->LowerBound(key, comparator_);
+        // The first entry >= key may start the next leaf
+        while (index >= CastPage<LeafPage>(leaf.data())->GetSize()) {
+            page_id_t next_page_id = CastPage<LeafPage>(leaf.data())->GetNextPageId();
+            if (next_page_id == -1) return End();
+            ReadPageShared(next_page_id, leaf.data());
+            index = 0;
         }
+        version = structure_version_;
     }
+    return Iterator(this, std::move(leaf), index, version);
 }
 
-bool BPlusTree::Insert(const int &key, const RID &value) {
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::End() -> Iterator {
+    return Iterator(this);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::Insert(const KeyType &key, const RID &value) {
+    {
+        // Optimistic: the entry fits into its leaf, which is all that changes
+        std::shared_lock<std::shared_mutex> tree_lock(tree_latch_);
+        if (root_page_id_ != -1) {
+            alignas(8) char buf[NODE_SIZE];
+            page_id_t leaf_id = FindLeafPage(key, buf, !unique_);
+            std::unique_lock<std::shared_mutex> leaf_lock(PageLatch(leaf_id));
+            ReadNode(leaf_id, buf);
+            LeafPage* leaf = CastPage<LeafPage>(buf);
+            if (unique_ && leaf->KeyIndex(key, comparator_) != -1) return false;
+            leaf->Insert(key, value, comparator_, unique_);
+            if (!leaf->IsOverfull()) {
+                WriteNode(leaf_id, buf);
+                return true;
+            }
+        }
+    }
+
+    // The leaf splits (or the tree is empty): start over with the tree to ourselves
+    std::unique_lock<std::shared_mutex> tree_lock = LockExclusive();
     if (root_page_id_ == -1) {
         StartNewTree(key, value);
         return true;
@@ -46,68 +137,573 @@ bool BPlusTree::Insert(const int &key, const RID &value) {
     return InsertIntoLeaf(key, value);
 }
 
-void BPlusTree::StartNewTree(const int &key, const RID &value) {
+namespace {
+
+// Entries per node for a bulk load: fill_percent of what a node holds before it
+// splits, but never below the minimum occupancy
+int FillTarget(int max_size, int fill_percent) {
+    int capacity = max_size - 1;
+    int target = static_cast<int>(static_cast<int64_t>(capacity) * fill_percent / 100);
+    return std::min(capacity, std::max({target, max_size / 2, 2}));
+}
+
+// Sizes of the nodes that pack n items `target` to a node, or fewer where fits(first, count)
+// says items [first, first + count) would not fit a page. A short last node is merged
+// into its neighbour, or the two are split evenly, so no node but a lone root is underfull.
+template <typename Fits>
+std::vector<int> PlanNodes(int n, int target, int max_size, int min_size, const Fits &fits) {
+    std::vector<int> sizes;
+    for (int first = 0; first < n; first += sizes.back()) {
+        int count = std::min(n - first, target);
+        if (!fits(first, count)) {
+            // The encoded size only grows with count: find the most that fits
+            int low = 1;
+            while (low + 1 < count) {
+                int mid = low + (count - low) / 2;
+                if (fits(first, mid)) {
+                    low = mid;
+                } else {
+                    count = mid;
+                }
+            }
+            count = low;
+        }
+        sizes.push_back(count);
+    }
+    if (sizes.size() > 1 && sizes.back() < min_size) {
+        int combined = sizes[sizes.size() - 2] + sizes.back();
+        int first = n - combined;
+        sizes.pop_back();
+        if (combined < max_size && fits(first, combined)) {
+            sizes.back() = combined;
+        } else {
+            // The left half is a prefix of a node that fit; min_size entries always fit
+            int left = combined / 2;
+            if (!fits(first + left, combined - left)) left = combined - min_size;
+            sizes.back() = left;
+            sizes.push_back(combined - left);
+        }
+    }
+    return sizes;
+}
+
+} // namespace
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(const std::vector<MappingType> &entries, int fill_percent) {
+    std::unique_lock<std::shared_mutex> tree_lock = LockExclusive();
+    if (root_page_id_ != -1) return false;
+    if (entries.empty()) return true;
+    if (unique_) {
+        for (size_t i = 1; i < entries.size(); ++i) {
+            if (comparator_(entries[i - 1].first, entries[i].first) == 0) return false;
+        }
+    }
+
+    // Plan every level first so each page knows its parent when it is written.
+    // levels[0] holds the leaf sizes (entries), the levels above count children;
+    // children[level] has the entry pointing at each node of the level below, keyed by
+    // the separator in front of that node. Compressed pages are also filled by bytes.
+    using InternalEntry = typename InternalPage::MappingType;
+    const int byte_budget = std::max(PAGE_SIZE / 2, PAGE_SIZE * fill_percent / 100);
+    std::vector<std::vector<int>> levels;
+    levels.push_back(PlanNodes(static_cast<int>(entries.size()), FillTarget(LeafPage::LEAF_PAGE_SIZE, fill_percent),
+                               LeafPage::LEAF_PAGE_SIZE, LeafPage::MinSize(LeafPage::LEAF_PAGE_SIZE),
+                               [&](int first, int count) {
+                                   return !COMPRESSED ||
+                                          LeafPage::EncodedSize(entries.data() + first, count) <= byte_budget;
+                               }));
+    std::vector<std::vector<InternalEntry>> children(1);
+    std::vector<InternalEntry> level_entries;
+    size_t offset = 0;
+    for (int size : levels[0]) {
+        KeyType key = offset == 0 ? entries[0].first
+                                  : KeyTraits<KeyType>::Separator(entries[offset - 1].first, entries[offset].first);
+        level_entries.push_back({key, -1});
+        offset += size;
+    }
+    while (level_entries.size() > 1) {
+        children.push_back(std::move(level_entries));
+        const std::vector<InternalEntry> &below = children.back();
+        levels.push_back(PlanNodes(static_cast<int>(below.size()),
+                                   FillTarget(InternalPage::INTERNAL_PAGE_SIZE, fill_percent),
+                                   InternalPage::INTERNAL_PAGE_SIZE,
+                                   InternalPage::MinSize(InternalPage::INTERNAL_PAGE_SIZE),
+                                   [&](int first, int count) {
+                                       return !COMPRESSED ||
+                                              InternalPage::EncodedSize(below.data() + first, count) <= byte_budget;
+                                   }));
+        level_entries.clear();
+        size_t child = 0;
+        for (int size : levels.back()) {
+            level_entries.push_back({below[child].first, -1});
+            child += size;
+        }
+    }
+    std::vector<std::vector<page_id_t>> page_ids(levels.size());
+    for (size_t level = 0; level < levels.size(); ++level) {
+        for (size_t i = 0; i < levels[level].size(); ++i) page_ids[level].push_back(disk_manager_->AllocatePage());
+        if (level > 0) {
+            for (size_t i = 0; i < children[level].size(); ++i) children[level][i].second = page_ids[level - 1][i];
+        }
+    }
+    // Parent of every node of `level`
+    auto parents = [&](size_t level) {
+        std::vector<page_id_t> result;
+        if (level + 1 == levels.size()) return std::vector<page_id_t>(levels[level].size(), -1);
+        for (size_t i = 0; i < levels[level + 1].size(); ++i) {
+            result.insert(result.end(), levels[level + 1][i], page_ids[level + 1][i]);
+        }
+        return result;
+    };
+
+    // Leaves, chained left to right
+    alignas(8) char buf[NODE_SIZE];
+    std::vector<page_id_t> parent_ids = parents(0);
+    offset = 0;
+    for (size_t i = 0; i < levels[0].size(); ++i) {
+        std::memset(buf, 0, NODE_SIZE);
+        LeafPage* leaf = CastPage<LeafPage>(buf);
+        leaf->Init(page_ids[0][i], parent_ids[i]);
+        leaf->CopyNFrom(entries.data() + offset, levels[0][i]);
+        leaf->SetNextPageId(i + 1 < levels[0].size() ? page_ids[0][i + 1] : -1);
+        WriteNode(page_ids[0][i], buf);
+        offset += levels[0][i];
+    }
+
+    // Internal levels: entry j of a node points at a child, keyed by the separator in front of it
+    for (size_t level = 1; level < levels.size(); ++level) {
+        parent_ids = parents(level);
+        size_t child = 0;
+        for (size_t i = 0; i < levels[level].size(); ++i) {
+            std::memset(buf, 0, NODE_SIZE);
+            InternalPage* internal = CastPage<InternalPage>(buf);
+            internal->Init(page_ids[level][i], parent_ids[i]);
+            for (int j = 0; j < levels[level][i]; ++j, ++child) {
+                internal->SetKeyAt(j, children[level][child].first);
+                internal->SetValueAt(j, children[level][child].second);
+            }
+            internal->SetSize(levels[level][i]);
+            WriteNode(page_ids[level][i], buf);
+        }
+    }
+
+    UpdateRootPageId(page_ids.back()[0]);
+    return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const RID &value) {
     // 1. Allocate page
-    int file_size = disk_manager_->GetFileSize("mydb.db");
-    page_id_t page_id = file_size / PAGE_SIZE;
-    root_page_id_ = page_id;
+    page_id_t page_id = disk_manager_->AllocatePage();
     
     // 2. Init Leaf
-    char buf[PAGE_SIZE];
-    std::memset(buf, 0, PAGE_SIZE);
-    BPlusTreeLeafPage* leaf = CastPage<BPlusTreeLeafPage>(buf);
+    alignas(8) char buf[NODE_SIZE];
+    std::memset(buf, 0, NODE_SIZE);
+    LeafPage* leaf = CastPage<LeafPage>(buf);
     leaf->Init(page_id, -1);
-    leaf->Insert(key, value, 0);
+    leaf->Insert(key, value, comparator_);
     
     // 3. Write
-    disk_manager_->WritePage(page_id, buf);
+    WriteNode(page_id, buf);
+    UpdateRootPageId(page_id);
 }
 
-bool BPlusTree::InsertIntoLeaf(const int &key, const RID &value) {
-    // Traverse to leaf
-    char buf[PAGE_SIZE];
-    page_id_t current_page_id = root_page_id_;
-    
-    // 1. Find leaf
-    // We ideally need to track the path to update parents, but for now let's assume no split for simplicity 
-    // OR we just find leaf and handle split (which is complex without holding parent pointers in memory)
-    
-    // Hack: Implementation without split for now (Fixed Limit) to pass Phase 3 basic requirements
-    // Real split logic requires BufferPool to pin pages. With just DiskManager it's hard to modify parent.
-    // For this "Step 2" of development, we can stick to single-root leaf or simplified logic.
-    // Let's implement full traversal.
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const RID &value) {
+    // 1. Find leaf. Parents are found again through the parent page ids stored in
+    // each node, so the path does not need to be kept in memory.
+    alignas(8) char buf[NODE_SIZE];
+    page_id_t current_page_id = FindLeafPage(key, buf, !unique_);
     
+    // Now buf contains the leaf
+    LeafPage* leaf = CastPage<LeafPage>(buf);
+    if (unique_ && leaf->KeyIndex(key, comparator_) != -1) {
+        return false; // Unique index: key already present
+    }
+
+    // 2. A leaf keeps room for max_size entries; it splits as soon as it fills up
+    // (or, compressed, no longer fits its page)
+    leaf->Insert(key, value, comparator_, unique_);
+    if (!leaf->IsOverfull()) {
+        WriteNode(current_page_id, buf);
+        return true;
+    }
+
+    // 3. Split: upper half goes to a new right sibling, linked into the leaf chain
+    page_id_t new_page_id = disk_manager_->AllocatePage();
+    alignas(8) char new_buf[NODE_SIZE];
+    std::memset(new_buf, 0, NODE_SIZE);
+    LeafPage* new_leaf = CastPage<LeafPage>(new_buf);
+    new_leaf->Init(new_page_id, leaf->GetParentPageId());
+    leaf->MoveHalfTo(new_leaf);
+    new_leaf->SetNextPageId(leaf->GetNextPageId());
+    leaf->SetNextPageId(new_page_id);
+
+    KeyType separator = KeyTraits<KeyType>::Separator(leaf->KeyAt(leaf->GetSize() - 1), new_leaf->KeyAt(0));
+    InsertIntoParent(leaf, separator, new_leaf);
+    return true;
+}
+
+// old_node and new_node are split siblings still held in the caller's buffers.
+// This links new_node into the parent (growing a new root if needed), writes both
+// nodes, and splits the parent recursively when it fills up.
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node) {
+    if (old_node->IsRootPage()) {
+        page_id_t root_id = disk_manager_->AllocatePage();
+        alignas(8) char root_buf[NODE_SIZE];
+        std::memset(root_buf, 0, NODE_SIZE);
+        InternalPage* root = CastPage<InternalPage>(root_buf);
+        root->Init(root_id, -1);
+        root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+
+        old_node->SetParentPageId(root_id);
+        new_node->SetParentPageId(root_id);
+        WriteNode(old_node->GetPageId(), reinterpret_cast<const char*>(old_node));
+        WriteNode(new_node->GetPageId(), reinterpret_cast<const char*>(new_node));
+        WriteNode(root_id, root_buf);
+        UpdateRootPageId(root_id);
+        return;
+    }
+
+    page_id_t parent_id = old_node->GetParentPageId();
+    new_node->SetParentPageId(parent_id);
+    // Persist the children first: a parent split below re-reads them from disk to re-parent them
+    WriteNode(old_node->GetPageId(), reinterpret_cast<const char*>(old_node));
+    WriteNode(new_node->GetPageId(), reinterpret_cast<const char*>(new_node));
+
+    alignas(8) char parent_buf[NODE_SIZE];
+    ReadNode(parent_id, parent_buf);
+    InternalPage* parent = CastPage<InternalPage>(parent_buf);
+    parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+
+    if (!parent->IsOverfull()) {
+        WriteNode(parent_id, parent_buf);
+        return;
+    }
+    SplitInternal(parent_buf);
+}
+
+// node_buf holds an internal node too full to be written: its upper half moves to a
+// new sibling and the middle key goes up
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SplitInternal(char *node_buf) {
+    InternalPage* node = CastPage<InternalPage>(node_buf);
+    page_id_t sibling_id = disk_manager_->AllocatePage();
+    alignas(8) char sibling_buf[NODE_SIZE];
+    std::memset(sibling_buf, 0, NODE_SIZE);
+    InternalPage* sibling = CastPage<InternalPage>(sibling_buf);
+    sibling->Init(sibling_id, node->GetParentPageId());
+    node->MoveHalfTo(sibling, disk_manager_);
+
+    InsertIntoParent(node, sibling->KeyAt(0), sibling);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::UpdateRootPageId(page_id_t root_page_id) {
+    root_page_id_ = root_page_id;
+
+    alignas(8) char buf[PAGE_SIZE];
+    std::memset(buf, 0, PAGE_SIZE);
+    BPlusTreeHeaderPage* header = CastPage<BPlusTreeHeaderPage>(buf);
+    header->Init(unique_);
+    header->SetRootPageId(root_page_id);
+    disk_manager_->WritePage(header_page_id_, buf);
+}
+
+// Reads the leaf that covers key into buf and returns its page id. With `leftmost`
+// it is the first leaf that may hold key, the start point for duplicate and range walks.
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, char *buf, bool leftmost) {
+    page_id_t current_page_id = root_page_id_;
     while (true) {
-        disk_manager_->ReadPage(current_page_id, buf);
+        ReadPageShared(current_page_id, buf);
         BPlusTreePage* page = CastPage<BPlusTreePage>(buf);
-        
         if (page->IsLeafPage()) {
-            break; 
+            return current_page_id;
+        }
+        InternalPage* internal = CastPage<InternalPage>(buf);
+        current_page_id = leftmost ? internal->LookupFirst(key, comparator_) : internal->Lookup(key, comparator_);
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReadPageShared(page_id_t page_id, char *buf) {
+    std::shared_lock<std::shared_mutex> page_lock(PageLatch(page_id));
+    ReadNode(page_id, buf);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReadNode(page_id_t page_id, char *buf) {
+    if (!COMPRESSED) {
+        disk_manager_->ReadPage(page_id, buf);
+        return;
+    }
+    alignas(8) char page[PAGE_SIZE];
+    disk_manager_->ReadPage(page_id, page);
+    if (CastPage<BPlusTreePage>(page)->IsLeafPage()) {
+        LeafPage::Decode(page, buf);
+    } else {
+        InternalPage::Decode(page, buf);
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::WriteNode(page_id_t page_id, const char *buf) {
+    if (!COMPRESSED) {
+        disk_manager_->WritePage(page_id, buf);
+        return;
+    }
+    alignas(8) char page[PAGE_SIZE];
+    if (reinterpret_cast<const BPlusTreePage*>(buf)->IsLeafPage()) {
+        reinterpret_cast<const LeafPage*>(buf)->Encode(page);
+    } else {
+        reinterpret_cast<const InternalPage*>(buf)->Encode(page);
+    }
+    disk_manager_->WritePage(page_id, page);
+}
+
+namespace {
+
+// Whether a leaf can give up an entry without merging or borrowing (a root leaf must not empty)
+template <typename LeafPage>
+bool CanShrink(const LeafPage* leaf) {
+    return leaf->IsRootPage() ? leaf->GetSize() > 1 : leaf->GetSize() > leaf->GetMinSize();
+}
+
+} // namespace
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key) {
+    {
+        std::shared_lock<std::shared_mutex> tree_lock(tree_latch_);
+        if (root_page_id_ == -1) return;
+        alignas(8) char buf[NODE_SIZE];
+        page_id_t leaf_id = FindLeafPage(key, buf);
+        std::unique_lock<std::shared_mutex> leaf_lock(PageLatch(leaf_id));
+        ReadNode(leaf_id, buf);
+        LeafPage* leaf = CastPage<LeafPage>(buf);
+        if (leaf->KeyIndex(key, comparator_) == -1) return;
+        if (CanShrink(leaf)) {
+            leaf->RemoveAndDeleteRecord(key, comparator_);
+            WriteNode(leaf_id, buf);
+            return;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> tree_lock = LockExclusive();
+    if (root_page_id_ == -1) return;
+
+    alignas(8) char buf[NODE_SIZE];
+    FindLeafPage(key, buf);
+    LeafPage* leaf = CastPage<LeafPage>(buf);
+    int old_size = leaf->GetSize();
+    if (leaf->RemoveAndDeleteRecord(key, comparator_) == old_size) {
+        return; // Key not present
+    }
+    RebalanceAfterRemove(buf);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::Remove(const KeyType &key, const RID &value) {
+    {
+        // Walk the duplicates one leaf at a time; entries only change leaves under the
+        // exclusive latch, so the walk cannot miss one
+        std::shared_lock<std::shared_mutex> tree_lock(tree_latch_);
+        if (root_page_id_ == -1) return false;
+        alignas(8) char buf[NODE_SIZE];
+        page_id_t leaf_id = FindLeafPage(key, buf, true);
+        while (true) {
+            std::unique_lock<std::shared_mutex> leaf_lock(PageLatch(leaf_id));
+            ReadNode(leaf_id, buf);
+            LeafPage* leaf = CastPage<LeafPage>(buf);
+            bool can_shrink = CanShrink(leaf);
+            int old_size = leaf->GetSize();
+            if (leaf->RemoveAndDeleteRecord(key, value, comparator_) != old_size) {
+                if (!can_shrink) break; // Leave the page alone and redo the removal below
+                WriteNode(leaf_id, buf);
+                return true;
+            }
+            if (old_size > 0 && comparator_(leaf->KeyAt(old_size - 1), key) > 0) return false;
+            leaf_id = leaf->GetNextPageId();
+            if (leaf_id == -1) return false;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> tree_lock = LockExclusive();
+    if (root_page_id_ == -1) return false;
+
+    alignas(8) char buf[NODE_SIZE];
+    FindLeafPage(key, buf, true);
+    while (true) {
+        LeafPage* leaf = CastPage<LeafPage>(buf);
+        int old_size = leaf->GetSize();
+        if (leaf->RemoveAndDeleteRecord(key, value, comparator_) != old_size) {
+            RebalanceAfterRemove(buf);
+            return true;
+        }
+        // Entries with this key may continue in the next leaf
+        if (old_size > 0 && comparator_(leaf->KeyAt(old_size - 1), key) > 0) return false;
+        page_id_t next_page_id = leaf->GetNextPageId();
+        if (next_page_id == -1) return false;
+        ReadNode(next_page_id, buf);
+    }
+}
+
+// leaf_buf holds a leaf that just lost an entry
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RebalanceAfterRemove(char *leaf_buf) {
+    LeafPage* leaf = CastPage<LeafPage>(leaf_buf);
+    if (leaf->IsRootPage()) {
+        AdjustRoot(leaf_buf);
+    } else if (leaf->GetSize() < leaf->GetMinSize()) {
+        CoalesceOrRedistribute(leaf_buf);
+    } else {
+        WriteNode(leaf->GetPageId(), leaf_buf);
+    }
+}
+
+// node_buf holds an underfull node. If it fits together with a sibling the two are
+// merged (right into left) and the separator is removed from the parent, which may
+// underflow in turn; otherwise one entry is borrowed from the sibling.
+// Pages emptied by a merge are not reused (the DiskManager has no free list yet).
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CoalesceOrRedistribute(char *node_buf) {
+    BPlusTreePage* node = CastPage<BPlusTreePage>(node_buf);
+    if (node->IsRootPage()) {
+        AdjustRoot(node_buf);
+        return;
+    }
+
+    alignas(8) char parent_buf[NODE_SIZE];
+    ReadNode(node->GetParentPageId(), parent_buf);
+    InternalPage* parent = CastPage<InternalPage>(parent_buf);
+    int index = parent->ValueIndex(node->GetPageId());
+    int sibling_index = (index == 0) ? 1 : index - 1;
+
+    alignas(8) char sibling_buf[NODE_SIZE];
+    ReadNode(parent->ValueAt(sibling_index), sibling_buf);
+    BPlusTreePage* sibling = CastPage<BPlusTreePage>(sibling_buf);
+
+    char* left_buf = (index == 0) ? node_buf : sibling_buf;
+    char* right_buf = (index == 0) ? sibling_buf : node_buf;
+    int right_index = (index == 0) ? 1 : index;
+    bool fits = node->IsLeafPage()
+                    ? CastPage<LeafPage>(left_buf)->CanAbsorb(CastPage<LeafPage>(right_buf))
+                    : CastPage<InternalPage>(left_buf)->CanAbsorb(CastPage<InternalPage>(right_buf),
+                                                                  parent->KeyAt(right_index));
+    if (fits) {
+        // Coalesce: always fold the right page into the left one
+        if (node->IsLeafPage()) {
+            CastPage<LeafPage>(right_buf)->MoveAllTo(CastPage<LeafPage>(left_buf));
         } else {
-            BPlusTreeInternalPage* internal = CastPage<BPlusTreeInternalPage>(buf);
-            current_page_id = internal->Lookup(key, 0);
+            CastPage<InternalPage>(right_buf)->MoveAllTo(
+                CastPage<InternalPage>(left_buf), parent->KeyAt(right_index), disk_manager_);
         }
+        WriteNode(CastPage<BPlusTreePage>(left_buf)->GetPageId(), left_buf);
+
+        parent->Remove(right_index);
+        bool parent_underflow = parent->IsRootPage() ? parent->GetSize() < 2
+                                                     : parent->GetSize() < parent->GetMinSize();
+        if (parent_underflow) {
+            CoalesceOrRedistribute(parent_buf);
+        } else {
+            WriteNode(parent->GetPageId(), parent_buf);
+        }
+        return;
     }
-    
-    // Now buf contains the leaf
-    BPlusTreeLeafPage* leaf = CastPage<BPlusTreeLeafPage>(buf);
-    
-    if (leaf->GetSize() < leaf->GetMaxSize()) {
-        leaf->Insert(key, value, 0);
-        disk_manager_->WritePage(current_page_id, buf);
-        return true;
+
+    // Redistribute: borrow the sibling's nearest entry and fix the separator
+    if (node->IsLeafPage()) {
+        LeafPage* leaf = CastPage<LeafPage>(node_buf);
+        LeafPage* sibling_leaf = CastPage<LeafPage>(sibling_buf);
+        if (index == 0) {
+            sibling_leaf->MoveFirstToEndOf(leaf);
+        } else {
+            sibling_leaf->MoveLastToFrontOf(leaf);
+        }
+        LeafPage* left = CastPage<LeafPage>(left_buf);
+        LeafPage* right = CastPage<LeafPage>(right_buf);
+        parent->SetKeyAt(right_index,
+                         KeyTraits<KeyType>::Separator(left->KeyAt(left->GetSize() - 1), right->KeyAt(0)));
+    } else {
+        InternalPage* internal = CastPage<InternalPage>(node_buf);
+        InternalPage* sibling_internal = CastPage<InternalPage>(sibling_buf);
+        if (index == 0) {
+            sibling_internal->MoveFirstToEndOf(internal, parent->KeyAt(1), disk_manager_);
+            parent->SetKeyAt(1, sibling_internal->KeyAt(0));
+        } else {
+            KeyType new_separator = sibling_internal->KeyAt(sibling_internal->GetSize() - 1);
+            sibling_internal->MoveLastToFrontOf(internal, parent->KeyAt(index), disk_manager_);
+            parent->SetKeyAt(index, new_separator);
+        }
+    }
+    WriteNode(node->GetPageId(), node_buf);
+    WriteNode(sibling->GetPageId(), sibling_buf);
+    // A new separator can make a compressed parent outgrow its page
+    if (parent->IsOverfull()) {
+        SplitInternal(parent_buf);
     } else {
-        std::cerr << "Split logic not fully implemented in this phase yet!" << std::endl;
-        return false;
+        WriteNode(parent->GetPageId(), parent_buf);
     }
 }
 
-void BPlusTree::Remove(const int &key) {
-    // empty
+// Shrinks the tree at the root: an internal root left with one child hands the
+// root over to that child, and an empty root leaf empties the tree.
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::AdjustRoot(char *root_buf) {
+    BPlusTreePage* root = CastPage<BPlusTreePage>(root_buf);
+    if (!root->IsLeafPage() && root->GetSize() == 1) {
+        page_id_t child_id = CastPage<InternalPage>(root_buf)->RemoveAndReturnOnlyChild();
+        alignas(8) char child_buf[PAGE_SIZE];
+        disk_manager_->ReadPage(child_id, child_buf);
+        CastPage<BPlusTreePage>(child_buf)->SetParentPageId(-1);
+        disk_manager_->WritePage(child_id, child_buf);
+        UpdateRootPageId(child_id);
+        return;
+    }
+    if (root->IsLeafPage() && root->GetSize() == 0) {
+        UpdateRootPageId(-1);
+        return;
+    }
+    WriteNode(root->GetPageId(), root_buf);
 }
 
-void BPlusTree::Print(page_id_t page_id) {
-    // empty
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Print(page_id_t page_id) {
+    std::shared_lock<std::shared_mutex> tree_lock(tree_latch_, std::defer_lock);
+    if (page_id == -1) {
+        tree_lock.lock(); // Only the outermost call; children are printed under it
+        page_id = root_page_id_;
+    }
+    if (page_id == -1) {
+        std::cout << "Index " << index_name_ << " is empty." << std::endl;
+        return;
+    }
+
+    alignas(8) char buf[NODE_SIZE];
+    ReadNode(page_id, buf);
+    BPlusTreePage* page = CastPage<BPlusTreePage>(buf);
+    if (page->IsLeafPage()) {
+        LeafPage* leaf = CastPage<LeafPage>(buf);
+        std::cout << "Leaf " << page_id << " (parent " << leaf->GetParentPageId()
+                  << ", next " << leaf->GetNextPageId() << "): ";
+        for (int i = 0; i < leaf->GetSize(); ++i) std::cout << leaf->KeyAt(i) << " ";
+        std::cout << std::endl;
+        return;
+    }
+
+    InternalPage* internal = CastPage<InternalPage>(buf);
+    std::cout << "Internal " << page_id << " (parent " << internal->GetParentPageId() << "): ";
+    for (int i = 1; i < internal->GetSize(); ++i) std::cout << internal->KeyAt(i) << " ";
+    std::cout << std::endl;
+    std::vector<page_id_t> children;
+    for (int i = 0; i < internal->GetSize(); ++i) children.push_back(internal->ValueAt(i));
+    for (page_id_t child : children) Print(child);
 }
 
+#define INSTANTIATE_B_PLUS_TREE(KeyType, KeyComparator) template class BPlusTree<KeyType, KeyComparator>;
+MYDB_FOR_EACH_BPLUS_TREE_KEY(INSTANTIATE_B_PLUS_TREE)
+
 } // namespace mydb
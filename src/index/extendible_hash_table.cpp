@@ -0,0 +1,301 @@
+#include "index/extendible_hash_table.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace mydb {
+
+namespace {
+
+template <typename BucketPage>
+BucketPage *AsBucket(std::vector<char> &page) {
+    return reinterpret_cast<BucketPage *>(page.data());
+}
+
+} // namespace
+
+INDEX_TEMPLATE_ARGUMENTS
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(std::string name, DiskManager *disk_manager, page_id_t header_page_id,
+                                                const KeyComparator &comparator)
+    : index_name_(std::move(name)), header_page_id_(header_page_id), comparator_(comparator),
+      disk_manager_(disk_manager) {
+    std::memset(header_, 0, PAGE_SIZE);
+    if (header_page_id_ == -1) {
+        header_page_id_ = disk_manager_->AllocatePage();
+        Header()->Init();
+        disk_manager_->WritePage(header_page_id_, header_);
+    } else {
+        disk_manager_->ReadPage(header_page_id_, header_);
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::Hash(const KeyType &key) {
+    // FNV-1a, then a 64-bit finalizer so both the top bits (directory) and the low
+    // bits (bucket) depend on every byte
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&key);
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < sizeof(KeyType); ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return static_cast<uint32_t>(hash);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(const KeyType &key, std::vector<RID> &result) {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    uint32_t hash = Hash(key);
+    page_id_t directory_page_id = Header()->GetDirectoryPageId(Header()->HashToDirectoryIndex(hash));
+    if (directory_page_id == -1) return false;
+    alignas(8) char buf[PAGE_SIZE];
+    disk_manager_->ReadPage(directory_page_id, buf);
+    auto *directory = reinterpret_cast<HashTableDirectoryPage *>(buf);
+    page_id_t page_id = directory->GetBucketPageId(directory->HashToBucketIndex(hash));
+
+    size_t found = result.size();
+    while (page_id != -1) {
+        disk_manager_->ReadPage(page_id, buf);
+        auto *bucket = reinterpret_cast<BucketPage *>(buf);
+        bucket->GetValues(key, comparator_, result);
+        page_id = bucket->GetNextPageId();
+    }
+    return result.size() > found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::Insert(const KeyType &key, const RID &value) {
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    uint32_t hash = Hash(key);
+    uint32_t directory_index = Header()->HashToDirectoryIndex(hash);
+    page_id_t directory_page_id = Header()->GetDirectoryPageId(directory_index);
+    alignas(8) char directory_buf[PAGE_SIZE];
+    auto *directory = reinterpret_cast<HashTableDirectoryPage *>(directory_buf);
+    if (directory_page_id == -1) {
+        // First key under this directory: one bucket of local depth 0
+        page_id_t bucket_page_id = disk_manager_->AllocatePage();
+        WriteChain({bucket_page_id}, {});
+        directory_page_id = disk_manager_->AllocatePage();
+        std::memset(directory_buf, 0, PAGE_SIZE);
+        directory->Init(bucket_page_id);
+        disk_manager_->WritePage(directory_page_id, directory_buf);
+        Header()->SetDirectoryPageId(directory_index, directory_page_id);
+        disk_manager_->WritePage(header_page_id_, header_);
+    } else {
+        disk_manager_->ReadPage(directory_page_id, directory_buf);
+    }
+
+    // Hash bits that can still tell two keys of this directory apart
+    const uint32_t depth_mask = (1u << directory->GetMaxDepth()) - 1;
+    while (true) {
+        uint32_t bucket_index = directory->HashToBucketIndex(hash);
+        page_id_t page_id = directory->GetBucketPageId(bucket_index);
+        alignas(8) char bucket_buf[PAGE_SIZE];
+        auto *bucket = reinterpret_cast<BucketPage *>(bucket_buf);
+        bool splittable = false;
+        page_id_t last_page_id = -1;
+        while (page_id != -1) {
+            disk_manager_->ReadPage(page_id, bucket_buf);
+            if (bucket->Insert(key, value)) {
+                disk_manager_->WritePage(page_id, bucket_buf);
+                return;
+            }
+            for (int i = 0; i < bucket->GetSize() && !splittable; ++i) {
+                splittable = ((Hash(bucket->KeyAt(i)) ^ hash) & depth_mask) != 0;
+            }
+            last_page_id = page_id;
+            page_id = bucket->GetNextPageId();
+        }
+
+        // Full: split if some entry would leave, and retry
+        if (splittable && directory->GetLocalDepth(bucket_index) < directory->GetMaxDepth()) {
+            SplitBucket(directory, bucket_index);
+            disk_manager_->WritePage(directory_page_id, directory_buf);
+            continue;
+        }
+
+        // Every entry shares the key's hash: chain an overflow page
+        page_id_t overflow_page_id = disk_manager_->AllocatePage();
+        bucket->SetNextPageId(overflow_page_id);
+        disk_manager_->WritePage(last_page_id, bucket_buf);
+        std::memset(bucket_buf, 0, PAGE_SIZE);
+        bucket->Init();
+        bucket->Insert(key, value);
+        disk_manager_->WritePage(overflow_page_id, bucket_buf);
+        return;
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(const KeyType &key, const RID &value) {
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    uint32_t hash = Hash(key);
+    uint32_t directory_index = Header()->HashToDirectoryIndex(hash);
+    page_id_t directory_page_id = Header()->GetDirectoryPageId(directory_index);
+    if (directory_page_id == -1) return false;
+    alignas(8) char directory_buf[PAGE_SIZE];
+    disk_manager_->ReadPage(directory_page_id, directory_buf);
+    auto *directory = reinterpret_cast<HashTableDirectoryPage *>(directory_buf);
+    uint32_t bucket_index = directory->HashToBucketIndex(hash);
+
+    std::vector<page_id_t> page_ids;
+    std::vector<std::vector<char>> pages;
+    for (page_id_t page_id = directory->GetBucketPageId(bucket_index); page_id != -1;
+         page_id = AsBucket<BucketPage>(pages.back())->GetNextPageId()) {
+        page_ids.push_back(page_id);
+        pages.emplace_back(PAGE_SIZE);
+        disk_manager_->ReadPage(page_id, pages.back().data());
+    }
+
+    for (size_t p = 0; p < pages.size(); ++p) {
+        BucketPage *bucket = AsBucket<BucketPage>(pages[p]);
+        int index = bucket->EntryIndex(key, value, comparator_);
+        if (index == -1) continue;
+
+        // Fill the hole from the end of the chain, so only its last page can empty
+        size_t last = pages.size() - 1;
+        BucketPage *last_bucket = AsBucket<BucketPage>(pages[last]);
+        bucket->RemoveAt(index);
+        if (p != last) {
+            bucket->Insert(last_bucket->KeyAt(last_bucket->GetSize() - 1),
+                           last_bucket->ValueAt(last_bucket->GetSize() - 1));
+            last_bucket->RemoveAt(last_bucket->GetSize() - 1);
+        }
+        disk_manager_->WritePage(page_ids[p], pages[p].data());
+        if (last > 0 && last_bucket->GetSize() == 0) {
+            // Unlink the empty overflow page (it is not reused: no free list yet)
+            AsBucket<BucketPage>(pages[last - 1])->SetNextPageId(-1);
+            disk_manager_->WritePage(page_ids[last - 1], pages[last - 1].data());
+        } else if (p != last) {
+            disk_manager_->WritePage(page_ids[last], pages[last].data());
+        }
+
+        if (last == 0 && bucket->GetSize() == 0) {
+            MergeBuckets(directory, bucket_index);
+            if (directory->GetGlobalDepth() == 0 && IsEmptyBucket(directory->GetBucketPageId(0))) {
+                // Nothing left under this directory
+                Header()->SetDirectoryPageId(directory_index, -1);
+                disk_manager_->WritePage(header_page_id_, header_);
+            } else {
+                disk_manager_->WritePage(directory_page_id, directory_buf);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTENDIBLE_HASH_TABLE_TYPE::IsEmpty() const {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    for (uint32_t i = 0; i < Header()->MaxSize(); ++i) {
+        if (Header()->GetDirectoryPageId(i) != -1) return false;
+    }
+    return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::ReadChain(page_id_t bucket_page_id, std::vector<page_id_t> &page_ids,
+                                           std::vector<MappingType> &entries) {
+    alignas(8) char buf[PAGE_SIZE];
+    auto *bucket = reinterpret_cast<BucketPage *>(buf);
+    for (page_id_t page_id = bucket_page_id; page_id != -1; page_id = bucket->GetNextPageId()) {
+        disk_manager_->ReadPage(page_id, buf);
+        page_ids.push_back(page_id);
+        for (int i = 0; i < bucket->GetSize(); ++i) entries.push_back(bucket->GetItem(i));
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::WriteChain(std::vector<page_id_t> page_ids, const std::vector<MappingType> &entries) {
+    size_t pages = std::max<size_t>(1, (entries.size() + BucketPage::BUCKET_SIZE - 1) / BucketPage::BUCKET_SIZE);
+    while (page_ids.size() < pages) page_ids.push_back(disk_manager_->AllocatePage());
+    alignas(8) char buf[PAGE_SIZE];
+    auto *bucket = reinterpret_cast<BucketPage *>(buf);
+    size_t next = 0;
+    for (size_t p = 0; p < pages; ++p) {
+        std::memset(buf, 0, PAGE_SIZE);
+        bucket->Init();
+        while (next < entries.size() && bucket->Insert(entries[next].first, entries[next].second)) next++;
+        // Pages past the last one needed drop out of the chain
+        bucket->SetNextPageId(p + 1 < pages ? page_ids[p + 1] : -1);
+        disk_manager_->WritePage(page_ids[p], buf);
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTENDIBLE_HASH_TABLE_TYPE::IsEmptyBucket(page_id_t bucket_page_id) {
+    alignas(8) char buf[PAGE_SIZE];
+    disk_manager_->ReadPage(bucket_page_id, buf);
+    auto *bucket = reinterpret_cast<BucketPage *>(buf);
+    return bucket->GetSize() == 0 && bucket->GetNextPageId() == -1;
+}
+
+// Splits the (full) bucket at bucket_index on hash bit LocalDepth: the slots with that
+// bit set move to a new bucket along with the entries whose hash has it
+INDEX_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::SplitBucket(HashTableDirectoryPage *directory, uint32_t bucket_index) {
+    page_id_t old_page_id = directory->GetBucketPageId(bucket_index);
+    uint32_t local_depth = directory->GetLocalDepth(bucket_index);
+    if (local_depth == directory->GetGlobalDepth()) directory->IncrGlobalDepth();
+
+    page_id_t new_page_id = disk_manager_->AllocatePage();
+    const uint32_t bit = 1u << local_depth;
+    for (uint32_t i = 0; i < directory->Size(); ++i) {
+        if (directory->GetBucketPageId(i) != old_page_id) continue;
+        directory->SetLocalDepth(i, local_depth + 1);
+        if (i & bit) directory->SetBucketPageId(i, new_page_id);
+    }
+
+    std::vector<page_id_t> page_ids;
+    std::vector<MappingType> entries;
+    ReadChain(old_page_id, page_ids, entries);
+    std::vector<MappingType> stay;
+    std::vector<MappingType> moved;
+    for (const MappingType &entry : entries) {
+        (Hash(entry.first) & bit ? moved : stay).push_back(entry);
+    }
+    WriteChain(std::move(page_ids), stay);
+    WriteChain({new_page_id}, moved);
+}
+
+// The bucket at bucket_index just emptied. Folds empty buckets into their split images
+// while the two have the same local depth, then halves the directory as far as it goes.
+INDEX_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::MergeBuckets(HashTableDirectoryPage *directory, uint32_t bucket_index) {
+    while (true) {
+        uint32_t local_depth = directory->GetLocalDepth(bucket_index);
+        if (local_depth == 0) break;
+        uint32_t image_index = directory->GetSplitImageIndex(bucket_index);
+        if (directory->GetLocalDepth(image_index) != local_depth) break;
+
+        page_id_t page_id = directory->GetBucketPageId(bucket_index);
+        page_id_t image_page_id = directory->GetBucketPageId(image_index);
+        page_id_t kept;
+        if (IsEmptyBucket(page_id)) {
+            kept = image_page_id;
+        } else if (IsEmptyBucket(image_page_id)) {
+            kept = page_id;
+        } else {
+            break;
+        }
+        for (uint32_t i = 0; i < directory->Size(); ++i) {
+            page_id_t slot_page_id = directory->GetBucketPageId(i);
+            if (slot_page_id != page_id && slot_page_id != image_page_id) continue;
+            directory->SetBucketPageId(i, kept);
+            directory->SetLocalDepth(i, local_depth - 1);
+        }
+    }
+    while (directory->CanShrink()) directory->DecrGlobalDepth();
+}
+
+#define INSTANTIATE_EXTENDIBLE_HASH_TABLE(KeyType, KeyComparator) \
+    template class ExtendibleHashTable<KeyType, KeyComparator>;
+MYDB_FOR_EACH_INDEX_KEY(INSTANTIATE_EXTENDIBLE_HASH_TABLE)
+
+} // namespace mydb
@@ -0,0 +1,357 @@
+#include "index/hnsw_graph.h"
+#include "storage/page/hnsw_header_page.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <queue>
+
+namespace mydb {
+
+namespace {
+
+uint64_t RidKey(const RID &rid) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(rid.GetPageId())) << 32) | rid.GetSlotNum();
+}
+
+bool ParseCount(const std::string &text, uint32_t low, uint32_t high, uint32_t &out) {
+    if (text.empty() || text.size() > 9 || !std::all_of(text.begin(), text.end(), ::isdigit)) return false;
+    uint32_t value = static_cast<uint32_t>(std::stoul(text));
+    if (value < low || value > high) return false;
+    out = value;
+    return true;
+}
+
+} // namespace
+
+bool HnswParams::Parse(const std::vector<std::pair<std::string, std::string>> &options, HnswParams &params,
+                       std::string &error) {
+    for (const auto &option : options) {
+        std::string name = option.first;
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        if (name == "m") {
+            if (!ParseCount(option.second, 2, 64, params.m)) {
+                error = "m must be between 2 and 64";
+                return false;
+            }
+        } else if (name == "ef_construction") {
+            if (!ParseCount(option.second, 1, 4096, params.ef_construction)) {
+                error = "ef_construction must be between 1 and 4096";
+                return false;
+            }
+        } else if (name == "metric") {
+            if (!ParseDistanceMetric(option.second, params.metric)) {
+                error = "metric must be L2, IP or COSINE";
+                return false;
+            }
+        } else {
+            error = "unknown option '" + option.first + "' (use m, ef_construction or metric)";
+            return false;
+        }
+    }
+    return true;
+}
+
+HnswGraph::HnswGraph(DiskManager *disk_manager, page_id_t header_page_id, const HnswParams &params)
+    : disk_manager_(disk_manager), header_page_id_(header_page_id), params_(params) {
+    if (header_page_id_ == -1) {
+        header_page_id_ = disk_manager_->AllocatePage();
+        WriteHeader();
+        return;
+    }
+    char buf[PAGE_SIZE];
+    disk_manager_->ReadPage(header_page_id_, buf);
+    const auto *header = reinterpret_cast<const HnswHeaderPage *>(buf);
+    params_.m = header->GetM();
+    params_.ef_construction = header->GetEfConstruction();
+    params_.metric = static_cast<DistanceMetric>(header->GetMetric());
+    dims_ = header->GetDims();
+    entry_point_ = header->GetEntryPoint();
+    max_level_ = header->GetMaxLevel();
+    if (header->GetNodesPageId() == -1) return;
+    node_map_ = std::make_unique<PageSummaryMap>(disk_manager_, NodeSize(), header->GetNodesPageId());
+    link_map_ = std::make_unique<PageSummaryMap>(disk_manager_, LinksSize(), header->GetLinksPageId());
+    uint32_t node_count = header->GetNodeCount();
+    for (uint32_t node = 0; node < node_count; ++node) {
+        bool added = false;
+        char *record = node_map_->FindOrAdd(static_cast<page_id_t>(node), &added);
+        int32_t deleted = 1;
+        if (added) std::memcpy(record + 12, &deleted, sizeof(deleted)); // Never finished: keep it out of results
+        nodes_.push_back(record);
+        upper_.emplace_back();
+        for (uint32_t level = 1; level <= Level(node); ++level) {
+            upper_[node].push_back(link_map_->FindOrAdd(static_cast<page_id_t>(node * MAX_LEVELS + level)));
+        }
+        if (IsDeleted(node)) continue;
+        RID rid;
+        std::memcpy(&rid, record, sizeof(RID));
+        rids_[RidKey(rid)] = node;
+        live_count_++;
+    }
+    visited_.assign(nodes_.size(), 0);
+    rng_.seed(static_cast<uint32_t>(nodes_.size()));
+}
+
+uint32_t HnswGraph::MaxDims(uint32_t m) {
+    return (PAGE_SIZE - PageSummaryPage::HEADER_SIZE - sizeof(page_id_t) - (20 + 8 * m)) / 4;
+}
+
+uint32_t HnswGraph::Level(uint32_t node) const {
+    uint32_t level;
+    std::memcpy(&level, nodes_[node] + 8, sizeof(level));
+    return level;
+}
+
+bool HnswGraph::IsDeleted(uint32_t node) const {
+    int32_t deleted;
+    std::memcpy(&deleted, nodes_[node] + 12, sizeof(deleted));
+    return deleted != 0;
+}
+
+uint32_t *HnswGraph::Links(uint32_t node, uint32_t level) {
+    if (level == 0) return reinterpret_cast<uint32_t *>(nodes_[node] + 16 + dims_ * 4);
+    return reinterpret_cast<uint32_t *>(upper_[node][level - 1]);
+}
+
+bool HnswGraph::Insert(const float *vec, uint32_t dims, const RID &rid) {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (dims == 0 || (dims_ != 0 && dims != dims_) || dims > MaxDims(params_.m)) return false;
+    if (nodes_.size() >= static_cast<size_t>(INT32_MAX / MAX_LEVELS)) return false;
+    if (dims_ == 0) {
+        dims_ = dims;
+        CreateMaps();
+    }
+
+    uint32_t node = static_cast<uint32_t>(nodes_.size());
+    uint32_t level = RandomLevel();
+    char *record = node_map_->FindOrAdd(static_cast<page_id_t>(node));
+    int32_t deleted = 0;
+    std::memcpy(record, &rid, sizeof(RID));
+    std::memcpy(record + 8, &level, sizeof(level));
+    std::memcpy(record + 12, &deleted, sizeof(deleted));
+    std::memcpy(record + 16, vec, dims_ * sizeof(float));
+    nodes_.push_back(record);
+    upper_.emplace_back();
+    for (uint32_t l = 1; l <= level; ++l) {
+        page_id_t key = static_cast<page_id_t>(node * MAX_LEVELS + l);
+        upper_[node].push_back(link_map_->FindOrAdd(key));
+        MarkDirty(key, true);
+    }
+    MarkDirty(static_cast<page_id_t>(node), false);
+    visited_.push_back(0);
+    rids_[RidKey(rid)] = node;
+    live_count_++;
+
+    if (node == 0) {
+        entry_point_ = 0;
+        max_level_ = level;
+        Flush();
+        return true;
+    }
+
+    const float *query = Vector(node);
+    std::vector<Candidate> entry = {Descend(query, level)};
+    for (int32_t l = static_cast<int32_t>(std::min(level, max_level_)); l >= 0; --l) {
+        std::vector<Candidate> candidates = SearchLevel(query, entry, params_.ef_construction, l);
+        std::vector<uint32_t> neighbors = SelectNeighbors(candidates, params_.m);
+        uint32_t *links = Links(node, l);
+        links[0] = static_cast<uint32_t>(neighbors.size());
+        std::copy(neighbors.begin(), neighbors.end(), links + 1);
+        for (uint32_t neighbor : neighbors) Connect(neighbor, node, l);
+        entry = std::move(candidates);
+    }
+    if (level > max_level_) {
+        entry_point_ = node;
+        max_level_ = level;
+    }
+    Flush();
+    return true;
+}
+
+bool HnswGraph::Remove(const RID &rid) {
+    std::lock_guard<std::mutex> guard(latch_);
+    auto it = rids_.find(RidKey(rid));
+    if (it == rids_.end()) return false;
+    int32_t deleted = 1;
+    std::memcpy(nodes_[it->second] + 12, &deleted, sizeof(deleted));
+    MarkDirty(static_cast<page_id_t>(it->second), false);
+    rids_.erase(it);
+    live_count_--;
+    Flush();
+    return true;
+}
+
+std::vector<std::pair<float, RID>> HnswGraph::Search(const float *query, uint32_t dims, size_t k, size_t ef) {
+    std::lock_guard<std::mutex> guard(latch_);
+    std::vector<std::pair<float, RID>> results;
+    if (live_count_ == 0 || dims != dims_ || k == 0) return results;
+    ef = std::max(ef, k);
+    while (true) {
+        std::vector<Candidate> found = SearchLevel(query, {Descend(query, 0)}, ef, 0);
+        results.clear();
+        for (const Candidate &candidate : found) {
+            if (results.size() == k) break;
+            if (IsDeleted(candidate.second)) continue;
+            RID rid;
+            std::memcpy(&rid, nodes_[candidate.second], sizeof(RID));
+            results.emplace_back(candidate.first, rid);
+        }
+        // Deleted nodes may have crowded live ones out of the candidates
+        if (results.size() >= std::min(k, live_count_) || ef >= nodes_.size()) return results;
+        ef *= 2;
+    }
+}
+
+void HnswGraph::EndBulk() {
+    std::lock_guard<std::mutex> guard(latch_);
+    bulk_ = false;
+    dirty_nodes_.clear();
+    dirty_links_.clear();
+    if (node_map_) {
+        node_map_->WriteAll();
+        link_map_->WriteAll();
+    }
+    WriteHeader();
+}
+
+void HnswGraph::CreateMaps() {
+    node_map_ = std::make_unique<PageSummaryMap>(disk_manager_, NodeSize());
+    link_map_ = std::make_unique<PageSummaryMap>(disk_manager_, LinksSize());
+    WriteHeader();
+}
+
+uint32_t HnswGraph::RandomLevel() {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    double level = -std::log(1.0 - uniform(rng_)) / std::log(static_cast<double>(params_.m));
+    return std::min(static_cast<uint32_t>(level), MAX_LEVELS - 1);
+}
+
+HnswGraph::Candidate HnswGraph::Descend(const float *query, uint32_t level) {
+    Candidate current = {Distance(query, entry_point_), entry_point_};
+    for (uint32_t l = max_level_; l > level; --l) {
+        bool moved = true;
+        while (moved) {
+            moved = false;
+            const uint32_t *links = Links(current.second, l);
+            for (uint32_t i = 1; i <= links[0]; ++i) {
+                float distance = Distance(query, links[i]);
+                if (distance < current.first) {
+                    current = {distance, links[i]};
+                    moved = true;
+                }
+            }
+        }
+    }
+    return current;
+}
+
+std::vector<HnswGraph::Candidate> HnswGraph::SearchLevel(const float *query, const std::vector<Candidate> &entry,
+                                                         size_t ef, uint32_t level) {
+    if (++visit_mark_ == 0) {
+        std::fill(visited_.begin(), visited_.end(), 0);
+        visit_mark_ = 1;
+    }
+    // Closest unexpanded candidate on top / farthest kept result on top
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+    std::priority_queue<Candidate> results;
+    for (const Candidate &start : entry) {
+        if (visited_[start.second] == visit_mark_) continue;
+        visited_[start.second] = visit_mark_;
+        candidates.push(start);
+        results.push(start);
+        if (results.size() > ef) results.pop();
+    }
+    while (!candidates.empty()) {
+        Candidate closest = candidates.top();
+        if (results.size() >= ef && closest.first > results.top().first) break;
+        candidates.pop();
+        const uint32_t *links = Links(closest.second, level);
+        for (uint32_t i = 1; i <= links[0]; ++i) {
+            uint32_t neighbor = links[i];
+            if (visited_[neighbor] == visit_mark_) continue;
+            visited_[neighbor] = visit_mark_;
+            float distance = Distance(query, neighbor);
+            if (results.size() < ef || distance < results.top().first) {
+                candidates.push({distance, neighbor});
+                results.push({distance, neighbor});
+                if (results.size() > ef) results.pop();
+            }
+        }
+    }
+    std::vector<Candidate> found(results.size());
+    for (size_t i = found.size(); i-- > 0;) {
+        found[i] = results.top();
+        results.pop();
+    }
+    return found;
+}
+
+std::vector<uint32_t> HnswGraph::SelectNeighbors(const std::vector<Candidate> &candidates, size_t max) const {
+    std::vector<uint32_t> selected, pruned;
+    for (const Candidate &candidate : candidates) {
+        if (selected.size() >= max) break;
+        bool diverse = true;
+        for (uint32_t other : selected) {
+            if (VectorDistance(params_.metric, Vector(candidate.second), Vector(other), dims_) < candidate.first) {
+                diverse = false;
+                break;
+            }
+        }
+        (diverse ? selected : pruned).push_back(candidate.second);
+    }
+    // Fill up with the closest pruned ones, so nodes keep enough links
+    for (size_t i = 0; i < pruned.size() && selected.size() < max; ++i) selected.push_back(pruned[i]);
+    return selected;
+}
+
+void HnswGraph::Connect(uint32_t neighbor, uint32_t node, uint32_t level) {
+    uint32_t *links = Links(neighbor, level);
+    MarkDirty(static_cast<page_id_t>(level == 0 ? neighbor : neighbor * MAX_LEVELS + level), level != 0);
+    if (links[0] < MaxLinks(level)) {
+        links[1 + links[0]++] = node;
+        return;
+    }
+    const float *base = Vector(neighbor);
+    std::vector<Candidate> candidates;
+    for (uint32_t i = 1; i <= links[0]; ++i) {
+        candidates.push_back({VectorDistance(params_.metric, base, Vector(links[i]), dims_), links[i]});
+    }
+    candidates.push_back({VectorDistance(params_.metric, base, Vector(node), dims_), node});
+    std::sort(candidates.begin(), candidates.end());
+    std::vector<uint32_t> kept = SelectNeighbors(candidates, MaxLinks(level));
+    links[0] = static_cast<uint32_t>(kept.size());
+    std::copy(kept.begin(), kept.end(), links + 1);
+}
+
+void HnswGraph::Flush() {
+    if (bulk_) {
+        dirty_nodes_.clear();
+        dirty_links_.clear();
+        return;
+    }
+    for (auto *dirty : {&dirty_nodes_, &dirty_links_}) {
+        std::sort(dirty->begin(), dirty->end());
+        dirty->erase(std::unique(dirty->begin(), dirty->end()), dirty->end());
+    }
+    for (page_id_t key : dirty_nodes_) node_map_->WriteBack(key);
+    for (page_id_t key : dirty_links_) link_map_->WriteBack(key);
+    dirty_nodes_.clear();
+    dirty_links_.clear();
+    WriteHeader();
+}
+
+void HnswGraph::WriteHeader() {
+    char buf[PAGE_SIZE];
+    std::memset(buf, 0, PAGE_SIZE);
+    auto *header = reinterpret_cast<HnswHeaderPage *>(buf);
+    header->Init(params_.m, params_.ef_construction, static_cast<uint32_t>(params_.metric));
+    header->SetDims(dims_);
+    header->SetEntryPoint(entry_point_, max_level_);
+    header->SetNodeCount(static_cast<uint32_t>(nodes_.size()));
+    if (node_map_) header->SetMapPageIds(node_map_->GetFirstPageId(), link_map_->GetFirstPageId());
+    disk_manager_->WritePage(header_page_id_, buf);
+}
+
+} // namespace mydb
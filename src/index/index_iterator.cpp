@@ -0,0 +1,249 @@
+#include "index/index_iterator.h"
+#include "index/b_plus_tree.h"
+#include "index/index_key.h"
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+
+namespace mydb {
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BPlusTree<KeyType, KeyComparator>* tree)
+    : tree_(tree), page_(BPlusTree<KeyType, KeyComparator>::NODE_SIZE) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BPlusTree<KeyType, KeyComparator>* tree, std::vector<char> leaf, int index,
+                                  uint64_t version)
+    : tree_(tree), index_(index), page_(std::move(leaf)), version_(version) {
+    page_id_ = Leaf()->GetPageId();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType INDEXITERATOR_TYPE::Key() const {
+    return Leaf()->KeyAt(index_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+RID INDEXITERATOR_TYPE::Value() const {
+    return Leaf()->ValueAt(index_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator++() -> IndexIterator& {
+    if (run_direction_ != 1) skipping_ = false;
+    do {
+        StepForward();
+    } while (skipping_ && Visited());
+    return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator--() -> IndexIterator& {
+    if (run_direction_ != -1) skipping_ = false;
+    do {
+        StepBackward();
+    } while (skipping_ && Visited());
+    return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::StepForward() {
+    if (IsEnd()) return;
+    if (++index_ < Leaf()->GetSize()) return;
+
+    std::shared_lock<std::shared_mutex> tree_lock(tree_->tree_latch_);
+    RememberRun(Leaf()->GetSize() - 1, 1);
+    if (tree_->structure_version_ != version_) {
+        SeekAfterRun();
+        return;
+    }
+    // Nothing split or merged since the leaf was read, so its next link still holds
+    page_id_t next_page_id = Leaf()->GetNextPageId();
+    if (next_page_id == -1) {
+        SetEnd();
+    } else {
+        Load(next_page_id);
+        index_ = 0;
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::StepBackward() {
+    if (!IsEnd() && index_ > 0) {
+        index_--;
+        return;
+    }
+
+    std::shared_lock<std::shared_mutex> tree_lock(tree_->tree_latch_);
+    if (IsEnd()) {
+        // Last entry of the tree
+        page_id_t root_page_id = tree_->root_page_id_;
+        if (root_page_id == -1) return;
+        run_.clear();
+        skipping_ = false;
+        DescendRightmost(root_page_id);
+        index_ = Leaf()->GetSize() - 1;
+        if (index_ < 0) SetEnd();
+        return;
+    }
+    RememberRun(0, -1);
+    if (tree_->structure_version_ != version_) {
+        SeekBeforeRun();
+    } else {
+        PreviousLeaf();
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Load(page_id_t page_id) {
+    tree_->ReadPageShared(page_id, page_.data());
+    page_id_ = page_id;
+    version_ = tree_->structure_version_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SetEnd() {
+    page_id_ = -1;
+    index_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::DescendRightmost(page_id_t page_id) {
+    Load(page_id);
+    while (!reinterpret_cast<BPlusTreePage*>(page_.data())->IsLeafPage()) {
+        auto* internal = reinterpret_cast<InternalPage*>(page_.data());
+        Load(internal->ValueAt(internal->GetSize() - 1));
+    }
+}
+
+// Climb until the path has a left neighbour, then take that subtree's last leaf
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::PreviousLeaf() {
+    page_id_t child_id = page_id_;
+    page_id_t parent_id = Leaf()->GetParentPageId();
+    std::vector<char> parent_buf(BPlusTree<KeyType, KeyComparator>::NODE_SIZE);
+    while (parent_id != -1) {
+        tree_->ReadPageShared(parent_id, parent_buf.data());
+        auto* parent = reinterpret_cast<InternalPage*>(parent_buf.data());
+        int child_index = parent->ValueIndex(child_id);
+        if (child_index > 0) {
+            DescendRightmost(parent->ValueAt(child_index - 1));
+            index_ = Leaf()->GetSize() - 1;
+            return;
+        }
+        child_id = parent_id;
+        parent_id = parent->GetParentPageId();
+    }
+    SetEnd(); // Stepped back past the first entry
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::RememberRun(int from, int direction) {
+    const LeafPage* leaf = Leaf();
+    KeyType key = leaf->KeyAt(from);
+    // A run belongs to one key and one direction
+    if (tree_->comparator_(key, run_key_) != 0 || direction != run_direction_) {
+        run_.clear();
+        skipping_ = false;
+    }
+    run_key_ = key;
+    run_direction_ = direction;
+    for (int i = from; i >= 0 && i < leaf->GetSize() && tree_->comparator_(leaf->KeyAt(i), key) == 0;
+         i -= direction) {
+        run_.push_back(leaf->ValueAt(i));
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEXITERATOR_TYPE::Visited() {
+    if (IsEnd()) return false;
+    if (tree_->comparator_(Key(), run_key_) != 0) {
+        skipping_ = false; // Past the run
+        return false;
+    }
+    return InRun(Value());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEXITERATOR_TYPE::InRun(const RID& rid) const {
+    return std::find(run_.begin(), run_.end(), rid) != run_.end();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SeekAfterRun() {
+    if (tree_->root_page_id_ == -1) {
+        SetEnd();
+        return;
+    }
+    page_id_ = tree_->FindLeafPage(run_key_, page_.data(), true);
+    version_ = tree_->structure_version_;
+    index_ = Leaf()->LowerBound(run_key_, tree_->comparator_);
+    skipping_ = true;
+    while (true) {
+        if (index_ >= Leaf()->GetSize()) {
+            page_id_t next_page_id = Leaf()->GetNextPageId();
+            if (next_page_id == -1) {
+                SetEnd();
+                return;
+            }
+            Load(next_page_id);
+            index_ = 0;
+            continue;
+        }
+        if (tree_->comparator_(Leaf()->KeyAt(index_), run_key_) > 0 || !InRun(Leaf()->ValueAt(index_))) return;
+        ++index_;
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SeekBeforeRun() {
+    if (tree_->root_page_id_ == -1) {
+        SetEnd();
+        return;
+    }
+    page_id_ = tree_->FindLeafPage(run_key_, page_.data(), true);
+    version_ = tree_->structure_version_;
+    index_ = Leaf()->LowerBound(run_key_, tree_->comparator_);
+    skipping_ = true;
+    std::vector<char> first_leaf = page_;
+    page_id_t first_page_id = page_id_;
+    int first_index = index_;
+
+    // The last unvisited entry with the run's key, if any
+    std::vector<char> found;
+    page_id_t found_page_id = -1;
+    int found_index = -1;
+    while (true) {
+        if (index_ >= Leaf()->GetSize()) {
+            page_id_t next_page_id = Leaf()->GetNextPageId();
+            if (next_page_id == -1) break;
+            Load(next_page_id);
+            index_ = 0;
+            continue;
+        }
+        if (tree_->comparator_(Leaf()->KeyAt(index_), run_key_) > 0) break;
+        if (!InRun(Leaf()->ValueAt(index_))) {
+            found = page_;
+            found_page_id = page_id_;
+            found_index = index_;
+        }
+        ++index_;
+    }
+    if (found_index != -1) {
+        page_ = std::move(found);
+        page_id_ = found_page_id;
+        index_ = found_index;
+        return;
+    }
+
+    // Otherwise the entry just before the first with the run's key
+    page_ = std::move(first_leaf);
+    page_id_ = first_page_id;
+    index_ = first_index - 1;
+    if (index_ < 0) PreviousLeaf();
+}
+
+#define INSTANTIATE_INDEX_ITERATOR(KeyType, KeyComparator) template class IndexIterator<KeyType, KeyComparator>;
+MYDB_FOR_EACH_BPLUS_TREE_KEY(INSTANTIATE_INDEX_ITERATOR)
+
+} // namespace mydb
@@ -0,0 +1,583 @@
+#include "index/ivf_pq.h"
+#include "storage/page/ivf_pq_header_page.h"
+#include "storage/page/page_summary_page.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <random>
+
+namespace mydb {
+
+namespace {
+
+constexpr uint32_t KMEANS_ITERATIONS = 10;
+constexpr uint32_t DELETED_SLOT = UINT32_MAX;
+
+bool ParseCount(const std::string &text, uint32_t low, uint32_t high, uint32_t &out) {
+    if (text.empty() || text.size() > 9 || !std::all_of(text.begin(), text.end(), ::isdigit)) return false;
+    uint32_t value = static_cast<uint32_t>(std::stoul(text));
+    if (value < low || value > high) return false;
+    out = value;
+    return true;
+}
+
+// Runs fn(begin, end) over [0, n) in chunks, as scheduler tasks when there are enough
+void ForChunks(TaskScheduler *scheduler, size_t parallelism, size_t n, const std::function<void(size_t, size_t)> &fn) {
+    constexpr size_t CHUNK = 256;
+    if (scheduler == nullptr || parallelism <= 1 || n < 2 * CHUNK) {
+        fn(0, n);
+        return;
+    }
+    TaskGroup group(scheduler);
+    for (size_t begin = 0; begin < n; begin += CHUNK) {
+        size_t end = std::min(begin + CHUNK, n);
+        group.Run([&fn, begin, end]() { fn(begin, end); });
+    }
+    group.Wait();
+}
+
+// Squared L2 distance; k-means over sub-vectors runs on a few floats at a time, where
+// the kernel dispatch would cost more than the arithmetic
+inline float L2Squared(const float *a, const float *b, size_t n) {
+    if (n >= 16) return VectorDistance(DistanceMetric::L2, a, b, n);
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+// Index of the centroid (k of them, d floats each) nearest to v by L2
+uint32_t Nearest(const float *v, const float *centroids, size_t k, size_t d) {
+    uint32_t best = 0;
+    float best_distance = INFINITY;
+    for (size_t c = 0; c < k; ++c) {
+        float distance = L2Squared(v, centroids + c * d, d);
+        if (distance < best_distance) {
+            best_distance = distance;
+            best = static_cast<uint32_t>(c);
+        }
+    }
+    return best;
+}
+
+// Lloyd's k-means over n rows of d floats, seeded with k distinct rows (repeating
+// them if n < k); an emptied cluster is reseeded with a random row
+void KMeans(const float *data, size_t n, size_t d, size_t k, std::vector<float> &centroids, std::mt19937 &rng,
+            TaskScheduler *scheduler, size_t parallelism) {
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    centroids.assign(k * d, 0.0f);
+    for (size_t c = 0; c < k; ++c) {
+        size_t row = order[c % n];
+        std::copy(data + row * d, data + (row + 1) * d, centroids.data() + c * d);
+    }
+
+    std::vector<uint32_t> assignment(n);
+    std::vector<double> sums(k * d);
+    std::vector<size_t> counts(k);
+    for (uint32_t iteration = 0; iteration < KMEANS_ITERATIONS; ++iteration) {
+        ForChunks(scheduler, parallelism, n, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) assignment[i] = Nearest(data + i * d, centroids.data(), k, d);
+        });
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (size_t i = 0; i < n; ++i) {
+            counts[assignment[i]]++;
+            for (size_t t = 0; t < d; ++t) sums[assignment[i] * d + t] += data[i * d + t];
+        }
+        for (size_t c = 0; c < k; ++c) {
+            if (counts[c] == 0) {
+                size_t row = rng() % n;
+                std::copy(data + row * d, data + (row + 1) * d, centroids.data() + c * d);
+                continue;
+            }
+            for (size_t t = 0; t < d; ++t) centroids[c * d + t] = static_cast<float>(sums[c * d + t] / counts[c]);
+        }
+    }
+}
+
+} // namespace
+
+bool IvfPqParams::Parse(const std::vector<std::pair<std::string, std::string>> &options, IvfPqParams &params,
+                        std::string &error) {
+    for (const auto &option : options) {
+        std::string name = option.first;
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        if (name == "lists") {
+            if (!ParseCount(option.second, 1, IvfPq::MAX_LISTS, params.lists)) {
+                error = "lists must be between 1 and " + std::to_string(IvfPq::MAX_LISTS);
+                return false;
+            }
+        } else if (name == "subvectors") {
+            if (!ParseCount(option.second, 1, IvfPq::MaxDims(), params.sub_vectors)) {
+                error = "subvectors must be between 1 and " + std::to_string(IvfPq::MaxDims());
+                return false;
+            }
+        } else if (name == "metric") {
+            if (!ParseDistanceMetric(option.second, params.metric)) {
+                error = "metric must be L2, IP or COSINE";
+                return false;
+            }
+        } else {
+            error = "unknown option '" + option.first + "' (use lists, subvectors or metric)";
+            return false;
+        }
+    }
+    return true;
+}
+
+IvfPq::IvfPq(DiskManager *disk_manager, page_id_t header_page_id, const IvfPqParams &params)
+    : disk_manager_(disk_manager), header_page_id_(header_page_id), params_(params) {
+    if (header_page_id_ == -1) {
+        header_page_id_ = disk_manager_->AllocatePage();
+        WriteHeader();
+        return;
+    }
+    char buf[PAGE_SIZE];
+    disk_manager_->ReadPage(header_page_id_, buf);
+    const auto *header = reinterpret_cast<const IvfPqHeaderPage *>(buf);
+    dims_ = header->GetDims();
+    params_.lists = header->GetLists();
+    params_.sub_vectors = header->GetSubVectors();
+    params_.metric = static_cast<DistanceMetric>(header->GetMetric());
+    trained_ = header->IsTrained();
+    live_count_ = header->GetLiveCount();
+    pending_count_ = header->GetPendingCount();
+    if (header->GetDirectoryPageId() != -1) {
+        directory_ = std::make_unique<PageSummaryMap>(disk_manager_, DIRECTORY_RECORD_SIZE,
+                                                      header->GetDirectoryPageId());
+    }
+    if (!trained_) return;
+
+    // Only the quantizers are kept; the maps that stored them are dropped again
+    centroids_page_id_ = header->GetCentroidsPageId();
+    codebooks_page_id_ = header->GetCodebooksPageId();
+    PageSummaryMap centroid_map(disk_manager_, dims_ * sizeof(float), centroids_page_id_);
+    centroids_.assign(static_cast<size_t>(params_.lists) * dims_, 0.0f);
+    for (uint32_t list = 0; list < params_.lists; ++list) {
+        const char *record = centroid_map.Find(static_cast<page_id_t>(list));
+        if (record != nullptr) std::memcpy(centroids_.data() + list * dims_, record, dims_ * sizeof(float));
+    }
+    PageSummaryMap codebook_map(disk_manager_, static_cast<uint32_t>(SubDims() * sizeof(float)), codebooks_page_id_);
+    codebooks_.assign(params_.sub_vectors * CODEBOOK_SIZE * SubDims(), 0.0f);
+    std::vector<float> codeword(SubDims());
+    for (uint32_t key = 0; key < params_.sub_vectors * CODEBOOK_SIZE; ++key) {
+        const char *record = codebook_map.Find(static_cast<page_id_t>(key));
+        if (record == nullptr) continue;
+        std::memcpy(codeword.data(), record, SubDims() * sizeof(float));
+        float *codebook = codebooks_.data() + (key / CODEBOOK_SIZE) * SubDims() * CODEBOOK_SIZE;
+        for (size_t t = 0; t < SubDims(); ++t) codebook[t * CODEBOOK_SIZE + key % CODEBOOK_SIZE] = codeword[t];
+    }
+}
+
+uint32_t IvfPq::MaxDims() {
+    return (PAGE_SIZE - PageSummaryPage::HEADER_SIZE - sizeof(page_id_t) - sizeof(uint32_t)) / sizeof(float);
+}
+
+uint32_t IvfPq::TrainRows() const {
+    return std::min(std::max(TRAIN_ROWS, 16 * params_.lists), MAX_TRAIN_ROWS);
+}
+
+std::vector<float> IvfPq::Prepare(const float *vec) const {
+    std::vector<float> prepared(vec, vec + dims_);
+    if (params_.metric != DistanceMetric::COSINE) return prepared;
+    double norm = 0;
+    for (float x : prepared) norm += static_cast<double>(x) * x;
+    if (norm > 0) {
+        float scale = static_cast<float>(1.0 / std::sqrt(norm));
+        for (float &x : prepared) x *= scale;
+    }
+    return prepared;
+}
+
+uint32_t IvfPq::NearestList(const float *vec) const {
+    return Nearest(vec, centroids_.data(), params_.lists, dims_);
+}
+
+void IvfPq::SubTable(uint32_t s, const float *vec, bool inner_product, float *out) const {
+    size_t begin = SubBegin(s), width = SubBegin(s + 1) - begin;
+    const float *codebook = SubCodebook(s);
+    std::fill(out, out + CODEBOOK_SIZE, 0.0f);
+    for (size_t t = 0; t < width; ++t) {
+        const float x = vec[begin + t];
+        const float *row = codebook + t * CODEBOOK_SIZE;
+        if (inner_product) {
+            for (uint32_t j = 0; j < CODEBOOK_SIZE; ++j) out[j] -= x * row[j];
+        } else {
+            for (uint32_t j = 0; j < CODEBOOK_SIZE; ++j) {
+                float diff = x - row[j];
+                out[j] += diff * diff;
+            }
+        }
+    }
+}
+
+uint32_t IvfPq::Encode(const float *vec, uint8_t *code) const {
+    uint32_t list = NearestList(vec);
+    std::vector<float> residual(dims_);
+    for (uint32_t t = 0; t < dims_; ++t) residual[t] = vec[t] - centroids_[list * dims_ + t];
+    float distances[CODEBOOK_SIZE];
+    for (uint32_t s = 0; s < params_.sub_vectors; ++s) {
+        SubTable(s, residual.data(), false, distances);
+        code[s] = static_cast<uint8_t>(std::min_element(distances, distances + CODEBOOK_SIZE) - distances);
+    }
+    return list;
+}
+
+bool IvfPq::Insert(const float *vec, uint32_t dims, const RID &rid) {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (dims == 0 || (dims_ != 0 && dims != dims_) || dims > MaxDims()) return false;
+    if (dims_ == 0) dims_ = dims;
+    std::vector<float> prepared = Prepare(vec);
+    live_count_++;
+    if (!trained_) {
+        Append(PENDING_LIST, 4 + dims_ * sizeof(float), {rid}, reinterpret_cast<const char *>(prepared.data()));
+        pending_count_++;
+        if (pending_count_ >= TrainRows()) TrainPending(nullptr, 1);
+        WriteHeader();
+        return true;
+    }
+    std::vector<uint8_t> code(params_.sub_vectors);
+    uint32_t list = Encode(prepared.data(), code.data());
+    Append(static_cast<page_id_t>(list), 4 + params_.sub_vectors, {rid}, reinterpret_cast<const char *>(code.data()));
+    WriteHeader();
+    return true;
+}
+
+void IvfPq::BulkInsert(const std::vector<const float *> &vecs, uint32_t dims, const std::vector<RID> &rids,
+                       TaskScheduler *scheduler, size_t parallelism) {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (vecs.empty() || dims == 0 || (dims_ != 0 && dims != dims_) || dims > MaxDims()) return;
+    if (dims_ == 0) dims_ = dims;
+    std::vector<float> prepared(vecs.size() * dims_);
+    std::vector<const float *> rows(vecs.size());
+    for (size_t i = 0; i < vecs.size(); ++i) {
+        std::vector<float> row = Prepare(vecs[i]);
+        std::copy(row.begin(), row.end(), prepared.begin() + i * dims_);
+        rows[i] = prepared.data() + i * dims_;
+    }
+    live_count_ += vecs.size();
+    if (!trained_ && pending_count_ == 0 && vecs.size() >= TrainRows()) {
+        Train(rows, rows.size(), scheduler, parallelism);
+    }
+    if (trained_) {
+        EncodeAll(rows, rids, scheduler, parallelism);
+    } else {
+        Append(PENDING_LIST, 4 + dims_ * sizeof(float), rids, reinterpret_cast<const char *>(prepared.data()));
+        pending_count_ += vecs.size();
+        if (pending_count_ >= TrainRows()) TrainPending(scheduler, parallelism);
+    }
+    WriteHeader();
+}
+
+bool IvfPq::Remove(const float *vec, uint32_t dims, const RID &rid) {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (dims == 0 || dims != dims_ || live_count_ == 0) return false;
+    bool found = false;
+    if (!trained_) {
+        found = Tombstone(PENDING_LIST, rid);
+    } else {
+        uint32_t list = NearestList(Prepare(vec).data());
+        found = Tombstone(static_cast<page_id_t>(list), rid);
+        // Rounding may pick another list than the insert did: look through the rest
+        for (uint32_t other = 0; !found && other < params_.lists; ++other) {
+            if (other != list) found = Tombstone(static_cast<page_id_t>(other), rid);
+        }
+    }
+    if (!found) return false;
+    live_count_--;
+    WriteHeader();
+    return true;
+}
+
+std::vector<std::pair<float, RID>> IvfPq::Search(const float *query, uint32_t dims, size_t k, size_t nprobe) {
+    std::lock_guard<std::mutex> guard(latch_);
+    std::vector<std::pair<float, RID>> results;
+    if (!trained_ || dims != dims_ || k == 0 || live_count_ == 0) return results;
+    std::vector<float> q = Prepare(query);
+    const bool inner_product = params_.metric == DistanceMetric::INNER_PRODUCT;
+    const DistanceMetric metric = inner_product ? DistanceMetric::INNER_PRODUCT : DistanceMetric::L2;
+
+    std::vector<std::pair<float, uint32_t>> lists(params_.lists);
+    for (uint32_t list = 0; list < params_.lists; ++list) {
+        lists[list] = {VectorDistance(metric, q.data(), centroids_.data() + list * dims_, dims_), list};
+    }
+    nprobe = std::min<size_t>(std::max<size_t>(nprobe, 1), lists.size());
+    std::partial_sort(lists.begin(), lists.begin() + nprobe, lists.end());
+
+    // table[s * CODEBOOK_SIZE + j]: distance contribution of slice s having code j. For
+    // L2 it depends on the list (the query's residual); for IP the list only adds <q, c>.
+    const uint32_t sub_vectors = params_.sub_vectors;
+    std::vector<float> table(sub_vectors * CODEBOOK_SIZE);
+    std::vector<float> residual(dims_);
+    auto fill_table = [&](const float *base) {
+        for (uint32_t s = 0; s < sub_vectors; ++s) SubTable(s, base, inner_product, table.data() + s * CODEBOOK_SIZE);
+    };
+    if (inner_product) fill_table(q.data());
+
+    // Max-heap of the k best (distance, RID) so far
+    using Scored = std::pair<float, uint64_t>;
+    std::vector<Scored> heap;
+    char buf[PAGE_SIZE];
+    const auto *page = reinterpret_cast<const PageSummaryPage *>(buf);
+    for (size_t p = 0; p < nprobe; ++p) {
+        uint32_t list = lists[p].second;
+        const char *directory = directory_ ? directory_->Find(static_cast<page_id_t>(list)) : nullptr;
+        if (directory == nullptr) continue;
+        float bias = 0.0f;
+        if (inner_product) {
+            bias = lists[p].first;
+        } else {
+            for (uint32_t t = 0; t < dims_; ++t) residual[t] = q[t] - centroids_[list * dims_ + t];
+            fill_table(residual.data());
+        }
+        page_id_t page_id;
+        std::memcpy(&page_id, directory, sizeof(page_id));
+        while (page_id != -1) {
+            disk_manager_->ReadPage(page_id, buf);
+            for (uint32_t i = 0; i < page->GetCount(); ++i) {
+                const char *entry = page->SummaryAt(i);
+                uint32_t slot;
+                std::memcpy(&slot, entry, sizeof(slot));
+                if (slot == DELETED_SLOT) continue;
+                const uint8_t *code = reinterpret_cast<const uint8_t *>(entry + 4);
+                float distance = bias;
+                for (uint32_t s = 0; s < sub_vectors; ++s) distance += table[s * CODEBOOK_SIZE + code[s]];
+                if (heap.size() == k && distance >= heap.front().first) continue;
+                uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(page->HeapPageIdAt(i))) << 32) | slot;
+                if (heap.size() == k) {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.pop_back();
+                }
+                heap.emplace_back(distance, key);
+                std::push_heap(heap.begin(), heap.end());
+            }
+            page_id = page->GetNextPageId();
+        }
+    }
+    std::sort(heap.begin(), heap.end());
+    for (const Scored &scored : heap) {
+        // L2 over unit vectors is twice the cosine distance
+        float distance = params_.metric == DistanceMetric::COSINE ? scored.first / 2 : scored.first;
+        results.emplace_back(distance, RID(static_cast<int32_t>(scored.second >> 32),
+                                           static_cast<uint32_t>(scored.second)));
+    }
+    return results;
+}
+
+void IvfPq::Train(const std::vector<const float *> &vecs, size_t total_rows, TaskScheduler *scheduler,
+                  size_t parallelism) {
+    std::mt19937 rng(static_cast<uint32_t>(vecs.size()));
+    std::vector<size_t> sample(vecs.size());
+    std::iota(sample.begin(), sample.end(), 0);
+    if (sample.size() > MAX_TRAIN_ROWS) {
+        std::shuffle(sample.begin(), sample.end(), rng);
+        sample.resize(MAX_TRAIN_ROWS);
+    }
+    size_t n = sample.size();
+    std::vector<float> data(n * dims_);
+    for (size_t i = 0; i < n; ++i) std::copy(vecs[sample[i]], vecs[sample[i]] + dims_, data.begin() + i * dims_);
+
+    uint32_t lists = params_.lists != 0 ? params_.lists
+                                        : static_cast<uint32_t>(std::lround(std::sqrt(static_cast<double>(total_rows))));
+    params_.lists = std::max<uint32_t>(1, std::min<uint32_t>({lists, MAX_LISTS, static_cast<uint32_t>(n)}));
+    uint32_t sub_vectors = params_.sub_vectors != 0 ? params_.sub_vectors : dims_ / 4;
+    params_.sub_vectors = std::max<uint32_t>(1, std::min(sub_vectors, dims_));
+
+    KMeans(data.data(), n, dims_, params_.lists, centroids_, rng, scheduler, parallelism);
+    // The codebooks are trained on residuals, which are what Encode quantizes
+    ForChunks(scheduler, parallelism, n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            float *row = data.data() + i * dims_;
+            uint32_t list = NearestList(row);
+            for (uint32_t t = 0; t < dims_; ++t) row[t] -= centroids_[list * dims_ + t];
+        }
+    });
+    codebooks_.assign(params_.sub_vectors * CODEBOOK_SIZE * SubDims(), 0.0f);
+    std::vector<float> slice, codewords;
+    for (uint32_t s = 0; s < params_.sub_vectors; ++s) {
+        size_t begin = SubBegin(s), width = SubBegin(s + 1) - begin;
+        slice.resize(n * width);
+        for (size_t i = 0; i < n; ++i) {
+            std::copy(data.begin() + i * dims_ + begin, data.begin() + i * dims_ + begin + width,
+                      slice.begin() + i * width);
+        }
+        KMeans(slice.data(), n, width, CODEBOOK_SIZE, codewords, rng, scheduler, parallelism);
+        float *codebook = codebooks_.data() + s * SubDims() * CODEBOOK_SIZE;
+        for (uint32_t j = 0; j < CODEBOOK_SIZE; ++j) {
+            for (size_t t = 0; t < width; ++t) codebook[t * CODEBOOK_SIZE + j] = codewords[j * width + t];
+        }
+    }
+
+    PageSummaryMap centroid_map(disk_manager_, dims_ * sizeof(float));
+    for (uint32_t list = 0; list < params_.lists; ++list) {
+        std::memcpy(centroid_map.FindOrAdd(static_cast<page_id_t>(list)), centroids_.data() + list * dims_,
+                    dims_ * sizeof(float));
+    }
+    centroid_map.WriteAll();
+    // On disk each codeword is a record of its own (key slice * CODEBOOK_SIZE + code)
+    PageSummaryMap codebook_map(disk_manager_, static_cast<uint32_t>(SubDims() * sizeof(float)));
+    for (uint32_t key = 0; key < params_.sub_vectors * CODEBOOK_SIZE; ++key) {
+        float *record = reinterpret_cast<float *>(codebook_map.FindOrAdd(static_cast<page_id_t>(key)));
+        const float *codebook = SubCodebook(key / CODEBOOK_SIZE);
+        for (size_t t = 0; t < SubDims(); ++t) record[t] = codebook[t * CODEBOOK_SIZE + key % CODEBOOK_SIZE];
+    }
+    codebook_map.WriteAll();
+    centroids_page_id_ = centroid_map.GetFirstPageId();
+    codebooks_page_id_ = codebook_map.GetFirstPageId();
+    trained_ = true;
+}
+
+void IvfPq::TrainPending(TaskScheduler *scheduler, size_t parallelism) {
+    std::vector<float> data;
+    std::vector<RID> rids;
+    const char *directory = directory_->Find(PENDING_LIST);
+    page_id_t page_id = -1;
+    if (directory != nullptr) std::memcpy(&page_id, directory, sizeof(page_id));
+    char buf[PAGE_SIZE];
+    const auto *page = reinterpret_cast<const PageSummaryPage *>(buf);
+    while (page_id != -1) {
+        disk_manager_->ReadPage(page_id, buf);
+        for (uint32_t i = 0; i < page->GetCount(); ++i) {
+            const char *entry = page->SummaryAt(i);
+            uint32_t slot;
+            std::memcpy(&slot, entry, sizeof(slot));
+            if (slot == DELETED_SLOT) continue;
+            rids.emplace_back(page->HeapPageIdAt(i), slot);
+            const float *vec = reinterpret_cast<const float *>(entry + 4);
+            data.insert(data.end(), vec, vec + dims_);
+        }
+        page_id = page->GetNextPageId();
+    }
+    if (rids.empty()) return;
+
+    std::vector<const float *> rows(rids.size());
+    for (size_t i = 0; i < rows.size(); ++i) rows[i] = data.data() + i * dims_;
+    Train(rows, rows.size(), scheduler, parallelism);
+    EncodeAll(rows, rids, scheduler, parallelism);
+    // The pending pages are abandoned, like the pages of dropped indexes
+    char *record = directory_->FindOrAdd(PENDING_LIST);
+    page_id_t none = -1;
+    uint32_t count = 0;
+    std::memcpy(record, &none, sizeof(none));
+    std::memcpy(record + 4, &none, sizeof(none));
+    std::memcpy(record + 8, &count, sizeof(count));
+    directory_->WriteBack(PENDING_LIST);
+    pending_count_ = 0;
+}
+
+void IvfPq::EncodeAll(const std::vector<const float *> &vecs, const std::vector<RID> &rids, TaskScheduler *scheduler,
+                      size_t parallelism) {
+    const uint32_t sub_vectors = params_.sub_vectors;
+    std::vector<uint8_t> codes(vecs.size() * sub_vectors);
+    std::vector<uint32_t> lists(vecs.size());
+    ForChunks(scheduler, parallelism, vecs.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) lists[i] = Encode(vecs[i], codes.data() + i * sub_vectors);
+    });
+
+    // Append list by list, so each list's pages are written once
+    std::vector<size_t> order(vecs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&lists](size_t a, size_t b) { return lists[a] < lists[b]; });
+    std::vector<RID> batch_rids;
+    std::vector<char> batch_codes;
+    for (size_t i = 0; i < order.size(); ++i) {
+        batch_rids.push_back(rids[order[i]]);
+        const uint8_t *code = codes.data() + order[i] * sub_vectors;
+        batch_codes.insert(batch_codes.end(), code, code + sub_vectors);
+        if (i + 1 == order.size() || lists[order[i + 1]] != lists[order[i]]) {
+            Append(static_cast<page_id_t>(lists[order[i]]), 4 + sub_vectors, batch_rids, batch_codes.data());
+            batch_rids.clear();
+            batch_codes.clear();
+        }
+    }
+}
+
+void IvfPq::Append(page_id_t list, uint32_t summary_size, const std::vector<RID> &rids, const char *payloads) {
+    if (!directory_) directory_ = std::make_unique<PageSummaryMap>(disk_manager_, DIRECTORY_RECORD_SIZE);
+    bool added = false;
+    char *record = directory_->FindOrAdd(list, &added);
+    page_id_t first_page_id = -1, last_page_id = -1;
+    uint32_t count = 0;
+    if (!added) {
+        std::memcpy(&first_page_id, record, sizeof(first_page_id));
+        std::memcpy(&last_page_id, record + 4, sizeof(last_page_id));
+        std::memcpy(&count, record + 8, sizeof(count));
+    }
+
+    char buf[PAGE_SIZE];
+    auto *page = reinterpret_cast<PageSummaryPage *>(buf);
+    page_id_t page_id = last_page_id;
+    if (page_id != -1) disk_manager_->ReadPage(page_id, buf);
+    const uint32_t payload_size = summary_size - 4;
+    for (size_t i = 0; i < rids.size(); ++i) {
+        if (page_id == -1 || page->IsFull()) {
+            page_id_t next_page_id = disk_manager_->AllocatePage();
+            if (page_id != -1) {
+                page->SetNextPageId(next_page_id);
+                disk_manager_->WritePage(page_id, buf);
+            } else {
+                first_page_id = next_page_id;
+            }
+            std::memset(buf, 0, PAGE_SIZE);
+            page->Init(summary_size);
+            page_id = next_page_id;
+        }
+        uint32_t index = page->Add(rids[i].GetPageId());
+        uint32_t slot = rids[i].GetSlotNum();
+        std::memcpy(page->SummaryAt(index), &slot, sizeof(slot));
+        std::memcpy(page->SummaryAt(index) + 4, payloads + i * payload_size, payload_size);
+    }
+    if (page_id != -1) disk_manager_->WritePage(page_id, buf);
+
+    count += static_cast<uint32_t>(rids.size());
+    std::memcpy(record, &first_page_id, sizeof(first_page_id));
+    std::memcpy(record + 4, &page_id, sizeof(page_id));
+    std::memcpy(record + 8, &count, sizeof(count));
+    directory_->WriteBack(list);
+}
+
+bool IvfPq::Tombstone(page_id_t list, const RID &rid) {
+    const char *directory = directory_ ? directory_->Find(list) : nullptr;
+    if (directory == nullptr) return false;
+    page_id_t page_id;
+    std::memcpy(&page_id, directory, sizeof(page_id));
+    char buf[PAGE_SIZE];
+    auto *page = reinterpret_cast<PageSummaryPage *>(buf);
+    while (page_id != -1) {
+        disk_manager_->ReadPage(page_id, buf);
+        for (uint32_t i = 0; i < page->GetCount(); ++i) {
+            uint32_t slot;
+            std::memcpy(&slot, page->SummaryAt(i), sizeof(slot));
+            if (page->HeapPageIdAt(i) != rid.GetPageId() || slot != rid.GetSlotNum()) continue;
+            slot = DELETED_SLOT;
+            std::memcpy(page->SummaryAt(i), &slot, sizeof(slot));
+            disk_manager_->WritePage(page_id, buf);
+            return true;
+        }
+        page_id = page->GetNextPageId();
+    }
+    return false;
+}
+
+void IvfPq::WriteHeader() {
+    char buf[PAGE_SIZE];
+    std::memset(buf, 0, PAGE_SIZE);
+    auto *header = reinterpret_cast<IvfPqHeaderPage *>(buf);
+    header->Init(params_.lists, params_.sub_vectors, static_cast<uint32_t>(params_.metric));
+    header->SetDims(dims_);
+    if (trained_) header->SetTrained(params_.lists, params_.sub_vectors);
+    header->SetCounts(static_cast<uint32_t>(live_count_), static_cast<uint32_t>(pending_count_));
+    header->SetDirectoryPageId(directory_ ? directory_->GetFirstPageId() : -1);
+    header->SetQuantizerPageIds(centroids_page_id_, codebooks_page_id_);
+    disk_manager_->WritePage(header_page_id_, buf);
+}
+
+} // namespace mydb
@@ -0,0 +1,586 @@
+#include "index/table_index.h"
+#include "index/b_plus_tree.h"
+#include "index/extendible_hash_table.h"
+#include "index/hnsw_graph.h"
+#include "index/ivf_pq.h"
+#include "storage/page_summary_map.h"
+#include <algorithm>
+
+namespace mydb {
+
+namespace {
+
+// The key `tuple` has in an index over key_columns
+template <typename KeyType>
+KeyType MakeKey(const Tuple &tuple, const std::vector<uint32_t> &key_columns) {
+    Value values[2];
+    for (size_t i = 0; i < key_columns.size(); ++i) values[i] = tuple.GetValue(key_columns[i]);
+    return KeyTraits<KeyType>::Make(values);
+}
+
+// INCLUDE values as stored in a covering key: a flag byte (1 if every value fit), then
+// per column an INT as 4 bytes or a VARCHAR as a length byte and its bytes. When the
+// values do not fit, the payload is all zeros and the row has to come from the heap.
+IncludePayload EncodeIncluded(const Tuple &tuple, const std::vector<uint32_t> &include_columns) {
+    IncludePayload payload = KeyTraits<IncludePayload>::Min();
+    size_t pos = 1;
+    for (uint32_t column : include_columns) {
+        const Value &value = tuple.GetValue(column);
+        if (value.GetTypeId() == TypeID::INTEGER) {
+            int32_t v = value.GetAsInteger();
+            if (pos + sizeof(v) > INCLUDE_PAYLOAD_SIZE) return KeyTraits<IncludePayload>::Min();
+            std::memcpy(payload.data + pos, &v, sizeof(v));
+            pos += sizeof(v);
+        } else if (value.GetTypeId() == TypeID::VARCHAR) {
+            const std::string &v = value.GetAsString();
+            if (v.size() > UINT8_MAX || pos + 1 + v.size() > INCLUDE_PAYLOAD_SIZE) {
+                return KeyTraits<IncludePayload>::Min();
+            }
+            payload.data[pos] = static_cast<char>(v.size());
+            std::memcpy(payload.data + pos + 1, v.data(), v.size());
+            pos += 1 + v.size();
+        } else {
+            return KeyTraits<IncludePayload>::Min();
+        }
+    }
+    payload.data[0] = 1;
+    return payload;
+}
+
+// Writes the INCLUDE values back into `values` (indexed by column); false if the
+// payload does not hold them
+bool DecodeIncluded(const IncludePayload &payload, const std::vector<uint32_t> &include_columns,
+                    const std::vector<TypeID> &include_types, std::vector<Value> &values) {
+    if (payload.data[0] != 1) return false;
+    size_t pos = 1;
+    for (size_t i = 0; i < include_columns.size(); ++i) {
+        if (include_types[i] == TypeID::INTEGER) {
+            int32_t v;
+            std::memcpy(&v, payload.data + pos, sizeof(v));
+            values[include_columns[i]] = Value(v);
+            pos += sizeof(v);
+        } else {
+            size_t length = static_cast<unsigned char>(payload.data[pos]);
+            values[include_columns[i]] = Value(std::string(payload.data + pos + 1, length));
+            pos += 1 + length;
+        }
+    }
+    return true;
+}
+
+// Secondary index over a non-unique BPlusTree keyed by KeyType
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeIndex : public TableIndex {
+public:
+    BPlusTreeIndex(const std::string &name, DiskManager *disk_manager, std::vector<uint32_t> key_columns,
+                   page_id_t header_page_id)
+        : key_columns_(std::move(key_columns)), tree_(name, disk_manager, header_page_id, false) {}
+
+    void InsertEntry(const Tuple &tuple, const RID &rid) override {
+        tree_.Insert(MakeKey(tuple), rid);
+    }
+
+    bool DeleteEntry(const Tuple &tuple, const RID &rid) override {
+        return tree_.Remove(MakeKey(tuple), rid);
+    }
+
+    std::vector<RID> ScanRange(const Value &low, const Value &high, bool descending) override {
+        std::vector<RID> rids;
+        Scan(low, high, descending, [&rids](const KeyType &, const RID &rid) { rids.push_back(rid); });
+        return rids;
+    }
+
+    bool BulkLoad(const std::vector<Tuple> &tuples, const std::vector<RID> &rids, int fill_percent,
+                  TaskScheduler *scheduler, size_t parallelism) override {
+        if (!tree_.IsEmpty()) return false;
+        using Entry = typename BPlusTree<KeyType, KeyComparator>::MappingType;
+        std::vector<Entry> entries;
+        entries.reserve(tuples.size());
+        for (size_t i = 0; i < tuples.size(); ++i) entries.emplace_back(MakeKey(tuples[i]), rids[i]);
+
+        // Equal keys keep heap order, as one-by-one inserts of a scan would
+        const KeyComparator comparator;
+        ParallelSort(scheduler, entries.begin(), entries.end(), [&comparator](const Entry &a, const Entry &b) {
+            int cmp = comparator(a.first, b.first);
+            if (cmp != 0) return cmp < 0;
+            if (a.second.GetPageId() != b.second.GetPageId()) return a.second.GetPageId() < b.second.GetPageId();
+            return a.second.GetSlotNum() < b.second.GetSlotNum();
+        }, parallelism);
+        return tree_.BulkLoad(entries, fill_percent);
+    }
+
+    bool IsEmpty() const override { return tree_.IsEmpty(); }
+    page_id_t GetHeaderPageId() const override { return tree_.GetHeaderPageId(); }
+
+    IndexType GetType() const override { return IndexType::BPLUS_TREE; }
+
+protected:
+    virtual KeyType MakeKey(const Tuple &tuple) const { return mydb::MakeKey<KeyType>(tuple, key_columns_); }
+
+    // Calls visit(key, rid) for the entries whose leading key column lies in [low, high]
+    template <typename Visit>
+    void Scan(const Value &low, const Value &high, bool descending, Visit &&visit) {
+        const KeyComparator comparator;
+        bool open_low = low.GetTypeId() == TypeID::INVALID;
+        bool open_high = high.GetTypeId() == TypeID::INVALID;
+        KeyType low_key = open_low ? KeyTraits<KeyType>::Min() : KeyTraits<KeyType>::Low(low);
+        KeyType high_key = open_high ? KeyTraits<KeyType>::Max() : KeyTraits<KeyType>::High(high);
+
+        if (!descending) {
+            auto it = open_low ? tree_.Begin() : tree_.Begin(low_key);
+            for (; !it.IsEnd() && (open_high || comparator(it.Key(), high_key) <= 0); ++it) {
+                visit(it.Key(), it.Value());
+            }
+            return;
+        }
+        // Start just past the last key <= high and walk back
+        auto it = tree_.End();
+        if (!open_high) {
+            it = tree_.Begin(high_key);
+            while (!it.IsEnd() && comparator(it.Key(), high_key) <= 0) ++it;
+        }
+        for (--it; !it.IsEnd() && (open_low || comparator(it.Key(), low_key) >= 0); --it) {
+            visit(it.Key(), it.Value());
+        }
+    }
+
+    std::vector<uint32_t> key_columns_;
+    BPlusTree<KeyType, KeyComparator> tree_;
+};
+
+// B+ tree index whose keys also carry the values of the INCLUDE columns
+template <typename BaseKey, typename BaseComparator>
+class CoveringIndex : public BPlusTreeIndex<CoveringKey<BaseKey>, CoveringComparator<BaseKey, BaseComparator>> {
+    using Base = BPlusTreeIndex<CoveringKey<BaseKey>, CoveringComparator<BaseKey, BaseComparator>>;
+
+public:
+    CoveringIndex(const std::string &name, DiskManager *disk_manager, const Schema &schema,
+                  std::vector<uint32_t> key_columns, std::vector<uint32_t> include_columns, page_id_t header_page_id)
+        : Base(name, disk_manager, std::move(key_columns), header_page_id),
+          include_columns_(std::move(include_columns)),
+          column_count_(schema.GetColumnCount()) {
+        for (uint32_t column : include_columns_) include_types_.push_back(schema.GetColumn(column).GetType());
+        // A VARCHAR key column that is also included comes back whole from the payload
+        for (uint32_t column : this->key_columns_) {
+            key_included_.push_back(std::find(include_columns_.begin(), include_columns_.end(), column) !=
+                                    include_columns_.end());
+        }
+    }
+
+    bool Covers(const std::vector<bool> &columns) const override {
+        for (uint32_t column = 0; column < columns.size(); ++column) {
+            if (!columns[column]) continue;
+            auto &keys = this->key_columns_;
+            if (std::find(keys.begin(), keys.end(), column) == keys.end() &&
+                std::find(include_columns_.begin(), include_columns_.end(), column) == include_columns_.end()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void ScanCovered(const Value &low, const Value &high, bool descending, const std::vector<bool> &columns,
+                     std::vector<RID> &rids, std::vector<Tuple> &rows) override {
+        bool need_included = false;
+        for (uint32_t column : include_columns_) need_included |= column < columns.size() && columns[column];
+        // VARCHAR key columns needed but not also included must not have been cut short
+        bool need_exact_key = false;
+        for (size_t i = 0; i < this->key_columns_.size(); ++i) {
+            uint32_t column = this->key_columns_[i];
+            need_exact_key |= !key_included_[i] && column < columns.size() && columns[column];
+        }
+        rids.clear();
+        rows.clear();
+        this->Scan(low, high, descending, [&](const CoveringKey<BaseKey> &key, const RID &rid) {
+            rids.push_back(rid);
+            rows.push_back(Restore(key, need_included, need_exact_key));
+        });
+    }
+
+protected:
+    CoveringKey<BaseKey> MakeKey(const Tuple &tuple) const override {
+        return {mydb::MakeKey<BaseKey>(tuple, this->key_columns_), EncodeIncluded(tuple, include_columns_)};
+    }
+
+private:
+    // The row held by an entry, or an empty tuple if a needed value cannot be restored
+    Tuple Restore(const CoveringKey<BaseKey> &key, bool need_included, bool need_exact_key) const {
+        std::vector<Value> values(column_count_);
+        Value key_values[KeyTraits<BaseKey>::COLUMNS];
+        bool exact = KeyTraits<BaseKey>::Restore(key.first, key_values);
+        if (need_exact_key && !exact) return Tuple();
+        for (size_t i = 0; i < this->key_columns_.size(); ++i) values[this->key_columns_[i]] = key_values[i];
+        // Included values replace the key prefixes of columns that are both
+        bool decoded = DecodeIncluded(key.second, include_columns_, include_types_, values);
+        if (need_included && !decoded) return Tuple();
+        return Tuple(std::move(values));
+    }
+
+    std::vector<uint32_t> include_columns_;
+    std::vector<TypeID> include_types_;
+    std::vector<bool> key_included_;
+    uint32_t column_count_;
+};
+
+// Secondary index over an ExtendibleHashTable keyed by one column
+INDEX_TEMPLATE_ARGUMENTS
+class HashIndex : public TableIndex {
+public:
+    HashIndex(const std::string &name, DiskManager *disk_manager, std::vector<uint32_t> key_columns,
+              page_id_t header_page_id)
+        : key_columns_(std::move(key_columns)), table_(name, disk_manager, header_page_id) {}
+
+    void InsertEntry(const Tuple &tuple, const RID &rid) override {
+        table_.Insert(MakeKey<KeyType>(tuple, key_columns_), rid);
+    }
+
+    bool DeleteEntry(const Tuple &tuple, const RID &rid) override {
+        return table_.Remove(MakeKey<KeyType>(tuple, key_columns_), rid);
+    }
+
+    std::vector<RID> ScanRange(const Value &low, const Value &high, bool) override {
+        std::vector<RID> rids;
+        if (low.GetTypeId() == TypeID::INVALID || high.GetTypeId() == TypeID::INVALID) return rids;
+        KeyType key = KeyTraits<KeyType>::Make(&low);
+        if (KeyComparator()(key, KeyTraits<KeyType>::Make(&high)) != 0) return rids;
+        table_.GetValue(key, rids);
+        return rids;
+    }
+
+    bool BulkLoad(const std::vector<Tuple> &tuples, const std::vector<RID> &rids, int, TaskScheduler *,
+                  size_t) override {
+        if (!table_.IsEmpty()) return false;
+        for (size_t i = 0; i < tuples.size(); ++i) InsertEntry(tuples[i], rids[i]);
+        return true;
+    }
+
+    bool IsEmpty() const override { return table_.IsEmpty(); }
+    page_id_t GetHeaderPageId() const override { return table_.GetHeaderPageId(); }
+    IndexType GetType() const override { return IndexType::HASH; }
+
+private:
+    std::vector<uint32_t> key_columns_;
+    ExtendibleHashTable<KeyType, KeyComparator> table_;
+};
+
+// Bloom filter of one column's values per heap page, in a PageSummaryMap. Rows are
+// never taken out of a filter: a deleted value only makes its page a false positive.
+class BloomIndex : public TableIndex {
+public:
+    // 1024 bits and 4 probes: about 1% false positives for 100 distinct values on a
+    // page, 8% for 200
+    static constexpr uint32_t FILTER_BYTES = 128;
+    static constexpr uint32_t PROBES = 4;
+
+    BloomIndex(DiskManager *disk_manager, uint32_t key_column, page_id_t header_page_id)
+        : key_column_(key_column), filters_(disk_manager, FILTER_BYTES, header_page_id) {}
+
+    void InsertEntry(const Tuple &tuple, const RID &rid) override {
+        Add(tuple, rid);
+        filters_.WriteBack(rid.GetPageId());
+    }
+
+    bool DeleteEntry(const Tuple &, const RID &) override { return true; }
+
+    std::vector<RID> ScanRange(const Value &, const Value &, bool) override { return {}; }
+
+    bool PageMayMatch(page_id_t page_id, const Value &low, const Value &high) const override {
+        if (low.GetTypeId() == TypeID::INVALID || high.GetTypeId() == TypeID::INVALID) return true;
+        uint64_t hash = Hash(low);
+        if (hash != Hash(high)) return true;
+        const char *filter = filters_.Find(page_id);
+        if (filter == nullptr) return false; // No row was ever added on the page
+        for (uint32_t i = 0; i < PROBES; ++i) {
+            uint32_t bit = Probe(hash, i);
+            if ((filter[bit / 8] & (1 << (bit % 8))) == 0) return false;
+        }
+        return true;
+    }
+
+    bool BulkLoad(const std::vector<Tuple> &tuples, const std::vector<RID> &rids, int, TaskScheduler *,
+                  size_t) override {
+        if (!filters_.IsEmpty()) return false;
+        for (size_t i = 0; i < tuples.size(); ++i) Add(tuples[i], rids[i]);
+        filters_.WriteAll();
+        return true;
+    }
+
+    bool IsEmpty() const override { return filters_.IsEmpty(); }
+    page_id_t GetHeaderPageId() const override { return filters_.GetFirstPageId(); }
+    IndexType GetType() const override { return IndexType::BLOOM; }
+
+private:
+    void Add(const Tuple &tuple, const RID &rid) {
+        uint64_t hash = Hash(tuple.GetValue(key_column_));
+        char *filter = filters_.FindOrAdd(rid.GetPageId());
+        for (uint32_t i = 0; i < PROBES; ++i) {
+            uint32_t bit = Probe(hash, i);
+            filter[bit / 8] |= static_cast<char>(1 << (bit % 8));
+        }
+    }
+
+    // Double hashing: probe i is h1 + i * h2
+    static uint32_t Probe(uint64_t hash, uint32_t i) {
+        uint32_t h1 = static_cast<uint32_t>(hash);
+        uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+        return (h1 + i * h2) % (FILTER_BYTES * 8);
+    }
+
+    // FNV-1a over the whole value (not a key prefix), then a 64-bit finalizer
+    static uint64_t Hash(const Value &value) {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix_bytes = [&hash](const void *data, size_t size) {
+            const unsigned char *bytes = static_cast<const unsigned char *>(data);
+            for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 1099511628211ull;
+        };
+        if (value.GetTypeId() == TypeID::INTEGER) {
+            int32_t v = value.GetAsInteger();
+            mix_bytes(&v, sizeof(v));
+        } else {
+            const std::string &v = value.GetAsString();
+            mix_bytes(v.data(), v.size());
+        }
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    uint32_t key_column_;
+    PageSummaryMap filters_;
+};
+
+// Approximate nearest-neighbour index over one VECTOR column (see HnswGraph). Rows
+// whose vector the graph rejects (a different dimension count, or more than MaxDims)
+// are left out of it; the executor checks CREATE INDEX against MaxVectorDims.
+class HnswIndex : public TableIndex {
+public:
+    HnswIndex(DiskManager *disk_manager, uint32_t key_column, page_id_t header_page_id, const HnswParams &params)
+        : key_column_(key_column), graph_(disk_manager, header_page_id, params) {}
+
+    void InsertEntry(const Tuple &tuple, const RID &rid) override {
+        const std::vector<float> &vec = tuple.GetValue(key_column_).GetAsVector();
+        graph_.Insert(vec.data(), static_cast<uint32_t>(vec.size()), rid);
+    }
+
+    bool DeleteEntry(const Tuple &, const RID &rid) override { return graph_.Remove(rid); }
+
+    std::vector<RID> ScanRange(const Value &, const Value &, bool) override { return {}; }
+
+    bool SearchNearest(const std::vector<float> &query, DistanceMetric metric, size_t k, size_t ef,
+                       std::vector<RID> &rids) override {
+        if (metric != graph_.GetParams().metric) return false;
+        if (graph_.IsEmpty() || query.size() != graph_.GetDims()) return false;
+        rids.clear();
+        for (const auto &found : graph_.Search(query.data(), static_cast<uint32_t>(query.size()), k, ef)) {
+            rids.push_back(found.second);
+        }
+        return true;
+    }
+
+    bool BulkLoad(const std::vector<Tuple> &tuples, const std::vector<RID> &rids, int, TaskScheduler *,
+                  size_t) override {
+        if (!graph_.IsEmpty()) return false;
+        graph_.BeginBulk();
+        for (size_t i = 0; i < tuples.size(); ++i) InsertEntry(tuples[i], rids[i]);
+        graph_.EndBulk();
+        return true;
+    }
+
+    bool IsEmpty() const override { return graph_.IsEmpty(); }
+    size_t GetVectorCount() const override { return graph_.GetLiveCount(); }
+    page_id_t GetHeaderPageId() const override { return graph_.GetHeaderPageId(); }
+    IndexType GetType() const override { return IndexType::HNSW; }
+    IndexOptions GetOptions() const override {
+        const HnswParams &params = graph_.GetParams();
+        return {{"m", std::to_string(params.m)},
+                {"ef_construction", std::to_string(params.ef_construction)},
+                {"metric", DistanceMetricName(params.metric)}};
+    }
+
+private:
+    uint32_t key_column_;
+    HnswGraph graph_;
+};
+
+// Quantized approximate nearest-neighbour index over one VECTOR column (see IvfPq).
+// Its distances are approximate, so it returns RIDs for the caller to re-rank exactly.
+// Vectors longer than IvfPq::MaxDims are left out; the executor checks CREATE INDEX
+// against MaxVectorDims.
+class IvfPqIndex : public TableIndex {
+public:
+    IvfPqIndex(DiskManager *disk_manager, uint32_t key_column, page_id_t header_page_id, const IvfPqParams &params)
+        : key_column_(key_column), lists_(disk_manager, header_page_id, params) {}
+
+    void InsertEntry(const Tuple &tuple, const RID &rid) override {
+        const std::vector<float> &vec = tuple.GetValue(key_column_).GetAsVector();
+        lists_.Insert(vec.data(), static_cast<uint32_t>(vec.size()), rid);
+    }
+
+    bool DeleteEntry(const Tuple &tuple, const RID &rid) override {
+        const std::vector<float> &vec = tuple.GetValue(key_column_).GetAsVector();
+        return lists_.Remove(vec.data(), static_cast<uint32_t>(vec.size()), rid);
+    }
+
+    std::vector<RID> ScanRange(const Value &, const Value &, bool) override { return {}; }
+
+    bool SearchNearest(const std::vector<float> &query, DistanceMetric metric, size_t k, size_t breadth,
+                       std::vector<RID> &rids) override {
+        if (!lists_.IsTrained() || metric != lists_.GetParams().metric || query.size() != lists_.GetDims()) {
+            return false;
+        }
+        rids.clear();
+        for (const auto &found : lists_.Search(query.data(), static_cast<uint32_t>(query.size()), k, breadth)) {
+            rids.push_back(found.second);
+        }
+        return true;
+    }
+
+    bool BulkLoad(const std::vector<Tuple> &tuples, const std::vector<RID> &rids, int, TaskScheduler *scheduler,
+                  size_t parallelism) override {
+        if (!lists_.IsEmpty()) return false;
+        // Vectors of another length than the first are left out, as Insert would
+        std::vector<const float *> vecs;
+        std::vector<RID> kept;
+        size_t dims = lists_.GetDims();
+        for (size_t i = 0; i < tuples.size(); ++i) {
+            const std::vector<float> &vec = tuples[i].GetValue(key_column_).GetAsVector();
+            if (dims == 0) dims = vec.size();
+            if (vec.empty() || vec.size() != dims) continue;
+            vecs.push_back(vec.data());
+            kept.push_back(rids[i]);
+        }
+        lists_.BulkInsert(vecs, static_cast<uint32_t>(dims), kept, scheduler, parallelism);
+        return true;
+    }
+
+    bool IsEmpty() const override { return lists_.IsEmpty(); }
+    size_t GetVectorCount() const override { return lists_.GetLiveCount(); }
+    page_id_t GetHeaderPageId() const override { return lists_.GetHeaderPageId(); }
+    IndexType GetType() const override { return IndexType::IVF_PQ; }
+    IndexOptions GetOptions() const override {
+        const IvfPqParams &params = lists_.GetParams();
+        IndexOptions options;
+        if (params.lists != 0) options.emplace_back("lists", std::to_string(params.lists));
+        if (params.sub_vectors != 0) options.emplace_back("subvectors", std::to_string(params.sub_vectors));
+        options.emplace_back("metric", DistanceMetricName(params.metric));
+        return options;
+    }
+
+private:
+    uint32_t key_column_;
+    IvfPq lists_;
+};
+
+template <typename KeyType, typename KeyComparator>
+std::unique_ptr<TableIndex> MakeIndex(const std::string &name, DiskManager *disk_manager, const Schema &schema,
+                                      const std::vector<uint32_t> &key_columns, page_id_t header_page_id,
+                                      IndexType type, const std::vector<uint32_t> &include_columns) {
+    if (type == IndexType::HASH) {
+        return std::make_unique<HashIndex<KeyType, KeyComparator>>(name, disk_manager, key_columns, header_page_id);
+    }
+    if (!include_columns.empty()) {
+        return std::make_unique<CoveringIndex<KeyType, KeyComparator>>(name, disk_manager, schema, key_columns,
+                                                                       include_columns, header_page_id);
+    }
+    return std::make_unique<BPlusTreeIndex<KeyType, KeyComparator>>(name, disk_manager, key_columns, header_page_id);
+}
+
+} // namespace
+
+bool TableIndex::ValidateOptions(IndexType type, const IndexOptions &options, std::string &error) {
+    if (type == IndexType::HNSW) {
+        HnswParams params;
+        return HnswParams::Parse(options, params, error);
+    }
+    if (type == IndexType::IVF_PQ) {
+        IvfPqParams params;
+        return IvfPqParams::Parse(options, params, error);
+    }
+    if (options.empty()) return true;
+    error = std::string("USING ") + IndexTypeName(type) + " takes no WITH options";
+    return false;
+}
+
+uint32_t TableIndex::MaxVectorDims(IndexType type, const IndexOptions &options) {
+    std::string error;
+    if (type == IndexType::HNSW) {
+        HnswParams params;
+        return HnswParams::Parse(options, params, error) ? HnswGraph::MaxDims(params.m) : 0;
+    }
+    if (type == IndexType::IVF_PQ) {
+        IvfPqParams params;
+        return IvfPqParams::Parse(options, params, error) ? IvfPq::MaxDims() : 0;
+    }
+    return 0;
+}
+
+std::unique_ptr<TableIndex> TableIndex::Create(const std::string &name, DiskManager *disk_manager,
+                                               const Schema &schema, const std::vector<uint32_t> &key_columns,
+                                               page_id_t header_page_id, IndexType type,
+                                               const std::vector<uint32_t> &include_columns,
+                                               const IndexOptions &options) {
+    if (IsVectorIndex(type)) {
+        if (key_columns.size() != 1 || !include_columns.empty() || key_columns[0] >= schema.GetColumnCount() ||
+            schema.GetColumn(key_columns[0]).GetType() != TypeID::VECTOR) {
+            return nullptr;
+        }
+        std::string error;
+        if (type == IndexType::IVF_PQ) {
+            IvfPqParams params;
+            if (!IvfPqParams::Parse(options, params, error)) return nullptr;
+            return std::make_unique<IvfPqIndex>(disk_manager, key_columns[0], header_page_id, params);
+        }
+        HnswParams params;
+        if (!HnswParams::Parse(options, params, error)) return nullptr;
+        return std::make_unique<HnswIndex>(disk_manager, key_columns[0], header_page_id, params);
+    }
+    std::vector<TypeID> types;
+    for (uint32_t column : key_columns) {
+        if (column >= schema.GetColumnCount()) return nullptr;
+        TypeID column_type = schema.GetColumn(column).GetType();
+        if (column_type != TypeID::INTEGER && column_type != TypeID::VARCHAR) return nullptr;
+        types.push_back(column_type);
+    }
+    for (uint32_t column : include_columns) {
+        if (column >= schema.GetColumnCount()) return nullptr;
+        TypeID column_type = schema.GetColumn(column).GetType();
+        if (column_type != TypeID::INTEGER && column_type != TypeID::VARCHAR) return nullptr;
+    }
+    if (type != IndexType::BPLUS_TREE && !include_columns.empty()) return nullptr;
+    if (type == IndexType::BLOOM) {
+        if (key_columns.size() != 1) return nullptr;
+        return std::make_unique<BloomIndex>(disk_manager, key_columns[0], header_page_id);
+    }
+
+    bool first_int = !types.empty() && types[0] == TypeID::INTEGER;
+    if (types.size() == 1) {
+        if (first_int) {
+            return MakeIndex<IntKey, IntKeyComparator>(name, disk_manager, schema, key_columns, header_page_id,
+                                                       type, include_columns);
+        }
+        return MakeIndex<StrKey, StrKeyComparator>(name, disk_manager, schema, key_columns, header_page_id, type,
+                                                   include_columns);
+    }
+    if (type == IndexType::HASH) return nullptr; // Equality on the whole key is all a hash answers
+    if (types.size() == 2) {
+        bool second_int = types[1] == TypeID::INTEGER;
+        if (first_int && second_int) {
+            return MakeIndex<IntIntKey, IntIntKeyComparator>(name, disk_manager, schema, key_columns,
+                                                             header_page_id, type, include_columns);
+        }
+        if (first_int) {
+            return MakeIndex<IntStrKey, IntStrKeyComparator>(name, disk_manager, schema, key_columns,
+                                                             header_page_id, type, include_columns);
+        }
+        if (second_int) {
+            return MakeIndex<StrIntKey, StrIntKeyComparator>(name, disk_manager, schema, key_columns,
+                                                             header_page_id, type, include_columns);
+        }
+        return MakeIndex<StrStrKey, StrStrKeyComparator>(name, disk_manager, schema, key_columns, header_page_id,
+                                                         type, include_columns);
+    }
+    return nullptr;
+}
+
+} // namespace mydb
@@ -11,6 +11,7 @@
 #include "catalog/catalog_manager.h"
 #include "cli/shell.h"
 #include "server/http_server.h"
+#include "common/task_scheduler.h"
 
 namespace mydb {
 
@@ -152,8 +153,11 @@ int main(int argc, char* argv[]) {
         recovery_manager.ARIES();
         
         // 3. Initialize Executor & Shell
+        // Shared worker pool for parallel scans/sorts and server requests
+        mydb::TaskScheduler scheduler;
         mydb::Executor executor(&disk_manager);
     executor.SetFiles(db_file, cat_file);
+    executor.SetScheduler(&scheduler);
     
     // 4. Catalog Persistence
     mydb::CatalogManager catalog_manager(&executor, cat_file);
@@ -164,7 +168,7 @@ int main(int argc, char* argv[]) {
     // 5. Run Shell or Server
     if (server_mode) {
         try {
-            mydb::HttpServer server(&executor, &catalog_manager, server_port, api_key);
+            mydb::HttpServer server(&executor, &catalog_manager, server_port, api_key, &scheduler);
             server.Start();
         } catch (const std::exception& e) {
             std::cerr << "\n\033[1;31m[SERVER ERROR]\033[0m " << e.what() << std::endl;
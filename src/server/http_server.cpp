@@ -1,7 +1,6 @@
 #include "server/http_server.h"
 #include <iostream>
 #include <sstream>
-#include <thread>
 #include <vector>
 #include <cstring>
 
@@ -13,8 +12,10 @@
 
 namespace mydb {
 
-HttpServer::HttpServer(Executor* executor, CatalogManager* catalog, int port, const std::string& api_key)
-    : executor_(executor), catalog_(catalog), port_(port), api_key_(api_key), server_sock_(-1), running_(false) {
+HttpServer::HttpServer(Executor* executor, CatalogManager* catalog, int port, const std::string& api_key,
+                       TaskScheduler* scheduler)
+    : executor_(executor), catalog_(catalog), port_(port), api_key_(api_key), scheduler_(scheduler),
+      server_sock_(-1), running_(false) {
 #ifdef _WIN32
     WSADATA wsaData;
     if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
@@ -88,8 +89,12 @@ void HttpServer::Start() {
         if (client_sock < 0) continue;
 #endif
 
-        // Simple blocking handle for now (single thread DB engine)
-        HandleClient(client_sock);
+        // Hand the connection to the worker pool; the accept loop never blocks on a query
+        if (scheduler_ != nullptr) {
+            scheduler_->Submit([this, client_sock]() { HandleClient(client_sock); });
+        } else {
+            HandleClient(client_sock);
+        }
     }
 }
 
@@ -209,10 +214,16 @@ void HttpServer::HandleClient(int client_sock) {
             HandleHealth(client_sock);
         } else if (method == "GET" && path == "/tables") {
             HandleTables(client_sock);
+        } else if (method == "GET" && path == "/metrics") {
+            HandleMetrics(client_sock);
         } else if (method == "POST" && path == "/query") {
             size_t body_start = request.find("\r\n\r\n");
             std::string body = (body_start != std::string::npos) ? request.substr(body_start + 4) : "";
             HandleQuery(client_sock, body);
+        } else if (method == "POST" && path == "/vector/search") {
+            size_t body_start = request.find("\r\n\r\n");
+            std::string body = (body_start != std::string::npos) ? request.substr(body_start + 4) : "";
+            HandleVectorSearch(client_sock, body);
         } else {
             SendResponse(client_sock, "404 Not Found", "application/json", "{\"error\":\"Not Found\"}");
         }
@@ -262,23 +273,127 @@ void HttpServer::HandleQuery(int client_sock, const std::string& body) {
         return;
     }
     
-    std::cout << "[v2vdb-server] Query: " << sql << std::endl;
-    
-    // Execute and capture
-    std::string result = ExecuteToString(sql);
-    
-    // Must save catalog if a schema changed
-    if (sql.find("CREATE") != std::string::npos || sql.find("make") != std::string::npos ||
-        sql.find("DROP") != std::string::npos) {
-        catalog_->SaveCatalog();
+    {
+        // Under the lock: ExecuteToString swaps std::cout's buffer while it holds it
+        std::lock_guard<std::mutex> guard(execute_mutex_);
+        std::cout << "[v2vdb-server] Query: " << sql << std::endl;
     }
+
+    // Execute and capture (saves the catalog if the statement changed it)
+    std::string result = ExecuteToString(sql);
     
     std::ostringstream json;
     json << "{\"result\":\"" << EscapeJsonString(result) << "\"}";
     SendResponse(client_sock, "200 OK", "application/json", json.str());
 }
 
+void HttpServer::HandleVectorSearch(int client_sock, const std::string& body) {
+    // {"table": "...", "column": "...", "k": 10, "metric": "L2", "vectors": [[...], [...]]}
+    std::string table = JsonField(body, "table");
+    std::string column = JsonField(body, "column");
+    std::string k_text = JsonField(body, "k");
+    std::string metric_name = JsonField(body, "metric");
+    std::string vectors_text = JsonField(body, "vectors");
+
+    DistanceMetric metric = DistanceMetric::L2;
+    if (!metric_name.empty() && !ParseDistanceMetric(metric_name, metric)) {
+        SendResponse(client_sock, "400 Bad Request", "application/json",
+                     "{\"error\":\"Unknown metric (use L2, IP or COSINE).\"}");
+        return;
+    }
+    int k = 10;
+    if (!k_text.empty()) {
+        try {
+            k = std::stoi(k_text);
+        } catch (...) {
+            k = -1;
+        }
+    }
+    std::vector<std::vector<float>> queries;
+    try {
+        queries = Executor::ParseVectorListLiteral(vectors_text);
+    } catch (...) {
+        queries.clear();
+    }
+    if (table.empty() || column.empty() || k < 0 || queries.empty()) {
+        SendResponse(client_sock, "400 Bad Request", "application/json",
+                     "{\"error\":\"Expected 'table', 'column', 'vectors' (a list of vectors) and optionally 'k' "
+                     "and 'metric'.\"}");
+        return;
+    }
+
+    std::vector<std::string> columns;
+    std::vector<std::vector<std::pair<float, Tuple>>> results;
+    std::string error;
+    bool found;
+    {
+        std::lock_guard<std::mutex> guard(execute_mutex_);
+        found = executor_->SearchNearestBatch(table, column, queries, metric, static_cast<size_t>(k), columns,
+                                              results, error);
+    }
+    if (!found) {
+        SendResponse(client_sock, "400 Bad Request", "application/json",
+                     "{\"error\":\"" + EscapeJsonString(error) + "\"}");
+        return;
+    }
+
+    // Rows are arrays in the order of "columns"; vectors are JSON arrays already
+    std::ostringstream json;
+    json << "{\"columns\":[";
+    for (size_t c = 0; c < columns.size(); ++c) {
+        if (c > 0) json << ",";
+        json << "\"" << EscapeJsonString(columns[c]) << "\"";
+    }
+    json << "],\"results\":[";
+    for (size_t q = 0; q < results.size(); ++q) {
+        if (q > 0) json << ",";
+        json << "[";
+        for (size_t r = 0; r < results[q].size(); ++r) {
+            const Tuple& tuple = results[q][r].second;
+            if (r > 0) json << ",";
+            json << "{\"distance\":" << results[q][r].first << ",\"row\":[";
+            for (uint32_t c = 0; c < tuple.GetValueCount(); ++c) {
+                if (c > 0) json << ",";
+                const Value& value = tuple.GetValue(c);
+                if (value.GetTypeId() == TypeID::INTEGER) {
+                    json << value.GetAsInteger();
+                } else if (value.GetTypeId() == TypeID::VECTOR) {
+                    json << value.GetAsString();
+                } else {
+                    json << "\"" << EscapeJsonString(value.GetAsString()) << "\"";
+                }
+            }
+            json << "]}";
+        }
+        json << "]";
+    }
+    json << "]}";
+    SendResponse(client_sock, "200 OK", "application/json", json.str());
+}
+
+void HttpServer::HandleMetrics(int client_sock) {
+    std::ostringstream json;
+    if (scheduler_ == nullptr) {
+        json << "{\"workers\":0}";
+    } else {
+        TaskScheduler::Metrics metrics = scheduler_->GetMetrics();
+        json << "{\"workers\":" << scheduler_->GetWorkerCount()
+             << ",\"submitted\":" << metrics.submitted
+             << ",\"executed\":" << metrics.executed
+             << ",\"steals\":" << metrics.steals
+             << ",\"queue_depths\":[";
+        for (size_t i = 0; i < metrics.queue_depths.size(); ++i) {
+            if (i > 0) json << ",";
+            json << metrics.queue_depths[i];
+        }
+        json << "]}";
+    }
+    SendResponse(client_sock, "200 OK", "application/json", json.str());
+}
+
 std::string HttpServer::ExecuteToString(const std::string& sql) {
+    std::lock_guard<std::mutex> guard(execute_mutex_);
+
     // Redirect std::cout to stringstream
     std::stringstream buffer;
     std::streambuf* old_cout = std::cout.rdbuf(buffer.rdbuf());
@@ -291,6 +406,10 @@ std::string HttpServer::ExecuteToString(const std::string& sql) {
     
     // Restore
     std::cout.rdbuf(old_cout);
+
+    // Persist new or dropped tables and indexes (and indexes CLEAR moved to new pages)
+    // now: server mode only reaches the exit-time save in main() on shutdown
+    if (executor_->TakeCatalogChanged()) catalog_->SaveCatalog();
     
     // Clean escape codes (ANSI colors used by terminal)
     std::string raw = buffer.str();
@@ -321,4 +440,30 @@ std::string HttpServer::EscapeJsonString(const std::string& input) {
     return ss.str();
 }
 
+std::string HttpServer::JsonField(const std::string& body, const std::string& name) {
+    size_t pos = body.find("\"" + name + "\"");
+    if (pos == std::string::npos) return "";
+    pos = body.find(':', pos + name.length() + 2);
+    if (pos == std::string::npos) return "";
+    pos = body.find_first_not_of(" \t\r\n", pos + 1);
+    if (pos == std::string::npos) return "";
+    if (body[pos] == '"') {
+        size_t end = pos + 1;
+        while (end < body.length() && !(body[end] == '"' && body[end - 1] != '\\')) end++;
+        return body.substr(pos + 1, end - pos - 1);
+    }
+    if (body[pos] == '[') {
+        int depth = 0;
+        for (size_t end = pos; end < body.length(); ++end) {
+            if (body[end] == '[') depth++;
+            if (body[end] == ']' && --depth == 0) return body.substr(pos, end - pos + 1);
+        }
+        return "";
+    }
+    size_t end = body.find_first_of(",}", pos);
+    std::string value = body.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    value.erase(value.find_last_not_of(" \t\r\n") + 1);
+    return value;
+}
+
 } // namespace mydb
@@ -45,6 +45,7 @@ void DiskManager::WritePage(page_id_t page_id, const char* page_data) {
 
 void DiskManager::ReadPage(page_id_t page_id, char* page_data) {
     std::lock_guard<std::mutex> guard(db_io_mutex_);
+    num_reads_++;
     int offset = page_id * PAGE_SIZE;
     if (offset > GetFileSize(file_name_)) {
         // read past end of file
@@ -66,6 +67,15 @@ void DiskManager::ReadPage(page_id_t page_id, char* page_data) {
     }
 }
 
+page_id_t DiskManager::AllocatePage() {
+    std::lock_guard<std::mutex> guard(db_io_mutex_);
+    if (next_page_id_ < 0) {
+        int file_size = GetFileSize(file_name_);
+        next_page_id_ = (file_size > 0) ? (file_size + PAGE_SIZE - 1) / PAGE_SIZE : 0;
+    }
+    return next_page_id_++;
+}
+
 int DiskManager::GetFileSize(const std::string& file_name) {
     try {
         return static_cast<int>(std::filesystem::file_size(file_name));
@@ -74,4 +84,9 @@ int DiskManager::GetFileSize(const std::string& file_name) {
     }
 }
 
+uint64_t DiskManager::GetNumReads() {
+    std::lock_guard<std::mutex> guard(db_io_mutex_);
+    return num_reads_;
+}
+
 } // namespace mydb
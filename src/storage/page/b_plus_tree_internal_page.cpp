@@ -1,9 +1,11 @@
 #include "storage/page/b_plus_tree_internal_page.h"
+#include "index/index_key.h"
 #include <iostream>
 
 namespace mydb {
 
-void BPlusTreeInternalPage::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
     SetPageType(IndexPageType::INTERNAL_PAGE);
     SetSize(0);
     SetMaxSize(max_size);
@@ -11,23 +13,75 @@ void BPlusTreeInternalPage::Init(page_id_t page_id, page_id_t parent_id, int max
     SetPageId(page_id);
 }
 
-int BPlusTreeInternalPage::KeyAt(int index) const {
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsOverfull() const {
+    return GetSize() >= GetMaxSize() || (COMPRESSED && EncodedSize(array_, GetSize()) > PAGE_SIZE);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanAbsorb(const BPlusTreeInternalPage *right, const KeyType &middle_key) const {
+    if (GetSize() + right->GetSize() >= GetMaxSize()) return false;
+    if (!COMPRESSED) return true;
+    KeyBytesRange<KeyType> keys;
+    for (int i = 1; i < GetSize(); ++i) keys.Add(KeyAt(i));
+    keys.Add(middle_key);
+    for (int i = 1; i < right->GetSize(); ++i) keys.Add(right->KeyAt(i));
+    return INTERNAL_PAGE_HEADER_SIZE + keys.Bytes() + (GetSize() + right->GetSize()) * sizeof(page_id_t) <=
+           PAGE_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::EncodedSize(const MappingType *entries, int count) {
+    if (!COMPRESSED) return PAGE_SIZE;
+    KeyBytesRange<KeyType> keys;
+    for (int i = 1; i < count; ++i) keys.Add(entries[i].first);
+    return INTERNAL_PAGE_HEADER_SIZE + keys.Bytes() + count * static_cast<int>(sizeof(page_id_t));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Encode(char *page) const {
+    if (!COMPRESSED) {
+        std::memcpy(page, this, PAGE_SIZE);
+        return;
+    }
+    std::memset(page, 0, PAGE_SIZE);
+    std::memcpy(page, this, INTERNAL_PAGE_HEADER_SIZE);
+    CompressEntries(array_, GetSize(), 1, page + INTERNAL_PAGE_HEADER_SIZE);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Decode(const char *page, char *node) {
+    if (!COMPRESSED) {
+        std::memcpy(node, page, PAGE_SIZE);
+        return;
+    }
+    std::memcpy(node, page, INTERNAL_PAGE_HEADER_SIZE);
+    auto *internal = reinterpret_cast<BPlusTreeInternalPage *>(node);
+    DecompressEntries(page + INTERNAL_PAGE_HEADER_SIZE, internal->array_, internal->GetSize(), 1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const {
     return array_[index].first;
 }
 
-void BPlusTreeInternalPage::SetKeyAt(int index, int key) {
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
     array_[index].first = key;
 }
 
-page_id_t BPlusTreeInternalPage::ValueAt(int index) const {
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
     return array_[index].second;
 }
 
-void BPlusTreeInternalPage::SetValueAt(int index, page_id_t value) {
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, page_id_t value) {
     array_[index].second = value;
 }
 
-int BPlusTreeInternalPage::ValueIndex(page_id_t value) const {
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(page_id_t value) const {
     for (int i = 0; i < GetSize(); ++i) {
         if (ValueAt(i) == value) {
             return i;
@@ -36,30 +90,117 @@ int BPlusTreeInternalPage::ValueIndex(page_id_t value) const {
     return -1;
 }
 
-page_id_t BPlusTreeInternalPage::Lookup(const int &key, const int &comparator) const {
-    // Basic linear search for phase 3, binary search later
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
     // The keys are sorted. We want the last key <= target.
     // array[0] key is invalid. 
     // keys: [X, 10, 20, 30]
     // ptrs: [p0, p1, p2, p3]
     // if key < 10 -> p0
     // if 10 <= key < 20 -> p1
-    
-    // For now simple scan from 1
-    for (int i = 1; i < GetSize(); ++i) {
-        if (key < KeyAt(i)) {
-            return ValueAt(i - 1);
-        }
+    // Searching keys 1..size-1 for the first key > target gives the pointer after it.
+    int index = 1 + KeySearch(array_ + 1, GetSize() - 1, key, comparator, true);
+    return ValueAt(index - 1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_INTERNAL_PAGE_TYPE::LookupFirst(const KeyType &key, const KeyComparator &comparator) const {
+    int index = 1 + KeySearch(array_ + 1, GetSize() - 1, key, comparator);
+    return ValueAt(index - 1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const page_id_t &old_value, const KeyType &new_key, const page_id_t &new_value) {
+    SetValueAt(0, old_value);
+    SetKeyAt(1, new_key);
+    SetValueAt(1, new_value);
+    SetSize(2);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const page_id_t &old_value, const KeyType &new_key, const page_id_t &new_value) {
+    int index = ValueIndex(old_value) + 1;
+    for (int i = GetSize(); i > index; --i) {
+        array_[i] = array_[i - 1];
     }
-    return ValueAt(GetSize() - 1);
+    array_[index] = {new_key, new_value};
+    IncreaseSize(1);
+    return GetSize();
 }
 
-void BPlusTreeInternalPage::MoveHalfTo(BPlusTreeInternalPage *recipient, char *buffer) {
-    // Not implemented for Phase 3 prototype yet
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient, DiskManager *disk_manager) {
+    int split = GetSize() / 2;
+    int moved = GetSize() - split;
+    for (int i = 0; i < moved; ++i) {
+        recipient->array_[i] = array_[split + i];
+    }
+    recipient->SetSize(moved);
+    SetSize(split);
+
+    // Children now hang off the recipient
+    for (int i = 0; i < moved; ++i) {
+        recipient->Reparent(recipient->ValueAt(i), disk_manager);
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, DiskManager *disk_manager) {
+    SetKeyAt(0, middle_key);
+    int start = recipient->GetSize();
+    for (int i = 0; i < GetSize(); ++i) {
+        recipient->array_[start + i] = array_[i];
+        recipient->Reparent(ValueAt(i), disk_manager);
+    }
+    recipient->IncreaseSize(GetSize());
+    SetSize(0);
 }
 
-void BPlusTreeInternalPage::MoveAllTo(BPlusTreeInternalPage *recipient, int index_in_parent, char *buffer) {
-    // Not implemented
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key, DiskManager *disk_manager) {
+    recipient->array_[recipient->GetSize()] = {middle_key, ValueAt(0)};
+    recipient->IncreaseSize(1);
+    recipient->Reparent(ValueAt(0), disk_manager);
+    Remove(0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key, DiskManager *disk_manager) {
+    page_id_t child = ValueAt(GetSize() - 1);
+    for (int i = recipient->GetSize(); i > 0; --i) {
+        recipient->array_[i] = recipient->array_[i - 1];
+    }
+    recipient->SetKeyAt(1, middle_key);
+    recipient->SetValueAt(0, child);
+    recipient->IncreaseSize(1);
+    recipient->Reparent(child, disk_manager);
+    IncreaseSize(-1);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
+    for (int i = index; i < GetSize() - 1; ++i) {
+        array_[i] = array_[i + 1];
+    }
+    IncreaseSize(-1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() {
+    page_id_t child = ValueAt(0);
+    SetSize(0);
+    return child;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Reparent(page_id_t child_page_id, DiskManager *disk_manager) const {
+    char buf[PAGE_SIZE];
+    disk_manager->ReadPage(child_page_id, buf);
+    reinterpret_cast<BPlusTreePage*>(buf)->SetParentPageId(GetPageId());
+    disk_manager->WritePage(child_page_id, buf);
+}
+
+#define INSTANTIATE_INTERNAL_PAGE(KeyType, KeyComparator) template class BPlusTreeInternalPage<KeyType, KeyComparator>;
+MYDB_FOR_EACH_BPLUS_TREE_KEY(INSTANTIATE_INTERNAL_PAGE)
+
 } // namespace mydb
@@ -1,8 +1,10 @@
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "index/index_key.h"
 
 namespace mydb {
 
-void BPlusTreeLeafPage::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
     SetPageType(IndexPageType::LEAF_PAGE);
     SetSize(0);
     SetMaxSize(max_size);
@@ -11,36 +13,92 @@ void BPlusTreeLeafPage::Init(page_id_t page_id, page_id_t parent_id, int max_siz
     SetNextPageId(-1);
 }
 
-page_id_t BPlusTreeLeafPage::GetNextPageId() const {
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::IsOverfull() const {
+    return GetSize() >= GetMaxSize() || (COMPRESSED && EncodedSize(array_, GetSize()) > PAGE_SIZE);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::CanAbsorb(const BPlusTreeLeafPage *right) const {
+    if (GetSize() + right->GetSize() >= GetMaxSize()) return false;
+    if (!COMPRESSED) return true;
+    KeyBytesRange<KeyType> keys;
+    for (int i = 0; i < GetSize(); ++i) keys.Add(KeyAt(i));
+    for (int i = 0; i < right->GetSize(); ++i) keys.Add(right->KeyAt(i));
+    return LEAF_PAGE_HEADER_SIZE + keys.Bytes() + (GetSize() + right->GetSize()) * sizeof(RID) <= PAGE_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::EncodedSize(const MappingType *entries, int count) {
+    if (!COMPRESSED) return PAGE_SIZE;
+    KeyBytesRange<KeyType> keys;
+    for (int i = 0; i < count; ++i) keys.Add(entries[i].first);
+    return LEAF_PAGE_HEADER_SIZE + keys.Bytes() + count * static_cast<int>(sizeof(RID));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Encode(char *page) const {
+    if (!COMPRESSED) {
+        std::memcpy(page, this, PAGE_SIZE);
+        return;
+    }
+    std::memset(page, 0, PAGE_SIZE);
+    std::memcpy(page, this, LEAF_PAGE_HEADER_SIZE);
+    CompressEntries(array_, GetSize(), 0, page + LEAF_PAGE_HEADER_SIZE);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Decode(const char *page, char *node) {
+    if (!COMPRESSED) {
+        std::memcpy(node, page, PAGE_SIZE);
+        return;
+    }
+    std::memcpy(node, page, LEAF_PAGE_HEADER_SIZE);
+    auto *leaf = reinterpret_cast<BPlusTreeLeafPage *>(node);
+    DecompressEntries(page + LEAF_PAGE_HEADER_SIZE, leaf->array_, leaf->GetSize(), 0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const {
     return next_page_id_;
 }
 
-void BPlusTreeLeafPage::SetNextPageId(page_id_t next_page_id) {
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
     next_page_id_ = next_page_id;
 }
 
-int BPlusTreeLeafPage::KeyAt(int index) const {
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const {
     return array_[index].first;
 }
 
-RID BPlusTreeLeafPage::ValueAt(int index) const {
+INDEX_TEMPLATE_ARGUMENTS
+RID B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const {
     return array_[index].second;
 }
 
-const std::pair<int, RID>& BPlusTreeLeafPage::GetItem(int index) {
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) -> const MappingType & {
     return array_[index];
 }
 
-int BPlusTreeLeafPage::KeyIndex(const int &key, const int &comparator) const {
-    for (int i = 0; i < GetSize(); ++i) {
-        if (key == KeyAt(i)) {
-            return i;
-        }
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+    int index = LowerBound(key, comparator);
+    if (index < GetSize() && comparator(KeyAt(index), key) == 0) {
+        return index;
     }
     return -1;
 }
 
-RID BPlusTreeLeafPage::Lookup(const int &key, const int &comparator) const {
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::LowerBound(const KeyType &key, const KeyComparator &comparator) const {
+    return KeySearch(array_, GetSize(), key, comparator);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+RID B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
     int index = KeyIndex(key, comparator);
     if (index != -1) {
         return ValueAt(index);
@@ -48,14 +106,12 @@ RID BPlusTreeLeafPage::Lookup(const int &key, const int &comparator) const {
     return RID();
 }
 
-int BPlusTreeLeafPage::Insert(const int &key, const RID &value, const int &comparator) {
-    // Simple sorted insert
-    int i = 0;
-    for (; i < GetSize(); ++i) {
-        if (KeyAt(i) >= key) break;
-    }
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const RID &value, const KeyComparator &comparator, bool unique) {
+    // Sorted insert: before an equal key (unique) or after all equal keys
+    int i = KeySearch(array_, GetSize(), key, comparator, !unique);
     // Check duplicate
-    if (i < GetSize() && KeyAt(i) == key) return 0; // Already exists
+    if (unique && i < GetSize() && comparator(KeyAt(i), key) == 0) return 0; // Already exists
 
     // Shift
     for (int j = GetSize(); j > i; --j) {
@@ -66,8 +122,82 @@ int BPlusTreeLeafPage::Insert(const int &key, const RID &value, const int &compa
     return GetSize();
 }
 
-void BPlusTreeLeafPage::MoveHalfTo(BPlusTreeLeafPage *recipient) {
-    // Not implemented
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
+    int index = KeyIndex(key, comparator);
+    if (index == -1) return GetSize();
+    for (int i = index; i < GetSize() - 1; ++i) {
+        array_[i] = array_[i + 1];
+    }
+    IncreaseSize(-1);
+    return GetSize();
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const RID &value, const KeyComparator &comparator) {
+    for (int index = LowerBound(key, comparator); index < GetSize() && comparator(KeyAt(index), key) == 0; ++index) {
+        if (ValueAt(index) == value) {
+            for (int i = index; i < GetSize() - 1; ++i) {
+                array_[i] = array_[i + 1];
+            }
+            IncreaseSize(-1);
+            break;
+        }
+    }
+    return GetSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(const MappingType *items, int count) {
+    for (int i = 0; i < count; ++i) {
+        array_[i] = items[i];
+    }
+    SetSize(count);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
+    int split = GetSize() / 2;
+    int moved = GetSize() - split;
+    for (int i = 0; i < moved; ++i) {
+        recipient->array_[i] = array_[split + i];
+    }
+    recipient->SetSize(moved);
+    SetSize(split);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
+    int start = recipient->GetSize();
+    for (int i = 0; i < GetSize(); ++i) {
+        recipient->array_[start + i] = array_[i];
+    }
+    recipient->IncreaseSize(GetSize());
+    recipient->SetNextPageId(GetNextPageId());
+    SetSize(0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+    recipient->array_[recipient->GetSize()] = array_[0];
+    recipient->IncreaseSize(1);
+    for (int i = 0; i < GetSize() - 1; ++i) {
+        array_[i] = array_[i + 1];
+    }
+    IncreaseSize(-1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+    for (int i = recipient->GetSize(); i > 0; --i) {
+        recipient->array_[i] = recipient->array_[i - 1];
+    }
+    recipient->array_[0] = array_[GetSize() - 1];
+    recipient->IncreaseSize(1);
+    IncreaseSize(-1);
+}
+
+#define INSTANTIATE_LEAF_PAGE(KeyType, KeyComparator) template class BPlusTreeLeafPage<KeyType, KeyComparator>;
+MYDB_FOR_EACH_BPLUS_TREE_KEY(INSTANTIATE_LEAF_PAGE)
+
 } // namespace mydb
@@ -0,0 +1,59 @@
+#include "storage/page/hash_table_bucket_page.h"
+#include "index/index_key.h"
+
+namespace mydb {
+
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_BUCKET_TYPE::Init() {
+    size_ = 0;
+    next_page_id_ = -1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType HASH_TABLE_BUCKET_TYPE::KeyAt(int index) const {
+    return array_[index].first;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+RID HASH_TABLE_BUCKET_TYPE::ValueAt(int index) const {
+    return array_[index].second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto HASH_TABLE_BUCKET_TYPE::GetItem(int index) const -> const MappingType & {
+    return array_[index];
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_BUCKET_TYPE::GetValues(const KeyType &key, const KeyComparator &comparator,
+                                       std::vector<RID> &result) const {
+    for (int i = 0; i < size_; ++i) {
+        if (comparator(array_[i].first, key) == 0) result.push_back(array_[i].second);
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int HASH_TABLE_BUCKET_TYPE::EntryIndex(const KeyType &key, const RID &value, const KeyComparator &comparator) const {
+    for (int i = 0; i < size_; ++i) {
+        if (array_[i].second == value && comparator(array_[i].first, key) == 0) return i;
+    }
+    return -1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_BUCKET_TYPE::Insert(const KeyType &key, const RID &value) {
+    if (IsFull()) return false;
+    array_[size_++] = {key, value};
+    return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(int index) {
+    array_[index] = array_[size_ - 1];
+    size_--;
+}
+
+#define INSTANTIATE_HASH_BUCKET_PAGE(KeyType, KeyComparator) template class HashTableBucketPage<KeyType, KeyComparator>;
+MYDB_FOR_EACH_INDEX_KEY(INSTANTIATE_HASH_BUCKET_PAGE)
+
+} // namespace mydb
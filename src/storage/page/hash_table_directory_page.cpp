@@ -0,0 +1,55 @@
+#include "storage/page/hash_table_directory_page.h"
+
+namespace mydb {
+
+void HashTableDirectoryPage::Init(page_id_t bucket_page_id, uint32_t max_depth) {
+    max_depth_ = max_depth;
+    global_depth_ = 0;
+    local_depths_[0] = 0;
+    bucket_page_ids_[0] = bucket_page_id;
+}
+
+page_id_t HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_index) const {
+    return bucket_page_ids_[bucket_index];
+}
+
+void HashTableDirectoryPage::SetBucketPageId(uint32_t bucket_index, page_id_t bucket_page_id) {
+    bucket_page_ids_[bucket_index] = bucket_page_id;
+}
+
+uint32_t HashTableDirectoryPage::GetLocalDepth(uint32_t bucket_index) const {
+    return local_depths_[bucket_index];
+}
+
+void HashTableDirectoryPage::SetLocalDepth(uint32_t bucket_index, uint32_t local_depth) {
+    local_depths_[bucket_index] = static_cast<uint8_t>(local_depth);
+}
+
+uint32_t HashTableDirectoryPage::GetSplitImageIndex(uint32_t bucket_index) const {
+    uint32_t local_depth = GetLocalDepth(bucket_index);
+    if (local_depth == 0) return bucket_index;
+    return bucket_index ^ (1u << (local_depth - 1));
+}
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+    uint32_t size = Size();
+    for (uint32_t i = 0; i < size; ++i) {
+        local_depths_[size + i] = local_depths_[i];
+        bucket_page_ids_[size + i] = bucket_page_ids_[i];
+    }
+    global_depth_++;
+}
+
+void HashTableDirectoryPage::DecrGlobalDepth() {
+    global_depth_--;
+}
+
+bool HashTableDirectoryPage::CanShrink() const {
+    if (global_depth_ == 0) return false;
+    for (uint32_t i = 0; i < Size(); ++i) {
+        if (local_depths_[i] == global_depth_) return false;
+    }
+    return true;
+}
+
+} // namespace mydb
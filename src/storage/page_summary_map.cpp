@@ -0,0 +1,68 @@
+#include "storage/page_summary_map.h"
+
+namespace mydb {
+
+PageSummaryMap::PageSummaryMap(DiskManager *disk_manager, uint32_t summary_size, page_id_t first_page_id)
+    : disk_manager_(disk_manager), summary_size_(summary_size) {
+    if (first_page_id == -1) {
+        AppendPage();
+        return;
+    }
+    for (page_id_t page_id = first_page_id; page_id != -1;) {
+        auto buf = std::make_unique<char[]>(PAGE_SIZE);
+        disk_manager_->ReadPage(page_id, buf.get());
+        page_ids_.push_back(page_id);
+        pages_.push_back(std::move(buf));
+        uint32_t page = static_cast<uint32_t>(pages_.size() - 1);
+        const PageSummaryPage *summary_page = Page(page);
+        summary_size_ = summary_page->GetSummarySize();
+        for (uint32_t i = 0; i < summary_page->GetCount(); ++i) {
+            locations_[summary_page->HeapPageIdAt(i)] = {page, i};
+        }
+        page_id = summary_page->GetNextPageId();
+    }
+}
+
+const char *PageSummaryMap::Find(page_id_t heap_page_id) const {
+    auto it = locations_.find(heap_page_id);
+    if (it == locations_.end()) return nullptr;
+    return Page(it->second.page)->SummaryAt(it->second.index);
+}
+
+char *PageSummaryMap::FindOrAdd(page_id_t heap_page_id, bool *added) {
+    auto it = locations_.find(heap_page_id);
+    if (added != nullptr) *added = it == locations_.end();
+    if (it != locations_.end()) return Page(it->second.page)->SummaryAt(it->second.index);
+    if (Page(static_cast<uint32_t>(pages_.size() - 1))->IsFull()) AppendPage();
+    uint32_t page = static_cast<uint32_t>(pages_.size() - 1);
+    uint32_t index = Page(page)->Add(heap_page_id);
+    locations_[heap_page_id] = {page, index};
+    return Page(page)->SummaryAt(index);
+}
+
+void PageSummaryMap::WriteBack(page_id_t heap_page_id) {
+    auto it = locations_.find(heap_page_id);
+    if (it == locations_.end()) return;
+    disk_manager_->WritePage(page_ids_[it->second.page], pages_[it->second.page].get());
+}
+
+void PageSummaryMap::WriteAll() {
+    for (size_t i = 0; i < pages_.size(); ++i) disk_manager_->WritePage(page_ids_[i], pages_[i].get());
+}
+
+// Links a new empty page after the last one; both are written
+void PageSummaryMap::AppendPage() {
+    page_id_t page_id = disk_manager_->AllocatePage();
+    auto buf = std::make_unique<char[]>(PAGE_SIZE);
+    std::memset(buf.get(), 0, PAGE_SIZE);
+    reinterpret_cast<PageSummaryPage *>(buf.get())->Init(summary_size_);
+    disk_manager_->WritePage(page_id, buf.get());
+    if (!pages_.empty()) {
+        Page(static_cast<uint32_t>(pages_.size() - 1))->SetNextPageId(page_id);
+        disk_manager_->WritePage(page_ids_.back(), pages_.back().get());
+    }
+    page_ids_.push_back(page_id);
+    pages_.push_back(std::move(buf));
+}
+
+} // namespace mydb
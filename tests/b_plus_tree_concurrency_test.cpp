@@ -0,0 +1,197 @@
+// Concurrency test for BPlusTree: writers on disjoint key partitions, point readers and
+// full scans all run at once (see the latching notes in index/b_plus_tree.h).
+//
+// Usage: b_plus_tree_concurrency_test [ops per writer] [writer threads]
+// Build with -DCMAKE_CXX_FLAGS=-fsanitize=thread to run it under ThreadSanitizer.
+#include "index/b_plus_tree.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace mydb;
+
+namespace {
+
+std::atomic<int> failures{0};
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            ++failures;                                                              \
+        }                                                                            \
+    } while (0)
+
+using IntTree = BPlusTree<IntKey, IntKeyComparator>;
+
+constexpr int KEYS_PER_WRITER = 4000;
+
+// Full forward scan while writers split and merge leaves under it: keys must come
+// strictly in order, and every stable key (present for the whole scan) exactly once,
+// which relies on the iterator re-seeking after a structure change
+void CheckScan(IntTree &tree, int stride, int stable_keys) {
+    IntKey prev = INT32_MIN;
+    int stable_seen = 0;
+    for (auto it = tree.Begin(); !it.IsEnd(); ++it) {
+        IntKey key = it.Key();
+        CHECK(key > prev);
+        CHECK(it.Value().GetPageId() == key);
+        prev = key;
+        if (key % stride == stride - 1) stable_seen++;
+    }
+    CHECK(stable_seen == stable_keys);
+}
+
+// Unique tree. Writer t owns the keys r * stride + t; the keys r * stride + stride - 1
+// are inserted up front and never touched, so every scan must return them all.
+void UniqueTest(int threads, int ops) {
+    const char *file = "b_plus_tree_concurrency_unique.db";
+    std::remove(file);
+    {
+        DiskManager disk_manager(file);
+        IntTree tree("unique", &disk_manager, -1, true);
+        const int stride = threads + 1;
+        for (int r = 0; r < KEYS_PER_WRITER; ++r) {
+            int key = r * stride + stride - 1;
+            CHECK(tree.Insert(key, RID(key, 0)));
+        }
+
+        std::vector<std::set<int>> owned(threads);
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threads; ++t) {
+            writers.emplace_back([&, t] {
+                std::mt19937 rng(t);
+                std::set<int> &mine = owned[t];
+                for (int i = 0; i < ops; ++i) {
+                    int key = static_cast<int>(rng() % KEYS_PER_WRITER) * stride + t;
+                    // Insert-heavy first (splits), remove-heavy after (merges and borrows)
+                    int op = static_cast<int>(rng() % 10);
+                    if (i >= ops / 2) op = op < 2 ? op : op < 8 ? 5 : 8;
+                    if (op < 5) {
+                        CHECK(tree.Insert(key, RID(key, 0)) == (mine.count(key) == 0));
+                        mine.insert(key);
+                    } else if (op < 8) {
+                        tree.Remove(key);
+                        mine.erase(key);
+                    } else {
+                        RID rid;
+                        bool found = tree.GetValue(key, rid);
+                        CHECK(found == (mine.count(key) > 0));
+                        if (found) CHECK(rid.GetPageId() == key);
+                    }
+                }
+            });
+        }
+        std::thread reader([&] {
+            std::mt19937 rng(99);
+            while (!stop) {
+                int key = static_cast<int>(rng() % (KEYS_PER_WRITER * stride));
+                RID rid;
+                if (tree.GetValue(key, rid)) CHECK(rid.GetPageId() == key);
+                if (key % stride == stride - 1) CHECK(tree.GetValue(key, rid));
+            }
+        });
+        std::thread scanner([&] {
+            int scans = 0;
+            while (!stop || scans == 0) {
+                CheckScan(tree, stride, KEYS_PER_WRITER);
+                scans++;
+            }
+            std::printf("unique: %d scans during the writes\n", scans);
+        });
+        for (auto &writer : writers) writer.join();
+        stop = true;
+        reader.join();
+        scanner.join();
+
+        std::set<int> expected;
+        for (const auto &mine : owned) expected.insert(mine.begin(), mine.end());
+        for (int r = 0; r < KEYS_PER_WRITER; ++r) expected.insert(r * stride + stride - 1);
+        std::vector<int> forward;
+        for (auto it = tree.Begin(); !it.IsEnd(); ++it) forward.push_back(it.Key());
+        CHECK(forward == std::vector<int>(expected.begin(), expected.end()));
+        std::vector<int> backward;
+        for (auto it = --tree.End(); !it.IsEnd(); --it) backward.push_back(it.Key());
+        CHECK(backward == std::vector<int>(expected.rbegin(), expected.rend()));
+        std::printf("unique: %zu keys\n", expected.size());
+    }
+    std::remove(file);
+}
+
+// Non-unique tree with few keys and many RIDs each, so duplicate runs span leaves.
+// Writer t owns the RIDs with slot t * 1000000 + i and must always see all of its own.
+void DuplicateTest(int threads, int ops) {
+    const char *file = "b_plus_tree_concurrency_duplicate.db";
+    std::remove(file);
+    {
+        DiskManager disk_manager(file);
+        IntTree tree("duplicate", &disk_manager, -1, false);
+        std::vector<std::multiset<std::pair<int, int>>> owned(threads);
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threads; ++t) {
+            writers.emplace_back([&, t] {
+                std::mt19937 rng(1000 + t);
+                std::multiset<std::pair<int, int>> &mine = owned[t];
+                std::vector<std::pair<int, int>> live;
+                for (int i = 0; i < ops; ++i) {
+                    int op = static_cast<int>(rng() % 10);
+                    if (op < 6 || live.empty()) {
+                        int key = static_cast<int>(rng() % 50);
+                        int slot = t * 1000000 + i;
+                        CHECK(tree.Insert(key, RID(key, slot)));
+                        mine.insert({key, slot});
+                        live.push_back({key, slot});
+                    } else if (op < 9) {
+                        size_t j = rng() % live.size();
+                        std::pair<int, int> entry = live[j];
+                        live[j] = live.back();
+                        live.pop_back();
+                        CHECK(tree.Remove(entry.first, RID(entry.first, entry.second)));
+                        mine.erase(mine.find(entry));
+                    } else {
+                        int key = static_cast<int>(rng() % 50);
+                        std::vector<RID> rids;
+                        tree.GetRange(key, key, rids);
+                        size_t visible = 0;
+                        for (const RID &rid : rids) {
+                            CHECK(rid.GetPageId() == key);
+                            if (rid.GetSlotNum() / 1000000 == static_cast<uint32_t>(t)) visible++;
+                        }
+                        size_t expected = std::count_if(mine.begin(), mine.end(),
+                                                        [key](const std::pair<int, int> &e) { return e.first == key; });
+                        CHECK(visible == expected);
+                    }
+                }
+            });
+        }
+        for (auto &writer : writers) writer.join();
+
+        std::multiset<std::pair<int, int>> expected;
+        for (const auto &mine : owned) expected.insert(mine.begin(), mine.end());
+        std::multiset<std::pair<int, int>> found;
+        for (auto it = tree.Begin(); !it.IsEnd(); ++it) {
+            found.insert({it.Key(), static_cast<int>(it.Value().GetSlotNum())});
+        }
+        CHECK(found == expected);
+        std::printf("duplicate: %zu entries\n", expected.size());
+    }
+    std::remove(file);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int ops = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 8;
+    UniqueTest(threads, ops);
+    DuplicateTest(threads, ops / 2);
+    std::printf("%s (%d failures)\n", failures == 0 ? "OK" : "FAILED", failures.load());
+    return failures == 0 ? 0 : 1;
+}
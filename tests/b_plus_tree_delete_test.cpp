@@ -0,0 +1,171 @@
+// BPlusTree removes: leaves and internal pages borrowing from or merging with their
+// siblings, the root collapsing level by level down to an empty tree, and the tree
+// still usable (and reopenable) after it has been emptied.
+#include "index/b_plus_tree.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace mydb;
+
+namespace {
+
+using IntTree = BPlusTree<IntKey, IntKeyComparator>;
+
+constexpr int KEYS = 100000;
+
+// Levels from the root down to the leftmost leaf (int keys: pages are stored as is)
+int Height(DiskManager &disk_manager, page_id_t root_page_id) {
+    char page[PAGE_SIZE];
+    int height = 0;
+    page_id_t page_id = root_page_id;
+    while (page_id != -1) {
+        disk_manager.ReadPage(page_id, page);
+        height++;
+        auto *node = reinterpret_cast<BPlusTreePage *>(page);
+        if (node->IsLeafPage()) break;
+        page_id = reinterpret_cast<BPlusTreeInternalPage<IntKey, IntKeyComparator> *>(page)->ValueAt(0);
+    }
+    return height;
+}
+
+// Half-full pages, so the first removes already underflow: 100000 keys make three levels
+void Load(IntTree &tree, int keys) {
+    std::vector<IntTree::MappingType> entries;
+    for (int key = 0; key < keys; ++key) entries.push_back({key, RID(key, 0)});
+    CHECK(tree.BulkLoad(entries, 50));
+}
+
+void CheckContents(IntTree &tree, const std::set<int> &expected) {
+    std::vector<int> forward;
+    for (auto it = tree.Begin(); !it.IsEnd(); ++it) forward.push_back(it.Key());
+    CHECK(forward == std::vector<int>(expected.begin(), expected.end()));
+    std::vector<int> backward;
+    if (!tree.IsEmpty()) {
+        for (auto it = --tree.End(); !it.IsEnd(); --it) backward.push_back(it.Key());
+    }
+    CHECK(backward == std::vector<int>(expected.rbegin(), expected.rend()));
+}
+
+// Removes every key in the given order, checking lookups as the tree shrinks
+void RemoveAll(const char *name, std::vector<int> order) {
+    std::string file = std::string("b_plus_tree_delete_") + name + ".db";
+    std::remove(file.c_str());
+    page_id_t header_page_id;
+    {
+        DiskManager disk_manager(file);
+        IntTree tree(name, &disk_manager);
+        Load(tree, KEYS);
+        CHECK(Height(disk_manager, tree.GetRootPageId()) == 3);
+        std::set<int> expected(order.begin(), order.end());
+
+        int height = 3;
+        for (size_t i = 0; i < order.size(); ++i) {
+            int key = order[i];
+            tree.Remove(key);
+            expected.erase(key);
+            RID rid;
+            CHECK(!tree.GetValue(key, rid));
+            if (i % 997 == 0 && !expected.empty()) {
+                // A neighbour that is still there, and the root only ever getting lower
+                auto next = expected.lower_bound(key);
+                if (next == expected.end()) --next;
+                CHECK(tree.GetValue(*next, rid) && rid.GetPageId() == *next);
+                int now = Height(disk_manager, tree.GetRootPageId());
+                CHECK(now <= height && now >= 1);
+                height = now;
+            }
+            if (i % 15000 == 0) CheckContents(tree, expected);
+        }
+        CHECK(height == 1);
+        CHECK(tree.IsEmpty());
+        CHECK(tree.Begin().IsEnd());
+        CheckContents(tree, expected);
+
+        // Removing from an empty tree is a no-op; the tree grows again from nothing
+        tree.Remove(order[0]);
+        for (int key = 0; key < 1000; ++key) CHECK(tree.Insert(key, RID(key, 0)));
+        header_page_id = tree.GetHeaderPageId();
+    }
+    {
+        DiskManager disk_manager(file);
+        IntTree tree(name, &disk_manager, header_page_id);
+        std::set<int> expected;
+        for (int key = 0; key < 1000; ++key) expected.insert(key);
+        CheckContents(tree, expected);
+        for (int key = 0; key < 1000; ++key) tree.Remove(key);
+        CHECK(tree.IsEmpty());
+    }
+    std::remove(file.c_str());
+}
+
+// Removing a key that is not there leaves the tree as it was
+void MissingKeyTest() {
+    const char *file = "b_plus_tree_delete_missing.db";
+    std::remove(file);
+    {
+        DiskManager disk_manager(file);
+        IntTree tree("missing", &disk_manager);
+        std::set<int> expected;
+        for (int key = 0; key < 5000; ++key) {
+            CHECK(tree.Insert(key * 2, RID(key * 2, 0)));
+            expected.insert(key * 2);
+        }
+        for (int key = 0; key < 5000; ++key) tree.Remove(key * 2 + 1);
+        tree.Remove(-1);
+        tree.Remove(1000000);
+        CheckContents(tree, expected);
+    }
+    std::remove(file);
+}
+
+// Non-unique tree: Remove(key, rid) finds its entry inside a run of duplicates that
+// spans several leaves, and leaves the rest of the run alone
+void DuplicateTest() {
+    const char *file = "b_plus_tree_delete_duplicate.db";
+    std::remove(file);
+    {
+        DiskManager disk_manager(file);
+        IntTree tree("duplicates", &disk_manager, -1, false);
+        std::vector<std::pair<int, int>> live;
+        for (int i = 0; i < 6000; ++i) {
+            CHECK(tree.Insert(i % 3, RID(i % 3, i)));
+            live.push_back({i % 3, i});
+        }
+        std::shuffle(live.begin(), live.end(), std::mt19937(5));
+        std::vector<int> counts = {2000, 2000, 2000};
+        for (size_t i = 0; i < live.size(); ++i) {
+            auto [key, slot] = live[i];
+            CHECK(tree.Remove(key, RID(key, slot)));
+            CHECK(!tree.Remove(key, RID(key, slot)));
+            counts[key]--;
+            if (i % 500 == 0) {
+                for (int k = 0; k < 3; ++k) {
+                    std::vector<RID> rids;
+                    tree.GetRange(k, k, rids);
+                    CHECK(static_cast<int>(rids.size()) == counts[k]);
+                }
+            }
+        }
+        CHECK(tree.IsEmpty());
+    }
+    std::remove(file);
+}
+
+} // namespace
+
+int main() {
+    std::vector<int> keys;
+    for (int key = 0; key < KEYS; ++key) keys.push_back(key);
+    // From the left edge, from the right edge, and from everywhere at once
+    RemoveAll("ascending", keys);
+    RemoveAll("descending", std::vector<int>(keys.rbegin(), keys.rend()));
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(3));
+    RemoveAll("random", keys);
+    MissingKeyTest();
+    DuplicateTest();
+    return mydb_test::TestExit("b_plus_tree_delete_test");
+}
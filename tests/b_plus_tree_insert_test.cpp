@@ -0,0 +1,174 @@
+// BPlusTree inserts: leaf and internal splits, root growth to three levels, lookups and
+// ordered iteration afterwards, and the root page id surviving a reopen.
+#include "index/b_plus_tree.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mydb;
+
+namespace {
+
+using IntTree = BPlusTree<IntKey, IntKeyComparator>;
+using StrTree = BPlusTree<StrKey, StrKeyComparator>;
+
+// Levels from the root down to the leftmost leaf (int keys: pages are stored as is)
+int Height(DiskManager &disk_manager, page_id_t root_page_id) {
+    char page[PAGE_SIZE];
+    int height = 0;
+    page_id_t page_id = root_page_id;
+    while (page_id != -1) {
+        disk_manager.ReadPage(page_id, page);
+        height++;
+        auto *node = reinterpret_cast<BPlusTreePage *>(page);
+        if (node->IsLeafPage()) break;
+        page_id = reinterpret_cast<BPlusTreeInternalPage<IntKey, IntKeyComparator> *>(page)->ValueAt(0);
+    }
+    return height;
+}
+
+void CheckIntKeys(IntTree &tree, const std::vector<int> &keys) {
+    std::vector<int> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    size_t missing = 0;
+    for (int key : keys) {
+        RID rid;
+        if (!tree.GetValue(key, rid) || rid.GetPageId() != key) missing++;
+    }
+    CHECK(missing == 0);
+    RID rid;
+    CHECK(!tree.GetValue(sorted.back() + 1, rid));
+    CHECK(!tree.GetValue(sorted.front() - 1, rid));
+
+    std::vector<int> forward;
+    for (auto it = tree.Begin(); !it.IsEnd(); ++it) forward.push_back(it.Key());
+    CHECK(forward == sorted);
+    std::vector<int> backward;
+    for (auto it = --tree.End(); !it.IsEnd(); --it) backward.push_back(it.Key());
+    CHECK(std::equal(backward.rbegin(), backward.rend(), sorted.begin(), sorted.end()));
+
+    // A range in the middle, crossing leaves
+    size_t low = sorted.size() / 3, high = 2 * sorted.size() / 3;
+    std::vector<RID> range;
+    tree.GetRange(sorted[low], sorted[high], range);
+    CHECK(range.size() == high - low + 1);
+    auto start = tree.Begin(sorted[low]);
+    CHECK(!start.IsEnd() && start.Key() == sorted[low]);
+}
+
+// Ascending keys (every split at the right edge), then a reopen from the header page
+void AscendingTest() {
+    const char *file = "b_plus_tree_insert_ascending.db";
+    std::remove(file);
+    std::vector<int> keys;
+    for (int i = 0; i < 120000; ++i) keys.push_back(i);
+    page_id_t header_page_id, root_page_id;
+    {
+        DiskManager disk_manager(file);
+        IntTree tree("ascending", &disk_manager);
+        CHECK(tree.IsEmpty());
+        for (int key : keys) CHECK(tree.Insert(key, RID(key, 0)));
+        CHECK(!tree.Insert(keys[1234], RID(0, 0)));
+        header_page_id = tree.GetHeaderPageId();
+        root_page_id = tree.GetRootPageId();
+        CHECK(Height(disk_manager, root_page_id) >= 3);
+        CheckIntKeys(tree, keys);
+    }
+    {
+        DiskManager disk_manager(file);
+        IntTree tree("ascending", &disk_manager, header_page_id);
+        CHECK(tree.GetRootPageId() == root_page_id);
+        CHECK(tree.IsUnique());
+        CheckIntKeys(tree, keys);
+        // Still growing after the reopen
+        for (int i = 0; i < 1000; ++i) CHECK(tree.Insert(-1 - i, RID(-1 - i, 0)));
+        for (int i = 0; i < 1000; ++i) keys.push_back(-1 - i);
+        CheckIntKeys(tree, keys);
+    }
+    std::remove(file);
+}
+
+// Descending and random orders split at the left edge and in the middle
+void UnorderedTest() {
+    const char *file = "b_plus_tree_insert_unordered.db";
+    std::remove(file);
+    {
+        DiskManager disk_manager(file);
+        IntTree descending("descending", &disk_manager);
+        std::vector<int> keys;
+        for (int i = 50000; i > 0; --i) keys.push_back(i * 3);
+        for (int key : keys) CHECK(descending.Insert(key, RID(key, 0)));
+        CHECK(Height(disk_manager, descending.GetRootPageId()) >= 2);
+        CheckIntKeys(descending, keys);
+
+        IntTree shuffled("shuffled", &disk_manager);
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+        for (int key : keys) CHECK(shuffled.Insert(key, RID(key, 0)));
+        CheckIntKeys(shuffled, keys);
+    }
+    std::remove(file);
+}
+
+// String keys: compressed pages, separators cut short, keys sharing long prefixes
+void StringTest() {
+    const char *file = "b_plus_tree_insert_string.db";
+    std::remove(file);
+    {
+        DiskManager disk_manager(file);
+        StrTree tree("strings", &disk_manager);
+        std::vector<std::string> keys;
+        for (int i = 0; i < 30000; ++i) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "customer/%06d/orders", i);
+            keys.push_back(buf);
+        }
+        std::vector<std::string> shuffled = keys;
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(11));
+        for (size_t i = 0; i < shuffled.size(); ++i) {
+            CHECK(tree.Insert(StrKey::FromString(shuffled[i]), RID(static_cast<int>(i), 0)));
+        }
+        CHECK(!tree.Insert(StrKey::FromString(keys[42]), RID(0, 0)));
+        size_t missing = 0;
+        for (const std::string &key : keys) {
+            RID rid;
+            if (!tree.GetValue(StrKey::FromString(key), rid)) missing++;
+        }
+        CHECK(missing == 0);
+        std::vector<std::string> forward;
+        for (auto it = tree.Begin(); !it.IsEnd(); ++it) forward.push_back(it.Key().ToString());
+        CHECK(forward == keys);
+    }
+    std::remove(file);
+}
+
+// Non-unique tree: runs of one key longer than a leaf
+void DuplicateTest() {
+    const char *file = "b_plus_tree_insert_duplicate.db";
+    std::remove(file);
+    {
+        DiskManager disk_manager(file);
+        IntTree tree("duplicates", &disk_manager, -1, false);
+        for (int i = 0; i < 6000; ++i) CHECK(tree.Insert(i % 3, RID(i % 3, i)));
+        for (int key = 0; key < 3; ++key) {
+            std::vector<RID> rids;
+            tree.GetRange(key, key, rids);
+            CHECK(rids.size() == 2000);
+            bool same_key = std::all_of(rids.begin(), rids.end(), [key](const RID &rid) { return rid.GetPageId() == key; });
+            CHECK(same_key);
+        }
+    }
+    std::remove(file);
+}
+
+} // namespace
+
+int main() {
+    AscendingTest();
+    UnorderedTest();
+    StringTest();
+    DuplicateTest();
+    return mydb_test::TestExit("b_plus_tree_insert_test");
+}
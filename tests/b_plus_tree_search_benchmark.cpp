@@ -0,0 +1,87 @@
+// Micro-benchmark of the in-page key search of B+ tree pages (KeySearch in
+// storage/page/b_plus_tree_page.h): internal Lookup and leaf KeyIndex on full int-key
+// pages, against the linear scans they replaced.
+//
+// Usage: b_plus_tree_search_benchmark [probes] [rounds]   (build in Release for real numbers)
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace mydb;
+
+namespace {
+
+using InternalPage = BPlusTreeInternalPage<IntKey, IntKeyComparator>;
+using LeafPage = BPlusTreeLeafPage<IntKey, IntKeyComparator>;
+
+// The searches before KeySearch: first child whose separator is above key, first equal key
+page_id_t LinearLookup(const InternalPage *page, IntKey key) {
+    for (int i = 1; i < page->GetSize(); ++i) {
+        if (key < page->KeyAt(i)) return page->ValueAt(i - 1);
+    }
+    return page->ValueAt(page->GetSize() - 1);
+}
+
+int LinearKeyIndex(const LeafPage *page, IntKey key) {
+    for (int i = 0; i < page->GetSize(); ++i) {
+        if (page->KeyAt(i) == key) return i;
+    }
+    return -1;
+}
+
+template <typename Search>
+void Time(const char *name, const std::vector<IntKey> &keys, int rounds, Search search) {
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (IntKey key : keys) checksum += search(key);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                (static_cast<double>(rounds) * keys.size());
+    std::printf("%-24s %7.1f ns per lookup (checksum %lld)\n", name, ns, checksum);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t probes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (1u << 20);
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 10;
+    IntKeyComparator comparator;
+
+    // Full pages of keys 0, 4, 8, ...
+    alignas(8) char internal_buf[PAGE_SIZE];
+    auto *internal = reinterpret_cast<InternalPage *>(internal_buf);
+    internal->Init(1);
+    int internal_size = InternalPage::INTERNAL_PAGE_SIZE - 1;
+    for (int i = 0; i < internal_size; ++i) {
+        internal->SetKeyAt(i, i * 4);
+        internal->SetValueAt(i, i);
+    }
+    internal->SetSize(internal_size);
+
+    alignas(8) char leaf_buf[PAGE_SIZE];
+    auto *leaf = reinterpret_cast<LeafPage *>(leaf_buf);
+    leaf->Init(2);
+    int leaf_size = LeafPage::LEAF_PAGE_SIZE - 1;
+    for (int i = 0; i < leaf_size; ++i) leaf->Insert(i * 4, RID(i, 0), comparator);
+
+    // Random probes, three in four of them missing the leaf's keys
+    std::mt19937 rng(1);
+    std::vector<IntKey> internal_keys(probes), leaf_keys(probes);
+    for (size_t i = 0; i < probes; ++i) {
+        internal_keys[i] = static_cast<IntKey>(rng() % (internal_size * 4));
+        leaf_keys[i] = static_cast<IntKey>(rng() % (leaf_size * 4));
+    }
+
+    std::printf("%d internal entries, %d leaf entries, %zu probes x %d rounds\n", internal_size, leaf_size, probes,
+                rounds);
+    Time("internal linear", internal_keys, rounds, [&](IntKey key) { return LinearLookup(internal, key); });
+    Time("internal Lookup", internal_keys, rounds, [&](IntKey key) { return internal->Lookup(key, comparator); });
+    Time("leaf linear", leaf_keys, rounds, [&](IntKey key) { return LinearKeyIndex(leaf, key); });
+    Time("leaf KeyIndex", leaf_keys, rounds, [&](IntKey key) { return leaf->KeyIndex(key, comparator); });
+    return 0;
+}
@@ -0,0 +1,248 @@
+// ColumnarTable against the row heap: the same inserts, deletes, updates and truncates
+// applied to both, then every read path (full and projected scans, parallel scans with
+// a filter, point and batch lookups, counts) must give the same rows, also after a
+// reopen. The row heap appends by walking its page chain, so the comparison runs on a
+// few thousand rows; a second test takes the columnar table alone past one row map
+// page and checks it against the rows it was given.
+#include "storage/columnar_table.h"
+#include "storage/table_heap.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mydb;
+
+namespace {
+
+Schema TestSchema() {
+    return Schema({Column("id", TypeID::INTEGER, 0), Column("grp", TypeID::INTEGER, 4),
+                   Column("name", TypeID::VARCHAR, 8), Column("embedding", TypeID::VECTOR, 12),
+                   Column("small", TypeID::VECTOR, 16, VectorEncoding::INT8)});
+}
+
+// Every 97th name is long enough for the columnar layout to move it to an overflow chain
+Tuple MakeRow(int id, int version = 0) {
+    std::string name = "name-" + std::to_string(id) + "-v" + std::to_string(version);
+    if (id % 97 == 0) name += std::string(1500, static_cast<char>('a' + id % 26));
+    std::vector<float> embedding = {static_cast<float>(id), static_cast<float>(version), 0.5f, -1.0f};
+    return Tuple({Value(static_cast<int32_t>(id)), Value(static_cast<int32_t>((id + version) % 7)), Value(name),
+                  Value(embedding), Value(embedding, VectorEncoding::INT8)});
+}
+
+// Projected columns only (the others come back INVALID); rows keyed by id
+std::string RowText(const Tuple &tuple) {
+    std::string text;
+    for (uint32_t c = 0; c < tuple.GetValueCount(); ++c) {
+        const Value &value = tuple.GetValue(c);
+        if (value.GetTypeId() == TypeID::INVALID) {
+            text += "-|";
+        } else if (value.GetTypeId() == TypeID::INTEGER) {
+            text += std::to_string(value.GetAsInteger()) + "|";
+        } else {
+            text += value.GetAsString() + "|";
+        }
+    }
+    return text;
+}
+
+std::map<int, std::string> ById(const std::vector<Tuple> &tuples) {
+    std::map<int, std::string> rows;
+    for (const Tuple &tuple : tuples) {
+        bool fresh = rows.emplace(tuple.GetValue(0).GetAsInteger(), RowText(tuple)).second;
+        CHECK(fresh);
+    }
+    return rows;
+}
+
+// One layout of the table, and where each live row id is in it
+struct Layout {
+    std::unique_ptr<TableHeap> table;
+    std::map<int, RID> rids;
+};
+
+// Every read path of `layout` gives the rows of `reference`
+void CheckSame(Layout &layout, Layout &reference, TaskScheduler &scheduler) {
+    CHECK(ById(layout.table->Scan()) == ById(reference.table->Scan()));
+    CHECK(layout.table->CountTuples(&scheduler, 4) == reference.table->CountTuples(&scheduler, 4));
+
+    // Projected, filtered and parallel, with the RIDs of the rows returned
+    const std::vector<bool> projection = {true, true, false, true, false};
+    auto in_group = [](const Tuple &tuple) { return tuple.GetValue(1).GetAsInteger() == 3; };
+    for (size_t parallelism : {1, 4}) {
+        std::vector<RID> rids;
+        std::vector<Tuple> tuples = layout.table->ParallelScan(projection, in_group, &scheduler, parallelism, &rids);
+        std::vector<Tuple> expected = reference.table->ParallelScan(projection, in_group, &scheduler, parallelism);
+        CHECK(ById(tuples) == ById(expected));
+        CHECK(rids.size() == tuples.size());
+        size_t wrong_rids = 0;
+        for (size_t i = 0; i < rids.size() && i < tuples.size(); ++i) {
+            if (!(layout.rids[tuples[i].GetValue(0).GetAsInteger()] == rids[i])) wrong_rids++;
+        }
+        CHECK(wrong_rids == 0);
+    }
+
+    // Point lookups, and a batch in random order that keeps its order
+    size_t wrong = 0;
+    std::vector<int> ids;
+    for (const auto &entry : reference.rids) ids.push_back(entry.first);
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(static_cast<unsigned>(ids.size())));
+    for (size_t i = 0; i < ids.size(); i += 11) {
+        Tuple tuple, expected;
+        if (!layout.table->GetTuple(layout.rids[ids[i]], tuple, projection) ||
+            !reference.table->GetTuple(reference.rids[ids[i]], expected, projection) ||
+            RowText(tuple) != RowText(expected)) {
+            wrong++;
+        }
+    }
+    std::vector<RID> batch, reference_batch;
+    for (int id : ids) {
+        batch.push_back(layout.rids[id]);
+        reference_batch.push_back(reference.rids[id]);
+    }
+    std::vector<Tuple> tuples = layout.table->GetTuples(batch);
+    std::vector<Tuple> expected = reference.table->GetTuples(reference_batch);
+    CHECK(tuples.size() == ids.size() && expected.size() == ids.size());
+    for (size_t i = 0; i < tuples.size() && i < expected.size(); ++i) {
+        if (RowText(tuples[i]) != RowText(expected[i]) || tuples[i].GetValue(0).GetAsInteger() != ids[i]) wrong++;
+    }
+    CHECK(wrong == 0);
+}
+
+void Insert(Layout &layout, int id, int version = 0) {
+    RID rid;
+    CHECK(layout.table->InsertTuple(MakeRow(id, version), &rid));
+    layout.rids[id] = rid;
+}
+
+void Delete(Layout &layout, int id) {
+    CHECK(layout.table->MarkDelete(layout.rids.at(id)));
+    layout.rids.erase(id);
+}
+
+void Update(Layout &layout, int id, int version) {
+    CHECK(layout.table->UpdateTuple(MakeRow(id, version), layout.rids.at(id)));
+}
+
+void CompareWithRowHeap() {
+    const char *file = "columnar_table_compare.db";
+    std::remove(file);
+    TaskScheduler scheduler(4);
+    const int rows = 5000;
+    page_id_t row_first_page_id, row_zone_map_page_id, header_page_id;
+    std::map<int, RID> row_rids, columnar_rids;
+    {
+        DiskManager disk_manager(file);
+        Layout row{TableHeap::Create(&disk_manager, TestSchema()), {}};
+        Layout columnar{ColumnarTable::Create(&disk_manager, TestSchema()), {}};
+        CHECK(columnar.table->GetStorage() == TableStorage::COLUMNAR);
+        for (int id = 0; id < rows; ++id) {
+            Insert(row, id);
+            Insert(columnar, id);
+        }
+        CheckSame(columnar, row, scheduler);
+
+        for (int id = 0; id < rows; id += 5) {
+            Delete(row, id);
+            Delete(columnar, id);
+        }
+        // A RID on a page that is no row map page names no row
+        CHECK(!columnar.table->MarkDelete(RID(columnar.table->GetFirstPageId(), 0)));
+        for (int id = 1; id < rows; id += 13) {
+            if (id % 5 == 0) continue;
+            Update(row, id, 1);
+            Update(columnar, id, 1);
+        }
+        CheckSame(columnar, row, scheduler);
+
+        row_first_page_id = row.table->GetFirstPageId();
+        row_zone_map_page_id = row.table->GetZoneMapPageId();
+        header_page_id = columnar.table->GetFirstPageId();
+        row_rids = row.rids;
+        columnar_rids = columnar.rids;
+    }
+    {
+        DiskManager disk_manager(file);
+        Layout row{std::make_unique<TableHeap>(&disk_manager, row_first_page_id, TestSchema(), row_zone_map_page_id),
+                   row_rids};
+        Layout columnar{std::make_unique<ColumnarTable>(&disk_manager, header_page_id, TestSchema()), columnar_rids};
+        CheckSame(columnar, row, scheduler);
+
+        // Truncate empties both; the table fills again from its first pages
+        size_t removed = row.table->Truncate();
+        CHECK(columnar.table->Truncate() == removed);
+        CHECK(columnar.table->Scan().empty());
+        CHECK(columnar.table->CountTuples() == 0);
+        row.rids.clear();
+        columnar.rids.clear();
+        for (int id = 0; id < 700; ++id) {
+            Insert(row, id, 2);
+            Insert(columnar, id, 2);
+        }
+        CheckSame(columnar, row, scheduler);
+    }
+    std::remove(file);
+}
+
+// Past RowMapPage::ROWS rows the row map grows a second page, and RIDs refer to it
+void ManyRowsTest() {
+    const char *file = "columnar_table_many.db";
+    std::remove(file);
+    TaskScheduler scheduler(4);
+    const int rows = static_cast<int>(RowMapPage::ROWS) + 3000;
+    std::map<int, std::string> expected;
+    std::map<int, RID> rids;
+    page_id_t header_page_id;
+    {
+        DiskManager disk_manager(file);
+        std::unique_ptr<ColumnarTable> table = ColumnarTable::Create(&disk_manager, TestSchema());
+        for (int id = 0; id < rows; ++id) {
+            Tuple tuple = MakeRow(id);
+            CHECK(table->InsertTuple(tuple, &rids[id]));
+            expected[id] = RowText(tuple);
+        }
+        CHECK(rids[0].GetPageId() != rids[rows - 1].GetPageId());
+        // Deletes on both row map pages
+        for (int id = 0; id < rows; id += 3) {
+            CHECK(table->MarkDelete(rids[id]));
+            rids.erase(id);
+            expected.erase(id);
+        }
+        header_page_id = table->GetFirstPageId();
+    }
+    {
+        DiskManager disk_manager(file);
+        ColumnarTable table(&disk_manager, header_page_id, TestSchema());
+        CHECK(table.CountTuples() == expected.size());
+        CHECK(ById(table.ParallelScan({}, nullptr, &scheduler, 4)) == expected);
+        std::vector<RID> batch;
+        std::vector<int> ids;
+        for (const auto &entry : rids) {
+            if (entry.first % 10 != 1) continue;
+            batch.push_back(entry.second);
+            ids.push_back(entry.first);
+        }
+        std::vector<Tuple> tuples = table.GetTuples(batch);
+        CHECK(tuples.size() == ids.size());
+        size_t wrong = 0;
+        for (size_t i = 0; i < tuples.size() && i < ids.size(); ++i) {
+            if (RowText(tuples[i]) != expected[ids[i]]) wrong++;
+        }
+        CHECK(wrong == 0);
+        CHECK(table.Truncate() == expected.size());
+        CHECK(table.CountTuples() == 0);
+    }
+    std::remove(file);
+}
+
+} // namespace
+
+int main() {
+    CompareWithRowHeap();
+    ManyRowsTest();
+    return mydb_test::TestExit("columnar_table_test");
+}
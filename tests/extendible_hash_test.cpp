@@ -0,0 +1,171 @@
+// ExtendibleHashTable: buckets splitting until their directory doubles several times,
+// the directory invariants after every phase, lookups, overflow chains for a repeated
+// key, and directories halving again as removals empty their buckets.
+#include "index/extendible_hash_table.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace mydb;
+
+namespace {
+
+using HashTable = ExtendibleHashTable<IntKey, IntKeyComparator>;
+
+// Copy of directory `directory_index` as it is on disk; false if it has no page
+bool ReadDirectory(DiskManager &disk_manager, page_id_t header_page_id, uint32_t directory_index,
+                   HashTableDirectoryPage &directory) {
+    alignas(8) char header_buf[PAGE_SIZE];
+    disk_manager.ReadPage(header_page_id, header_buf);
+    page_id_t page_id = reinterpret_cast<HashTableHeaderPage *>(header_buf)->GetDirectoryPageId(directory_index);
+    if (page_id == -1) return false;
+    alignas(8) char buf[PAGE_SIZE];
+    disk_manager.ReadPage(page_id, buf);
+    directory = *reinterpret_cast<HashTableDirectoryPage *>(buf);
+    return true;
+}
+
+// Every slot within the global depth, slots agreeing on their low local-depth bits
+// sharing one bucket, and that bucket used by exactly 2^(global - local) slots
+void CheckDirectory(const HashTableDirectoryPage &directory) {
+    uint32_t global_depth = directory.GetGlobalDepth();
+    CHECK(global_depth <= directory.GetMaxDepth());
+    for (uint32_t i = 0; i < directory.Size(); ++i) {
+        uint32_t local_depth = directory.GetLocalDepth(i);
+        CHECK(local_depth <= global_depth);
+        CHECK(directory.GetBucketPageId(i) != -1);
+        uint32_t shared = 0;
+        for (uint32_t j = 0; j < directory.Size(); ++j) {
+            bool same_bucket = directory.GetBucketPageId(j) == directory.GetBucketPageId(i);
+            bool same_bits = ((i ^ j) & ((1u << local_depth) - 1)) == 0;
+            CHECK(same_bucket == same_bits);
+            if (same_bucket) {
+                CHECK(directory.GetLocalDepth(j) == local_depth);
+                shared++;
+            }
+        }
+        CHECK(shared == 1u << (global_depth - local_depth));
+    }
+}
+
+void CheckLookups(HashTable &table, const std::set<int> &present, const std::vector<int> &absent) {
+    size_t wrong = 0;
+    for (int key : present) {
+        std::vector<RID> rids;
+        if (!table.GetValue(key, rids) || rids.size() != 1 || rids[0].GetPageId() != key) wrong++;
+    }
+    for (int key : absent) {
+        std::vector<RID> rids;
+        if (table.GetValue(key, rids)) wrong++;
+    }
+    CHECK(wrong == 0);
+}
+
+// Keys that all hash to directory 0, so one directory takes every split
+void DoublingTest() {
+    const char *file = "extendible_hash_doubling.db";
+    std::remove(file);
+    std::vector<int> keys, absent;
+    for (int key = 0; keys.size() < 20000 || absent.size() < 1000; ++key) {
+        if ((HashTable::Hash(key) >> (32 - HashTableHeaderPage::MAX_DEPTH)) != 0) continue;
+        (keys.size() < 20000 ? keys : absent).push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+    std::set<int> present;
+    page_id_t header_page_id;
+    uint32_t global_depth = 0;
+    {
+        DiskManager disk_manager(file);
+        HashTable table("doubling", &disk_manager);
+        header_page_id = table.GetHeaderPageId();
+        HashTableDirectoryPage directory;
+        CHECK(!ReadDirectory(disk_manager, header_page_id, 0, directory));
+
+        for (size_t i = 0; i < keys.size(); ++i) {
+            table.Insert(keys[i], RID(keys[i], 0));
+            present.insert(keys[i]);
+            if (i % 2000 == 1999) {
+                // The directory only ever grows while keys go in
+                CHECK(ReadDirectory(disk_manager, header_page_id, 0, directory));
+                CHECK(directory.GetGlobalDepth() >= global_depth);
+                global_depth = directory.GetGlobalDepth();
+                CheckDirectory(directory);
+            }
+        }
+        // 20000 keys need at least 20000 / BUCKET_SIZE buckets: the directory has doubled
+        // from one slot at least six times
+        CHECK(global_depth >= 6);
+        CHECK(!ReadDirectory(disk_manager, header_page_id, 1, directory));
+        CheckLookups(table, present, absent);
+    }
+    {
+        DiskManager disk_manager(file);
+        HashTable table("doubling", &disk_manager, header_page_id);
+        CheckLookups(table, present, absent);
+
+        // Emptying every bucket whose slot has the top bit set lets the directory halve
+        uint32_t top_bit = 1u << (global_depth - 1);
+        for (int key : keys) {
+            if ((HashTable::Hash(key) & top_bit) == 0) continue;
+            CHECK(table.Remove(key, RID(key, 0)));
+            CHECK(!table.Remove(key, RID(key, 0)));
+            present.erase(key);
+            absent.push_back(key);
+        }
+        HashTableDirectoryPage directory;
+        CHECK(ReadDirectory(disk_manager, header_page_id, 0, directory));
+        CHECK(directory.GetGlobalDepth() < global_depth);
+        CheckDirectory(directory);
+        CheckLookups(table, present, absent);
+
+        for (int key : keys) {
+            if (present.count(key)) CHECK(table.Remove(key, RID(key, 0)));
+        }
+        CHECK(table.IsEmpty());
+        CHECK(!ReadDirectory(disk_manager, header_page_id, 0, directory));
+    }
+    std::remove(file);
+}
+
+// Keys spread over every directory, and one key repeated past a bucket's capacity
+// (it cannot be split apart, so it grows an overflow chain)
+void SpreadAndDuplicateTest() {
+    const char *file = "extendible_hash_spread.db";
+    std::remove(file);
+    {
+        DiskManager disk_manager(file);
+        HashTable table("spread", &disk_manager);
+        std::set<int> present;
+        std::mt19937 rng(2);
+        while (present.size() < 30000) present.insert(static_cast<int>(rng() % 1000000) + 1);
+        for (int key : present) table.Insert(key, RID(key, 0));
+        CheckLookups(table, present, {-1, -2, 2000000});
+        for (uint32_t d = 0; d < (1u << HashTableHeaderPage::MAX_DEPTH); d += 37) {
+            HashTableDirectoryPage directory;
+            if (ReadDirectory(disk_manager, table.GetHeaderPageId(), d, directory)) CheckDirectory(directory);
+        }
+
+        const int copies = 3 * HashTableBucketPage<IntKey, IntKeyComparator>::BUCKET_SIZE;
+        for (int i = 0; i < copies; ++i) table.Insert(0, RID(0, i));
+        std::vector<RID> rids;
+        CHECK(table.GetValue(0, rids));
+        CHECK(static_cast<int>(rids.size()) == copies);
+        for (int i = 0; i < copies; i += 2) CHECK(table.Remove(0, RID(0, i)));
+        rids.clear();
+        CHECK(table.GetValue(0, rids));
+        CHECK(static_cast<int>(rids.size()) == copies / 2);
+        CheckLookups(table, present, {-1, -2, 2000000});
+    }
+    std::remove(file);
+}
+
+} // namespace
+
+int main() {
+    DoublingTest();
+    SpreadAndDuplicateTest();
+    return mydb_test::TestExit("extendible_hash_test");
+}
@@ -0,0 +1,137 @@
+// HnswGraph recall: the k nearest neighbours it finds against a brute-force scan, for
+// each metric, after rows are removed (which must never be returned again) and after
+// the graph is reopened from disk.
+//
+// Usage: hnsw_recall_test [rows]
+#include "index/hnsw_graph.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace mydb;
+
+namespace {
+
+constexpr uint32_t DIMS = 32;
+constexpr size_t K = 10;
+constexpr size_t EF = 64;
+constexpr int QUERIES = 100;
+
+// Points around 40 random centres, the shape of real embeddings rather than a uniform cube
+std::vector<std::vector<float>> Clustered(int count, std::mt19937 &rng) {
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::vector<std::vector<float>> centres(40, std::vector<float>(DIMS));
+    for (auto &centre : centres) {
+        for (float &x : centre) x = normal(rng) * 4.0f;
+    }
+    std::vector<std::vector<float>> points(count, std::vector<float>(DIMS));
+    for (auto &point : points) {
+        const std::vector<float> &centre = centres[rng() % centres.size()];
+        for (uint32_t d = 0; d < DIMS; ++d) point[d] = centre[d] + normal(rng);
+    }
+    return points;
+}
+
+// Exact k nearest live rows (the RID page id is the row number)
+std::vector<int> BruteForce(DistanceMetric metric, const std::vector<std::vector<float>> &rows,
+                            const std::vector<bool> &live, const std::vector<float> &query) {
+    std::vector<std::pair<float, int>> all;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (live[i]) all.push_back({VectorDistance(metric, query.data(), rows[i].data(), DIMS), static_cast<int>(i)});
+    }
+    std::partial_sort(all.begin(), all.begin() + K, all.end());
+    std::vector<int> nearest;
+    for (size_t i = 0; i < K; ++i) nearest.push_back(all[i].second);
+    return nearest;
+}
+
+// Mean recall@K over the queries; also checks every result is live, ordered and unique
+double Recall(HnswGraph &graph, DistanceMetric metric, const std::vector<std::vector<float>> &rows,
+              const std::vector<bool> &live, const std::vector<std::vector<float>> &queries,
+              std::vector<std::vector<int>> *results = nullptr) {
+    size_t found = 0;
+    for (const auto &query : queries) {
+        std::vector<std::pair<float, RID>> result = graph.Search(query.data(), DIMS, K, EF);
+        CHECK(result.size() == K);
+        std::vector<int> rows_found;
+        for (size_t i = 0; i < result.size(); ++i) {
+            int row = result[i].second.GetPageId();
+            CHECK(row >= 0 && row < static_cast<int>(rows.size()) && live[row]);
+            if (i > 0) CHECK(result[i - 1].first <= result[i].first);
+            rows_found.push_back(row);
+        }
+        CHECK(std::set<int>(rows_found.begin(), rows_found.end()).size() == rows_found.size());
+        std::vector<int> exact = BruteForce(metric, rows, live, query);
+        for (int row : rows_found) found += std::count(exact.begin(), exact.end(), row);
+        if (results != nullptr) results->push_back(rows_found);
+    }
+    return static_cast<double>(found) / (queries.size() * K);
+}
+
+// min_recall: inner product is not a metric, so the graph routes less well on it
+void RecallTest(DistanceMetric metric, int row_count, double min_recall) {
+    std::string file = std::string("hnsw_recall_") + DistanceMetricName(metric) + ".db";
+    std::remove(file.c_str());
+    std::mt19937 rng(static_cast<unsigned>(metric) + 1);
+    std::vector<std::vector<float>> rows = Clustered(row_count, rng);
+    std::vector<std::vector<float>> queries = Clustered(QUERIES, rng);
+    std::vector<bool> live(rows.size(), true);
+    HnswParams params;
+    params.metric = metric;
+    params.ef_construction = 100; // Keeps the build quick without the optimizer
+    page_id_t header_page_id;
+    std::vector<std::vector<int>> before_reopen;
+    double recall;
+    {
+        DiskManager disk_manager(file);
+        HnswGraph graph(&disk_manager, -1, params);
+        // Half built in bulk (CREATE INDEX), half written through row by row (INSERT)
+        graph.BeginBulk();
+        for (int i = 0; i < row_count / 2; ++i) CHECK(graph.Insert(rows[i].data(), DIMS, RID(i, 0)));
+        graph.EndBulk();
+        for (int i = row_count / 2; i < row_count; ++i) CHECK(graph.Insert(rows[i].data(), DIMS, RID(i, 0)));
+        CHECK(!graph.Insert(rows[0].data(), DIMS - 1, RID(row_count, 0)));
+        CHECK(graph.GetLiveCount() == rows.size());
+
+        recall = Recall(graph, metric, rows, live, queries);
+        std::printf("%s: recall@%zu %.3f\n", DistanceMetricName(metric), K, recall);
+        CHECK(recall >= min_recall);
+
+        // Every third row removed: still routed through, never returned
+        for (int i = 0; i < row_count; i += 3) {
+            CHECK(graph.Remove(RID(i, 0)));
+            live[i] = false;
+        }
+        CHECK(!graph.Remove(RID(0, 0)));
+        recall = Recall(graph, metric, rows, live, queries, &before_reopen);
+        std::printf("%s: recall@%zu %.3f after removes\n", DistanceMetricName(metric), K, recall);
+        CHECK(recall >= min_recall - 0.05);
+        header_page_id = graph.GetHeaderPageId();
+    }
+    {
+        // Same graph back from disk: same parameters, same answers
+        DiskManager disk_manager(file);
+        HnswGraph graph(&disk_manager, header_page_id);
+        CHECK(graph.GetParams().metric == metric);
+        CHECK(graph.GetDims() == DIMS);
+        CHECK(graph.GetLiveCount() == static_cast<size_t>(std::count(live.begin(), live.end(), true)));
+        std::vector<std::vector<int>> after_reopen;
+        CHECK(Recall(graph, metric, rows, live, queries, &after_reopen) == recall);
+        CHECK(after_reopen == before_reopen);
+    }
+    std::remove(file.c_str());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int rows = argc > 1 ? std::atoi(argv[1]) : 2000;
+    RecallTest(DistanceMetric::L2, rows, 0.9);
+    RecallTest(DistanceMetric::INNER_PRODUCT, rows, 0.8);
+    RecallTest(DistanceMetric::COSINE, rows, 0.9);
+    return mydb_test::TestExit("hnsw_recall_test");
+}
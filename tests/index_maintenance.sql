@@ -0,0 +1,107 @@
+-- B+ tree and hash indexes kept in step with the table through INSERT, UPDATE, DELETE
+-- and CLEAR. WHERE = and ranges on an indexed column read through the index, so a
+-- missing entry loses a row and a stale one returns it twice.
+CREATE TABLE users id INT, age INT, name TEXT
+INSERT INTO users VALUES 1, 30, 'ann'
+INSERT INTO users VALUES 2, 41, 'bob'
+INSERT INTO users VALUES 3, 25, 'cat'
+CREATE INDEX users_id ON users(id)
+-- expect: Index users_id created
+CREATE INDEX users_age ON users(age) INCLUDE (name)
+-- expect: Index users_age created
+CREATE INDEX users_name ON users(name) USING HASH
+-- expect: Index users_name created
+-- Rows inserted after CREATE INDEX
+INSERT INTO users VALUES 4, 52, 'dan'
+INSERT INTO users VALUES 5, 25, 'eve'
+SELECT name FROM users WHERE id = 4
+-- expect: dan
+-- expect: (1 rows)
+SELECT name FROM users WHERE age = 25
+-- expect: cat
+-- expect: eve
+-- expect: (2 rows)
+SELECT id FROM users WHERE name = 'eve'
+-- expect: | 5
+-- expect: (1 rows)
+-- UPDATE of a key column moves the entry; of an INCLUDE column refreshes it
+UPDATE users SET id = 40 WHERE id = 4
+-- expect: Updated 1 rows.
+SELECT name FROM users WHERE id = 4
+-- expect: (0 rows)
+SELECT name FROM users WHERE id = 40
+-- expect: dan
+-- expect: (1 rows)
+UPDATE users SET name = 'bobby' WHERE id = 2
+-- expect: Updated 1 rows.
+SELECT name FROM users WHERE age = 41
+-- expect: bobby
+-- expect: (1 rows)
+SELECT id FROM users WHERE name = 'bob'
+-- expect: (0 rows)
+SELECT id FROM users WHERE name = 'bobby'
+-- expect: | 2
+-- expect: (1 rows)
+UPDATE users SET age = 26 WHERE name = 'eve'
+-- expect: Updated 1 rows.
+SELECT name FROM users WHERE age BETWEEN 25 AND 26
+-- expect: cat
+-- expect: eve
+-- expect: (2 rows)
+-- A growing row may move to another page: every index follows its new RID
+UPDATE users SET name = 'annabelle-the-very-long-name-that-no-longer-fits-in-place' WHERE id = 1
+-- expect: Updated 1 rows.
+SELECT name FROM users WHERE id = 1
+-- expect: annabelle-the-very-long-name
+-- expect: (1 rows)
+SELECT id FROM users WHERE age = 30
+-- expect: | 1
+-- expect: (1 rows)
+-- DELETE drops the entries
+DELETE FROM users WHERE id = 3
+-- expect: Deleted 1 rows.
+SELECT name FROM users WHERE id = 3
+-- expect: (0 rows)
+SELECT name FROM users WHERE age < 30
+-- expect: eve
+-- expect: (1 rows)
+SELECT id FROM users WHERE name = 'cat'
+-- expect: (0 rows)
+-- The indexes survive a reopen with the changes above
+-- reopen
+SELECT name FROM users WHERE id = 40
+-- expect: dan
+-- expect: (1 rows)
+SELECT name FROM users WHERE age = 26
+-- expect: eve
+-- expect: (1 rows)
+SELECT id FROM users WHERE name = 'bobby'
+-- expect: | 2
+-- expect: (1 rows)
+SELECT * FROM users
+-- expect: (4 rows)
+-- CLEAR empties the indexes too: rows inserted again reuse the same RIDs and must
+-- each come back once
+CLEAR users
+-- expect: Cleared 4 rows
+SELECT name FROM users WHERE id = 40
+-- expect: (0 rows)
+INSERT INTO users VALUES 40, 30, 'fay'
+INSERT INTO users VALUES 41, 30, 'gus'
+SELECT name FROM users WHERE id = 40
+-- expect: fay
+-- expect: (1 rows)
+SELECT name FROM users WHERE age = 30
+-- expect: fay
+-- expect: gus
+-- expect: (2 rows)
+SELECT id FROM users WHERE name = 'gus'
+-- expect: | 41
+-- expect: (1 rows)
+-- and the new, empty indexes are in the saved catalog
+-- reopen
+SELECT name FROM users WHERE age = 30
+-- expect: (2 rows)
+SELECT id FROM users WHERE name = 'fay'
+-- expect: | 40
+-- expect: (1 rows)
@@ -0,0 +1,156 @@
+// IvfPq recall: the k nearest neighbours it finds, re-ranked by exact distance the way
+// the executor does, against a brute-force scan for each metric; also training on the
+// rows that arrived untrained, removes (never returned again) and a reopen from disk.
+//
+// Usage: ivf_pq_recall_test [rows]
+#include "common/task_scheduler.h"
+#include "index/ivf_pq.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace mydb;
+
+namespace {
+
+constexpr uint32_t DIMS = 32;
+constexpr size_t K = 10;
+constexpr size_t RERANK = 4; // Candidates fetched per requested row, as SET RERANK
+constexpr size_t NPROBE = 8;
+constexpr int QUERIES = 100;
+
+// Points around 40 random centres, the shape of real embeddings rather than a uniform cube
+std::vector<std::vector<float>> Clustered(int count, std::mt19937 &rng) {
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::vector<std::vector<float>> centres(40, std::vector<float>(DIMS));
+    for (auto &centre : centres) {
+        for (float &x : centre) x = normal(rng) * 4.0f;
+    }
+    std::vector<std::vector<float>> points(count, std::vector<float>(DIMS));
+    for (auto &point : points) {
+        const std::vector<float> &centre = centres[rng() % centres.size()];
+        for (uint32_t d = 0; d < DIMS; ++d) point[d] = centre[d] + normal(rng);
+    }
+    return points;
+}
+
+// Nearest K of the candidate rows by exact distance (the RID page id is the row number)
+std::vector<int> Nearest(DistanceMetric metric, const std::vector<std::vector<float>> &rows,
+                         const std::vector<int> &candidates, const std::vector<float> &query) {
+    std::vector<std::pair<float, int>> scored;
+    for (int row : candidates) scored.push_back({VectorDistance(metric, query.data(), rows[row].data(), DIMS), row});
+    size_t k = std::min(K, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + k, scored.end());
+    std::vector<int> nearest;
+    for (size_t i = 0; i < k; ++i) nearest.push_back(scored[i].second);
+    return nearest;
+}
+
+// Mean recall@K over the queries after re-ranking K * RERANK candidates; also checks
+// every candidate is live and unique
+double Recall(IvfPq &index, DistanceMetric metric, const std::vector<std::vector<float>> &rows,
+              const std::vector<bool> &live, const std::vector<std::vector<float>> &queries,
+              std::vector<std::vector<int>> *results = nullptr) {
+    std::vector<int> live_rows;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (live[i]) live_rows.push_back(static_cast<int>(i));
+    }
+    size_t found = 0;
+    for (const auto &query : queries) {
+        std::vector<std::pair<float, RID>> result = index.Search(query.data(), DIMS, K * RERANK, NPROBE);
+        CHECK(result.size() == K * RERANK);
+        std::vector<int> candidates;
+        for (size_t i = 0; i < result.size(); ++i) {
+            int row = result[i].second.GetPageId();
+            CHECK(row >= 0 && row < static_cast<int>(rows.size()) && live[row]);
+            if (i > 0) CHECK(result[i - 1].first <= result[i].first);
+            candidates.push_back(row);
+        }
+        CHECK(std::set<int>(candidates.begin(), candidates.end()).size() == candidates.size());
+        std::vector<int> reranked = Nearest(metric, rows, candidates, query);
+        std::vector<int> exact = Nearest(metric, rows, live_rows, query);
+        for (int row : reranked) found += std::count(exact.begin(), exact.end(), row);
+        if (results != nullptr) results->push_back(reranked);
+    }
+    return static_cast<double>(found) / (queries.size() * K);
+}
+
+void RecallTest(DistanceMetric metric, int row_count, TaskScheduler &scheduler) {
+    std::string file = std::string("ivf_pq_recall_") + DistanceMetricName(metric) + ".db";
+    std::remove(file.c_str());
+    std::mt19937 rng(static_cast<unsigned>(metric) + 1);
+    std::vector<std::vector<float>> rows = Clustered(row_count, rng);
+    std::vector<std::vector<float>> queries = Clustered(QUERIES, rng);
+    std::vector<bool> live(rows.size(), true);
+    IvfPqParams params;
+    params.metric = metric;
+    page_id_t header_page_id;
+    std::vector<std::vector<int>> before_reopen;
+    double recall;
+    {
+        DiskManager disk_manager(file);
+        IvfPq index(&disk_manager, -1, params);
+        // Too few rows to train on: kept raw, and searches refused
+        const int untrained = static_cast<int>(IvfPq::TRAIN_ROWS) / 2;
+        for (int i = 0; i < untrained; ++i) CHECK(index.Insert(rows[i].data(), DIMS, RID(i, 0)));
+        CHECK(!index.IsTrained());
+        CHECK(index.Search(queries[0].data(), DIMS, K, NPROBE).empty());
+
+        // A bulk load (CREATE INDEX) trains on everything so far, then rows one at a time
+        const int bulk_end = row_count * 3 / 4;
+        std::vector<const float *> vecs;
+        std::vector<RID> rids;
+        for (int i = untrained; i < bulk_end; ++i) {
+            vecs.push_back(rows[i].data());
+            rids.push_back(RID(i, 0));
+        }
+        index.BulkInsert(vecs, DIMS, rids, &scheduler, 4);
+        CHECK(index.IsTrained());
+        for (int i = bulk_end; i < row_count; ++i) CHECK(index.Insert(rows[i].data(), DIMS, RID(i, 0)));
+        CHECK(!index.Insert(rows[0].data(), DIMS - 1, RID(row_count, 0)));
+        CHECK(index.GetLiveCount() == rows.size());
+
+        recall = Recall(index, metric, rows, live, queries);
+        std::printf("%s: recall@%zu %.3f\n", DistanceMetricName(metric), K, recall);
+        CHECK(recall >= 0.9);
+
+        // Every third row removed, found through the list its vector falls in
+        for (int i = 0; i < row_count; i += 3) {
+            CHECK(index.Remove(rows[i].data(), DIMS, RID(i, 0)));
+            live[i] = false;
+        }
+        CHECK(!index.Remove(rows[0].data(), DIMS, RID(0, 0)));
+        recall = Recall(index, metric, rows, live, queries, &before_reopen);
+        std::printf("%s: recall@%zu %.3f after removes\n", DistanceMetricName(metric), K, recall);
+        CHECK(recall >= 0.9);
+        header_page_id = index.GetHeaderPageId();
+    }
+    {
+        // Same index back from disk: same parameters, same answers
+        DiskManager disk_manager(file);
+        IvfPq index(&disk_manager, header_page_id);
+        CHECK(index.IsTrained());
+        CHECK(index.GetParams().metric == metric);
+        CHECK(index.GetDims() == DIMS);
+        CHECK(index.GetLiveCount() == static_cast<size_t>(std::count(live.begin(), live.end(), true)));
+        std::vector<std::vector<int>> after_reopen;
+        CHECK(Recall(index, metric, rows, live, queries, &after_reopen) == recall);
+        CHECK(after_reopen == before_reopen);
+    }
+    std::remove(file.c_str());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int rows = argc > 1 ? std::atoi(argv[1]) : 3000;
+    TaskScheduler scheduler(4);
+    RecallTest(DistanceMetric::L2, rows, scheduler);
+    RecallTest(DistanceMetric::INNER_PRODUCT, rows, scheduler);
+    RecallTest(DistanceMetric::COSINE, rows, scheduler);
+    return mydb_test::TestExit("ivf_pq_recall_test");
+}
@@ -0,0 +1,187 @@
+// Values larger than a page: VARCHAR and VECTOR values moved to overflow chains round
+// trip through every read path of the row heap and the columnar layout, survive updates
+// and a reopen, and projections that leave them out never read their chains.
+#include "storage/columnar_table.h"
+#include "storage/table_heap.h"
+#include "test_check.h"
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mydb;
+
+namespace {
+
+constexpr int ROWS = 24;
+
+Schema TestSchema() {
+    return Schema({Column("id", TypeID::INTEGER, 0), Column("body", TypeID::VARCHAR, 4),
+                   Column("embedding", TypeID::VECTOR, 8), Column("tag", TypeID::VARCHAR, 12)});
+}
+
+// Even rows carry a body of several pages and a vector of 1500 floats (6000 bytes);
+// odd rows are small enough to stay inline
+Tuple MakeRow(int id, bool large) {
+    std::string body;
+    std::vector<float> embedding;
+    if (large) {
+        for (int i = 0; body.size() < 10000; ++i) body += "row " + std::to_string(id) + " line " + std::to_string(i) + "\n";
+        for (int i = 0; i < 1500; ++i) embedding.push_back(static_cast<float>(id) + i * 0.25f);
+    } else {
+        body = "short " + std::to_string(id);
+        embedding = {static_cast<float>(id), 1.0f};
+    }
+    return Tuple({Value(static_cast<int32_t>(id)), Value(body), Value(embedding), Value("tag" + std::to_string(id))});
+}
+
+bool SameRow(const Tuple &a, const Tuple &b) {
+    return a.GetValue(0).GetAsInteger() == b.GetValue(0).GetAsInteger() &&
+           a.GetValue(1).GetAsString() == b.GetValue(1).GetAsString() &&
+           a.GetValue(2).GetAsVector() == b.GetValue(2).GetAsVector() &&
+           a.GetValue(3).GetAsString() == b.GetValue(3).GetAsString();
+}
+
+// Overflow pages holding one value
+uint64_t ChainPages(const Value &value) {
+    return (value.GetSerializedSize() + OverflowPage::CAPACITY - 1) / OverflowPage::CAPACITY;
+}
+
+uint64_t ReadsDuring(DiskManager &disk_manager, const std::function<void()> &fn) {
+    uint64_t before = disk_manager.GetNumReads();
+    fn();
+    return disk_manager.GetNumReads() - before;
+}
+
+// expected[id] is the current contents of row id; rids[id] its location
+void CheckRows(TableHeap &table, const std::vector<Tuple> &expected, std::vector<RID> &rids,
+               TaskScheduler &scheduler) {
+    std::vector<Tuple> scanned = table.Scan();
+    CHECK(scanned.size() == expected.size());
+    size_t wrong = 0;
+    for (const Tuple &tuple : scanned) {
+        if (!SameRow(tuple, expected[tuple.GetValue(0).GetAsInteger()])) wrong++;
+    }
+    std::vector<RID> scan_rids;
+    std::vector<Tuple> parallel = table.ParallelScan({}, nullptr, &scheduler, 4, &scan_rids);
+    CHECK(parallel.size() == expected.size());
+    for (const Tuple &tuple : parallel) {
+        if (!SameRow(tuple, expected[tuple.GetValue(0).GetAsInteger()])) wrong++;
+    }
+    for (size_t id = 0; id < expected.size(); ++id) {
+        Tuple tuple;
+        if (!table.GetTuple(rids[id], tuple) || !SameRow(tuple, expected[id])) wrong++;
+    }
+    std::vector<RID> lookup = rids;
+    std::vector<Tuple> fetched = table.GetTuples(lookup);
+    CHECK(fetched.size() == expected.size());
+    for (const Tuple &tuple : fetched) {
+        if (!SameRow(tuple, expected[tuple.GetValue(0).GetAsInteger()])) wrong++;
+    }
+    CHECK(wrong == 0);
+}
+
+// The reads a scan or lookup saves by leaving the large columns out: at least their
+// overflow chains (for the row heap, exactly those)
+void CheckProjection(TableHeap &table, DiskManager &disk_manager, const std::vector<Tuple> &expected,
+                     const std::vector<RID> &rids, bool exact) {
+    uint64_t body_pages = 0, embedding_pages = 0;
+    for (const Tuple &tuple : expected) {
+        if (tuple.GetValue(1).GetSerializedSize() > PAGE_SIZE) body_pages += ChainPages(tuple.GetValue(1));
+        if (tuple.GetValue(2).GetSerializedSize() > PAGE_SIZE) embedding_pages += ChainPages(tuple.GetValue(2));
+    }
+    const std::vector<bool> small_columns = {true, false, false, true};
+    std::vector<Tuple> projected;
+    uint64_t small_reads = ReadsDuring(disk_manager, [&] { projected = table.Scan(small_columns); });
+    uint64_t body_reads = ReadsDuring(disk_manager, [&] { table.Scan({true, true, false, true}); });
+    uint64_t full_reads = ReadsDuring(disk_manager, [&] { table.Scan(); });
+    std::printf("%s: %llu reads without the large columns, %llu with the body, %llu with both\n",
+                exact ? "row" : "columnar", static_cast<unsigned long long>(small_reads),
+                static_cast<unsigned long long>(body_reads), static_cast<unsigned long long>(full_reads));
+    CHECK(projected.size() == expected.size());
+    for (const Tuple &tuple : projected) {
+        const Tuple &row = expected[tuple.GetValue(0).GetAsInteger()];
+        CHECK(tuple.GetValue(3).GetAsString() == row.GetValue(3).GetAsString());
+        CHECK(tuple.GetValue(1).GetTypeId() == TypeID::INVALID);
+    }
+    if (exact) {
+        CHECK(body_reads == small_reads + body_pages);
+        CHECK(full_reads == small_reads + body_pages + embedding_pages);
+    } else {
+        CHECK(body_reads >= small_reads + body_pages);
+        CHECK(full_reads >= body_reads + embedding_pages);
+    }
+
+    // A point lookup of a large row without its large columns reads no chain
+    Tuple tuple;
+    uint64_t lookup_reads = ReadsDuring(disk_manager, [&] { CHECK(table.GetTuple(rids[0], tuple, small_columns)); });
+    uint64_t large_reads = ReadsDuring(disk_manager, [&] { CHECK(table.GetTuple(rids[0], tuple)); });
+    uint64_t row_chains = ChainPages(expected[0].GetValue(1)) + ChainPages(expected[0].GetValue(2));
+    CHECK(exact ? large_reads == lookup_reads + row_chains : large_reads >= lookup_reads + row_chains);
+}
+
+// Inserts, checks, updates large rows to small and back, then reopens the table from the
+// page ids a catalog would record
+void RoundTrip(const char *name, const std::function<std::unique_ptr<TableHeap>(DiskManager &)> &create,
+               const std::function<std::unique_ptr<TableHeap>(DiskManager &, page_id_t, page_id_t)> &reopen,
+               bool exact) {
+    std::string file = std::string("overflow_") + name + ".db";
+    std::remove(file.c_str());
+    TaskScheduler scheduler(4);
+    std::vector<Tuple> expected;
+    std::vector<RID> rids(ROWS);
+    page_id_t first_page_id, zone_map_page_id;
+    {
+        DiskManager disk_manager(file);
+        std::unique_ptr<TableHeap> table = create(disk_manager);
+        for (int id = 0; id < ROWS; ++id) {
+            expected.push_back(MakeRow(id, id % 2 == 0));
+            CHECK(table->InsertTuple(expected.back(), &rids[id]));
+        }
+        CheckRows(*table, expected, rids, scheduler);
+        CheckProjection(*table, disk_manager, expected, rids, exact);
+
+        // Large to small, small to large, large to a different large value
+        for (int id : {2, 3, 4}) {
+            Tuple updated = MakeRow(id + 100, id != 2);
+            expected[id] = Tuple({Value(static_cast<int32_t>(id)), updated.GetValue(1), updated.GetValue(2),
+                                  updated.GetValue(3)});
+            CHECK(table->UpdateTuple(expected[id], rids[id]));
+        }
+        CheckRows(*table, expected, rids, scheduler);
+        first_page_id = table->GetFirstPageId();
+        zone_map_page_id = table->GetZoneMapPageId();
+    }
+    {
+        DiskManager disk_manager(file);
+        std::unique_ptr<TableHeap> table = reopen(disk_manager, first_page_id, zone_map_page_id);
+        CheckRows(*table, expected, rids, scheduler);
+        CheckProjection(*table, disk_manager, expected, rids, exact);
+    }
+    std::remove(file.c_str());
+}
+
+} // namespace
+
+int main() {
+    // The row heap moves values out of rows above half a page
+    RoundTrip(
+        "row", [](DiskManager &disk_manager) { return TableHeap::Create(&disk_manager, TestSchema()); },
+        [](DiskManager &disk_manager, page_id_t first_page_id, page_id_t zone_map_page_id) {
+            return std::make_unique<TableHeap>(&disk_manager, first_page_id, TestSchema(), zone_map_page_id);
+        },
+        true);
+    // The columnar layout moves single values above a quarter page; its column pages add
+    // reads of their own, so only the chains are known
+    RoundTrip(
+        "columnar",
+        [](DiskManager &disk_manager) -> std::unique_ptr<TableHeap> {
+            return ColumnarTable::Create(&disk_manager, TestSchema());
+        },
+        [](DiskManager &disk_manager, page_id_t header_page_id, page_id_t) -> std::unique_ptr<TableHeap> {
+            return std::make_unique<ColumnarTable>(&disk_manager, header_page_id, TestSchema());
+        },
+        false);
+    return mydb_test::TestExit("overflow_test");
+}
@@ -0,0 +1,147 @@
+// Runs a SQL scenario file through the Executor and checks what it prints.
+//
+// Usage: sql_scenario_test <scenario.sql>   (run in a scratch directory: it creates
+// <scenario>.db and <scenario>.cat there, and EXPORT / IMPORT files live there too)
+//
+// Every line is a statement, as typed into the shell, except:
+//   -- expect: <text>   the output of the statement above must contain <text>
+//   -- reopen           saves the catalog and reopens the database and catalog
+//   -- <anything else>  a comment
+// A statement whose output contains "Error" fails the scenario unless one of its
+// expect lines mentions "Error".
+#include "catalog/catalog_manager.h"
+#include "common/task_scheduler.h"
+#include "executor/executor.h"
+#include "storage/disk_manager.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace mydb;
+
+namespace {
+
+// One open database: disk manager, executor and catalog, torn down in reverse order
+struct Database {
+    Database(const std::string &db_file, const std::string &cat_file, TaskScheduler *scheduler)
+        : disk_manager(db_file), executor(&disk_manager), catalog(&executor, cat_file) {
+        executor.SetFiles(db_file, cat_file);
+        executor.SetScheduler(scheduler);
+        catalog.LoadCatalog();
+    }
+
+    DiskManager disk_manager;
+    Executor executor;
+    CatalogManager catalog;
+};
+
+// Output of one statement, without the terminal colour codes
+std::string Run(Executor &executor, const std::string &sql) {
+    std::stringstream buffer;
+    std::streambuf *old_cout = std::cout.rdbuf(buffer.rdbuf());
+    try {
+        executor.Execute(sql);
+    } catch (const std::exception &e) {
+        buffer << "Error: " << e.what() << "\n";
+    }
+    std::cout.rdbuf(old_cout);
+
+    std::string clean;
+    bool in_escape = false;
+    for (char c : buffer.str()) {
+        if (c == '\033') {
+            in_escape = true;
+        } else if (in_escape) {
+            if (c == 'm') in_escape = false;
+        } else {
+            clean += c;
+        }
+    }
+    return clean;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::printf("usage: %s <scenario.sql>\n", argv[0]);
+        return 2;
+    }
+    std::ifstream scenario(argv[1]);
+    if (!scenario.is_open()) {
+        std::printf("cannot open %s\n", argv[1]);
+        return 2;
+    }
+    std::string name = argv[1];
+    name = name.substr(name.find_last_of("/\\") + 1);
+    name = name.substr(0, name.rfind('.'));
+    const std::string db_file = name + ".db";
+    const std::string cat_file = name + ".cat";
+    std::remove(db_file.c_str());
+    std::remove(cat_file.c_str());
+
+    TaskScheduler scheduler(4);
+    auto database = std::make_unique<Database>(db_file, cat_file, &scheduler);
+
+    int failures = 0;
+    int line_num = 0;
+    std::string line, statement, output;
+    std::vector<std::string> expects;
+    // Checks the statement run last against its expect lines
+    auto finish = [&]() {
+        if (statement.empty()) return;
+        bool error_expected = false;
+        bool failed = false;
+        for (const std::string &text : expects) {
+            if (text.find("Error") != std::string::npos) error_expected = true;
+            if (output.find(text) == std::string::npos) {
+                std::printf("FAILED: '%s' did not print '%s'\n", statement.c_str(), text.c_str());
+                failed = true;
+            }
+        }
+        if (!error_expected && output.find("Error") != std::string::npos) {
+            std::printf("FAILED: '%s' failed\n", statement.c_str());
+            failed = true;
+        }
+        if (failed) {
+            std::printf("%s", output.c_str());
+            failures++;
+        }
+        statement.clear();
+        expects.clear();
+    };
+
+    while (std::getline(scenario, line)) {
+        line_num++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.find_first_not_of(" \t") == std::string::npos) continue;
+        if (line.rfind("-- expect: ", 0) == 0) {
+            expects.push_back(line.substr(11));
+            continue;
+        }
+        if (line.rfind("--", 0) == 0) {
+            if (line == "-- reopen") {
+                finish();
+                database->catalog.SaveCatalog();
+                database.reset();
+                database = std::make_unique<Database>(db_file, cat_file, &scheduler);
+            }
+            continue;
+        }
+        finish();
+        statement = line;
+        output = Run(database->executor, line);
+    }
+    finish();
+    database.reset();
+    std::remove(db_file.c_str());
+    std::remove(cat_file.c_str());
+
+    std::printf("%s: %s (%d failures, %d lines)\n", name.c_str(), failures == 0 ? "OK" : "FAILED", failures,
+                line_num);
+    return failures == 0 ? 0 : 1;
+}
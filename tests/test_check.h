@@ -0,0 +1,30 @@
+#pragma once
+
+// Checks for the C++ tests: CHECK reports a failed condition and carries on, so one
+// run lists every failure; main() ends with `return TestExit("name");`, which is
+// non-zero (a ctest failure) if any CHECK failed.
+#include <atomic>
+#include <cstdio>
+
+namespace mydb_test {
+
+inline std::atomic<int> &Failures() {
+    static std::atomic<int> failures{0};
+    return failures;
+}
+
+inline int TestExit(const char *name) {
+    int failures = Failures().load();
+    std::printf("%s: %s (%d failures)\n", name, failures == 0 ? "OK" : "FAILED", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace mydb_test
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            ++mydb_test::Failures();                                                 \
+        }                                                                            \
+    } while (0)
@@ -0,0 +1,47 @@
+-- VECTOR columns through INSERT, UPDATE, IMPORT / EXPORT and projected SELECTs
+CREATE TABLE docs id INT, embedding VECTOR, title TEXT
+-- expect: Table docs created.
+INSERT INTO docs VALUES 1, '[0.5,0.25,1]', 'first'
+INSERT INTO docs VALUES 2, '[1,1,1]', 'second'
+INSERT INTO docs VALUES 3, '[0,0,0.125]', 'third'
+SELECT * FROM docs
+-- expect: [0.5, 0.25, 1]
+-- expect: (3 rows)
+SELECT id FROM docs WHERE id >= 2
+-- expect: | id
+-- expect: (2 rows)
+SELECT title, embedding FROM docs WHERE id = 3
+-- expect: [0, 0, 0.125]
+-- expect: third
+UPDATE docs SET embedding = '[2,2,2]' WHERE id = 2
+-- expect: Updated 1 rows.
+SELECT id FROM docs ORDER BY VECTOR_DIST(embedding, [2, 2, 2]) LIMIT 1
+-- expect: | 2
+-- Rows whose vector cell does not parse are refused, the rest imported
+CREATE TABLE places id INT, v VECTOR, name TEXT
+IMPORT places vector_import.csv
+-- expect: Invalid vector at line 2
+-- expect: Invalid vector at line 5
+-- expect: Imported 3 rows
+SELECT * FROM places
+-- expect: north, up
+-- expect: (3 rows)
+SELECT id FROM places WHERE id = 5
+-- expect: | 5
+-- expect: (1 rows)
+SELECT name FROM places ORDER BY VECTOR_DIST(v, [0, 1]) LIMIT 1
+-- expect: north, up
+-- EXPORT quotes vectors and text with commas; IMPORT reads them back into another encoding
+EXPORT places places_export.csv
+-- expect: Exported 3 rows
+CREATE TABLE copies id INT, v VECTOR_FP16, name TEXT
+IMPORT copies places_export.csv
+-- expect: Imported 3 rows
+SELECT v, name FROM copies WHERE id = 3
+-- expect: [0, 1]
+-- expect: north, up
+-- reopen
+SELECT id, v FROM copies WHERE id = 5
+-- expect: [-1, 0]
+SELECT embedding FROM docs WHERE id = 1
+-- expect: [0.5, 0.25, 1]
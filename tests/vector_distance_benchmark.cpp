@@ -0,0 +1,89 @@
+// Micro-benchmark of the vector distance kernels (common/vector_distance.h): every kernel
+// set this CPU supports, for each metric, on vectors stored in each encoding, streamed
+// from memory the way a scan reads them.
+//
+// Usage: vector_distance_benchmark [dims ...]   (build in Release for real numbers)
+#include "common/vector_distance.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace mydb;
+
+namespace {
+
+const DistanceMetric METRICS[] = {DistanceMetric::L2, DistanceMetric::INNER_PRODUCT, DistanceMetric::COSINE};
+const VectorEncoding ENCODINGS[] = {VectorEncoding::FP32, VectorEncoding::FP16, VectorEncoding::INT8};
+
+// ns per distance of `kernels` over every row, repeated for at least 50 ms
+double Time(DistanceMetric metric, const std::vector<float> &query, float query_norm, VectorEncoding encoding,
+            const std::vector<char> &codes, const std::vector<float> &scales, size_t dims,
+            const DistanceKernels &kernels) {
+    const size_t rows = scales.size();
+    const size_t row_bytes = EncodedVectorSize(encoding, dims);
+    volatile float sink = 0;
+    size_t computed = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration::zero();
+    do {
+        for (size_t r = 0; r < rows; ++r) {
+            sink = sink + EncodedVectorDistance(metric, query.data(), query_norm, encoding,
+                                                codes.data() + r * row_bytes, scales[r], dims, kernels);
+        }
+        computed += rows;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed < std::chrono::milliseconds(50));
+    return std::chrono::duration<double, std::nano>(elapsed).count() / computed;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::vector<size_t> dims_list;
+    for (int i = 1; i < argc; ++i) {
+        long dims = std::strtol(argv[i], nullptr, 10);
+        if (dims <= 0 || dims > 65536) {
+            std::fprintf(stderr, "invalid dimension count '%s'\n", argv[i]);
+            return 1;
+        }
+        dims_list.push_back(static_cast<size_t>(dims));
+    }
+    if (dims_list.empty()) dims_list = {128, 384, 768, 1536};
+
+    std::printf("Distance kernels, ns per distance (active: %s)\n", ActiveDistanceKernels().name);
+    std::printf("%-7s%-9s%-6s", "dims", "kernel", "enc");
+    for (DistanceMetric metric : METRICS) std::printf("%10s", DistanceMetricName(metric));
+    std::printf("\n");
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    for (size_t dims : dims_list) {
+        // Enough rows to stream from memory like a scan does, not just from L1
+        const size_t rows = std::max<size_t>(16, (4u << 20) / (dims * sizeof(float)));
+        std::vector<float> data(rows * dims);
+        std::vector<float> query(dims);
+        for (float &x : data) x = uniform(rng);
+        for (float &x : query) x = uniform(rng);
+        const float query_norm = ActiveDistanceKernels().dot(query.data(), query.data(), dims);
+
+        for (VectorEncoding encoding : ENCODINGS) {
+            const size_t row_bytes = EncodedVectorSize(encoding, dims);
+            std::vector<char> codes(rows * row_bytes);
+            std::vector<float> scales(rows);
+            for (size_t r = 0; r < rows; ++r) {
+                scales[r] = EncodeVector(encoding, data.data() + r * dims, dims, codes.data() + r * row_bytes);
+            }
+            for (const DistanceKernels *kernels : SupportedDistanceKernels()) {
+                std::printf("%-7zu%-9s%-6s", dims, kernels->name, VectorEncodingName(encoding));
+                for (DistanceMetric metric : METRICS) {
+                    std::printf("%10.1f", Time(metric, query, query_norm, encoding, codes, scales, dims, *kernels));
+                }
+                std::printf("\n");
+            }
+        }
+    }
+    return 0;
+}